@@ -780,6 +780,36 @@ static int add_batch_data(cJSON *array, enum batch_data_type type, void *buf, si
 	return 0;
 }
 
+/* Encode a message as CBOR or as a JSON string, as configured for the message type. */
+static int encode_output(struct cloud_codec_data *output, cJSON *root_obj, bool cbor)
+{
+	char *buffer;
+
+	if (cbor) {
+		struct nrf_cloud_data data;
+		int err = nrf_cloud_cbor_encode(root_obj, &data);
+
+		if (err) {
+			LOG_ERR("nrf_cloud_cbor_encode, error: %d", err);
+			return err;
+		}
+
+		output->buf = (char *)data.ptr;
+		output->len = data.len;
+		return 0;
+	}
+
+	buffer = cJSON_PrintUnformatted(root_obj);
+	if (buffer == NULL) {
+		LOG_ERR("Failed to allocate memory for JSON string");
+		return -ENOMEM;
+	}
+
+	output->buf = buffer;
+	output->len = strlen(buffer);
+	return 0;
+}
+
 int cloud_codec_init(struct cloud_data_cfg *cfg, cloud_codec_evt_handler_t event_handler)
 {
 	ARG_UNUSED(cfg);
@@ -988,7 +1018,6 @@ int cloud_codec_encode_ui_data(struct cloud_codec_data *output,
 			       struct cloud_data_ui *ui_buf)
 {
 	int err, len;
-	char *buffer;
 	cJSON *root_obj = NULL;
 
 	if (!ui_buf->queued) {
@@ -1023,11 +1052,8 @@ int cloud_codec_encode_ui_data(struct cloud_codec_data *output,
 		goto exit;
 	}
 
-	buffer = cJSON_PrintUnformatted(root_obj);
-	if (buffer == NULL) {
-		LOG_ERR("Failed to allocate memory for JSON string");
-
-		err = -ENOMEM;
+	err = encode_output(output, root_obj, IS_ENABLED(CONFIG_CLOUD_CODEC_NRF_CLOUD_CBOR_UI));
+	if (err) {
 		goto exit;
 	}
 
@@ -1037,9 +1063,6 @@ int cloud_codec_encode_ui_data(struct cloud_codec_data *output,
 		json_print_obj("Encoded message:\n", root_obj);
 	}
 
-	output->buf = buffer;
-	output->len = strlen(buffer);
-
 exit:
 	cJSON_Delete(root_obj);
 	return err;
@@ -1049,7 +1072,6 @@ int cloud_codec_encode_impact_data(struct cloud_codec_data *output,
 				   struct cloud_data_impact *impact_buf)
 {
 	int err, len;
-	char *buffer;
 	cJSON *root_obj = NULL;
 	char magnitude[10];
 
@@ -1082,11 +1104,8 @@ int cloud_codec_encode_impact_data(struct cloud_codec_data *output,
 		goto exit;
 	}
 
-	buffer = cJSON_PrintUnformatted(root_obj);
-	if (buffer == NULL) {
-		LOG_ERR("Failed to allocate memory for JSON string");
-
-		err = -ENOMEM;
+	err = encode_output(output, root_obj, IS_ENABLED(CONFIG_CLOUD_CODEC_NRF_CLOUD_CBOR_IMPACT));
+	if (err) {
 		goto exit;
 	}
 
@@ -1096,9 +1115,6 @@ int cloud_codec_encode_impact_data(struct cloud_codec_data *output,
 		json_print_obj("Encoded message:\n", root_obj);
 	}
 
-	output->buf = buffer;
-	output->len = strlen(buffer);
-
 exit:
 	cJSON_Delete(root_obj);
 	return err;
@@ -1121,7 +1137,6 @@ int cloud_codec_encode_batch_data(struct cloud_codec_data *output,
 				  size_t bat_buf_count)
 {
 	int err;
-	char *buffer;
 
 	cJSON *root_array = cJSON_CreateArray();
 
@@ -1182,11 +1197,9 @@ int cloud_codec_encode_batch_data(struct cloud_codec_data *output,
 		err = 0;
 	}
 
-	buffer = cJSON_PrintUnformatted(root_array);
-	if (buffer == NULL) {
-		LOG_ERR("Failed to allocate memory for JSON string");
-
-		err = -ENOMEM;
+	err = encode_output(output, root_array,
+			    IS_ENABLED(CONFIG_CLOUD_CODEC_NRF_CLOUD_CBOR_BATCH));
+	if (err) {
 		goto exit;
 	}
 
@@ -1194,9 +1207,6 @@ int cloud_codec_encode_batch_data(struct cloud_codec_data *output,
 		json_print_obj("Encoded batch message:\n", root_array);
 	}
 
-	output->buf = buffer;
-	output->len = strlen(buffer);
-
 exit:
 	cJSON_Delete(root_array);
 	return err;
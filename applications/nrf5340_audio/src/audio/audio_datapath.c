@@ -11,6 +11,7 @@
 #include <zephyr/shell/shell.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <ctype.h>
 
 #include "macros_common.h"
@@ -24,6 +25,9 @@
 #include "contin_array.h"
 #include "pcm_mix.h"
 #include "streamctrl.h"
+#if (CONFIG_AUDIO_DATAPATH_ASRC)
+#include "asrc.h"
+#endif /* (CONFIG_AUDIO_DATAPATH_ASRC) */
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(audio_datapath, CONFIG_AUDIO_DATAPATH_LOG_LEVEL);
@@ -85,6 +89,22 @@ LOG_MODULE_REGISTER(audio_datapath, CONFIG_AUDIO_DATAPATH_LOG_LEVEL);
 /* How often to print underrun warning */
 #define UNDERRUN_LOG_INTERVAL_BLKS 5000
 
+#if (CONFIG_AUDIO_DATAPATH_ASRC)
+#define ASRC_FRAME_NUM_SAMPS (NUM_BLKS_IN_FRAME * BLK_MONO_NUM_SAMPS)
+/* Converted frames waiting to fill a block, and the output of one frame */
+#define ASRC_STAGE_NUM_SAMPS (BLK_MONO_NUM_SAMPS * (NUM_BLKS_IN_FRAME + 2))
+/* Ratio control loop. A presentation delay error of 1 us changes the ratio
+ * by 1 ppm, which corrects the error with a time constant of one second.
+ * The integral term removes the error caused by a constant drift, and has a
+ * time constant of four seconds for a critically damped loop.
+ */
+#define ASRC_PPM_PER_ERR_US 1
+#define ASRC_INTEGRAL_DIV (4000000 / CONFIG_AUDIO_FRAME_DURATION_US)
+#define ASRC_SUM_ERR_MAX (ASRC_PPM_MAX * ASRC_INTEGRAL_DIV)
+
+BUILD_ASSERT(ASRC_FRAME_NUM_SAMPS <= ASRC_IN_FRAMES_MAX, "Frame too long for the ASRC");
+#endif /* (CONFIG_AUDIO_DATAPATH_ASRC) */
+
 enum drift_comp_state {
 	DRIFT_STATE_INIT, /* Waiting for data to be received */
 	DRIFT_STATE_CALIB, /* Calibrate and zero out local delay */
@@ -148,6 +168,15 @@ static struct {
 		int32_t sum_err_dly_us;
 		uint32_t pres_delay_us;
 	} pres_comp;
+
+#if (CONFIG_AUDIO_DATAPATH_ASRC)
+	struct {
+		struct asrc_ctx ctx;
+		int16_t stage[ASRC_STAGE_NUM_SAMPS * 2];
+		uint32_t stage_num_samps; /* Converted stereo samples not yet in out.fifo */
+		int32_t sum_err_us;
+	} asrc;
+#endif /* (CONFIG_AUDIO_DATAPATH_ASRC) */
 } ctrl_blk;
 
 static bool tone_active;
@@ -185,12 +214,17 @@ static void drift_comp_state_set(enum drift_comp_state new_state)
 /**
  * @brief Adjust frequency of HFCLKAUDIO to get audio in sync
  *
- * @note The audio sync is based on sdu_ref_us
+ * @note The audio sync is based on sdu_ref_us. Not used with the ASRC, which
+ * converts the audio to the I2S clock instead.
  *
  * @param frame_start_ts I2S frame start timestamp
  */
 static void audio_datapath_drift_compensation(uint32_t frame_start_ts)
 {
+	if (IS_ENABLED(CONFIG_AUDIO_DATAPATH_ASRC)) {
+		return;
+	}
+
 	switch (ctrl_blk.drift_comp.state) {
 	case DRIFT_STATE_INIT: {
 		/* Check if audio data has been received */
@@ -300,6 +334,41 @@ static void pres_comp_state_set(enum pres_comp_state new_state)
 	ERR_CHK(ret);
 }
 
+#if (CONFIG_AUDIO_DATAPATH_ASRC)
+/**
+ * @brief Adjust the ASRC ratio to hold the presentation delay
+ *
+ * @param err_us Wanted minus current presentation delay
+ */
+static void asrc_ratio_adjust(int32_t err_us)
+{
+	int ret;
+	int32_t ppm;
+
+	ctrl_blk.asrc.sum_err_us =
+		CLAMP(ctrl_blk.asrc.sum_err_us + err_us, -ASRC_SUM_ERR_MAX, ASRC_SUM_ERR_MAX);
+
+	/* Too short delay needs more output per input, which is a lower ratio */
+	ppm = -(err_us * ASRC_PPM_PER_ERR_US + ctrl_blk.asrc.sum_err_us / ASRC_INTEGRAL_DIV);
+
+	ret = asrc_ratio_set(&ctrl_blk.asrc.ctx, CLAMP(ppm, -ASRC_PPM_MAX, ASRC_PPM_MAX));
+	ERR_CHK(ret);
+}
+
+/**
+ * @brief Return to the nominal ASRC ratio, and forget the accumulated error
+ */
+static void asrc_ratio_reset(void)
+{
+	int ret;
+
+	ctrl_blk.asrc.sum_err_us = 0;
+
+	ret = asrc_ratio_set(&ctrl_blk.asrc.ctx, 0);
+	ERR_CHK(ret);
+}
+#endif /* (CONFIG_AUDIO_DATAPATH_ASRC) */
+
 /**
  * @brief Move audio blocks back and forth in FIFO to get audio in sync
  *
@@ -313,7 +382,8 @@ static void pres_comp_state_set(enum pres_comp_state new_state)
 static void audio_datapath_presentation_compensation(uint32_t recv_frame_ts_us, uint32_t sdu_ref_us,
 						     bool sdu_ref_not_consecutive)
 {
-	if (ctrl_blk.drift_comp.state != DRIFT_STATE_LOCKED) {
+	if (!IS_ENABLED(CONFIG_AUDIO_DATAPATH_ASRC) &&
+	    ctrl_blk.drift_comp.state != DRIFT_STATE_LOCKED) {
 		/* Unconditionally reset state machine if drift compensation looses lock */
 		pres_comp_state_set(PRES_STATE_INIT);
 		return;
@@ -333,6 +403,10 @@ static void audio_datapath_presentation_compensation(uint32_t recv_frame_ts_us,
 	switch (ctrl_blk.pres_comp.state) {
 	case PRES_STATE_INIT: {
 		ctrl_blk.pres_comp.sum_err_dly_us = 0;
+#if (CONFIG_AUDIO_DATAPATH_ASRC)
+		/* Measure at the nominal ratio. The correction of the last lock no longer applies */
+		asrc_ratio_reset();
+#endif /* (CONFIG_AUDIO_DATAPATH_ASRC) */
 		pres_comp_state_set(PRES_STATE_MEAS);
 		break;
 	}
@@ -352,7 +426,9 @@ static void audio_datapath_presentation_compensation(uint32_t recv_frame_ts_us,
 		if ((pres_adj_us >= (BLK_PERIOD_US / 2)) || (pres_adj_us <= -(BLK_PERIOD_US / 2))) {
 			pres_comp_state_set(PRES_STATE_WAIT);
 		} else {
-			/* Drift compensation will always be in DRIFT_STATE_LOCKED here */
+			/* Drift compensation will always be in DRIFT_STATE_LOCKED here,
+			 * unless the ASRC is used, which bypasses drift compensation
+			 */
 			pres_comp_state_set(PRES_STATE_LOCKED);
 		}
 
@@ -372,6 +448,17 @@ static void audio_datapath_presentation_compensation(uint32_t recv_frame_ts_us,
 		 * and previous sdu_ref_us origins from non-consecutive frames, or into
 		 * PRES_STATE_INIT if drift compensation unlocks.
 		 */
+#if (CONFIG_AUDIO_DATAPATH_ASRC)
+		int32_t err_us = wanted_pres_dly_us - ctrl_blk.current_pres_dly_us;
+
+		/* The ratio only makes small corrections. Start over to move blocks */
+		if ((err_us >= BLK_PERIOD_US) || (err_us <= -BLK_PERIOD_US)) {
+			pres_comp_state_set(PRES_STATE_INIT);
+			break;
+		}
+
+		asrc_ratio_adjust(err_us);
+#endif /* (CONFIG_AUDIO_DATAPATH_ASRC) */
 
 		break;
 	}
@@ -760,6 +847,68 @@ void audio_datapath_sdu_ref_update(uint32_t sdu_ref_us)
 	}
 }
 
+#if (CONFIG_AUDIO_DATAPATH_ASRC)
+/**
+ * @brief Convert a decoded frame to the I2S clock, and add it to out.fifo
+ *
+ * @note The number of blocks per frame varies with the ratio. The samples
+ * that do not fill a block are kept for the next frame.
+ *
+ * @param recv_frame_ts_us Timestamp of when frame was received
+ */
+static void audio_datapath_asrc_stream_out(uint32_t recv_frame_ts_us)
+{
+	int ret;
+	size_t num_samps;
+
+	ret = asrc_process(&ctrl_blk.asrc.ctx, (int16_t *)ctrl_blk.decoded_data,
+			   ASRC_FRAME_NUM_SAMPS,
+			   &ctrl_blk.asrc.stage[ctrl_blk.asrc.stage_num_samps * 2],
+			   ASRC_STAGE_NUM_SAMPS - ctrl_blk.asrc.stage_num_samps, &num_samps);
+	if (ret) {
+		LOG_WRN("ASRC error: %d", ret);
+	}
+
+	ctrl_blk.asrc.stage_num_samps += num_samps;
+
+	uint32_t num_blks = ctrl_blk.asrc.stage_num_samps / BLK_MONO_NUM_SAMPS;
+	int32_t num_blks_in_fifo = ctrl_blk.out.prod_blk_idx - ctrl_blk.out.cons_blk_idx;
+
+	if ((num_blks_in_fifo + (int32_t)num_blks) > FIFO_NUM_BLKS) {
+		LOG_WRN("Output audio stream overrun - Discarding audio frame");
+
+		/* Discard frame to allow consumer to catch up */
+		ctrl_blk.asrc.stage_num_samps = 0;
+		return;
+	}
+
+	int64_t step = asrc_step_get(&ctrl_blk.asrc.ctx);
+	/* Input position of the first staged sample, relative to the frame start (Q32) */
+	int64_t pos = ((int64_t)ASRC_FRAME_NUM_SAMPS << 32) +
+		      asrc_next_pos_get(&ctrl_blk.asrc.ctx) - ctrl_blk.asrc.stage_num_samps * step;
+	uint32_t out_blk_idx = ctrl_blk.out.prod_blk_idx;
+
+	for (uint32_t i = 0; i < num_blks; i++) {
+		memcpy(&ctrl_blk.out.fifo[out_blk_idx * BLK_STEREO_NUM_SAMPS],
+		       &ctrl_blk.asrc.stage[i * BLK_STEREO_NUM_SAMPS], BLK_STEREO_SIZE_OCTETS);
+
+		/* Record producer block start reference, with sub-sample precision */
+		ctrl_blk.out.prod_blk_ts[out_blk_idx] =
+			recv_frame_ts_us +
+			(int32_t)((pos * 1000000 / CONFIG_AUDIO_SAMPLE_RATE_HZ) >> 32);
+
+		pos += BLK_MONO_NUM_SAMPS * step;
+		out_blk_idx = NEXT_IDX(out_blk_idx);
+	}
+
+	ctrl_blk.out.prod_blk_idx = out_blk_idx;
+	ctrl_blk.asrc.stage_num_samps -= num_blks * BLK_MONO_NUM_SAMPS;
+
+	memmove(ctrl_blk.asrc.stage, &ctrl_blk.asrc.stage[num_blks * BLK_STEREO_NUM_SAMPS],
+		ctrl_blk.asrc.stage_num_samps * 2 * sizeof(ctrl_blk.asrc.stage[0]));
+}
+#endif /* (CONFIG_AUDIO_DATAPATH_ASRC) */
+
 void audio_datapath_stream_out(const uint8_t *buf, size_t size, uint32_t sdu_ref_us, bool bad_frame,
 			       uint32_t recv_frame_ts_us)
 {
@@ -836,6 +985,9 @@ void audio_datapath_stream_out(const uint8_t *buf, size_t size, uint32_t sdu_ref
 
 	/*** Add audio data to FIFO buffer ***/
 
+#if (CONFIG_AUDIO_DATAPATH_ASRC)
+	audio_datapath_asrc_stream_out(recv_frame_ts_us);
+#else
 	int32_t num_blks_in_fifo = ctrl_blk.out.prod_blk_idx - ctrl_blk.out.cons_blk_idx;
 
 	if ((num_blks_in_fifo + NUM_BLKS_IN_FRAME) > FIFO_NUM_BLKS) {
@@ -859,6 +1011,15 @@ void audio_datapath_stream_out(const uint8_t *buf, size_t size, uint32_t sdu_ref
 	}
 
 	ctrl_blk.out.prod_blk_idx = out_blk_idx;
+#endif /* (CONFIG_AUDIO_DATAPATH_ASRC) */
+}
+
+void audio_datapath_stats_get(struct audio_datapath_stats *stats, bool reset)
+{
+	__ASSERT_NO_MSG(stats != NULL);
+
+	stats->blk_underruns = ctrl_blk.out.total_blk_underruns;
+	sw_codec_stats_get(&stats->codec, reset);
 }
 
 int audio_datapath_start(struct data_fifo *fifo_rx)
@@ -876,6 +1037,15 @@ int audio_datapath_start(struct data_fifo *fifo_rx)
 		/* Clear counters and mute initial audio */
 		memset(&ctrl_blk.out, 0, sizeof(ctrl_blk.out));
 
+#if (CONFIG_AUDIO_DATAPATH_ASRC)
+		int ret;
+
+		ret = asrc_init(&ctrl_blk.asrc.ctx, 2);
+		ERR_CHK(ret);
+		ctrl_blk.asrc.stage_num_samps = 0;
+		ctrl_blk.asrc.sum_err_us = 0;
+#endif /* (CONFIG_AUDIO_DATAPATH_ASRC) */
+
 		audio_datapath_i2s_start();
 		ctrl_blk.stream_started = true;
 
@@ -1001,6 +1171,61 @@ static int cmd_hfclkaudio_drift_comp_disable(const struct shell *shell, size_t a
 	return 0;
 }
 
+static void stage_time_print(const struct shell *shell, const char *name,
+			     const struct sw_codec_stage_time *time)
+{
+	if (time->count == 0) {
+		return;
+	}
+
+	shell_print(shell, "%-12s %8u %8u %8u %10u", name, time->last_us,
+		    time->total_us / time->count, time->max_us, time->count);
+}
+
+static int cmd_codec_stats(const struct shell *shell, size_t argc, const char **argv)
+{
+	static const char *const stage_names[SW_CODEC_STAGE_NUM] = {
+		[SW_CODEC_STAGE_ENC_L] = "enc_l",
+		[SW_CODEC_STAGE_ENC_R] = "enc_r",
+		[SW_CODEC_STAGE_DEC_L] = "dec_l",
+		[SW_CODEC_STAGE_DEC_R] = "dec_r",
+		[SW_CODEC_STAGE_DEC_INTERLEAVE] = "dec_intlv",
+	};
+	struct audio_datapath_stats stats;
+	bool reset = false;
+
+	if (argc > 1) {
+		if (strcmp(argv[1], "reset") != 0) {
+			shell_error(shell, "Only argument allowed is reset");
+			return -EINVAL;
+		}
+
+		reset = true;
+	}
+
+	if (!IS_ENABLED(CONFIG_SW_CODEC_TIMING_STATS)) {
+		shell_warn(shell, "Enable CONFIG_SW_CODEC_TIMING_STATS for codec timing");
+	}
+
+	audio_datapath_stats_get(&stats, reset);
+
+	shell_print(shell, "%-12s %8s %8s %8s %10s", "Stage [us]", "Last", "Avg", "Max", "Count");
+
+	for (size_t i = 0; i < SW_CODEC_STAGE_NUM; i++) {
+		stage_time_print(shell, stage_names[i], &stats.codec.stage[i]);
+	}
+
+	stage_time_print(shell, "enc_frame", &stats.codec.enc_frame);
+	stage_time_print(shell, "dec_frame", &stats.codec.dec_frame);
+
+	shell_print(shell, "Frames over budget: encode %u (%d us), decode %u (%d us)",
+		    stats.codec.enc_deadline_misses, ENC_TIME_US,
+		    stats.codec.dec_deadline_misses, DEC_TIME_US);
+	shell_print(shell, "I2S TX underruns: %u", stats.blk_underruns);
+
+	return 0;
+}
+
 SHELL_STATIC_SUBCMD_SET_CREATE(test_cmd,
 			       SHELL_COND_CMD(CONFIG_SHELL, nrf_tone_start, NULL,
 					      "Start local tone from nRF5340.", cmd_i2s_tone_play),
@@ -1012,6 +1237,9 @@ SHELL_STATIC_SUBCMD_SET_CREATE(test_cmd,
 			       SHELL_COND_CMD(CONFIG_SHELL, pll_comp_disable, NULL,
 					      "Disable audio PLL auto drift compensation",
 					      cmd_hfclkaudio_drift_comp_disable),
+			       SHELL_COND_CMD(CONFIG_SHELL, codec_stats, NULL,
+					      "Print codec stage timing. Add reset to clear it.",
+					      cmd_codec_stats),
 			       SHELL_SUBCMD_SET_END);
 
 SHELL_CMD_REGISTER(test, &test_cmd, "Test mode commands", NULL);
@@ -21,6 +21,11 @@
 #define DEFAULT_PRES_DLY_US 10000
 #define MIN_PRES_DLY_US (DEC_TIME_US + PRES_DLY_BUFFER_US)
 
+struct audio_datapath_stats {
+	uint32_t blk_underruns; /* I2S TX blocks with no data since stream start */
+	struct sw_codec_stats codec; /* Time per codec stage and frame */
+};
+
 /**
  * @brief Mixes a tone into the I2S TX stream
  *
@@ -91,6 +96,16 @@ void audio_datapath_sdu_ref_update(uint32_t sdu_ref_us);
 void audio_datapath_stream_out(const uint8_t *buf, size_t size, uint32_t sdu_ref_us, bool bad_frame,
 			       uint32_t recv_frame_ts_us);
 
+/**
+ * @brief Get the audio datapath statistics
+ *
+ * @note The codec statistics require CONFIG_SW_CODEC_TIMING_STATS
+ *
+ * @param stats Pointer to store the statistics
+ * @param reset Clear the codec statistics after reading them
+ */
+void audio_datapath_stats_get(struct audio_datapath_stats *stats, bool reset);
+
 /**
  * @brief Start the audio datapath module
  *
@@ -8,6 +8,7 @@
 
 #include <zephyr/kernel.h>
 #include <errno.h>
+#include <string.h>
 
 #include "channel_assignment.h"
 #include "pcm_stream_channel_modifier.h"
@@ -20,14 +21,110 @@ LOG_MODULE_REGISTER(sw_codec_select, CONFIG_SW_CODEC_SELECT_LOG_LEVEL);
 
 static struct sw_codec_config m_config;
 
+static struct sw_codec_stats stats;
+static struct k_spinlock stats_lock;
+
+static void stage_time_add(struct sw_codec_stage_time *time, uint32_t us)
+{
+	time->last_us = us;
+	time->max_us = MAX(time->max_us, us);
+	time->total_us += us;
+	time->count++;
+}
+
+static uint32_t timing_start(void)
+{
+	return IS_ENABLED(CONFIG_SW_CODEC_TIMING_STATS) ? k_cycle_get_32() : 0;
+}
+
+/* Record the time since start_cyc for a stage, and restart the timing there
+ * so consecutive stages can be timed without reading the cycle counter twice
+ */
+static void stage_time_end(enum sw_codec_stage stage, uint32_t *start_cyc)
+{
+	k_spinlock_key_t key;
+	uint32_t now;
+
+	if (!IS_ENABLED(CONFIG_SW_CODEC_TIMING_STATS)) {
+		return;
+	}
+
+	now = k_cycle_get_32();
+
+	key = k_spin_lock(&stats_lock);
+	stage_time_add(&stats.stage[stage], k_cyc_to_us_floor32(now - *start_cyc));
+	k_spin_unlock(&stats_lock, key);
+
+	*start_cyc = now;
+}
+
+/* Record the time for all stages of a frame and check it against the time
+ * reserved for the codec in the ISO timing
+ */
+static void frame_time_end(bool encode, uint32_t start_cyc)
+{
+	k_spinlock_key_t key;
+	uint32_t us;
+
+	if (!IS_ENABLED(CONFIG_SW_CODEC_TIMING_STATS)) {
+		return;
+	}
+
+	us = k_cyc_to_us_floor32(k_cycle_get_32() - start_cyc);
+
+	key = k_spin_lock(&stats_lock);
+	if (encode) {
+		stage_time_add(&stats.enc_frame, us);
+		if (us > ENC_TIME_US) {
+			stats.enc_deadline_misses++;
+		}
+	} else {
+		stage_time_add(&stats.dec_frame, us);
+		if (us > DEC_TIME_US) {
+			stats.dec_deadline_misses++;
+		}
+	}
+	k_spin_unlock(&stats_lock, key);
+}
+
+#if (CONFIG_SW_CODEC_LC3)
+/* LC3 reads and writes one channel at a time, from and to contiguous buffers.
+ * The channels are moved between these and the interleaved stream with a
+ * strided copy, so only the channels that are coded are copied. The encoder
+ * splits and encodes one channel at a time, so one buffer serves both
+ * channels. Encoding and decoding can run in different threads, so they have
+ * separate buffers. The buffers are always completely written before they
+ * are read, so they are never cleared.
+ */
+static char pcm_enc_mono[PCM_NUM_BYTES_MONO];
+static char pcm_dec_mono[AUDIO_CH_NUM][PCM_NUM_BYTES_MONO];
+static char pcm_dec_stereo[PCM_NUM_BYTES_STEREO];
+
+/* Encode channel pcm_ch of the stream with LC3 encoder channel lc3_ch */
+static int lc3_channel_encode(void const *const pcm_data, size_t pcm_size,
+			      enum audio_channel pcm_ch, uint8_t lc3_ch, uint8_t *encoded_data,
+			      size_t encoded_size, uint16_t *encoded_bytes_written)
+{
+	size_t pcm_block_size_mono;
+	int ret;
+
+	ret = pscm_one_channel_split(pcm_data, pcm_size, pcm_ch, CONFIG_AUDIO_BIT_DEPTH_BITS,
+				     pcm_enc_mono, &pcm_block_size_mono);
+	if (ret) {
+		return ret;
+	}
+
+	return sw_codec_lc3_enc_run(pcm_enc_mono, pcm_block_size_mono,
+				    LC3_USE_BITRATE_FROM_INIT, lc3_ch, encoded_size, encoded_data,
+				    encoded_bytes_written);
+}
+#endif /* (CONFIG_SW_CODEC_LC3) */
+
 int sw_codec_encode(void *pcm_data, size_t pcm_size, uint8_t **encoded_data, size_t *encoded_size)
 {
-	/* Temp storage for split stereo PCM signal */
-	char pcm_data_mono[AUDIO_CH_NUM][PCM_NUM_BYTES_MONO] = { 0 };
 	/* Make sure we have enough space for two frames (stereo) */
 	static uint8_t m_encoded_data[ENC_MAX_FRAME_SIZE * AUDIO_CH_NUM];
 
-	size_t pcm_block_size_mono;
 	int ret;
 
 	if (!m_config.encoder.enabled) {
@@ -38,47 +135,45 @@ int sw_codec_encode(void *pcm_data, size_t pcm_size, uint8_t **encoded_data, siz
 	switch (m_config.sw_codec) {
 	case SW_CODEC_LC3: {
 #if (CONFIG_SW_CODEC_LC3)
+		uint32_t frame_start = timing_start();
+		uint32_t stage_start = frame_start;
 		uint16_t encoded_bytes_written;
+		uint16_t encoded_bytes_written_r;
 
-		/* Since LC3 is a single channel codec, we must split the
-		 * stereo PCM stream
+		/* Since LC3 is a single channel codec, each channel is split
+		 * from the stereo PCM stream right before it is encoded
 		 */
-		ret = pscm_two_channel_split(pcm_data, pcm_size, CONFIG_AUDIO_BIT_DEPTH_BITS,
-					     pcm_data_mono[AUDIO_CH_L], pcm_data_mono[AUDIO_CH_R],
-					     &pcm_block_size_mono);
-		if (ret) {
-			return ret;
-		}
-
 		switch (m_config.encoder.channel_mode) {
 		case SW_CODEC_MONO: {
-			ret = sw_codec_lc3_enc_run(pcm_data_mono[m_config.encoder.audio_ch],
-						   pcm_block_size_mono, LC3_USE_BITRATE_FROM_INIT,
-						   0, sizeof(m_encoded_data), m_encoded_data,
-						   &encoded_bytes_written);
+			/* The mono encoder is initialized as LC3 channel 0 */
+			ret = lc3_channel_encode(pcm_data, pcm_size, m_config.encoder.audio_ch, 0,
+						 m_encoded_data, sizeof(m_encoded_data),
+						 &encoded_bytes_written);
 			if (ret) {
 				return ret;
 			}
+			stage_time_end(SW_CODEC_STAGE_ENC_L + m_config.encoder.audio_ch,
+				       &stage_start);
 			break;
 		}
 		case SW_CODEC_STEREO: {
-			ret = sw_codec_lc3_enc_run(pcm_data_mono[AUDIO_CH_L], pcm_block_size_mono,
-						   LC3_USE_BITRATE_FROM_INIT, AUDIO_CH_L,
-						   sizeof(m_encoded_data), m_encoded_data,
-						   &encoded_bytes_written);
+			ret = lc3_channel_encode(pcm_data, pcm_size, AUDIO_CH_L, AUDIO_CH_L,
+						 m_encoded_data, sizeof(m_encoded_data),
+						 &encoded_bytes_written);
 			if (ret) {
 				return ret;
 			}
+			stage_time_end(SW_CODEC_STAGE_ENC_L, &stage_start);
 
-			ret = sw_codec_lc3_enc_run(pcm_data_mono[AUDIO_CH_R], pcm_block_size_mono,
-						   LC3_USE_BITRATE_FROM_INIT, AUDIO_CH_R,
-						   sizeof(m_encoded_data) - encoded_bytes_written,
-						   m_encoded_data + encoded_bytes_written,
-						   &encoded_bytes_written);
+			ret = lc3_channel_encode(pcm_data, pcm_size, AUDIO_CH_R, AUDIO_CH_R,
+						 m_encoded_data + encoded_bytes_written,
+						 sizeof(m_encoded_data) - encoded_bytes_written,
+						 &encoded_bytes_written_r);
 			if (ret) {
 				return ret;
 			}
-			encoded_bytes_written += encoded_bytes_written;
+			stage_time_end(SW_CODEC_STAGE_ENC_R, &stage_start);
+			encoded_bytes_written += encoded_bytes_written_r;
 			break;
 		}
 		default:
@@ -89,6 +184,7 @@ int sw_codec_encode(void *pcm_data, size_t pcm_size, uint8_t **encoded_data, siz
 		*encoded_data = m_encoded_data;
 		*encoded_size = encoded_bytes_written;
 
+		frame_time_end(true, frame_start);
 #endif /* (CONFIG_SW_CODEC_LC3) */
 		break;
 	}
@@ -109,85 +205,91 @@ int sw_codec_decode(uint8_t const *const encoded_data, size_t encoded_size, bool
 	}
 
 	int ret;
-	char pcm_data_mono[PCM_NUM_BYTES_MONO] = { 0 };
-	static char pcm_data_stereo[PCM_NUM_BYTES_STEREO];
-
 	size_t pcm_size_stereo = 0;
 	size_t pcm_size_session = 0;
 
 	switch (m_config.sw_codec) {
 	case SW_CODEC_LC3: {
 #if (CONFIG_SW_CODEC_LC3)
-		/* Typically used for right channel if stereo signal */
-		char pcm_data_mono_right[PCM_NUM_BYTES_MONO] = { 0 };
-
-		switch (m_config.decoder.channel_mode) {
-		case SW_CODEC_MONO: {
-			if (bad_frame && IS_ENABLED(CONFIG_SW_CODEC_OVERRIDE_PLC)) {
-				memset(pcm_data_mono, 0, PCM_NUM_BYTES_MONO);
-				pcm_size_session = PCM_NUM_BYTES_MONO;
-			} else {
+		uint32_t frame_start = timing_start();
+		uint32_t stage_start = frame_start;
+
+		if (bad_frame && IS_ENABLED(CONFIG_SW_CODEC_OVERRIDE_PLC)) {
+			/* Silence goes straight into the stereo output */
+			memset(pcm_dec_stereo, 0, PCM_NUM_BYTES_STEREO);
+			pcm_size_stereo = PCM_NUM_BYTES_STEREO;
+		} else {
+			switch (m_config.decoder.channel_mode) {
+			case SW_CODEC_MONO: {
 				ret = sw_codec_lc3_dec_run(encoded_data, encoded_size,
-							   LC3_PCM_NUM_BYTES_MONO, 0, pcm_data_mono,
+							   LC3_PCM_NUM_BYTES_MONO, 0,
+							   pcm_dec_mono[AUDIO_CH_L],
 							   (uint16_t *)&pcm_size_session,
 							   bad_frame);
 				if (ret) {
 					return ret;
 				}
+				stage_time_end(SW_CODEC_STAGE_DEC_L + m_config.decoder.audio_ch,
+					       &stage_start);
+
+				/* For now, i2s is only stereo, so in order to send
+				 * just one channel, we need to insert 0 for the
+				 * other channel
+				 */
+				ret = pscm_zero_pad(pcm_dec_mono[AUDIO_CH_L], pcm_size_session,
+						    m_config.decoder.audio_ch,
+						    CONFIG_AUDIO_BIT_DEPTH_BITS, pcm_dec_stereo,
+						    &pcm_size_stereo);
+				if (ret) {
+					return ret;
+				}
+				stage_time_end(SW_CODEC_STAGE_DEC_INTERLEAVE, &stage_start);
+				break;
 			}
-
-			/* For now, i2s is only stereo, so in order to send
-			 * just one channel, we need to insert 0 for the
-			 * other channel
-			 */
-			ret = pscm_zero_pad(pcm_data_mono, pcm_size_session,
-					    m_config.decoder.audio_ch, CONFIG_AUDIO_BIT_DEPTH_BITS,
-					    pcm_data_stereo, &pcm_size_stereo);
-			if (ret) {
-				return ret;
-			}
-			break;
-		}
-		case SW_CODEC_STEREO: {
-			if (bad_frame && IS_ENABLED(CONFIG_SW_CODEC_OVERRIDE_PLC)) {
-				memset(pcm_data_mono, 0, PCM_NUM_BYTES_MONO);
-				memset(pcm_data_mono_right, 0, PCM_NUM_BYTES_MONO);
-				pcm_size_session = PCM_NUM_BYTES_MONO;
-			} else {
+			case SW_CODEC_STEREO: {
 				/* Decode left channel */
 				ret = sw_codec_lc3_dec_run(encoded_data, encoded_size / 2,
 							   LC3_PCM_NUM_BYTES_MONO, AUDIO_CH_L,
-							   pcm_data_mono,
+							   pcm_dec_mono[AUDIO_CH_L],
 							   (uint16_t *)&pcm_size_session,
 							   bad_frame);
 				if (ret) {
 					return ret;
 				}
+				stage_time_end(SW_CODEC_STAGE_DEC_L, &stage_start);
+
 				/* Decode right channel */
 				ret = sw_codec_lc3_dec_run((encoded_data + (encoded_size / 2)),
 							   encoded_size / 2, LC3_PCM_NUM_BYTES_MONO,
-							   AUDIO_CH_R, pcm_data_mono_right,
+							   AUDIO_CH_R, pcm_dec_mono[AUDIO_CH_R],
 							   (uint16_t *)&pcm_size_session,
 							   bad_frame);
 				if (ret) {
 					return ret;
 				}
+				stage_time_end(SW_CODEC_STAGE_DEC_R, &stage_start);
+
+				ret = pscm_combine(pcm_dec_mono[AUDIO_CH_L],
+						   pcm_dec_mono[AUDIO_CH_R], pcm_size_session,
+						   CONFIG_AUDIO_BIT_DEPTH_BITS, pcm_dec_stereo,
+						   &pcm_size_stereo);
+				if (ret) {
+					return ret;
+				}
+				stage_time_end(SW_CODEC_STAGE_DEC_INTERLEAVE, &stage_start);
+				break;
 			}
-			ret = pscm_combine(pcm_data_mono, pcm_data_mono_right, pcm_size_session,
-					   CONFIG_AUDIO_BIT_DEPTH_BITS, pcm_data_stereo,
-					   &pcm_size_stereo);
-			if (ret) {
-				return ret;
+			default:
+				LOG_ERR("Unsupported channel mode: %d",
+					m_config.decoder.channel_mode);
+				return -ENODEV;
 			}
-			break;
-		}
-		default:
-			LOG_ERR("Unsupported channel mode: %d", m_config.encoder.channel_mode);
-			return -ENODEV;
 		}
 
 		*decoded_size = pcm_size_stereo;
-		*decoded_data = pcm_data_stereo;
+		*decoded_data = pcm_dec_stereo;
+
+		frame_time_end(false, frame_start);
 #endif /* (CONFIG_SW_CODEC_LC3) */
 		break;
 	}
@@ -198,6 +300,18 @@ int sw_codec_decode(uint8_t const *const encoded_data, size_t encoded_size, bool
 	return 0;
 }
 
+void sw_codec_stats_get(struct sw_codec_stats *stats_out, bool reset)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	*stats_out = stats;
+	if (reset) {
+		memset(&stats, 0, sizeof(stats));
+	}
+
+	k_spin_unlock(&stats_lock, key);
+}
+
 int sw_codec_uninit(struct sw_codec_config sw_codec_cfg)
 {
 	int ret;
@@ -65,6 +65,41 @@ struct sw_codec_config {
 	bool initialized; /* Status of codec */
 };
 
+/* Stages of the SW codec that are timed with CONFIG_SW_CODEC_TIMING_STATS */
+enum sw_codec_stage {
+	SW_CODEC_STAGE_ENC_L, /* Split and encode left channel */
+	SW_CODEC_STAGE_ENC_R, /* Split and encode right channel */
+	SW_CODEC_STAGE_DEC_L, /* Decode left channel */
+	SW_CODEC_STAGE_DEC_R, /* Decode right channel */
+	SW_CODEC_STAGE_DEC_INTERLEAVE, /* Write decoded channel(s) to stereo output */
+	SW_CODEC_STAGE_NUM,
+};
+
+struct sw_codec_stage_time {
+	uint32_t last_us;
+	uint32_t max_us;
+	uint32_t total_us;
+	uint32_t count;
+};
+
+struct sw_codec_stats {
+	struct sw_codec_stage_time stage[SW_CODEC_STAGE_NUM];
+	struct sw_codec_stage_time enc_frame; /* All encode stages of a frame */
+	struct sw_codec_stage_time dec_frame; /* All decode stages of a frame */
+	uint32_t enc_deadline_misses; /* Frames that took longer than ENC_TIME_US */
+	uint32_t dec_deadline_misses; /* Frames that took longer than DEC_TIME_US */
+};
+
+/**@brief	Get the SW codec timing statistics
+ *
+ * @note	Requires CONFIG_SW_CODEC_TIMING_STATS, the statistics are all zero
+ *		otherwise
+ *
+ * @param[out]	stats		Pointer to store the statistics
+ * @param[in]	reset		Clear the statistics after reading them
+ */
+void sw_codec_stats_get(struct sw_codec_stats *stats, bool reset);
+
 /**@brief	Encode PCM data and output encoded data
  *
  * @note	Takes in stereo PCM stream, will encode either one or two
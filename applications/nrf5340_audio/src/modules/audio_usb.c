@@ -7,21 +7,60 @@
 #include "audio_usb.h"
 
 #include <zephyr/kernel.h>
+#include <stdlib.h>
 #include <zephyr/usb/usb_device.h>
 #include <zephyr/usb/class/usb_audio.h>
 
 #include "macros_common.h"
 #include "data_fifo.h"
 
+#if (CONFIG_AUDIO_DATAPATH_ASRC)
+#include "asrc.h"
+#include "audio_sync_timer.h"
+#endif /* (CONFIG_AUDIO_DATAPATH_ASRC) */
+
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(audio_usb, CONFIG_MODULE_AUDIO_USB_LOG_LEVEL);
 
 #define USB_FRAME_SIZE_STEREO                                                                      \
 	(((CONFIG_AUDIO_SAMPLE_RATE_HZ * CONFIG_AUDIO_BIT_DEPTH_OCTETS) / 1000) * 2)
 
+#define USB_FRAME_DURATION_US 1000
+#define USB_FRAME_NUM_SAMPS (CONFIG_AUDIO_SAMPLE_RATE_HZ / 1000)
+
 static struct data_fifo *fifo_tx;
 static struct data_fifo *fifo_rx;
 
+#if (CONFIG_AUDIO_DATAPATH_ASRC)
+/* Holds the converted samples until there is a full USB frame */
+#define ASRC_STAGE_NUM_SAMPS (USB_FRAME_NUM_SAMPS * 3)
+
+/* The USB frames arrive at the rate of the host clock. The ratio is set by
+ * a PI loop on the time of the converted samples relative to the audio sync
+ * timer, which runs on the same crystal as the Bluetooth controller. One
+ * microsecond of error gives one ppm of correction, and the integral
+ * term has a time constant of 4 seconds.
+ */
+#define ASRC_PPM_PER_ERR_US 1
+#define ASRC_INTEGRAL_DIV (4000000 / USB_FRAME_DURATION_US)
+#define ASRC_SUM_ERR_MAX (ASRC_PPM_MAX * ASRC_INTEGRAL_DIV)
+/* Restart the loop if frames are lost or the timer is cleared */
+#define ASRC_ERR_US_MAX (5 * USB_FRAME_DURATION_US)
+
+BUILD_ASSERT(USB_FRAME_NUM_SAMPS <= ASRC_IN_FRAMES_MAX, "USB frame too long for the ASRC");
+
+static struct {
+	struct asrc_ctx ctx;
+	int16_t stage[ASRC_STAGE_NUM_SAMPS * 2];
+	uint32_t stage_num_samps;
+	bool locked;
+	uint32_t prev_frame_ts_us;
+	int64_t elapsed_us;
+	uint64_t out_num_samps;
+	int32_t sum_err_us;
+} asrc;
+#endif /* (CONFIG_AUDIO_DATAPATH_ASRC) */
+
 NET_BUF_POOL_FIXED_DEFINE(pool_out, CONFIG_FIFO_FRAME_SPLIT_NUM, USB_FRAME_SIZE_STEREO, 8,
 			  net_buf_destroy);
 
@@ -63,29 +102,11 @@ static void data_write(const struct device *dev)
 }
 #endif /* (CONFIG_STREAM_BIDIRECTIONAL) */
 
-static void data_received(const struct device *dev, struct net_buf *buffer, size_t size)
+static void fifo_rx_block_write(void const *const data, size_t size)
 {
 	int ret;
 	void *data_in;
 
-	if (fifo_rx == NULL) {
-		/* Throwing away data */
-		net_buf_unref(buffer);
-		return;
-	}
-
-	if (!buffer || !size) {
-		/* This should never happen */
-		ERR_CHK(-EINVAL);
-	}
-
-	/* Receive data from USB */
-	if (size != USB_FRAME_SIZE_STEREO) {
-		LOG_WRN("Wrong length: %d", size);
-		net_buf_unref(buffer);
-		return;
-	}
-
 	ret = data_fifo_pointer_first_vacant_get(fifo_rx, &data_in, K_NO_WAIT);
 
 	/* RX FIFO can fill up due to retransmissions or disconnect */
@@ -105,10 +126,134 @@ static void data_received(const struct device *dev, struct net_buf *buffer, size
 
 	ERR_CHK_MSG(ret, "RX failed to get block");
 
-	memcpy(data_in, buffer->data, size);
+	memcpy(data_in, data, size);
 
 	ret = data_fifo_block_lock(fifo_rx, &data_in, size);
 	ERR_CHK_MSG(ret, "Failed to lock block");
+}
+
+#if (CONFIG_AUDIO_DATAPATH_ASRC)
+/**
+ * @brief Start the ratio loop over at the nominal ratio
+ */
+static void asrc_unlock(void)
+{
+	int ret;
+
+	asrc.locked = false;
+	asrc.sum_err_us = 0;
+
+	ret = asrc_ratio_set(&asrc.ctx, 0);
+	ERR_CHK(ret);
+}
+
+/**
+ * @brief Adjust the ASRC ratio to the time of arrival of a USB frame
+ *
+ * @param frame_ts_us	Arrival time of the frame
+ * @param out_num_samps	Number of samples converted from the frame
+ */
+static void asrc_ratio_adjust(uint32_t frame_ts_us, uint32_t out_num_samps)
+{
+	int ret;
+	int32_t err_us;
+	int32_t ppm;
+	uint32_t frame_interval_us = frame_ts_us - asrc.prev_frame_ts_us;
+
+	asrc.prev_frame_ts_us = frame_ts_us;
+
+	if (!asrc.locked) {
+		/* The time is counted from the end of this frame */
+		asrc.elapsed_us = 0;
+		asrc.out_num_samps = 0;
+		asrc.locked = true;
+		return;
+	}
+
+	asrc.elapsed_us += frame_interval_us;
+	asrc.out_num_samps += out_num_samps;
+
+	/* Positive if more samples were converted than the local clock consumed */
+	err_us = ((int64_t)asrc.out_num_samps * USEC_PER_SEC -
+		  asrc.elapsed_us * CONFIG_AUDIO_SAMPLE_RATE_HZ) /
+		 CONFIG_AUDIO_SAMPLE_RATE_HZ;
+
+	if ((frame_interval_us > ASRC_ERR_US_MAX) || (abs(err_us) > ASRC_ERR_US_MAX)) {
+		LOG_WRN("USB frame timing lost, interval: %d us, error: %d us", frame_interval_us,
+			err_us);
+		asrc_unlock();
+		return;
+	}
+
+	asrc.sum_err_us =
+		CLAMP(asrc.sum_err_us + err_us, -ASRC_SUM_ERR_MAX, ASRC_SUM_ERR_MAX);
+
+	ppm = err_us * ASRC_PPM_PER_ERR_US + asrc.sum_err_us / ASRC_INTEGRAL_DIV;
+
+	ret = asrc_ratio_set(&asrc.ctx, CLAMP(ppm, -ASRC_PPM_MAX, ASRC_PPM_MAX));
+	ERR_CHK(ret);
+}
+
+/**
+ * @brief Convert a USB frame to the local clock, and write the converted
+ *	  samples to the RX FIFO in blocks of one USB frame
+ *
+ * @param data	USB frame
+ */
+static void asrc_stream_in(void const *const data)
+{
+	int ret;
+	size_t num_samps;
+	uint32_t frame_ts_us = audio_sync_timer_curr_time_get();
+
+	ret = asrc_process(&asrc.ctx, (int16_t const *)data, USB_FRAME_NUM_SAMPS,
+			   &asrc.stage[asrc.stage_num_samps * 2],
+			   ASRC_STAGE_NUM_SAMPS - asrc.stage_num_samps, &num_samps);
+	if (ret) {
+		LOG_WRN("ASRC error: %d", ret);
+	}
+
+	asrc.stage_num_samps += num_samps;
+
+	asrc_ratio_adjust(frame_ts_us, num_samps);
+
+	uint32_t num_blks = asrc.stage_num_samps / USB_FRAME_NUM_SAMPS;
+
+	for (uint32_t i = 0; i < num_blks; i++) {
+		fifo_rx_block_write(&asrc.stage[i * USB_FRAME_NUM_SAMPS * 2], USB_FRAME_SIZE_STEREO);
+	}
+
+	asrc.stage_num_samps -= num_blks * USB_FRAME_NUM_SAMPS;
+	memmove(asrc.stage, &asrc.stage[num_blks * USB_FRAME_NUM_SAMPS * 2],
+		asrc.stage_num_samps * 2 * sizeof(asrc.stage[0]));
+}
+#endif /* (CONFIG_AUDIO_DATAPATH_ASRC) */
+
+static void data_received(const struct device *dev, struct net_buf *buffer, size_t size)
+{
+	if (fifo_rx == NULL) {
+		/* Throwing away data */
+		net_buf_unref(buffer);
+		return;
+	}
+
+	if (!buffer || !size) {
+		/* This should never happen */
+		ERR_CHK(-EINVAL);
+	}
+
+	/* Receive data from USB */
+	if (size != USB_FRAME_SIZE_STEREO) {
+		LOG_WRN("Wrong length: %d", size);
+		net_buf_unref(buffer);
+		return;
+	}
+
+#if (CONFIG_AUDIO_DATAPATH_ASRC)
+	asrc_stream_in(buffer->data);
+#else
+	fifo_rx_block_write(buffer->data, size);
+#endif /* (CONFIG_AUDIO_DATAPATH_ASRC) */
 
 	net_buf_unref(buffer);
 }
@@ -138,6 +283,18 @@ int audio_usb_start(struct data_fifo *fifo_tx_in, struct data_fifo *fifo_rx_in)
 		return -EINVAL;
 	}
 
+#if (CONFIG_AUDIO_DATAPATH_ASRC)
+	int ret;
+
+	ret = asrc_init(&asrc.ctx, 2);
+	if (ret) {
+		return ret;
+	}
+
+	asrc.stage_num_samps = 0;
+	asrc_unlock();
+#endif /* (CONFIG_AUDIO_DATAPATH_ASRC) */
+
 	fifo_tx = fifo_tx_in;
 	fifo_rx = fifo_rx_in;
 
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "asrc.h"
+
+#include <zephyr/kernel.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+#include <zephyr/arch/arm/aarch32/cortex_m/cmsis.h>
+#define ASRC_USE_DSP 1
+#endif
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(asrc, CONFIG_ASRC_LOG_LEVEL);
+
+#define PHASE_BITS 6
+BUILD_ASSERT((1 << PHASE_BITS) == ASRC_PHASES, "PHASE_BITS must match ASRC_PHASES");
+BUILD_ASSERT((ASRC_TAPS % 2) == 0, "Taps are processed in pairs");
+
+/* Cutoff relative to the sample rate, and Kaiser window beta. The cutoff is
+ * above the audio band of all supported sample rates, and the stopband
+ * attenuation of the window is about 80 dB.
+ */
+#define CUTOFF 0.46f
+#define KAISER_BETA 8.0f
+
+/* The output at a fractional position between input samples idx and idx + 1
+ * is the dot product of the inputs idx - (ASRC_TAPS / 2 - 1) to
+ * idx + ASRC_TAPS / 2 with one row of coefficients. There is one row more
+ * than the number of phases, so the last phase can be interpolated with
+ * the next input sample.
+ */
+#define FIRST_TAP (ASRC_TAPS / 2 - 1)
+
+static int16_t __aligned(4) coefs[ASRC_PHASES + 1][ASRC_TAPS];
+static bool coefs_generated;
+
+/* Zeroth order modified Bessel function of the first kind */
+static float bessel_i0(float x)
+{
+	float sum = 1.0f;
+	float term = 1.0f;
+
+	for (int k = 1; k < 20; k++) {
+		term *= (x / (2.0f * k)) * (x / (2.0f * k));
+		sum += term;
+	}
+
+	return sum;
+}
+
+static void coefs_generate(void)
+{
+	float row[ASRC_TAPS];
+	float ratio;
+	float sum;
+	int32_t q15_sum;
+	int32_t max_idx;
+
+	for (int p = 0; p <= ASRC_PHASES; p++) {
+		sum = 0;
+
+		for (int m = 0; m < ASRC_TAPS; m++) {
+			float t = (float)(m - FIRST_TAP) - (float)p / ASRC_PHASES;
+			float x = 2.0f * CUTOFF * t;
+			float sinc = (t == 0) ? 1.0f : sinf(M_PI * x) / (M_PI * x);
+
+			ratio = 2.0f * t / ASRC_TAPS;
+			ratio = (ratio * ratio < 1.0f) ? sqrtf(1.0f - ratio * ratio) : 0.0f;
+
+			row[m] = sinc * bessel_i0(KAISER_BETA * ratio);
+			sum += row[m];
+		}
+
+		/* Unity gain at DC for every phase, also after rounding */
+		q15_sum = 0;
+		max_idx = 0;
+
+		for (int m = 0; m < ASRC_TAPS; m++) {
+			coefs[p][m] = lroundf(row[m] / sum * (1 << 15));
+			q15_sum += coefs[p][m];
+
+			if (coefs[p][m] > coefs[p][max_idx]) {
+				max_idx = m;
+			}
+		}
+
+		coefs[p][max_idx] += (1 << 15) - q15_sum;
+	}
+
+	coefs_generated = true;
+}
+
+/* Dot product of ASRC_TAPS samples and Q15 coefficients. The result is the
+ * output sample, scaled by 2^15.
+ */
+static inline int32_t dot(int16_t const *x, int16_t const *c)
+{
+	int32_t acc = 0;
+
+#if ASRC_USE_DSP
+	uint32_t x2;
+	uint32_t c2;
+
+	/* Two multiply-accumulates per instruction. The samples are not
+	 * always word aligned, which the core handles in the load.
+	 */
+	for (int m = 0; m < ASRC_TAPS; m += 2) {
+		memcpy(&x2, &x[m], sizeof(x2));
+		memcpy(&c2, &c[m], sizeof(c2));
+		acc = __SMLAD(x2, c2, acc);
+	}
+#else
+	for (int m = 0; m < ASRC_TAPS; m++) {
+		acc += (int32_t)x[m] * c[m];
+	}
+#endif /* ASRC_USE_DSP */
+
+	return acc;
+}
+
+static inline int16_t output_get(int16_t const *x, uint32_t frac)
+{
+	uint32_t phase = frac >> (32 - PHASE_BITS);
+	int32_t sub = (frac >> (32 - PHASE_BITS - 15)) & 0x7FFF;
+	int32_t d0 = dot(x, coefs[phase]);
+	int32_t d1 = dot(x, coefs[phase + 1]);
+	int32_t y = d0 + (int32_t)(((int64_t)(d1 - d0) * sub) >> 15);
+
+	/* Round, and saturate the overshoot of full scale input */
+	return CLAMP((y + (1 << 14)) >> 15, INT16_MIN, INT16_MAX);
+}
+
+int asrc_init(struct asrc_ctx *ctx, uint8_t channels)
+{
+	if (ctx == NULL || channels == 0 || channels > ASRC_CH_MAX) {
+		return -EINVAL;
+	}
+
+	if (!coefs_generated) {
+		coefs_generate();
+	}
+
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->channels = channels;
+
+	/* Silence before the first input, so the first output is at the
+	 * first input sample
+	 */
+	ctx->hist_len = FIRST_TAP;
+	ctx->pos = (uint64_t)FIRST_TAP << 32;
+
+	return asrc_ratio_set(ctx, 0);
+}
+
+int asrc_ratio_set(struct asrc_ctx *ctx, int32_t ppm)
+{
+	if (ctx == NULL || ppm > ASRC_PPM_MAX || ppm < -ASRC_PPM_MAX) {
+		return -EINVAL;
+	}
+
+	ctx->ppm = ppm;
+	ctx->step = (1LL << 32) + (int64_t)ppm * (1LL << 32) / 1000000;
+
+	return 0;
+}
+
+int asrc_process(struct asrc_ctx *ctx, int16_t const *in, size_t in_frames, int16_t *out,
+		 size_t out_frames_max, size_t *out_frames)
+{
+	uint32_t idx;
+	uint32_t base;
+	size_t num_out = 0;
+	bool out_full = false;
+
+	if (ctx == NULL || ctx->channels == 0 || in == NULL || out == NULL ||
+	    out_frames == NULL || in_frames > ASRC_IN_FRAMES_MAX) {
+		return -EINVAL;
+	}
+
+	for (uint8_t ch = 0; ch < ctx->channels; ch++) {
+		int16_t *hist = &ctx->hist[ch][ctx->hist_len];
+
+		for (size_t i = 0; i < in_frames; i++) {
+			hist[i] = in[i * ctx->channels + ch];
+		}
+	}
+
+	ctx->hist_len += in_frames;
+
+	/* Output while the last input the filter needs is available */
+	while (((ctx->pos >> 32) + ASRC_TAPS / 2) < ctx->hist_len) {
+		idx = ctx->pos >> 32;
+
+		if (num_out < out_frames_max) {
+			for (uint8_t ch = 0; ch < ctx->channels; ch++) {
+				out[num_out * ctx->channels + ch] = output_get(
+					&ctx->hist[ch][idx - FIRST_TAP], (uint32_t)ctx->pos);
+			}
+
+			num_out++;
+		} else {
+			out_full = true;
+		}
+
+		ctx->pos += ctx->step;
+	}
+
+	/* Keep the inputs needed for the next output */
+	base = (ctx->pos >> 32) - FIRST_TAP;
+
+	for (uint8_t ch = 0; ch < ctx->channels; ch++) {
+		memmove(ctx->hist[ch], &ctx->hist[ch][base],
+			(ctx->hist_len - base) * sizeof(ctx->hist[ch][0]));
+	}
+
+	ctx->hist_len -= base;
+	ctx->pos -= (uint64_t)base << 32;
+
+	*out_frames = num_out;
+
+	if (out_full) {
+		LOG_WRN("Output buffer too small, dropped output");
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+int64_t asrc_next_pos_get(struct asrc_ctx const *ctx)
+{
+	return (int64_t)ctx->pos - ((int64_t)ctx->hist_len << 32);
+}
+
+int64_t asrc_step_get(struct asrc_ctx const *ctx)
+{
+	return ctx->step;
+}
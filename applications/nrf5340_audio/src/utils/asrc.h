@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _ASRC_H_
+#define _ASRC_H_
+
+#include <zephyr/kernel.h>
+
+/* Taps of each polyphase filter, and number of filter phases between two
+ * input samples. The output is interpolated between the two nearest phases.
+ */
+#define ASRC_TAPS 32
+#define ASRC_PHASES 64
+
+#define ASRC_CH_MAX 2
+/* Max input frames per call, 10 ms at 48 kHz */
+#define ASRC_IN_FRAMES_MAX 480
+/* Max ratio offset, in parts per million */
+#define ASRC_PPM_MAX 10000
+
+/* Delay of the filter in input samples */
+#define ASRC_DELAY_SAMPLES (ASRC_TAPS / 2)
+
+struct asrc_ctx {
+	int16_t hist[ASRC_CH_MAX][ASRC_TAPS + ASRC_IN_FRAMES_MAX];
+	uint32_t hist_len; /* Input samples in hist */
+	uint64_t pos; /* Position of the next output in hist, Q32 */
+	int64_t step; /* Input samples per output sample, Q32 */
+	int32_t ppm;
+	uint8_t channels;
+};
+
+/**
+ * @brief Initialize an asynchronous sample rate converter.
+ *
+ * @note The ratio is 1.0 after init. The converter only handles signed 16-bit PCM.
+ *
+ * @param ctx		[out]	Converter to initialize
+ * @param channels	[in]	Number of interleaved channels (1 or 2)
+ *
+ * @return 0		Success
+ * @return -EINVAL	Invalid number of channels
+ */
+int asrc_init(struct asrc_ctx *ctx, uint8_t channels);
+
+/**
+ * @brief Set the conversion ratio.
+ *
+ * @note The ratio can be changed at any time, also between two calls to
+ * asrc_process(), without discontinuity in the output.
+ *
+ * @param ctx		[in/out]	Converter
+ * @param ppm		[in]		Input samples consumed per output sample,
+ *					as an offset from 1.0 in parts per million.
+ *					A positive value gives fewer output samples.
+ *
+ * @return 0		Success
+ * @return -EINVAL	ppm is out of range (+/- ASRC_PPM_MAX)
+ */
+int asrc_ratio_set(struct asrc_ctx *ctx, int32_t ppm);
+
+/**
+ * @brief Convert a block of PCM data.
+ *
+ * @note All input is consumed. The number of output frames is the number of
+ * input frames divided by the ratio, with the fraction carried over to the
+ * next call.
+ *
+ * @param ctx		[in/out]	Converter
+ * @param in		[in]		Interleaved input PCM data
+ * @param in_frames	[in]		Number of input frames, at most ASRC_IN_FRAMES_MAX
+ * @param out		[out]		Interleaved output PCM data
+ * @param out_frames_max [in]		Size of out, in frames
+ * @param out_frames	[out]		Number of output frames written
+ *
+ * @return 0		Success
+ * @return -EINVAL	Invalid parameters
+ * @return -ENOMEM	out is too small. The input is still consumed, and
+ *			out_frames_max frames are written.
+ */
+int asrc_process(struct asrc_ctx *ctx, int16_t const *in, size_t in_frames, int16_t *out,
+		 size_t out_frames_max, size_t *out_frames);
+
+/**
+ * @brief Get the input position of the next output sample.
+ *
+ * @note Used to time stamp the output. The next output is always before the
+ * end of the input, because of the delay of the filter.
+ *
+ * @param ctx		[in]	Converter
+ *
+ * @return Position relative to the end of the last input, in input samples (Q32)
+ */
+int64_t asrc_next_pos_get(struct asrc_ctx const *ctx);
+
+/**
+ * @brief Get the number of input samples consumed per output sample.
+ *
+ * @param ctx		[in]	Converter
+ *
+ * @return Input samples per output sample (Q32)
+ */
+int64_t asrc_step_get(struct asrc_ctx const *ctx);
+
+#endif /* _ASRC_H_ */
@@ -7,38 +7,109 @@
 #include "data_fifo.h"
 
 #include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
 
 #include "macros_common.h"
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(data_fifo, CONFIG_DATA_FIFO_LOG_LEVEL);
 
-static struct k_spinlock lock;
+static inline struct data_fifo_msgq *ring_get(struct data_fifo *data_fifo, uint32_t idx)
+{
+	return &((struct data_fifo_msgq *)data_fifo->msgq_buffer)[idx % data_fifo->elements_max];
+}
 
-/** @brief Checks that the elements in the msgq and slab are legal.
- * I.e. the number of msgq elements cannot be more than mem blocks used.
+/* The ring indices wrap at a multiple of elements_max, so the slot
+ * of an index is the same before and after the wrap
  */
-static int msgq_slab_legal_used_elements(struct data_fifo *data_fifo, uint32_t *msgq_num_used_in,
-					 uint32_t *slab_blocks_num_used_in)
+static inline uint32_t ring_next(struct data_fifo *data_fifo, uint32_t idx)
 {
-	/* Lock so msgq and slab reads are in sync */
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	return (idx + 1 == data_fifo->ring_mod) ? 0 : idx + 1;
+}
 
-	uint32_t msgq_num_used = k_msgq_num_used_get(&data_fifo->msgq);
-	uint32_t slab_blocks_num_used = k_mem_slab_num_used_get(&data_fifo->mem_slab);
+static inline uint32_t ring_used(struct data_fifo *data_fifo, uint32_t head, uint32_t tail)
+{
+	return (tail >= head) ? (tail - head) : (data_fifo->ring_mod - head + tail);
+}
 
-	k_spin_unlock(&lock, key);
+/* Wait until ready() returns true, or the timeout expires. The other side
+ * only gives the semaphore when the waiting flag is set, so the kernel is not
+ * involved unless a thread is actually waiting.
+ */
+static void wait_for(struct data_fifo *data_fifo, struct k_sem *sem, atomic_t *waiting,
+		     bool (*ready)(struct data_fifo *data_fifo), k_timeout_t timeout)
+{
+	/* Clear gives from earlier waits that did not need to sleep */
+	k_sem_reset(sem);
+	atomic_set(waiting, 1);
 
-	if (slab_blocks_num_used < msgq_num_used) {
-		LOG_ERR("Num used mgsq %d cannot be larger than used blocks %d", msgq_num_used,
-			slab_blocks_num_used);
-		return -EACCES;
+	/* Check again, since the other side may not have seen the flag */
+	if (!ready(data_fifo)) {
+		(void)k_sem_take(sem, timeout);
 	}
 
-	if (msgq_num_used_in != NULL && slab_blocks_num_used_in != NULL) {
-		*msgq_num_used_in = msgq_num_used;
-		*slab_blocks_num_used_in = slab_blocks_num_used;
+	atomic_set(waiting, 0);
+}
+
+static inline void wake(struct k_sem *sem, atomic_t *waiting)
+{
+	if (atomic_get(waiting)) {
+		k_sem_give(sem);
 	}
+}
+
+static bool vacant_available(struct data_fifo *data_fifo)
+{
+	return atomic_get(&data_fifo->alloced_num) < data_fifo->elements_max;
+}
+
+static bool filled_available(struct data_fifo *data_fifo)
+{
+	return atomic_get(&data_fifo->cons.head) != atomic_get(&data_fifo->prod.tail);
+}
+
+/* Only the producer allocates, so a set bit cannot be taken by someone else
+ * between finding and clearing it. Frees only set bits.
+ */
+static int block_alloc(struct data_fifo *data_fifo, void **data)
+{
+	for (uint32_t i = 0; i < ATOMIC_BITMAP_SIZE(data_fifo->elements_max); i++) {
+		atomic_val_t vacant = atomic_get(&data_fifo->vacant_bitmap[i]);
+
+		if (vacant == 0) {
+			continue;
+		}
+
+		uint32_t bit = __builtin_ctzl(vacant);
+
+		atomic_clear_bit(&data_fifo->vacant_bitmap[i], bit);
+		atomic_inc(&data_fifo->alloced_num);
+
+		*data = &data_fifo->slab_buffer[(i * ATOMIC_BITS + bit) *
+						data_fifo->block_size_max];
+		return 0;
+	}
+
+	return -ENOMEM;
+}
+
+/* Take the oldest descriptor. The consumer and a producer dropping data on
+ * overrun may race for it, so the head is advanced with a compare and swap.
+ * The descriptor is read before the swap. It cannot be overwritten before
+ * that, since the block it points to is not free until it has been taken.
+ */
+static int descriptor_take(struct data_fifo *data_fifo, struct data_fifo_msgq *desc)
+{
+	uint32_t head;
+
+	do {
+		head = atomic_get(&data_fifo->cons.head);
+		if (head == atomic_get(&data_fifo->prod.tail)) {
+			return -ENOMSG;
+		}
+
+		*desc = *ring_get(data_fifo, head);
+	} while (!atomic_cas(&data_fifo->cons.head, head, ring_next(data_fifo, head)));
 
 	return 0;
 }
@@ -50,15 +121,24 @@ int data_fifo_pointer_first_vacant_get(struct data_fifo *data_fifo, void **data,
 	__ASSERT_NO_MSG(data_fifo->initialized);
 	int ret;
 
-	ret = k_mem_slab_alloc(&data_fifo->mem_slab, data, timeout);
-	return ret;
+	ret = block_alloc(data_fifo, data);
+	if (ret == 0 || K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		return ret;
+	}
+
+	do {
+		wait_for(data_fifo, &data_fifo->prod.sem, &data_fifo->prod.waiting,
+			 vacant_available, timeout);
+		ret = block_alloc(data_fifo, data);
+	} while (ret && K_TIMEOUT_EQ(timeout, K_FOREVER));
+
+	return ret ? -EAGAIN : 0;
 }
 
 int data_fifo_block_lock(struct data_fifo *data_fifo, void **data, size_t size)
 {
 	__ASSERT_NO_MSG(data_fifo != NULL);
 	__ASSERT_NO_MSG(data_fifo->initialized);
-	int ret;
 
 	if (size > data_fifo->block_size_max) {
 		LOG_ERR("Size %zu too big", size);
@@ -68,20 +148,18 @@ int data_fifo_block_lock(struct data_fifo *data_fifo, void **data, size_t size)
 		return -EINVAL;
 	}
 
-	struct data_fifo_msgq msgq_tmp;
+	uint32_t tail = atomic_get(&data_fifo->prod.tail);
+	struct data_fifo_msgq *desc = ring_get(data_fifo, tail);
 
-	msgq_tmp.block_ptr = *data;
-	msgq_tmp.size = size;
-
-	/* Since num elements in the slab and msgq are equal, there
-	 * must be space in the queue. if k_msg_put fails, it
-	 * is fatal.
+	/* Since there are as many descriptors as blocks, and the
+	 * block is alloced, there is always a free descriptor
 	 */
-	ret = k_msgq_put(&data_fifo->msgq, &msgq_tmp, K_NO_WAIT);
-	if (ret) {
-		LOG_ERR("Fatal error %d from k_msgq_put", ret);
-		return -ESPIPE;
-	}
+	desc->block_ptr = *data;
+	desc->size = size;
+
+	/* Publish the descriptor after it has been written */
+	atomic_set(&data_fifo->prod.tail, ring_next(data_fifo, tail));
+	wake(&data_fifo->cons.sem, &data_fifo->cons.waiting);
 
 	return 0;
 }
@@ -95,7 +173,19 @@ int data_fifo_pointer_last_filled_get(struct data_fifo *data_fifo, void **data,
 
 	struct data_fifo_msgq msgq_tmp;
 
-	ret = k_msgq_get(&data_fifo->msgq, &msgq_tmp, timeout);
+	ret = descriptor_take(data_fifo, &msgq_tmp);
+	if (ret && !K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		do {
+			wait_for(data_fifo, &data_fifo->cons.sem, &data_fifo->cons.waiting,
+				 filled_available, timeout);
+			ret = descriptor_take(data_fifo, &msgq_tmp);
+		} while (ret && K_TIMEOUT_EQ(timeout, K_FOREVER));
+
+		if (ret) {
+			return -EAGAIN;
+		}
+	}
+
 	if (ret) {
 		return ret;
 	}
@@ -110,27 +200,57 @@ void data_fifo_block_free(struct data_fifo *data_fifo, void **data)
 	__ASSERT_NO_MSG(data_fifo != NULL);
 	__ASSERT_NO_MSG(data_fifo->initialized);
 
-	k_mem_slab_free(&data_fifo->mem_slab, data);
+	size_t offset = (char *)*data - data_fifo->slab_buffer;
+	uint32_t idx = offset / data_fifo->block_size_max;
+
+	__ASSERT(idx < data_fifo->elements_max && (offset % data_fifo->block_size_max) == 0,
+		 "Block %p is not in the FIFO", *data);
+	__ASSERT(!atomic_test_bit(data_fifo->vacant_bitmap, idx), "Block %p freed twice",
+		 *data);
+
+	atomic_set_bit(data_fifo->vacant_bitmap, idx);
+	atomic_dec(&data_fifo->alloced_num);
+	wake(&data_fifo->prod.sem, &data_fifo->prod.waiting);
 }
 
 int data_fifo_num_used_get(struct data_fifo *data_fifo, uint32_t *alloced_num, uint32_t *locked_num)
 {
 	__ASSERT_NO_MSG(data_fifo != NULL);
 	__ASSERT_NO_MSG(data_fifo->initialized);
-	int ret;
 
-	uint32_t msgq_num_used = UINT32_MAX;
-	uint32_t slab_blocks_num_used = UINT32_MAX;
+	uint32_t head;
+	uint32_t tail;
+	uint32_t alloced;
 
-	ret = msgq_slab_legal_used_elements(data_fifo, &msgq_num_used, &slab_blocks_num_used);
-	if (ret) {
-		return ret;
+	/* The values are read one at a time, so an allocation or free between
+	 * the reads can make the snapshot inconsistent. A locked block is
+	 * always alloced, so retry until that holds.
+	 */
+	do {
+		head = atomic_get(&data_fifo->cons.head);
+		tail = atomic_get(&data_fifo->prod.tail);
+		alloced = atomic_get(&data_fifo->alloced_num);
+	} while (ring_used(data_fifo, head, tail) > alloced);
+
+	*locked_num = ring_used(data_fifo, head, tail);
+	*alloced_num = alloced;
+
+	return 0;
+}
+
+static void data_fifo_reset(struct data_fifo *data_fifo)
+{
+	for (uint32_t i = 0; i < ATOMIC_BITMAP_SIZE(data_fifo->elements_max); i++) {
+		atomic_clear(&data_fifo->vacant_bitmap[i]);
 	}
 
-	*locked_num = msgq_num_used;
-	*alloced_num = slab_blocks_num_used;
+	for (uint32_t i = 0; i < data_fifo->elements_max; i++) {
+		atomic_set_bit(data_fifo->vacant_bitmap, i);
+	}
 
-	return ret;
+	atomic_clear(&data_fifo->alloced_num);
+	atomic_clear(&data_fifo->prod.tail);
+	atomic_clear(&data_fifo->cons.head);
 }
 
 int data_fifo_empty(struct data_fifo *data_fifo)
@@ -158,13 +278,8 @@ int data_fifo_empty(struct data_fifo *data_fifo)
 		data_fifo_block_free(data_fifo, &old_data);
 	}
 
-	/* Re-init k_mem_slab to reset the number of alloced slabs */
-	ret = k_mem_slab_init(&data_fifo->mem_slab, data_fifo->slab_buffer,
-			      data_fifo->block_size_max, data_fifo->elements_max);
-	if (ret) {
-		LOG_ERR("Slab init failed with %d", ret);
-		return ret;
-	}
+	/* Reset to also return blocks that were alloced but never locked */
+	data_fifo_reset(data_fifo);
 
 	return 0;
 }
@@ -176,19 +291,17 @@ int data_fifo_init(struct data_fifo *data_fifo)
 	__ASSERT_NO_MSG(data_fifo->elements_max != 0);
 	__ASSERT_NO_MSG(data_fifo->block_size_max != 0);
 	__ASSERT_NO_MSG((data_fifo->block_size_max % WB_UP(1)) == 0);
-	int ret;
 
-	k_msgq_init(&data_fifo->msgq, data_fifo->msgq_buffer, sizeof(struct data_fifo_msgq),
-		    data_fifo->elements_max);
+	data_fifo->ring_mod = data_fifo->elements_max * (UINT32_MAX / data_fifo->elements_max);
 
-	ret = k_mem_slab_init(&data_fifo->mem_slab, data_fifo->slab_buffer,
-			      data_fifo->block_size_max, data_fifo->elements_max);
-	if (ret) {
-		LOG_ERR("Slab init failed with %d", ret);
-		return ret;
-	}
+	k_sem_init(&data_fifo->prod.sem, 0, 1);
+	k_sem_init(&data_fifo->cons.sem, 0, 1);
+	atomic_clear(&data_fifo->prod.waiting);
+	atomic_clear(&data_fifo->cons.waiting);
+
+	data_fifo_reset(data_fifo);
 
 	data_fifo->initialized = true;
 
-	return ret;
+	return 0;
 }
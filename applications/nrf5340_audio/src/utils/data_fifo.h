@@ -11,6 +11,16 @@
 #include <stdint.h>
 #include <zephyr/kernel.h>
 
+/* Descriptors and the indices written by each side are aligned to the data
+ * cache line on cores that have one, so the producer and the consumer never
+ * write to the same line.
+ */
+#if defined(CONFIG_DCACHE_LINE_SIZE) && (CONFIG_DCACHE_LINE_SIZE > 0)
+#define DATA_FIFO_ALIGN CONFIG_DCACHE_LINE_SIZE
+#else
+#define DATA_FIFO_ALIGN WB_UP(1)
+#endif
+
 /* The queue elements hold a pointer to a memory block in a slab and the
  * number of bytes written to that block.
  */
@@ -19,23 +29,48 @@ struct data_fifo_msgq {
 	size_t size;
 };
 
+/* The filled blocks are kept in a ring of descriptors. Only the producer
+ * writes to the ring, while the oldest descriptor can be taken by both the
+ * consumer and a producer that drops it on overrun. The vacant blocks are kept
+ * in a bitmap, so they can be freed in any order. No operation takes a lock
+ * or calls into the kernel, unless it has to wait.
+ */
 struct data_fifo {
 	char *msgq_buffer;
 	char *slab_buffer;
-	struct k_mem_slab mem_slab;
-	struct k_msgq msgq;
+	atomic_t *vacant_bitmap;
 	uint32_t elements_max;
 	size_t block_size_max;
+	uint32_t ring_mod; /* Multiple of elements_max the ring indices wrap at */
 	bool initialized;
+
+	/* Written by the producer */
+	struct {
+		atomic_t tail; /* Next descriptor to write */
+		atomic_t waiting; /* Producer waits for a vacant block */
+		struct k_sem sem;
+	} __aligned(DATA_FIFO_ALIGN) prod;
+
+	/* Written by the consumer */
+	struct {
+		atomic_t head; /* Oldest descriptor not read */
+		atomic_t waiting; /* Consumer waits for a filled block */
+		struct k_sem sem;
+	} __aligned(DATA_FIFO_ALIGN) cons;
+
+	/* Written by both sides */
+	atomic_t alloced_num __aligned(DATA_FIFO_ALIGN);
 };
 
 #define DATA_FIFO_DEFINE(name, elements_max_in, block_size_max_in)                                 \
-	char __aligned(WB_UP(1))                                                                   \
+	char __aligned(DATA_FIFO_ALIGN)                                                            \
 		_msgq_buffer_##name[(elements_max_in) * sizeof(struct data_fifo_msgq)] = { 0 };    \
 	char __aligned(WB_UP(1))                                                                   \
 		_slab_buffer_##name[(elements_max_in) * (block_size_max_in)] = { 0 };              \
+	atomic_t _vacant_bitmap_##name[ATOMIC_BITMAP_SIZE(elements_max_in)] = { 0 };               \
 	struct data_fifo name = { .msgq_buffer = _msgq_buffer_##name,                              \
 				  .slab_buffer = _slab_buffer_##name,                              \
+				  .vacant_bitmap = _vacant_bitmap_##name,                          \
 				  .block_size_max = block_size_max_in,                             \
 				  .elements_max = elements_max_in,                                 \
 				  .initialized = false }
@@ -55,8 +90,9 @@ struct data_fifo {
  *	(in milliseconds). Use K_NO_WAIT to return without waiting,
  *	or K_FOREVER to wait as long as necessary.
  *
- * @retval 0 Memory allocated.
- * @retval Return values from k_mem_slab_alloc.
+ * @retval 0		Memory allocated.
+ * @retval -ENOMEM	No vacant block and K_NO_WAIT was given.
+ * @retval -EAGAIN	Waiting period timed out.
  */
 int data_fifo_pointer_first_vacant_get(struct data_fifo *data_fifo, void **data,
 				       k_timeout_t timeout);
@@ -77,9 +113,6 @@ int data_fifo_pointer_first_vacant_get(struct data_fifo *data_fifo, void **data,
  * @retval 0		Block has been sumbitted to the message queue.
  * @retval -ENOMEM	size is larger than block size max.
  * @retval -EINVAL	Supplied size is zero
- * @retval -ESPIPE	Generic return if an error occurs in k_msg_put.
- *			Since data has already been added to the slab, there
- *			must be space in the message queue.
  */
 int data_fifo_block_lock(struct data_fifo *data_fifo, void **data, size_t size);
 
@@ -98,8 +131,9 @@ int data_fifo_block_lock(struct data_fifo *data_fifo, void **data, size_t size);
  *	(in milliseconds). Use K_NO_WAIT to return without waiting,
  *	or K_FOREVER to wait as long as necessary.
  *
- * @retval 0 Memory pointer retrieved.
- * @retval Return values from k_msgq_get.
+ * @retval 0		Memory pointer retrieved.
+ * @retval -ENOMSG	No filled block and K_NO_WAIT was given.
+ * @retval -EAGAIN	Waiting period timed out.
  */
 int data_fifo_pointer_last_filled_get(struct data_fifo *data_fifo, void **data, size_t *size,
 				      k_timeout_t timeout);
@@ -107,7 +141,7 @@ int data_fifo_pointer_last_filled_get(struct data_fifo *data_fifo, void **data,
 /**
  * @brief Free the data block after reading.
  *
- * Read has finished in the given data block.
+ * Read has finished in the given data block. Blocks can be freed in any order.
  *
  * @param data_fifo Pointer to the data_fifo structure.
  * @param data Double pointer to the memory area which is to be freed.
@@ -117,14 +151,15 @@ void data_fifo_block_free(struct data_fifo *data_fifo, void **data);
 /**
  * @brief See how many alloced and locked blocks are in the system.
  *
+ * Runs in constant time without locking, so it can be called from an ISR,
+ * e.g. for drift compensation.
+ *
  * @param data_fifo Pointer to the data_fifo structure.
  * @param alloced_num Number of used blocks in the slab.
  * @param locked_num Number of used items in the message queue.
  *
- * @retval 0		Success
- * @retval -EACCES	Illegal combination of used message queue items
- *			and slabs. If an error occurs, parameters
- *			will be set to UINT32_MAX.
+ * @retval 0		Success. The locked number is never larger than the
+ *			alloced number.
  */
 int data_fifo_num_used_get(struct data_fifo *data_fifo, uint32_t *alloced_num,
 			   uint32_t *locked_num);
@@ -144,7 +179,6 @@ int data_fifo_empty(struct data_fifo *data_fifo);
  * @param data_fifo Pointer to the data_fifo structure.
  *
  * @retval 0		Success
- * @retval Return values from k_mem_slab_init.
  */
 int data_fifo_init(struct data_fifo *data_fifo);
 
@@ -6,99 +6,234 @@
 
 #include "pcm_mix.h"
 
+#include <string.h>
 #include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+#include <zephyr/arch/arm/aarch32/cortex_m/cmsis.h>
+#define PCM_MIX_USE_DSP 1
+#endif
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(pcm_mix, CONFIG_PCM_MIX_LOG_LEVEL);
 
-/* Clip signal if amplitude is outside legal range */
-static void hard_limiter(int32_t *const pcm)
+#define INT24_MAX ((1 << 23) - 1)
+#define INT24_MIN (-(1 << 23))
+
+static atomic_t clip_count;
+
+/* Add the two signed 16-bit halves of a and b, with and without saturation */
+#if PCM_MIX_USE_DSP
+#define qadd16(a, b) __QADD16(a, b)
+#define sadd16(a, b) __SADD16(a, b)
+#else
+static inline int32_t sat16(int32_t val)
 {
-	if (*pcm < INT16_MIN) {
-		LOG_DBG("Clip");
-		*pcm = INT16_MIN;
-	} else if (*pcm > INT16_MAX) {
-		LOG_DBG("Clip");
-		*pcm = INT16_MAX;
-	}
+	return CLAMP(val, INT16_MIN, INT16_MAX);
 }
 
-/* Mix stereo-stereo or mono-mono. I.e. buffers are of equal size */
-static void pcm_mix_identical(void *const pcm_a, size_t size_a, void const *const pcm_b,
-			      size_t size_b)
+static inline uint32_t qadd16(uint32_t a, uint32_t b)
 {
-	int32_t res;
+	int32_t lo = sat16((int16_t)a + (int16_t)b);
+	int32_t hi = sat16((int16_t)(a >> 16) + (int16_t)(b >> 16));
+
+	return (uint16_t)lo | ((uint32_t)hi << 16);
+}
 
-	for (uint32_t i = 0; i < size_b / 2; i++) {
-		res = ((int16_t *)pcm_a)[i] + ((int16_t *)pcm_b)[i];
+static inline uint32_t sadd16(uint32_t a, uint32_t b)
+{
+	uint16_t lo = (uint16_t)a + (uint16_t)b;
+	uint16_t hi = (uint16_t)(a >> 16) + (uint16_t)(b >> 16);
 
-		hard_limiter(&res);
+	return lo | ((uint32_t)hi << 16);
+}
+#endif /* PCM_MIX_USE_DSP */
 
-		((int16_t *)pcm_a)[i] = (int16_t)res;
+static inline int16_t scale16(int16_t sample, uint16_t gain)
+{
+	/* Gain is at most 1.0, so the result always fits */
+	return ((int32_t)sample * gain) >> 15;
+}
+
+static inline uint32_t pack16(int16_t lo, int16_t hi)
+{
+	return (uint16_t)lo | ((uint32_t)(uint16_t)hi << 16);
+}
+
+/* Mix two 16-bit samples in one word, and count the halves that saturated */
+static inline uint32_t mix16x2(uint32_t a, uint32_t b, uint32_t *clips)
+{
+	uint32_t sum = qadd16(a, b);
+	uint32_t diff = sum ^ sadd16(a, b);
+
+	if (unlikely(diff)) {
+		*clips += ((diff & 0xFFFF) != 0) + ((diff >> 16) != 0);
 	}
+
+	return sum;
 }
 
-/* Mix mono into both channels of a stereo buffer */
-static void pcm_mix_b_mono_into_a_stereo_lr(void *const pcm_a, size_t size_a,
-					    void const *const pcm_b, size_t size_b)
+/* Each word of A holds two 16-bit samples, either two mono samples or the
+ * left and right samples of a stereo frame. For each word, B is expanded to
+ * the samples to add, with zero in a channel that is not mixed.
+ */
+static void pcm_mix16(int16_t *pcm_a, int16_t const *pcm_b, size_t samples_b,
+		      enum pcm_mix_mode mix_mode, uint16_t gain, uint32_t *clips)
 {
-	int32_t res;
+	bool unity = (gain == PCM_MIX_GAIN_UNITY);
+	uint32_t word_a;
+	uint32_t word_b;
+	int16_t b;
+	size_t i;
+
+	if (mix_mode == B_STEREO_INTO_A_STEREO || mix_mode == B_MONO_INTO_A_MONO) {
+		for (i = 0; i + 1 < samples_b; i += 2) {
+			memcpy(&word_a, &pcm_a[i], sizeof(word_a));
+			if (unity) {
+				memcpy(&word_b, &pcm_b[i], sizeof(word_b));
+			} else {
+				word_b = pack16(scale16(pcm_b[i], gain),
+						scale16(pcm_b[i + 1], gain));
+			}
+			word_a = mix16x2(word_a, word_b, clips);
+			memcpy(&pcm_a[i], &word_a, sizeof(word_a));
+		}
+
+		/* Odd number of samples */
+		if (i < samples_b) {
+			word_a = (uint16_t)pcm_a[i];
+			word_b = (uint16_t)scale16(pcm_b[i], gain);
+			pcm_a[i] = (int16_t)mix16x2(word_a, word_b, clips);
+		}
+
+		return;
+	}
 
-	/* Use size_b as this is the length of the mono sample.
-	 * This must be *2 to traverse the stereo sample and /2 since
-	 * the sample is two bytes in size.
-	 */
-	for (uint32_t i = 0; i < size_b; i++) {
-		res = ((int16_t *)pcm_a)[i] + ((int16_t *)pcm_b)[i / 2];
+	for (i = 0; i < samples_b; i++) {
+		b = unity ? pcm_b[i] : scale16(pcm_b[i], gain);
 
-		hard_limiter(&res);
+		switch (mix_mode) {
+		case B_MONO_INTO_A_STEREO_LR:
+			word_b = pack16(b, b);
+			break;
+		case B_MONO_INTO_A_STEREO_L:
+			word_b = pack16(b, 0);
+			break;
+		default:
+			word_b = pack16(0, b);
+			break;
+		}
 
-		((int16_t *)pcm_a)[i] = (int16_t)res;
+		memcpy(&word_a, &pcm_a[i * 2], sizeof(word_a));
+		word_a = mix16x2(word_a, word_b, clips);
+		memcpy(&pcm_a[i * 2], &word_a, sizeof(word_a));
 	}
 }
 
-/* Mix mono into left channel of a stereo buffer */
-static void pcm_mix_b_mono_into_a_stereo_l(void *const pcm_a, size_t size_a,
-					   void const *const pcm_b, size_t size_b)
+static int32_t sample_get(uint8_t const *pcm, size_t idx, uint8_t bytes)
 {
-	int32_t res;
+	int32_t sample;
 
-	for (uint32_t i = 0; i < size_b / 2; i++) {
-		res = ((int16_t *)pcm_a)[i * 2] + ((int16_t *)pcm_b)[i];
+	if (bytes == 4) {
+		memcpy(&sample, &pcm[idx * 4], sizeof(sample));
+		return sample;
+	}
 
-		hard_limiter(&res);
+	/* Packed 24-bit, little endian. Shift up to sign extend */
+	pcm += idx * 3;
+	sample = ((uint32_t)pcm[0] << 8) | ((uint32_t)pcm[1] << 16) | ((uint32_t)pcm[2] << 24);
 
-		((int16_t *)pcm_a)[i * 2] = (int16_t)res;
+	return sample >> 8;
+}
+
+static void sample_put(uint8_t *pcm, size_t idx, uint8_t bytes, int32_t sample)
+{
+	if (bytes == 4) {
+		memcpy(&pcm[idx * 4], &sample, sizeof(sample));
+		return;
 	}
+
+	pcm += idx * 3;
+	pcm[0] = sample;
+	pcm[1] = sample >> 8;
+	pcm[2] = sample >> 16;
 }
 
-/* Mix mono into right channel of a stereo buffer */
-static void pcm_mix_b_mono_into_a_stereo_r(void *const pcm_a, size_t size_a,
-					   void const *const pcm_b, size_t size_b)
+static void sample_mix(uint8_t *pcm_a, size_t idx, uint8_t bytes, int32_t b, uint32_t *clips)
 {
-	int32_t res;
+	int64_t res = (int64_t)sample_get(pcm_a, idx, bytes) + b;
+	int32_t max = (bytes == 4) ? INT32_MAX : INT24_MAX;
+	int32_t min = (bytes == 4) ? INT32_MIN : INT24_MIN;
 
-	for (uint32_t i = 0; i < size_b / 2; i++) {
-		res = ((int16_t *)pcm_a)[i * 2 + 1] + ((int16_t *)pcm_b)[i];
+	if (unlikely(res > max || res < min)) {
+		res = CLAMP(res, min, max);
+		(*clips)++;
+	}
 
-		hard_limiter(&res);
+	sample_put(pcm_a, idx, bytes, res);
+}
+
+/* 24 and 32-bit samples */
+static void pcm_mix_wide(uint8_t *pcm_a, uint8_t const *pcm_b, size_t samples_b, uint8_t bytes,
+			 enum pcm_mix_mode mix_mode, uint16_t gain, uint32_t *clips)
+{
+	int32_t b;
 
-		((int16_t *)pcm_a)[i * 2 + 1] = (int16_t)res;
+	for (size_t i = 0; i < samples_b; i++) {
+		b = sample_get(pcm_b, i, bytes);
+		if (gain != PCM_MIX_GAIN_UNITY) {
+			b = ((int64_t)b * gain) >> 15;
+		}
+
+		switch (mix_mode) {
+		case B_MONO_INTO_A_STEREO_LR:
+			sample_mix(pcm_a, i * 2, bytes, b, clips);
+			sample_mix(pcm_a, i * 2 + 1, bytes, b, clips);
+			break;
+		case B_MONO_INTO_A_STEREO_L:
+			sample_mix(pcm_a, i * 2, bytes, b, clips);
+			break;
+		case B_MONO_INTO_A_STEREO_R:
+			sample_mix(pcm_a, i * 2 + 1, bytes, b, clips);
+			break;
+		default:
+			sample_mix(pcm_a, i, bytes, b, clips);
+			break;
+		}
 	}
 }
 
-int pcm_mix(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
-	    enum pcm_mix_mode mix_mode)
+int pcm_mix_gain(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
+		 enum pcm_mix_mode mix_mode, uint8_t pcm_bit_depth, uint16_t gain_b)
 {
+	uint8_t bytes = pcm_bit_depth / 8;
+	uint32_t clips = 0;
+
 	if (pcm_a == NULL || size_a == 0) {
 		return -EINVAL;
 	}
 
+	if (pcm_bit_depth != 16 && pcm_bit_depth != 24 && pcm_bit_depth != 32) {
+		LOG_ERR("Invalid bit depth: %d", pcm_bit_depth);
+		return -EINVAL;
+	}
+
+	if (gain_b > PCM_MIX_GAIN_UNITY) {
+		LOG_ERR("Invalid gain: %d", gain_b);
+		return -EINVAL;
+	}
+
 	if (pcm_b == NULL || size_b == 0) {
 		/* Nothing to mix, returning */
 		return 0;
 	}
 
+	if ((size_a % bytes) || (size_b % bytes)) {
+		LOG_ERR("Size a %zu or size b %zu is not a multiple of %d", size_a, size_b, bytes);
+		return -EINVAL;
+	}
+
 	switch (mix_mode) {
 	case B_STEREO_INTO_A_STEREO:
 		/* Fall through */
@@ -106,24 +241,14 @@ int pcm_mix(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t si
 		if (size_b > size_a) {
 			return -EPERM;
 		}
-		pcm_mix_identical(pcm_a, size_a, pcm_b, size_b);
 		break;
 	case B_MONO_INTO_A_STEREO_LR:
-		if (size_b > (size_a / 2)) {
-			return -EPERM;
-		}
-		pcm_mix_b_mono_into_a_stereo_lr(pcm_a, size_a, pcm_b, size_b);
-		break;
+		/* Fall through */
 	case B_MONO_INTO_A_STEREO_L:
-		pcm_mix_b_mono_into_a_stereo_l(pcm_a, size_a, pcm_b, size_b);
-		if (size_b > (size_a / 2)) {
-			LOG_ERR("size a %d size b %d", size_a, size_b);
-			return -EPERM;
-		}
-		break;
+		/* Fall through */
 	case B_MONO_INTO_A_STEREO_R:
-		pcm_mix_b_mono_into_a_stereo_r(pcm_a, size_a, pcm_b, size_b);
 		if (size_b > (size_a / 2)) {
+			LOG_ERR("size a %zu size b %zu", size_a, size_b);
 			return -EPERM;
 		}
 		break;
@@ -131,5 +256,34 @@ int pcm_mix(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t si
 		return -ESRCH;
 	};
 
+	if (gain_b == 0) {
+		return 0;
+	}
+
+	if (bytes == 2) {
+		pcm_mix16(pcm_a, pcm_b, size_b / bytes, mix_mode, gain_b, &clips);
+	} else {
+		pcm_mix_wide(pcm_a, pcm_b, size_b / bytes, bytes, mix_mode, gain_b, &clips);
+	}
+
+	if (clips) {
+		atomic_add(&clip_count, clips);
+	}
+
 	return 0;
 }
+
+int pcm_mix(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
+	    enum pcm_mix_mode mix_mode)
+{
+	return pcm_mix_gain(pcm_a, size_a, pcm_b, size_b, mix_mode, 16, PCM_MIX_GAIN_UNITY);
+}
+
+uint32_t pcm_mix_clip_count_get(bool reset)
+{
+	if (reset) {
+		return atomic_clear(&clip_count);
+	}
+
+	return atomic_get(&clip_count);
+}
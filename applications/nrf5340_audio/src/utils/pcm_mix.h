@@ -9,6 +9,9 @@
 
 #include <zephyr/kernel.h>
 
+/* Gain of 1.0 in the Q15 format used by pcm_mix_gain() */
+#define PCM_MIX_GAIN_UNITY (1U << 15)
+
 enum pcm_mix_mode {
 	B_STEREO_INTO_A_STEREO,
 	B_MONO_INTO_A_MONO,
@@ -23,7 +26,7 @@ enum pcm_mix_mode {
  * @note Uses simple addition with hard clip protection.
  * Input can be mono or stereo as long as inputs match.
  * By selecting the mix mode, mono can also be mixed into a stereo buffer.
- * Hard coded for signed 16-bit PCM.
+ * Hard coded for signed 16-bit PCM. See pcm_mix_gain() for other bit depths.
  *
  * @param pcm_a         [in/out]Pointer to buffer A PCM data
  * @param size_a        [in]    Size (bytes) of buffer A PCM data
@@ -40,4 +43,39 @@ enum pcm_mix_mode {
 int pcm_mix(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
 	    enum pcm_mix_mode mix_mode);
 
+/**
+ * @brief Mixes buffer B, scaled by a gain, into buffer A.
+ *
+ * @note The sum saturates at the limits of the sample format, and each
+ * saturated sample increments the clip counter.
+ * 24-bit samples are packed in three bytes, as in pcm_stream_channel_modifier.
+ * On cores with the DSP extension, 16-bit samples are mixed two at a time.
+ *
+ * @param pcm_a         [in/out]Pointer to buffer A PCM data
+ * @param size_a        [in]    Size (bytes) of buffer A PCM data
+ * @param pcm_b         [in]    Pointer to buffer B PCM data
+ * @param size_b        [in]    Size (bytes) of buffer B PCM data
+ * @param mix_mode      [in]    Mixing mode according to pcm_mix_mode
+ * @param pcm_bit_depth [in]    Bit depth of the PCM samples (16, 24 or 32)
+ * @param gain_b        [in]    Gain of buffer B in Q15, at most PCM_MIX_GAIN_UNITY
+ *
+ * @return 0            Success. Result stored in pcm_a
+ * @return -EINVAL      pcm_a is NULL, size_a = 0, the sizes are not a whole
+ *                      number of samples, or the bit depth or gain is invalid
+ * @return -EPERM       size_b < size_a for stereo to stereo, mono to mono
+ *                      or size_a/2 < size_b for mono to stereo mix
+ * @return -ESRCH       Invalid mix_mode
+ */
+int pcm_mix_gain(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
+		 enum pcm_mix_mode mix_mode, uint8_t pcm_bit_depth, uint16_t gain_b);
+
+/**
+ * @brief Get the number of samples clipped by the mixer.
+ *
+ * @param reset         [in]    Set the counter to zero after reading it
+ *
+ * @return Number of clipped samples since the last reset
+ */
+uint32_t pcm_mix_clip_count_get(bool reset);
+
 #endif /* _PCM_MIX_H_ */
@@ -8,6 +8,7 @@
 
 #include <zephyr/kernel.h>
 #include <errno.h>
+#include <string.h>
 
 #include "channel_assignment.h"
 
@@ -51,41 +52,89 @@ static bool is_valid_size(size_t size, uint8_t bytes_per_sample, uint8_t no_chan
 	return true;
 }
 
+/* Samples are copied with fixed size memcpy() so that the compiler emits
+ * one load and one store per sample instead of a loop over the bytes.
+ */
+#define STRIDED_COPY(bytes, in, in_stride, num, out, out_stride)                                  \
+	do {                                                                                       \
+		for (size_t i = 0; i < (num); i++) {                                               \
+			memcpy((out), (in), (bytes));                                              \
+			(in) += (in_stride) * (bytes);                                             \
+			(out) += (out_stride) * (bytes);                                           \
+		}                                                                                  \
+	} while (0)
+
+static void strided_copy(char const *input, uint8_t input_stride, size_t num_samples,
+			 uint8_t bytes_per_sample, char *output, uint8_t output_stride)
+{
+	switch (bytes_per_sample) {
+	case 2:
+		STRIDED_COPY(2, input, input_stride, num_samples, output, output_stride);
+		break;
+	case 3:
+		STRIDED_COPY(3, input, input_stride, num_samples, output, output_stride);
+		break;
+	default:
+		STRIDED_COPY(4, input, input_stride, num_samples, output, output_stride);
+		break;
+	}
+}
+
+static int channel_offset(enum audio_channel channel, uint8_t bytes_per_sample, size_t *offset)
+{
+	if (channel == AUDIO_CH_L) {
+		*offset = 0;
+	} else if (channel == AUDIO_CH_R) {
+		*offset = bytes_per_sample;
+	} else {
+		LOG_ERR("Invalid channel selection");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+int pscm_strided_copy(void const *const input, uint8_t input_stride, size_t num_samples,
+		      uint8_t pcm_bit_depth, void *output, uint8_t output_stride)
+{
+	if (!is_valid_bit_depth(pcm_bit_depth)) {
+		return -EINVAL;
+	}
+
+	if (input_stride == 0 || output_stride == 0) {
+		LOG_ERR("Invalid stride");
+		return -EINVAL;
+	}
+
+	strided_copy(input, input_stride, num_samples, pcm_bit_depth / 8, output, output_stride);
+
+	return 0;
+}
+
 int pscm_zero_pad(void const *const input, size_t input_size, enum audio_channel channel,
 		  uint8_t pcm_bit_depth, void *output, size_t *output_size)
 {
+	static const char zero_sample[4];
 	uint8_t bytes_per_sample = pcm_bit_depth / 8;
+	size_t num_samples;
+	size_t offset;
+	int ret;
 
 	if (!is_valid_bit_depth(pcm_bit_depth) || !is_valid_size(input_size, bytes_per_sample, 1)) {
 		return -EINVAL;
 	}
 
-	char *pointer_input = (char *)input;
-	char *pointer_output = (char *)output;
-
-	for (uint32_t i = 0; i < input_size / bytes_per_sample; i++) {
-		if (channel == AUDIO_CH_L) {
-			for (uint8_t j = 0; j < bytes_per_sample; j++) {
-				*pointer_output++ = *pointer_input++;
-			}
-
-			for (uint8_t j = 0; j < bytes_per_sample; j++) {
-				*pointer_output++ = 0;
-			}
-		} else if (channel == AUDIO_CH_R) {
-			for (uint8_t j = 0; j < bytes_per_sample; j++) {
-				*pointer_output++ = 0;
-			}
-
-			for (uint8_t j = 0; j < bytes_per_sample; j++) {
-				*pointer_output++ = *pointer_input++;
-			}
-		} else {
-			LOG_ERR("Invalid channel selection");
-			return -EINVAL;
-		}
+	ret = channel_offset(channel, bytes_per_sample, &offset);
+	if (ret) {
+		return ret;
 	}
 
+	num_samples = input_size / bytes_per_sample;
+	strided_copy(input, 1, num_samples, bytes_per_sample, (char *)output + offset, 2);
+	/* An input stride of zero repeats the silent sample in the other channel */
+	strided_copy(zero_sample, 0, num_samples, bytes_per_sample,
+		     (char *)output + (bytes_per_sample - offset), 2);
+
 	*output_size = input_size * 2;
 	return 0;
 }
@@ -94,25 +143,17 @@ int pscm_copy_pad(void const *const input, size_t input_size, uint8_t pcm_bit_de
 		  size_t *output_size)
 {
 	uint8_t bytes_per_sample = pcm_bit_depth / 8;
+	size_t num_samples;
 
 	if (!is_valid_bit_depth(pcm_bit_depth) || !is_valid_size(input_size, bytes_per_sample, 1)) {
 		return -EINVAL;
 	}
 
-	char *pointer_input = (char *)input;
-	char *pointer_output = (char *)output;
+	num_samples = input_size / bytes_per_sample;
 
-	for (uint32_t i = 0; i < input_size / bytes_per_sample; i++) {
-		for (uint8_t j = 0; j < bytes_per_sample; j++) {
-			*pointer_output++ = *pointer_input++;
-		}
-		/* Move back to start of sample to copy into next channel */
-		pointer_input -= bytes_per_sample;
-
-		for (uint8_t j = 0; j < bytes_per_sample; j++) {
-			*pointer_output++ = *pointer_input++;
-		}
-	}
+	strided_copy(input, 1, num_samples, bytes_per_sample, output, 2);
+	strided_copy(input, 1, num_samples, bytes_per_sample, (char *)output + bytes_per_sample,
+		     2);
 
 	*output_size = input_size * 2;
 	return 0;
@@ -122,23 +163,17 @@ int pscm_combine(void const *const input_left, void const *const input_right, si
 		 uint8_t pcm_bit_depth, void *output, size_t *output_size)
 {
 	uint8_t bytes_per_sample = pcm_bit_depth / 8;
+	size_t num_samples;
 
 	if (!is_valid_bit_depth(pcm_bit_depth) || !is_valid_size(input_size, bytes_per_sample, 1)) {
 		return -EINVAL;
 	}
 
-	char *pointer_input_left = (char *)input_left;
-	char *pointer_input_right = (char *)input_right;
-	char *pointer_output = (char *)output;
-
-	for (uint32_t i = 0; i < input_size / bytes_per_sample; i++) {
-		for (uint8_t j = 0; j < bytes_per_sample; j++) {
-			*pointer_output++ = *pointer_input_left++;
-		}
-		for (uint8_t j = 0; j < bytes_per_sample; j++) {
-			*pointer_output++ = *pointer_input_right++;
-		}
-	}
+	num_samples = input_size / bytes_per_sample;
+
+	strided_copy(input_left, 1, num_samples, bytes_per_sample, output, 2);
+	strided_copy(input_right, 1, num_samples, bytes_per_sample,
+		     (char *)output + bytes_per_sample, 2);
 
 	*output_size = input_size * 2;
 	return 0;
@@ -149,33 +184,21 @@ int pscm_one_channel_split(void const *const input, size_t input_size,
 			   size_t *output_size)
 {
 	uint8_t bytes_per_sample = pcm_bit_depth / 8;
+	size_t offset;
+	int ret;
 
 	if (!is_valid_bit_depth(pcm_bit_depth) || !is_valid_size(input_size, bytes_per_sample, 2)) {
 		return -EINVAL;
 	}
 
-	char *pointer_input = (char *)input;
-	char *pointer_output = (char *)output;
-
-	for (uint32_t i = 0; i < input_size / bytes_per_sample; i += 2) {
-		if (channel == AUDIO_CH_L) {
-			for (uint8_t j = 0; j < bytes_per_sample; j++) {
-				*pointer_output++ = *pointer_input++;
-			}
-			pointer_input += bytes_per_sample;
-
-		} else if (channel == AUDIO_CH_R) {
-			pointer_input += bytes_per_sample;
-
-			for (uint8_t j = 0; j < bytes_per_sample; j++) {
-				*pointer_output++ = *pointer_input++;
-			}
-		} else {
-			LOG_ERR("Invalid channel selection");
-			return -EINVAL;
-		}
+	ret = channel_offset(channel, bytes_per_sample, &offset);
+	if (ret) {
+		return ret;
 	}
 
+	strided_copy((char const *)input + offset, 2, input_size / (bytes_per_sample * 2),
+		     bytes_per_sample, output, 1);
+
 	*output_size = input_size / 2;
 	return 0;
 }
@@ -184,23 +207,17 @@ int pscm_two_channel_split(void const *const input, size_t input_size, uint8_t p
 			   void *output_left, void *output_right, size_t *output_size)
 {
 	uint8_t bytes_per_sample = pcm_bit_depth / 8;
+	size_t num_samples;
 
 	if (!is_valid_bit_depth(pcm_bit_depth) || !is_valid_size(input_size, bytes_per_sample, 2)) {
 		return -EINVAL;
 	}
 
-	char *pointer_input = (char *)input;
-	char *pointer_output_left = (char *)output_left;
-	char *pointer_output_right = (char *)output_right;
-
-	for (uint32_t i = 0; i < input_size / bytes_per_sample; i += 2) {
-		for (uint8_t j = 0; j < bytes_per_sample; j++) {
-			*pointer_output_left++ = *pointer_input++;
-		}
-		for (uint8_t j = 0; j < bytes_per_sample; j++) {
-			*pointer_output_right++ = *pointer_input++;
-		}
-	}
+	num_samples = input_size / (bytes_per_sample * 2);
+
+	strided_copy(input, 2, num_samples, bytes_per_sample, output_left, 1);
+	strided_copy((char const *)input + bytes_per_sample, 2, num_samples, bytes_per_sample,
+		     output_right, 1);
 
 	*output_size = input_size / 2;
 	return 0;
@@ -11,6 +11,22 @@
 
 #include "sw_codec_select.h"
 
+/**@brief  Copies samples with a stride between them in the input, the output, or both
+ * @note: Use to read or write one channel of interleaved audio in place. All
+ *	  other functions in this module are built on this copy.
+ *
+ * @param[in]	input:			Pointer to the first input sample
+ * @param[in]	input_stride:		Distance between input samples, in samples
+ * @param[in]	num_samples:		Number of samples to copy
+ * @param[in]	pcm_bit_depth		Bit depth of pcm samples (16, 24 or 32)
+ * @param[out]	output:			Pointer to the first output sample
+ * @param[in]	output_stride:		Distance between output samples, in samples
+ *
+ * @return	0 if success
+ */
+int pscm_strided_copy(void const *const input, uint8_t input_stride, size_t num_samples,
+		      uint8_t pcm_bit_depth, void *output, uint8_t output_stride);
+
 /**@brief  Adds a 0 after every sample from *input
  *	   and writes it to *output
  * @note: Use to create stereo stream from a mono source where one
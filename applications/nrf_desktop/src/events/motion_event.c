@@ -24,14 +24,35 @@ static void profile_motion_event(struct log_event_buf *buf,
 	nrf_profiler_log_encode_int16(buf, event->dy);
 }
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCING)
+static int16_t motion_add(int16_t a, int16_t b)
+{
+	int32_t sum = (int32_t)a + b;
+
+	return MAX(MIN(sum, INT16_MAX), INT16_MIN);
+}
+
+static void coalesce_motion_event(struct app_event_header *pending,
+				  const struct app_event_header *aeh)
+{
+	struct motion_event *pending_event = cast_motion_event(pending);
+	const struct motion_event *event = cast_motion_event(aeh);
+
+	pending_event->dx = motion_add(pending_event->dx, event->dx);
+	pending_event->dy = motion_add(pending_event->dy, event->dy);
+}
+#endif
+
 APP_EVENT_INFO_DEFINE(motion_event,
 		  ENCODE(NRF_PROFILER_ARG_S16, NRF_PROFILER_ARG_S16),
 		  ENCODE("dx", "dy"),
 		  profile_motion_event);
 
-APP_EVENT_TYPE_DEFINE(motion_event,
+APP_EVENT_TYPE_DEFINE_COALESCING(motion_event,
 		  log_motion_event,
 		  &motion_event_info,
 		  APP_EVENT_FLAGS_CREATE(
 			IF_ENABLED(CONFIG_DESKTOP_INIT_LOG_MOTION_EVENT,
-				(APP_EVENT_TYPE_FLAGS_INIT_LOG_ENABLE))));
+				(APP_EVENT_TYPE_FLAGS_INIT_LOG_ENABLE))),
+		  COND_CODE_1(CONFIG_APP_EVENT_MANAGER_COALESCING,
+			      (coalesce_motion_event), (NULL)));
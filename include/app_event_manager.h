@@ -51,6 +51,11 @@ enum app_event_type_flags {
 	APP_EVENT_TYPE_FLAGS_INIT_LOG_ENABLE =
 		APP_EVENT_TYPE_FLAGS_USER_SETTABLE_START,
 
+	/* Process events of the type in the high priority lane.
+	 * Requires CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES, otherwise ignored.
+	 */
+	APP_EVENT_TYPE_FLAGS_HIGH_PRIORITY,
+
 	/* Number of predefined flags. */
 	APP_EVENT_TYPE_FLAGS_COUNT,
 
@@ -109,6 +114,28 @@ static inline bool app_event_get_type_flag(const struct event_type *et,
 	_APP_EVENT_SUBSCRIBE(lname, ename, _APP_EM_SUBS_PRIO_ID(_APP_EM_SUBS_PRIO_NORMAL))
 
 
+/** @brief Subscribe a listener to the normal notification list for an event
+ *  type, filtered by the value of an event field.
+ *
+ * The listener is notified only about events for which the given field equals
+ * @p value. The filter is evaluated by the Application Event Manager, so the
+ * listener function is not called for other events of the type.
+ * The field must be 1, 2 or 4 bytes long.
+ *
+ * @note
+ * For this macro to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTERS} option needs to be enabled.
+ *
+ * @param lname  Name of the listener.
+ * @param ename  Name of the event.
+ * @param field  Name of the event structure field used for filtering.
+ * @param value  Value of the field for which the listener is notified.
+ */
+#define APP_EVENT_SUBSCRIBE_FILTERED(lname, ename, field, value)			\
+	_APP_EVENT_SUBSCRIBE_FILTERED(lname, ename,					\
+		_APP_EM_SUBS_PRIO_ID(_APP_EM_SUBS_PRIO_NORMAL), field, value)
+
+
 /** @brief Subscribe a listener to an event type as final module that is
  *  being notified.
  *
@@ -165,6 +192,36 @@ static inline bool app_event_get_type_flag(const struct event_type *et,
 	_APP_EVENT_TYPE_DEFINE(ename, log_fn, ev_info_struct, app_event_type_flags)
 
 
+/** @brief Define an event type with coalescing.
+ *
+ * This macro defines an event type like @ref APP_EVENT_TYPE_DEFINE. Additionally, at most one
+ * instance of the event type waits in the event queue at a time. If an event of this type is
+ * submitted while the previous one is not yet processed, the function @p coalesce_fn merges
+ * the submitted event into the queued one and the submitted event is freed.
+ *
+ * Use @ref app_event_coalesce_latest to keep only the latest event data or provide
+ * a function that accumulates the data (for example, sums motion deltas).
+ * Events with dynamic data cannot be coalesced.
+ *
+ * @note
+ * Coalescing requires the @kconfig{CONFIG_APP_EVENT_MANAGER_COALESCING} option.
+ * If the option is disabled, @p coalesce_fn is ignored and the event type is defined
+ * as with @ref APP_EVENT_TYPE_DEFINE.
+ *
+ * @param ename     	   Name of the event.
+ * @param log_fn  	   Function to stringify an event of this type.
+ * @param ev_info_struct   Data structure describing the event type.
+ * @param app_event_type_flags Event type flags.
+ *                         You should use APP_EVENT_FLAGS_CREATE to define them.
+ * @param coalesce_fn      Function merging the submitted event into the queued one
+ *                         or NULL to disable coalescing.
+ */
+#define APP_EVENT_TYPE_DEFINE_COALESCING(ename, log_fn, ev_info_struct, app_event_type_flags, \
+					 coalesce_fn)					  \
+	_APP_EVENT_TYPE_DEFINE_COALESCING(ename, log_fn, ev_info_struct, app_event_type_flags, \
+					  coalesce_fn)
+
+
 /** @brief Verify if an event ID is valid.
  *
  * The pointer to an event type structure is used as its ID. This macro
@@ -184,6 +241,20 @@ static inline bool app_event_get_type_flag(const struct event_type *et,
  */
 #define APP_EVENT_SUBMIT(event) _event_submit(&event->header)
 
+/** @brief Submit multiple events.
+ *
+ * The events are queued in the given order with a single lock per event lane and
+ * the event processing is triggered once, instead of once per event.
+ *
+ * @param ... Comma-separated list of pointers to the event objects.
+ */
+#define APP_EVENT_SUBMIT_BATCH(...) do {						\
+	struct app_event_header * const _aehs[] = {					\
+		FOR_EACH(_APP_EVENT_HEADER_PTR, (,), __VA_ARGS__)			\
+	};										\
+	_event_submit_batch(_aehs, ARRAY_SIZE(_aehs));					\
+} while (0)
+
 /**
  * @brief Register event hook after the Application Event Manager is initialized.
  *
@@ -359,6 +430,19 @@ static inline size_t app_event_manager_event_size(const struct app_event_header
 	const struct {} __event_hook_postprocess_last_sub_redefined = {};  \
 	_APP_EVENT_HOOK_POSTPROCESS_REGISTER(hook_fn, _APP_EM_MARKER_FINAL_ELEMENT)
 
+/**
+ * @brief Register event hook called after a listener is notified.
+ *
+ * The hook function should have a form
+ * `void hook(const struct app_event_header *aeh, const struct event_listener *el,
+ * uint32_t cycles)`, where @p cycles is the time spent in the listener, in hardware cycles.
+ * Listeners skipped by a subscriber filter are not reported.
+ *
+ * @param hook_fn Hook function.
+ */
+#define APP_EVENT_HOOK_LISTENER_REGISTER(hook_fn) \
+	_APP_EVENT_HOOK_LISTENER_REGISTER(hook_fn, _APP_EM_SUBS_PRIO_ID(_APP_EM_SUBS_PRIO_NORMAL))
+
 
 /** @brief Initialize the Application Event Manager.
  *
@@ -383,13 +467,78 @@ void *app_event_manager_alloc(size_t size);
  *
  * The behavior of this function depends on the actual implementation.
  * The default implementation of this function is same as k_free.
- * It is annotated as weak and can be overridden by user.
+ * If @kconfig{CONFIG_APP_EVENT_MANAGER_EVENT_POOLS} is enabled, the default
+ * implementation returns events allocated from a pool to the pool instead.
+ * It is annotated as weak and can be overridden by user. An implementation
+ * that overrides it is only called for events allocated with
+ * @ref app_event_manager_alloc, as long as the events allocated from a pool
+ * are freed with @ref app_event_manager_event_free.
  *
  * @param addr  Pointer to previously allocated memory.
  **/
 void app_event_manager_free(void *addr);
 
 
+/** @brief Free an event that was not submitted.
+ *
+ * Events allocated with the new_<i>%event_type</i> function are freed by the Application
+ * Event Manager after they are processed. Use this function to release an event that was
+ * allocated but is not going to be submitted.
+ *
+ * If @kconfig{CONFIG_APP_EVENT_MANAGER_EVENT_POOLS} is enabled, the event is returned to
+ * the pool of its event type. Otherwise, the function calls @ref app_event_manager_free.
+ *
+ * @param event  Pointer to the event.
+ **/
+void app_event_manager_event_free(void *event);
+
+
+/** @brief Coalesce events by keeping the data of the latest event.
+ *
+ * The function can be used as the coalescing function of
+ * @ref APP_EVENT_TYPE_DEFINE_COALESCING. It overwrites the data of the queued event
+ * with the data of the submitted event.
+ *
+ * @param pending  Pointer to the application event header of the queued event.
+ * @param aeh      Pointer to the application event header of the submitted event.
+ **/
+void app_event_coalesce_latest(struct app_event_header *pending,
+			       const struct app_event_header *aeh);
+
+
+/** @brief Event type pool statistics.
+ */
+struct app_event_manager_pool_stats {
+	/** Number of events in the pool. */
+	uint32_t block_cnt;
+
+	/** Number of events currently allocated from the pool. */
+	uint32_t used;
+
+	/** Maximum number of events allocated from the pool at the same time. */
+	uint32_t max_used;
+
+	/** Number of allocations that fell back to the heap because the pool was exhausted. */
+	uint32_t heap_fallback_cnt;
+};
+
+
+/** @brief Get statistics of the event type pool.
+ *
+ * @note
+ * For this function to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_EVENT_POOLS} option needs to be enabled.
+ *
+ * @param et     Pointer to the event type.
+ * @param stats  Pointer to the structure filled with the statistics.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOTSUP If the event type does not use a pool.
+ */
+int app_event_manager_pool_stats_get(const struct event_type *et,
+				     struct app_event_manager_pool_stats *stats);
+
+
 /** @brief Log event.
  *
  * This helper macro simplifies event logging.
@@ -114,5 +114,36 @@ int event_manager_proxy_start(void);
  */
 int event_manager_proxy_wait_for_remotes(k_timeout_t timeout);
 
+/** @brief Transfer statistics of a single remote core communication channel. */
+struct event_manager_proxy_stats {
+	/** Number of events sent to the remote core. */
+	uint32_t events_sent;
+	/** Number of IPC messages used to send the events. */
+	uint32_t msgs_sent;
+	/** Number of bytes sent in the IPC messages. */
+	uint32_t bytes_sent;
+	/** Number of events that could not be sent. */
+	uint32_t send_errors;
+	/** Number of events received from the remote core. */
+	uint32_t events_received;
+	/** Number of IPC messages carrying the received events. */
+	uint32_t msgs_received;
+};
+
+/**
+ * @brief Get transfer statistics of the remote core communication channel.
+ *
+ * Requires @kconfig{CONFIG_EVENT_MANAGER_PROXY_STATS}.
+ *
+ * @param instance Remote IPC instance.
+ * @param stats    Pointer to the structure to be filled with the statistics.
+ *
+ * @retval 0 On success.
+ * @retval -EINVAL Given remote instance was not added.
+ * @retval -ENOTSUP Statistics are disabled.
+ */
+int event_manager_proxy_stats_get(const struct device *instance,
+				  struct event_manager_proxy_stats *stats);
+
 /** @} */
 #endif /* _EVENT_MANAGER_PROXY_H_ */
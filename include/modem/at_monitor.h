@@ -46,6 +46,14 @@ struct at_monitor_entry {
 		uint8_t paused : 1; /* Monitor is paused. */
 		uint8_t direct : 1; /* Dispatch in ISR. */
 	} flags;
+#if defined(CONFIG_AT_MONITOR_FILTER_INDEX)
+	/** Next monitor in the same filter index bucket, set by the library. */
+	struct at_monitor_entry *next;
+#endif
+#if defined(CONFIG_AT_MONITOR_STATS)
+	/** Number of notifications dispatched to this monitor. */
+	uint32_t matches;
+#endif
 };
 
 /** Wildcard. Match any notifications. */
@@ -117,6 +125,67 @@ static inline void at_monitor_resume(struct at_monitor_entry *mon)
 	mon->flags.paused = false;
 }
 
+#if defined(CONFIG_AT_MONITOR_STATS)
+/**
+ * @brief Get the number of notifications dispatched to a monitor.
+ *
+ * @param mon The monitor.
+ *
+ * @return The number of notifications dispatched to @p mon since boot.
+ */
+static inline uint32_t at_monitor_match_count_get(const struct at_monitor_entry *mon)
+{
+	return mon->matches;
+}
+
+/**
+ * @brief AT monitor notification buffer statistics.
+ */
+struct at_monitor_stats {
+	/** Notifications dropped because the notification buffer was full. */
+	uint32_t drops;
+	/** Notifications dropped because they duplicated the queued notification. */
+	uint32_t coalesced;
+	/** Highest number of bytes in use in the notification buffer. */
+	uint32_t buf_used_max;
+};
+
+/**
+ * @brief Get the notification buffer statistics.
+ *
+ * @param[out] stats The statistics.
+ */
+void at_monitor_stats_get(struct at_monitor_stats *stats);
+#endif
+
+#if defined(CONFIG_AT_MONITOR_NOTIF_HOLD)
+/**
+ * @brief Hold a notification received in the system workqueue thread.
+ *
+ * Notifications are stored once and shared by all monitors that receive them.
+ * By default, a notification is released once all monitor handlers have returned.
+ * A handler can call this function to keep using @p notif after it returns,
+ * instead of copying it. The notification must then be released with
+ * @ref at_monitor_notif_release.
+ *
+ * A notification that is held prevents the space of the notifications received
+ * after it from being reused, so it should be released as soon as possible.
+ *
+ * @note Only notifications received by monitors defined with @ref AT_MONITOR
+ *	 can be held, not those received by monitors defined with @ref AT_MONITOR_ISR.
+ *
+ * @param notif The notification passed to the monitor handler.
+ */
+void at_monitor_notif_hold(const char *notif);
+
+/**
+ * @brief Release a notification held with @ref at_monitor_notif_hold.
+ *
+ * @param notif The notification.
+ */
+void at_monitor_notif_release(const char *notif);
+#endif /* CONFIG_AT_MONITOR_NOTIF_HOLD */
+
 /** @} */
 
 #ifdef __cplusplus
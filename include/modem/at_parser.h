@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#ifndef AT_PARSER_H__
+#define AT_PARSER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <zephyr/types.h>
+
+#include <modem/at_params.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file at_parser.h
+ *
+ * @defgroup at_parser AT response parser
+ * @ingroup at_cmd_parser
+ * @{
+ * @brief Non-allocating parser for AT responses and notifications.
+ *
+ * The parser reads the parameters of the first line of an AT response or
+ * notification directly from the response string, which must remain valid
+ * and unchanged while it is parsed. The parameters are tokenized lazily,
+ * when they are requested, and nothing is allocated or copied unless
+ * requested. Reading the parameters in increasing index order does not
+ * require the response to be scanned more than once.
+ *
+ * Parameter 0 is the response prefix, for example, "+CEREG" or "%XT3412",
+ * or the whole line if it does not begin with '+' or '%'. The following parameters
+ * are separated by commas. Quoted strings are returned without the quotes,
+ * and arrays are returned without the parentheses.
+ */
+
+/** @brief A parameter in the parsed string. */
+struct at_token {
+	/** Parameter type. */
+	enum at_param_type type;
+	/** Start of the parameter in the parsed string. */
+	const char *start;
+	/** Length of the parameter. */
+	size_t len;
+};
+
+/**
+ * @brief AT response parser.
+ *
+ * The members are private and must be initialized with @ref at_parser_init.
+ */
+struct at_parser {
+	/** The parsed string. */
+	const char *at;
+	/** Start of the next parameter. */
+	const char *cursor;
+	/** Index of the next parameter. */
+	size_t index;
+	/** The end of the line has been reached. */
+	bool eol;
+};
+
+/**
+ * @brief Initialize a parser.
+ *
+ * @param parser The parser.
+ * @param at     AT response or notification as a null-terminated string.
+ *               The string is not copied.
+ *
+ * @retval 0       If the operation was successful.
+ * @retval -EINVAL One or more of the supplied parameters are invalid.
+ */
+int at_parser_init(struct at_parser *parser, const char *at);
+
+/**
+ * @brief Get the next parameter.
+ *
+ * @param parser The parser.
+ * @param token  The parameter.
+ *
+ * @retval 0        If the operation was successful.
+ * @retval -ENODATA There are no more parameters in the line.
+ * @retval -EBADMSG The parameter is malformed.
+ * @retval -EINVAL  One or more of the supplied parameters are invalid.
+ */
+int at_parser_next(struct at_parser *parser, struct at_token *token);
+
+/**
+ * @brief Get a parameter by index.
+ *
+ * The parser continues from the last parameter read if @p index is after it,
+ * otherwise it starts over from the beginning of the string.
+ *
+ * @param parser The parser.
+ * @param index  Parameter index.
+ * @param token  The parameter.
+ *
+ * @retval 0        If the operation was successful.
+ * @retval -ENODATA There is no parameter at @p index.
+ * @retval -EBADMSG The string is malformed.
+ * @retval -EINVAL  One or more of the supplied parameters are invalid.
+ */
+int at_parser_token_get(struct at_parser *parser, size_t index, struct at_token *token);
+
+/**
+ * @brief Get the number of parameters in the line.
+ *
+ * @param parser The parser.
+ * @param count  Number of parameters, including the response prefix.
+ *
+ * @retval 0        If the operation was successful.
+ * @retval -EBADMSG The string is malformed.
+ * @retval -EINVAL  One or more of the supplied parameters are invalid.
+ */
+int at_parser_count_get(struct at_parser *parser, size_t *count);
+
+/**
+ * @brief Get a parameter value as a short number.
+ *
+ * @param parser The parser.
+ * @param index  Parameter index.
+ * @param value  Parameter value.
+ *
+ * @retval 0       If the operation was successful.
+ * @retval -EINVAL The parameter does not exist, is not a number, or is
+ *                 out of range.
+ */
+int at_parser_short_get(struct at_parser *parser, size_t index, int16_t *value);
+
+/**
+ * @brief Get a parameter value as an unsigned short number.
+ *
+ * @param parser The parser.
+ * @param index  Parameter index.
+ * @param value  Parameter value.
+ *
+ * @retval 0       If the operation was successful.
+ * @retval -EINVAL The parameter does not exist, is not a number, or is
+ *                 out of range.
+ */
+int at_parser_unsigned_short_get(struct at_parser *parser, size_t index, uint16_t *value);
+
+/**
+ * @brief Get a parameter value as an integer number.
+ *
+ * @param parser The parser.
+ * @param index  Parameter index.
+ * @param value  Parameter value.
+ *
+ * @retval 0       If the operation was successful.
+ * @retval -EINVAL The parameter does not exist, is not a number, or is
+ *                 out of range.
+ */
+int at_parser_int_get(struct at_parser *parser, size_t index, int32_t *value);
+
+/**
+ * @brief Get a parameter value as an unsigned integer number.
+ *
+ * @param parser The parser.
+ * @param index  Parameter index.
+ * @param value  Parameter value.
+ *
+ * @retval 0       If the operation was successful.
+ * @retval -EINVAL The parameter does not exist, is not a number, or is
+ *                 out of range.
+ */
+int at_parser_unsigned_int_get(struct at_parser *parser, size_t index, uint32_t *value);
+
+/**
+ * @brief Get a parameter value as a signed 64-bit integer number.
+ *
+ * @param parser The parser.
+ * @param index  Parameter index.
+ * @param value  Parameter value.
+ *
+ * @retval 0       If the operation was successful.
+ * @retval -EINVAL The parameter does not exist, is not a number, or is
+ *                 out of range.
+ */
+int at_parser_int64_get(struct at_parser *parser, size_t index, int64_t *value);
+
+/**
+ * @brief Get a pointer to a string parameter in the parsed string.
+ *
+ * The string is not null-terminated. Numbers can also be read as strings.
+ *
+ * @param parser The parser.
+ * @param index  Parameter index.
+ * @param str    Start of the parameter.
+ * @param len    Length of the parameter.
+ *
+ * @retval 0       If the operation was successful.
+ * @retval -EINVAL The parameter does not exist or is not a string or number.
+ */
+int at_parser_string_ptr_get(struct at_parser *parser, size_t index,
+			     const char **str, size_t *len);
+
+/**
+ * @brief Copy a string parameter.
+ *
+ * The string is not null-terminated. Numbers can also be read as strings.
+ *
+ * @param parser The parser.
+ * @param index  Parameter index.
+ * @param value  Buffer to copy the parameter to.
+ * @param len    Size of @p value, set to the length of the parameter.
+ *
+ * @retval 0       If the operation was successful.
+ * @retval -ENOMEM The parameter does not fit in @p value.
+ * @retval -EINVAL The parameter does not exist or is not a string or number.
+ */
+int at_parser_string_get(struct at_parser *parser, size_t index, char *value, size_t *len);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AT_PARSER_H__ */
@@ -865,6 +865,28 @@ struct lte_lc_evt {
 
 typedef void(*lte_lc_evt_handler_t)(const struct lte_lc_evt *const evt);
 
+/** @brief State cache fields. */
+enum lte_lc_state_cache_field {
+	/** Network registration status, see @ref lte_lc_nw_reg_status_get. */
+	LTE_LC_STATE_CACHE_NW_REG_STATUS,
+	/** LTE mode, see @ref lte_lc_lte_mode_get. */
+	LTE_LC_STATE_CACHE_LTE_MODE,
+	/** PSM configuration, see @ref lte_lc_psm_get. */
+	LTE_LC_STATE_CACHE_PSM,
+	/** Functional mode, see @ref lte_lc_func_mode_get. */
+	LTE_LC_STATE_CACHE_FUNC_MODE,
+
+	LTE_LC_STATE_CACHE_FIELD_COUNT,
+};
+
+/** @brief State cache statistics. */
+struct lte_lc_state_cache_stats {
+	/** Number of getter calls answered from the cache, per field. */
+	uint32_t hits[LTE_LC_STATE_CACHE_FIELD_COUNT];
+	/** Number of getter calls that sent an AT command to the modem, per field. */
+	uint32_t misses[LTE_LC_STATE_CACHE_FIELD_COUNT];
+};
+
 /** @brief Register event handler for LTE events.
  *
  *  @param handler Event handler.
@@ -1316,6 +1338,20 @@ int lte_lc_reduced_mobility_set(enum lte_lc_reduced_mobility_mode mode);
  */
 int lte_lc_factory_reset(enum lte_lc_factory_reset_type type);
 
+/** @brief Get the state cache statistics.
+ *
+ *  The hit rate of a field is the number of hits divided by the sum of
+ *  hits and misses.
+ *
+ *  @note Requires @kconfig{CONFIG_LTE_LC_STATE_CACHE} to be enabled.
+ *
+ *  @param[out] stats Statistics.
+ *
+ *  @retval 0 if successful.
+ *  @retval -EINVAL if @p stats is NULL.
+ */
+int lte_lc_state_cache_stats_get(struct lte_lc_state_cache_stats *stats);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -150,6 +150,27 @@ void nrf_modem_fault_handler(struct nrf_modem_fault_info *fault_info);
 
 #if defined(CONFIG_NRF_MODEM_LIB_MEM_DIAG) || defined(__DOXYGEN__)
 
+#if defined(CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB) || defined(__DOXYGEN__)
+/** Number of block sizes in the TX region. */
+#define NRF_MODEM_LIB_DIAG_SLAB_CLASSES 2
+
+/** @brief Statistics of the blocks of a given size in the TX region. */
+struct nrf_modem_lib_diag_slab_stats {
+	/** Block size. */
+	uint32_t block_size;
+	/** Number of blocks. */
+	uint32_t blocks;
+	/** Number of blocks in use. */
+	uint32_t blocks_used;
+	/** Highest number of blocks in use. */
+	uint32_t blocks_max_used;
+	/** Number of allocations served with a block of this size. */
+	uint32_t allocs;
+	/** Number of allocations that found no free block of this size. */
+	uint32_t misses;
+};
+#endif
+
 struct nrf_modem_lib_diag_stats {
 	struct {
 		struct sys_memory_stats heap;
@@ -158,6 +179,18 @@ struct nrf_modem_lib_diag_stats {
 	struct {
 		struct sys_memory_stats heap;
 		uint32_t failed_allocs;
+		/** Failed allocations for which the heap had enough free bytes,
+		 *  but not in a single chunk.
+		 */
+		uint32_t fragmented_allocs;
+#if defined(CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB) || defined(__DOXYGEN__)
+		/** Size of the largest fixed-size block that is free, zero if none is.
+		 *  Bigger allocations can still be served by the heap.
+		 */
+		uint32_t largest_free_slab_block;
+		/** Block statistics, in increasing block size. */
+		struct nrf_modem_lib_diag_slab_stats slab[NRF_MODEM_LIB_DIAG_SLAB_CLASSES];
+#endif
 	} shmem;
 };
 
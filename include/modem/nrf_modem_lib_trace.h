@@ -62,6 +62,55 @@ int nrf_modem_lib_trace_level_set(enum nrf_modem_lib_trace_level trace_level);
 uint32_t nrf_modem_lib_trace_backend_bitrate_get(void);
 #endif /* defined(CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_BITRATE) || defined(__DOXYGEN__) */
 
+#if defined(CONFIG_NRF_MODEM_LIB_TRACE_BATCH) || defined(__DOXYGEN__)
+/** @brief Trace batching statistics. */
+struct nrf_modem_lib_trace_stats {
+	/** Number of trace bytes received from the modem. */
+	uint32_t bytes_received;
+	/** Number of bytes written to the trace backend, after compression. */
+	uint32_t bytes_written;
+	/** Number of batches written to the trace backend. */
+	uint32_t batches;
+	/** Number of trace bytes waiting to be written to the trace backend. */
+	uint32_t backlog;
+	/** Highest number of trace bytes that have been waiting to be written. */
+	uint32_t backlog_max;
+};
+
+/** @brief Get trace batching statistics.
+ *
+ * @param stats Trace batching statistics.
+ */
+void nrf_modem_lib_trace_stats_get(struct nrf_modem_lib_trace_stats *stats);
+#endif /* defined(CONFIG_NRF_MODEM_LIB_TRACE_BATCH) || defined(__DOXYGEN__) */
+
+#if defined(CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_FLASH) || defined(__DOXYGEN__)
+/** @brief Get the size of the trace data stored in flash.
+ *
+ * @return Number of bytes stored that have not been read.
+ */
+size_t nrf_modem_lib_trace_data_size(void);
+
+/** @brief Read trace data stored in flash.
+ *
+ * The data that is read is removed from the flash storage.
+ *
+ * @param buf Buffer to read the trace data to.
+ * @param len Size of @p buf.
+ *
+ * @return Number of bytes read if the operation was successful.
+ * @retval -ENODATA No trace data is stored.
+ * @retval -EIO Flash read failed.
+ */
+int nrf_modem_lib_trace_read(uint8_t *buf, size_t len);
+
+/** @brief Clear trace data stored in flash.
+ *
+ * @return Zero on success.
+ */
+int nrf_modem_lib_trace_clear(void);
+#endif /* defined(CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_FLASH) || defined(__DOXYGEN__) */
+
 /** @} */
 
 #ifdef __cplusplus
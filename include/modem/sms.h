@@ -40,6 +40,18 @@ enum sms_type {
  */
 #define SMS_MAX_PAYLOAD_LEN_CHARS 160
 
+/**
+ * @brief Maximum length of the payload of a received message in bytes.
+ *
+ * @details When concatenated messages are reassembled, a message can be longer than
+ * a single SMS and UCS2 text is given in UTF-8.
+ */
+#if defined(CONFIG_SMS_CONCAT_REASSEMBLY)
+#define SMS_MAX_PAYLOAD_LEN CONFIG_SMS_CONCAT_MAX_LEN
+#else
+#define SMS_MAX_PAYLOAD_LEN SMS_MAX_PAYLOAD_LEN_CHARS
+#endif
+
 /**
  * @brief Maximum length of SMS address, i.e., phone number, in characters
  * as specified in 3GPP TS 23.040 Section 9.1.2.3.
@@ -78,6 +90,9 @@ struct sms_address {
  * @brief SMS concatenated short message information.
  *
  * @details This is specified in 3GPP TS 23.040 Section 9.2.3.24.1 and 9.2.3.24.8.
+ *
+ * When @kconfig{CONFIG_SMS_CONCAT_REASSEMBLY} is enabled, listeners receive the whole
+ * concatenated message at once, and the sequence number is zero.
  */
 struct sms_udh_concat {
 	/** @brief Indicates whether this field is present in the SMS message. */
@@ -144,13 +159,15 @@ struct sms_data {
 	 *
 	 * @details Reserving enough bytes for maximum number of characters
 	 * but the length of the received payload is in payload_len variable.
+	 * When @kconfig{CONFIG_SMS_CONCAT_REASSEMBLY} is enabled, text in UCS2 is
+	 * given in UTF-8.
 	 *
 	 * Generally the message is of text type in which case you can treat it as string.
 	 * However, header may contain information that determines it for specific purpose,
 	 * e.g., via application port information, in which case it should be treated as
 	 * specified for that purpose.
 	 */
-	uint8_t payload[SMS_MAX_PAYLOAD_LEN_CHARS + 1];
+	uint8_t payload[SMS_MAX_PAYLOAD_LEN + 1];
 };
 
 /** @brief SMS listener callback function. */
@@ -120,6 +120,68 @@ struct download_client_cfg {
 typedef int (*download_client_callback_t)(
 	const struct download_client_evt *event);
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_BUF_LENDING)
+/**
+ * @brief Buffer lent by the application.
+ */
+struct download_client_lent_buf {
+	/** Buffer. */
+	uint8_t *buf;
+	/** Buffer length. */
+	size_t len;
+};
+#endif
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW)
+/** CoAP block size, in bytes. */
+#define DOWNLOAD_CLIENT_COAP_BLOCK_BYTES \
+	(1 << (CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE + 4))
+
+/**
+ * @brief CoAP block requested in windowed mode.
+ */
+struct download_client_coap_block {
+	/** Retransmission state of the request. */
+	struct coap_pending pending;
+	/** Token of the request. */
+	uint8_t token[8];
+	/** Block number. */
+	uint32_t num;
+	/** Payload length, once received. */
+	uint16_t len;
+	/** The block has been requested. */
+	bool busy;
+	/** The block has been received. */
+	bool received;
+	/** Block payload. */
+	uint8_t buf[DOWNLOAD_CLIENT_COAP_BLOCK_BYTES];
+};
+#endif
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PARALLEL)
+/**
+ * @brief Connection downloading a single byte range of the file.
+ */
+struct download_client_range_conn {
+	/** Socket descriptor. */
+	int fd;
+	/** Offset of the first byte of the range. */
+	size_t start;
+	/** Length of the range, zero if no range is assigned. */
+	size_t len;
+	/** Number of payload bytes received. */
+	size_t received;
+	/** Buffer offset. */
+	size_t offset;
+	/** Whether the HTTP header of the response has been processed. */
+	bool has_header;
+	/** The server has closed the connection. */
+	bool connection_close;
+	/** Response buffer. */
+	char buf[CONFIG_DOWNLOAD_CLIENT_BUF_SIZE];
+};
+#endif
+
 /**
  * @brief Download client instance.
  */
@@ -165,8 +227,38 @@ struct download_client {
 
 		/** CoAP pending object. */
 		struct coap_pending pending;
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW)
+		/** Blocks requested or received, but not yet delivered. */
+		struct download_client_coap_block
+			window[CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE];
+#endif
 	} coap;
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PARALLEL)
+	/** Connections downloading the ranges in parallel.
+	 *  The first one uses the socket of the client.
+	 */
+	struct download_client_range_conn
+		range_conn[CONFIG_DOWNLOAD_CLIENT_HTTP_PARALLEL_CONNS];
+	/** The download has been stopped by download_client_disconnect(). */
+	bool range_abort;
+#endif
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_BUF_LENDING)
+	struct {
+		/** Buffers lent by the application, not yet in use. */
+		struct k_msgq queue;
+		/** Storage for the queue of lent buffers. */
+		struct download_client_lent_buf
+			queue_buf[CONFIG_DOWNLOAD_CLIENT_BUF_LENDING_COUNT];
+		/** Buffer receiving the current fragment, if any. */
+		struct download_client_lent_buf cur;
+		/** Whether the application has lent any buffers. */
+		bool active;
+	} lend;
+#endif
+
 	/** Internal thread ID. */
 	k_tid_t tid;
 	/** Internal download thread. */
@@ -228,6 +320,35 @@ int download_client_connect(struct download_client *client, const char *host,
 int download_client_start(struct download_client *client, const char *file,
 			  size_t from);
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_BUF_LENDING)
+/**
+ * @brief Lend a buffer to receive a fragment into.
+ *
+ * Once the application has lent a buffer, every fragment is received
+ * into a buffer lent by the application, and the
+ * @ref DOWNLOAD_CLIENT_EVT_FRAGMENT event points to the beginning of it.
+ * For HTTP, the payload is received from the socket directly into the
+ * buffer. The buffer is handed back to the application with the event,
+ * and must be lent again once the application is done with the fragment.
+ * This can be done from any thread, so that the fragment can be processed,
+ * for example written to flash, while the next one is being downloaded.
+ * If no buffer is available, the download waits until one is lent.
+ *
+ * Lent buffers remain in use by the client across downloads, until they
+ * are handed back with a fragment.
+ *
+ * @param[in] client	Client instance.
+ * @param[in] buf	Buffer. It must be able to hold a whole fragment.
+ * @param[in] len	Buffer length.
+ *
+ * @retval int Zero on success, a negative error code otherwise.
+ *	   -ENOMEM if @kconfig{CONFIG_DOWNLOAD_CLIENT_BUF_LENDING_COUNT}
+ *	   buffers are already lent.
+ */
+int download_client_buf_lend(struct download_client *client, void *buf,
+			     size_t len);
+#endif
+
 /**
  * @brief Pause the download.
  *
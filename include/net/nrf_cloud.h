@@ -957,6 +957,26 @@ bool nrf_cloud_fota_is_type_enabled(const enum nrf_cloud_fota_type type);
  */
 int nrf_cloud_gnss_msg_json_encode(const struct nrf_cloud_gnss_data * const gnss,
 				   cJSON * const gnss_msg_obj);
+
+/**
+ * @brief Encode a cJSON object, such as a device message, as CBOR (RFC 8949).
+ *
+ * The CBOR message has the same structure and keys as the JSON message, so
+ * the functions that build device messages as cJSON objects can be used for
+ * both formats. Objects and arrays are encoded with indefinite length, and
+ * numbers without a fraction are encoded as integers.
+ *
+ * @note The receiving endpoint must be able to decode CBOR messages.
+ *
+ * @param[in]  obj    cJSON object to encode.
+ * @param[out] output Encoded message. The memory is allocated with the cJSON
+ *                    allocator and must be freed with cJSON_free().
+ *
+ * @retval 0 If successful.
+ * @retval -EINVAL The object is invalid or contains raw JSON.
+ * @retval -ENOMEM Out of memory.
+ */
+int nrf_cloud_cbor_encode(const cJSON * const obj, struct nrf_cloud_data * const output);
 /** @} */
 
 #ifdef __cplusplus
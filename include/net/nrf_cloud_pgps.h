@@ -215,7 +215,9 @@ int nrf_cloud_pgps_notify_prediction(void);
  *
  * @return 0..NumPredictions-1 if successful; -ETIMEUNKNOWN if current date and time
  * not known; -ETIMEDOUT if all predictions stored are expired;
- * -EINVAL if prediction for the current time is invalid.
+ * -EINVAL if prediction for the current time is invalid; -EBADMSG if
+ * CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX is enabled and the stored prediction
+ * does not match its index entry.
  */
 int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction);
 
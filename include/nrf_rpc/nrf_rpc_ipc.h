@@ -58,6 +58,9 @@ struct nrf_rpc_ipc {
 
 	/** Indicates if transport is already initialized. */
 	bool used;
+
+	/** Indicates that the IPC Service backend does not provide no-copy Tx buffers. */
+	bool nocopy_unavailable;
 };
 
 /** @brief Extern nRF RPC IPC Service transport declaration.
@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/types.h>
+
+#include <modem/at_parser.h>
+#include "at_utils.h"
+
+static bool is_eol(char chr)
+{
+	return is_lfcr(chr) || is_terminated(chr);
+}
+
+static const char *skip_blanks(const char *str)
+{
+	while (*str == ' ' || *str == '\t') {
+		str++;
+	}
+
+	return str;
+}
+
+static void parser_rewind(struct at_parser *parser)
+{
+	parser->cursor = parser->at;
+	parser->index = 0;
+	parser->eol = false;
+}
+
+/* Tell whether the whole token is a decimal number. */
+static bool is_int(const char *start, size_t len)
+{
+	size_t i = 0;
+
+	if (len && (start[0] == '-' || start[0] == '+')) {
+		i++;
+	}
+
+	if (i == len) {
+		return false;
+	}
+
+	for (; i < len; i++) {
+		if (!isdigit((int)start[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* The first token is the response prefix, for example, "+CEREG",
+ * or the whole line if there is no prefix.
+ */
+static int prefix_tokenize(struct at_parser *parser, struct at_token *token)
+{
+	const char *str = parser->cursor;
+
+	while (is_lfcr(*str) || *str == ' ') {
+		str++;
+	}
+
+	token->type = AT_PARAM_TYPE_STRING;
+	token->start = str;
+
+	if (!is_notification(*str)) {
+		while (!is_eol(*str)) {
+			str++;
+		}
+		token->len = str - token->start;
+		parser->cursor = str;
+		parser->eol = true;
+		return 0;
+	}
+
+	str++;
+	while (is_valid_notification_char(*str) || isdigit((int)*str)) {
+		str++;
+	}
+	token->len = str - token->start;
+
+	if (*str == AT_RSP_SEPARATOR) {
+		str = skip_blanks(str + 1);
+	}
+
+	parser->cursor = str;
+	parser->eol = is_eol(*str);
+
+	return 0;
+}
+
+static int param_tokenize(struct at_parser *parser, struct at_token *token)
+{
+	const char *str = skip_blanks(parser->cursor);
+	const char *end;
+
+	if (is_dblquote(*str)) {
+		token->type = AT_PARAM_TYPE_STRING;
+		token->start = ++str;
+		while (!is_dblquote(*str)) {
+			if (is_terminated(*str)) {
+				return -EBADMSG;
+			}
+			str++;
+		}
+		token->len = str - token->start;
+		str++;
+	} else if (is_array_start(*str)) {
+		token->type = AT_PARAM_TYPE_ARRAY;
+		token->start = ++str;
+		while (!is_array_stop(*str)) {
+			if (is_eol(*str)) {
+				return -EBADMSG;
+			}
+			str++;
+		}
+		token->len = str - token->start;
+		str++;
+	} else {
+		token->start = str;
+		while (*str != AT_PARAM_SEPARATOR && !is_eol(*str)) {
+			str++;
+		}
+		/* Trailing blanks are not part of the parameter. */
+		end = str;
+		while (end > token->start && (end[-1] == ' ' || end[-1] == '\t')) {
+			end--;
+		}
+		token->len = end - token->start;
+
+		if (token->len == 0) {
+			token->type = AT_PARAM_TYPE_EMPTY;
+		} else if (is_int(token->start, token->len)) {
+			token->type = AT_PARAM_TYPE_NUM_INT;
+		} else {
+			token->type = AT_PARAM_TYPE_STRING;
+		}
+	}
+
+	str = skip_blanks(str);
+
+	if (*str == AT_PARAM_SEPARATOR) {
+		str++;
+	} else if (is_eol(*str)) {
+		parser->eol = true;
+	} else {
+		return -EBADMSG;
+	}
+
+	parser->cursor = str;
+
+	return 0;
+}
+
+int at_parser_init(struct at_parser *parser, const char *at)
+{
+	if (parser == NULL || at == NULL) {
+		return -EINVAL;
+	}
+
+	parser->at = at;
+	parser_rewind(parser);
+
+	return 0;
+}
+
+int at_parser_next(struct at_parser *parser, struct at_token *token)
+{
+	int err;
+
+	if (parser == NULL || parser->at == NULL || token == NULL) {
+		return -EINVAL;
+	}
+
+	if (parser->eol) {
+		return -ENODATA;
+	}
+
+	if (parser->index == 0) {
+		err = prefix_tokenize(parser, token);
+	} else {
+		err = param_tokenize(parser, token);
+	}
+
+	if (err) {
+		/* Do not return parameters past a malformed one. */
+		parser->eol = true;
+		return err;
+	}
+
+	parser->index++;
+
+	return 0;
+}
+
+int at_parser_token_get(struct at_parser *parser, size_t index, struct at_token *token)
+{
+	int err;
+
+	if (parser == NULL || parser->at == NULL || token == NULL) {
+		return -EINVAL;
+	}
+
+	if (index < parser->index) {
+		parser_rewind(parser);
+	}
+
+	do {
+		err = at_parser_next(parser, token);
+		if (err) {
+			return err;
+		}
+	} while (parser->index <= index);
+
+	return 0;
+}
+
+int at_parser_count_get(struct at_parser *parser, size_t *count)
+{
+	struct at_parser tmp;
+	struct at_token token;
+	int err;
+
+	if (parser == NULL || parser->at == NULL || count == NULL) {
+		return -EINVAL;
+	}
+
+	/* Count on a copy so as not to move the parser. */
+	tmp = *parser;
+	parser_rewind(&tmp);
+
+	while (!(err = at_parser_next(&tmp, &token))) {
+	}
+
+	if (err != -ENODATA) {
+		return err;
+	}
+
+	*count = tmp.index;
+
+	return 0;
+}
+
+static int num_get(struct at_parser *parser, size_t index, int64_t *value,
+		   int64_t min, int64_t max)
+{
+	struct at_token token;
+	long long val;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = at_parser_token_get(parser, index, &token);
+	if (err) {
+		return -EINVAL;
+	}
+
+	if (token.type != AT_PARAM_TYPE_NUM_INT) {
+		return -EINVAL;
+	}
+
+	/* The token is followed by a non-digit, so it can be converted in place. */
+	errno = 0;
+	val = strtoll(token.start, NULL, 10);
+	if (errno == ERANGE || val < min || val > max) {
+		return -EINVAL;
+	}
+
+	*value = val;
+
+	return 0;
+}
+
+int at_parser_short_get(struct at_parser *parser, size_t index, int16_t *value)
+{
+	int64_t val;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = num_get(parser, index, &val, INT16_MIN, INT16_MAX);
+	if (!err) {
+		*value = (int16_t)val;
+	}
+
+	return err;
+}
+
+int at_parser_unsigned_short_get(struct at_parser *parser, size_t index, uint16_t *value)
+{
+	int64_t val;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = num_get(parser, index, &val, 0, UINT16_MAX);
+	if (!err) {
+		*value = (uint16_t)val;
+	}
+
+	return err;
+}
+
+int at_parser_int_get(struct at_parser *parser, size_t index, int32_t *value)
+{
+	int64_t val;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = num_get(parser, index, &val, INT32_MIN, INT32_MAX);
+	if (!err) {
+		*value = (int32_t)val;
+	}
+
+	return err;
+}
+
+int at_parser_unsigned_int_get(struct at_parser *parser, size_t index, uint32_t *value)
+{
+	int64_t val;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = num_get(parser, index, &val, 0, UINT32_MAX);
+	if (!err) {
+		*value = (uint32_t)val;
+	}
+
+	return err;
+}
+
+int at_parser_int64_get(struct at_parser *parser, size_t index, int64_t *value)
+{
+	return num_get(parser, index, value, INT64_MIN, INT64_MAX);
+}
+
+int at_parser_string_ptr_get(struct at_parser *parser, size_t index,
+			     const char **str, size_t *len)
+{
+	struct at_token token;
+	int err;
+
+	if (str == NULL || len == NULL) {
+		return -EINVAL;
+	}
+
+	err = at_parser_token_get(parser, index, &token);
+	if (err) {
+		return -EINVAL;
+	}
+
+	if (token.type != AT_PARAM_TYPE_STRING && token.type != AT_PARAM_TYPE_NUM_INT) {
+		return -EINVAL;
+	}
+
+	*str = token.start;
+	*len = token.len;
+
+	return 0;
+}
+
+int at_parser_string_get(struct at_parser *parser, size_t index, char *value, size_t *len)
+{
+	const char *str;
+	size_t str_len;
+	int err;
+
+	if (value == NULL || len == NULL) {
+		return -EINVAL;
+	}
+
+	err = at_parser_string_ptr_get(parser, index, &str, &str_len);
+	if (err) {
+		return err;
+	}
+
+	if (*len < str_len) {
+		return -ENOMEM;
+	}
+
+	memcpy(value, str, str_len);
+	*len = str_len;
+
+	return 0;
+}
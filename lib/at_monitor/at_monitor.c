@@ -17,15 +17,44 @@ LOG_MODULE_REGISTER(at_monitor, CONFIG_AT_MONITOR_LOG_LEVEL);
 
 struct at_notif_fifo {
 	void *fifo_reserved;
+	atomic_t refcount; /* Released when zero */
+	uint16_t size; /* Size of this entry in the notification buffer */
 	char data[]; /* Null-terminated AT notification string */
 };
 
+#define NOTIF_BUF_SIZE ROUND_DOWN(CONFIG_AT_MONITOR_HEAP_SIZE, sizeof(void *))
+
 static void at_monitor_task(struct k_work *work);
 
 static K_FIFO_DEFINE(at_monitor_fifo);
-static K_HEAP_DEFINE(at_monitor_heap, CONFIG_AT_MONITOR_HEAP_SIZE);
 static K_WORK_DEFINE(at_monitor_work, at_monitor_task);
 
+/* Notifications are stored in order in a ring buffer, and are dispatched in order.
+ * Each notification is stored once, and freed when its reference count drops to zero.
+ * The space of the oldest notifications is reclaimed once they have been freed.
+ * Unlike a heap, the ring buffer does not fragment.
+ */
+static struct {
+	uint8_t buf[NOTIF_BUF_SIZE] __aligned(sizeof(void *));
+	/* Offset of the next entry */
+	size_t head;
+	/* Offset of the oldest entry */
+	size_t tail;
+	/* End of the entries, when the entries have wrapped around */
+	size_t end;
+	/* Bytes in use, including the unused space before the end when wrapped */
+	size_t used;
+	/* Last entry queued and not yet dispatched */
+	struct at_notif_fifo *last;
+	struct k_spinlock lock;
+} notif_buf = {
+	.end = NOTIF_BUF_SIZE,
+};
+
+#if defined(CONFIG_AT_MONITOR_STATS)
+static struct at_monitor_stats stats;
+#endif
+
 static bool is_paused(const struct at_monitor_entry *mon)
 {
 	return mon->flags.paused;
@@ -41,6 +70,281 @@ static bool has_match(const struct at_monitor_entry *mon, const char *notif)
 	return (mon->filter == ANY || strstr(notif, mon->filter));
 }
 
+#if defined(CONFIG_AT_MONITOR_FILTER_INDEX)
+#define INDEX_BUCKETS CONFIG_AT_MONITOR_FILTER_INDEX_BUCKETS
+/* Number of characters hashed to select the bucket */
+#define INDEX_KEY_LEN 4
+
+BUILD_ASSERT((INDEX_BUCKETS & (INDEX_BUCKETS - 1)) == 0,
+	     "CONFIG_AT_MONITOR_FILTER_INDEX_BUCKETS must be a power of two");
+
+/* Monitors with an indexed filter, by bucket, in section order */
+static struct at_monitor_entry *index_bucket[INDEX_BUCKETS];
+/* Monitors with any other filter, in section order */
+static struct at_monitor_entry *index_others;
+
+static bool is_indexable(const char *str)
+{
+	return (str[0] == '+' || str[0] == '%') &&
+	       (strnlen(str, INDEX_KEY_LEN) == INDEX_KEY_LEN);
+}
+
+static uint32_t index_hash(const char *str)
+{
+	uint32_t hash = 0;
+
+	for (size_t i = 0; i < INDEX_KEY_LEN; i++) {
+		hash = hash * 31 + (uint8_t)str[i];
+	}
+
+	return hash & (INDEX_BUCKETS - 1);
+}
+
+static void index_build(void)
+{
+	uint32_t bucket;
+	struct at_monitor_entry **others_tail = &index_others;
+	struct at_monitor_entry **bucket_tail[INDEX_BUCKETS];
+
+	for (size_t i = 0; i < INDEX_BUCKETS; i++) {
+		bucket_tail[i] = &index_bucket[i];
+	}
+
+	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
+		e->next = NULL;
+
+		if (e->filter != ANY && is_indexable(e->filter)) {
+			bucket = index_hash(e->filter);
+			*bucket_tail[bucket] = e;
+			bucket_tail[bucket] = &e->next;
+		} else {
+			*others_tail = e;
+			others_tail = &e->next;
+		}
+	}
+}
+
+/* Collect the buckets of the indexed filters that can be found in the notification.
+ * An indexed filter can only be found where the notification has a '+' or a '%'
+ * followed by the hashed characters of the filter.
+ * Returns the number of buckets, each of them is collected once.
+ */
+static size_t index_lookup(const char *notif, struct at_monitor_entry **lists)
+{
+	uint64_t collected = 0;
+	uint32_t bucket;
+	size_t cnt = 0;
+
+	for (const char *p = strpbrk(notif, "+%"); p; p = strpbrk(p + 1, "+%")) {
+		if (!is_indexable(p)) {
+			continue;
+		}
+
+		bucket = index_hash(p);
+		if (!(collected & BIT64(bucket)) && index_bucket[bucket]) {
+			collected |= BIT64(bucket);
+			lists[cnt++] = index_bucket[bucket];
+		}
+	}
+
+	return cnt;
+}
+
+/* Take the first monitor of all the lists, in section order. */
+static struct at_monitor_entry *lists_pop(struct at_monitor_entry **lists, size_t cnt)
+{
+	size_t first = 0;
+	struct at_monitor_entry *e;
+
+	for (size_t i = 1; i < cnt; i++) {
+		if (!lists[first] || (lists[i] && lists[i] < lists[first])) {
+			first = i;
+		}
+	}
+
+	e = lists[first];
+	if (e) {
+		lists[first] = e->next;
+	}
+
+	return e;
+}
+#endif /* CONFIG_AT_MONITOR_FILTER_INDEX */
+
+/* Dispatch the notification to the monitor, if it is dispatched in this context.
+ * Returns true if the monitor is dispatched from the workqueue instead.
+ */
+static bool monitor_dispatch(struct at_monitor_entry *mon, const char *notif, bool in_isr)
+{
+	if (is_paused(mon)) {
+		return false;
+	}
+
+	if (is_direct(mon) != in_isr) {
+		return in_isr;
+	}
+
+	LOG_DBG("Dispatching to %p%s", mon->handler, in_isr ? " (ISR)" : "");
+#if defined(CONFIG_AT_MONITOR_STATS)
+	mon->matches++;
+#endif
+	mon->handler(notif);
+
+	return false;
+}
+
+/* Dispatch the notification to all matching monitors, in section order.
+ * Returns true if any matching monitor is dispatched from the workqueue.
+ */
+static bool matches_dispatch(const char *notif, bool in_isr)
+{
+	bool deferred = false;
+
+#if defined(CONFIG_AT_MONITOR_FILTER_INDEX)
+	struct at_monitor_entry *e;
+	struct at_monitor_entry *lists[INDEX_BUCKETS + 1];
+	size_t cnt;
+
+	/* The index only skips the monitors that cannot match, the filters are matched
+	 * the same way as without the index.
+	 */
+	lists[0] = index_others;
+	cnt = 1 + index_lookup(notif, &lists[1]);
+
+	/* Merge the lists, to keep the order in which monitors are dispatched */
+	while ((e = lists_pop(lists, cnt))) {
+		if (has_match(e, notif)) {
+			deferred |= monitor_dispatch(e, notif, in_isr);
+		}
+	}
+#else
+	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
+		if (has_match(e, notif)) {
+			deferred |= monitor_dispatch(e, notif, in_isr);
+		}
+	}
+#endif
+
+	return deferred;
+}
+
+/* Allocate an entry at the head of the ring buffer, with a reference count of one.
+ * Returns NULL if there is no contiguous space for it. Called with the lock held.
+ */
+static struct at_notif_fifo *notif_alloc(size_t size)
+{
+	struct at_notif_fifo *at_notif = NULL;
+
+	if (notif_buf.used == 0) {
+		/* Start over to make the most of the contiguous space. */
+		notif_buf.head = 0;
+		notif_buf.tail = 0;
+		notif_buf.end = NOTIF_BUF_SIZE;
+	}
+
+	if (notif_buf.head > notif_buf.tail || notif_buf.used == 0) {
+		/* Free space is after the head and before the tail. */
+		if (NOTIF_BUF_SIZE - notif_buf.head < size) {
+			if (notif_buf.tail < size) {
+				return NULL;
+			}
+			/* Wrap around. */
+			notif_buf.end = notif_buf.head;
+			notif_buf.used += NOTIF_BUF_SIZE - notif_buf.head;
+			notif_buf.head = 0;
+		}
+	} else if (notif_buf.tail - notif_buf.head < size) {
+		/* Free space is between the head and the tail. */
+		return NULL;
+	}
+
+	at_notif = (struct at_notif_fifo *)&notif_buf.buf[notif_buf.head];
+	at_notif->size = size;
+	atomic_set(&at_notif->refcount, 1);
+
+	notif_buf.head += size;
+	notif_buf.used += size;
+
+#if defined(CONFIG_AT_MONITOR_STATS)
+	stats.buf_used_max = MAX(stats.buf_used_max, notif_buf.used);
+#endif
+
+	return at_notif;
+}
+
+static void notif_buf_reclaim(void)
+{
+	struct at_notif_fifo *at_notif;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&notif_buf.lock);
+
+	while (notif_buf.used) {
+		if (notif_buf.tail == notif_buf.end) {
+			notif_buf.used -= NOTIF_BUF_SIZE - notif_buf.end;
+			notif_buf.tail = 0;
+			notif_buf.end = NOTIF_BUF_SIZE;
+			continue;
+		}
+
+		at_notif = (struct at_notif_fifo *)&notif_buf.buf[notif_buf.tail];
+		if (atomic_get(&at_notif->refcount)) {
+			break;
+		}
+
+		notif_buf.tail += at_notif->size;
+		notif_buf.used -= at_notif->size;
+	}
+
+	k_spin_unlock(&notif_buf.lock, key);
+}
+
+static bool is_duplicate(const char *notif)
+{
+	return IS_ENABLED(CONFIG_AT_MONITOR_COALESCE) &&
+	       notif_buf.last && !strcmp(notif_buf.last->data, notif);
+}
+
+static void notif_release(const char *notif)
+{
+	struct at_notif_fifo *at_notif = CONTAINER_OF(notif, struct at_notif_fifo, data);
+
+	__ASSERT_NO_MSG(atomic_get(&at_notif->refcount) > 0);
+
+	if (atomic_dec(&at_notif->refcount) == 1) {
+		notif_buf_reclaim();
+	}
+}
+
+#if defined(CONFIG_AT_MONITOR_NOTIF_HOLD)
+void at_monitor_notif_hold(const char *notif)
+{
+	struct at_notif_fifo *at_notif = CONTAINER_OF(notif, struct at_notif_fifo, data);
+
+	__ASSERT_NO_MSG(atomic_get(&at_notif->refcount) > 0);
+
+	atomic_inc(&at_notif->refcount);
+}
+
+void at_monitor_notif_release(const char *notif)
+{
+	notif_release(notif);
+}
+#endif /* CONFIG_AT_MONITOR_NOTIF_HOLD */
+
+#if defined(CONFIG_AT_MONITOR_STATS)
+void at_monitor_stats_get(struct at_monitor_stats *out)
+{
+	k_spinlock_key_t key;
+
+	__ASSERT_NO_MSG(out != NULL);
+
+	key = k_spin_lock(&notif_buf.lock);
+	*out = stats;
+	k_spin_unlock(&notif_buf.lock, key);
+}
+#endif
+
 /* Dispatch AT notifications immediately, or schedules a workqueue task to do that.
  * Keep this function public so that it can be called by tests.
  * This function is called from an ISR.
@@ -50,56 +354,77 @@ void at_monitor_dispatch(const char *notif)
 	bool monitored;
 	struct at_notif_fifo *at_notif;
 	size_t sz_needed;
+	k_spinlock_key_t key;
 
 	__ASSERT_NO_MSG(notif != NULL);
 
-	monitored = false;
-	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
-		if (!is_paused(e) && has_match(e, notif)) {
-			if (is_direct(e)) {
-				LOG_DBG("Dispatching to %p (ISR)", e->handler);
-				e->handler(notif);
-			} else {
-				/* Copy and schedule work-queue task */
-				monitored = true;
-			}
-		}
-	}
-
+	monitored = matches_dispatch(notif, true);
 	if (!monitored) {
-		/* Only copy monitored notifications to save heap */
+		/* Only copy monitored notifications to save space */
 		return;
 	}
 
-	sz_needed = sizeof(struct at_notif_fifo) + strlen(notif) + sizeof(char);
+	sz_needed = ROUND_UP(sizeof(struct at_notif_fifo) + strlen(notif) + sizeof(char),
+			     sizeof(void *));
+
+	key = k_spin_lock(&notif_buf.lock);
 
-	at_notif = k_heap_alloc(&at_monitor_heap, sz_needed, K_NO_WAIT);
+	if (is_duplicate(notif)) {
+#if defined(CONFIG_AT_MONITOR_STATS)
+		stats.coalesced++;
+#endif
+		k_spin_unlock(&notif_buf.lock, key);
+		LOG_DBG("Coalesced duplicate notification");
+		return;
+	}
+
+	at_notif = notif_alloc(sz_needed);
 	if (!at_notif) {
-		LOG_WRN("No heap space for incoming notification: %s",
-			notif);
+#if defined(CONFIG_AT_MONITOR_STATS)
+		stats.drops++;
+#endif
+		k_spin_unlock(&notif_buf.lock, key);
+		LOG_WRN("No space for incoming notification: %s", notif);
 		return;
 	}
 
 	strcpy(at_notif->data, notif);
+	notif_buf.last = at_notif;
 
 	k_fifo_put(&at_monitor_fifo, at_notif);
+
+	k_spin_unlock(&notif_buf.lock, key);
+
 	k_work_submit(&at_monitor_work);
 }
 
+static struct at_notif_fifo *notif_get(void)
+{
+	struct at_notif_fifo *at_notif;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&notif_buf.lock);
+
+	at_notif = k_fifo_get(&at_monitor_fifo, K_NO_WAIT);
+	if (at_notif == notif_buf.last) {
+		/* Do not coalesce with a notification being dispatched. */
+		notif_buf.last = NULL;
+	}
+
+	k_spin_unlock(&notif_buf.lock, key);
+
+	return at_notif;
+}
+
 static void at_monitor_task(struct k_work *work)
 {
 	struct at_notif_fifo *at_notif;
 
-	while ((at_notif = k_fifo_get(&at_monitor_fifo, K_NO_WAIT))) {
+	while ((at_notif = notif_get())) {
 		/* Match notification with all monitors */
 		LOG_DBG("AT notif: %.*s", strlen(at_notif->data) - strlen("\r\n"), at_notif->data);
-		STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
-			if (!is_paused(e) && !is_direct(e) && has_match(e, at_notif->data)) {
-				LOG_DBG("Dispatching to %p", e->handler);
-				e->handler(at_notif->data);
-			}
-		}
-		k_heap_free(&at_monitor_heap, at_notif);
+		(void)matches_dispatch(at_notif->data, false);
+		notif_release(at_notif->data);
 	}
 }
 
@@ -107,6 +432,10 @@ static int at_monitor_sys_init(const struct device *unused)
 {
 	int err;
 
+#if defined(CONFIG_AT_MONITOR_FILTER_INDEX)
+	index_build();
+#endif
+
 	err = nrf_modem_at_notif_handler_set(at_monitor_dispatch);
 	if (err) {
 		LOG_ERR("Failed to hook the dispatch function, err %d", err);
@@ -21,6 +21,7 @@
 #include <zephyr/logging/log.h>
 
 #include "lte_lc_helpers.h"
+#include "lte_lc_state_cache.h"
 
 LOG_MODULE_REGISTER(lte_lc, CONFIG_LTE_LINK_CONTROL_LOG_LEVEL);
 
@@ -125,6 +126,11 @@ static const char system_mode_preference[] = {
 
 static struct k_sem link;
 
+/* Set when +CEREG notifications are subscribed to, so that the state derived
+ * from them is kept up to date by the notification handler.
+ */
+static bool cereg_notif_enabled;
+
 static bool is_cellid_valid(uint32_t cellid)
 {
 	if (cellid == LTE_LC_CELL_EUTRAN_ID_INVALID) {
@@ -208,6 +214,12 @@ static void at_handler_cereg(const char *response)
 		break;
 	}
 
+	lte_lc_state_cache_set(LTE_LC_STATE_CACHE_NW_REG_STATUS, &reg_status, sizeof(reg_status));
+	lte_lc_state_cache_set(LTE_LC_STATE_CACHE_LTE_MODE, &lte_mode, sizeof(lte_mode));
+
+	/* Changes to the PSM configuration are reported with +CEREG. */
+	lte_lc_state_cache_invalidate(LTE_LC_STATE_CACHE_PSM);
+
 	if (event_handler_list_is_empty()) {
 		return;
 	}
@@ -326,6 +338,9 @@ static void at_handler_xt3412(const char *response)
 		return;
 	}
 
+	/* The network may update the PSM configuration in the coming TAU. */
+	lte_lc_state_cache_invalidate(LTE_LC_STATE_CACHE_PSM);
+
 	if (evt.time != CONFIG_LTE_LC_TAU_PRE_WARNING_TIME_MS) {
 		/* Only propagate TAU pre-warning notifications when the received time
 		 * parameter is the duration of the set pre-warning time.
@@ -501,6 +516,11 @@ static void at_handler_mdmev(const char *response)
 		return;
 	}
 
+	if (evt.modem_evt == LTE_LC_MODEM_EVT_RESET_LOOP) {
+		/* The modem has been reset, the cached state is no longer valid. */
+		lte_lc_state_cache_invalidate_all();
+	}
+
 	evt.type = LTE_LC_EVT_MODEM_EVENT;
 
 	event_handler_list_dispatch(&evt);
@@ -517,6 +537,15 @@ static int enable_notifications(void)
 		return -EFAULT;
 	}
 
+	cereg_notif_enabled = true;
+
+	/* Values cached before the subscription may be stale, the notifications
+	 * keep them up to date from now on.
+	 */
+	lte_lc_state_cache_invalidate(LTE_LC_STATE_CACHE_NW_REG_STATUS);
+	lte_lc_state_cache_invalidate(LTE_LC_STATE_CACHE_LTE_MODE);
+	lte_lc_state_cache_invalidate(LTE_LC_STATE_CACHE_PSM);
+
 	if (IS_ENABLED(CONFIG_LTE_LC_TAU_PRE_WARNING_NOTIFICATIONS)) {
 		err = nrf_modem_at_printf(AT_XT3412_SUB,
 					  CONFIG_LTE_LC_TAU_PRE_WARNING_TIME_MS,
@@ -799,6 +828,10 @@ int lte_lc_init_and_connect_async(lte_lc_evt_handler_t handler)
 
 int lte_lc_deinit(void)
 {
+	/* Notification subscriptions are lost when the modem is shut down. */
+	cereg_notif_enabled = false;
+	lte_lc_state_cache_invalidate_all();
+
 	if (is_initialized) {
 		is_initialized = false;
 
@@ -893,6 +926,13 @@ int lte_lc_psm_get(int *tau, int *active_time)
 		return -EINVAL;
 	}
 
+	if (lte_lc_state_cache_get(LTE_LC_STATE_CACHE_PSM, &psm_cfg, sizeof(psm_cfg)) == 0) {
+		*tau = psm_cfg.tau;
+		*active_time = psm_cfg.active_time;
+
+		return 0;
+	}
+
 	/* Format of XMONITOR AT command response:
 	 * %XMONITOR: <reg_status>,[<full_name>,<short_name>,<plmn>,<tac>,<AcT>,<band>,<cell_id>,
 	 * <phys_cell_id>,<EARFCN>,<rsrp>,<snr>,<NW-provided_eDRX_value>,<Active-Time>,
@@ -965,6 +1005,10 @@ int lte_lc_psm_get(int *tau, int *active_time)
 	*tau = psm_cfg.tau;
 	*active_time = psm_cfg.active_time;
 
+	if (cereg_notif_enabled) {
+		lte_lc_state_cache_set(LTE_LC_STATE_CACHE_PSM, &psm_cfg, sizeof(psm_cfg));
+	}
+
 	LOG_DBG("TAU: %d sec, active time: %d sec", *tau, *active_time);
 
 	return 0;
@@ -1141,6 +1185,11 @@ int lte_lc_nw_reg_status_get(enum lte_lc_nw_reg_status *status)
 		return -EINVAL;
 	}
 
+	if (lte_lc_state_cache_get(LTE_LC_STATE_CACHE_NW_REG_STATUS, status,
+				   sizeof(*status)) == 0) {
+		return 0;
+	}
+
 	/* Read network registration status */
 	err = nrf_modem_at_scanf("AT+CEREG?",
 		"+CEREG: "
@@ -1318,6 +1367,10 @@ int lte_lc_func_mode_get(enum lte_lc_func_mode *mode)
 		return -EINVAL;
 	}
 
+	if (lte_lc_state_cache_get(LTE_LC_STATE_CACHE_FUNC_MODE, mode, sizeof(*mode)) == 0) {
+		return 0;
+	}
+
 	/* Exactly one parameter is expected to match. */
 	err = nrf_modem_at_scanf(AT_CFUN_READ, "+CFUN: %hu", &mode_tmp);
 	if (err != 1) {
@@ -1327,6 +1380,8 @@ int lte_lc_func_mode_get(enum lte_lc_func_mode *mode)
 
 	*mode = mode_tmp;
 
+	lte_lc_state_cache_set(LTE_LC_STATE_CACHE_FUNC_MODE, mode, sizeof(*mode));
+
 	return 0;
 }
 
@@ -1387,6 +1442,11 @@ int lte_lc_func_mode_set(enum lte_lc_func_mode mode)
 		return -EINVAL;
 	}
 
+	/* The network state changes with the functional mode, and some modes
+	 * are read back as a different mode. Read it all from the modem again.
+	 */
+	lte_lc_state_cache_invalidate_all();
+
 	err = nrf_modem_at_printf("AT+CFUN=%d", mode);
 	if (err) {
 		LOG_ERR("Failed to set functional mode. Please check XSYSTEMMODE.");
@@ -1410,6 +1470,10 @@ int lte_lc_lte_mode_get(enum lte_lc_lte_mode *mode)
 		return -EINVAL;
 	}
 
+	if (lte_lc_state_cache_get(LTE_LC_STATE_CACHE_LTE_MODE, mode, sizeof(*mode)) == 0) {
+		return 0;
+	}
+
 	err = nrf_modem_at_scanf(AT_CEREG_READ,
 		"+CEREG: "
 		"%*u,"		/* <n> */
@@ -52,10 +52,40 @@ static int cmd_offline(const struct shell *shell, size_t argc, char **argv)
 	return 0;
 }
 
+#if defined(CONFIG_LTE_LC_STATE_CACHE)
+static int cmd_cache(const struct shell *shell, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	static const char *const names[] = {
+		[LTE_LC_STATE_CACHE_NW_REG_STATUS] = "nw_reg_status",
+		[LTE_LC_STATE_CACHE_LTE_MODE] = "lte_mode",
+		[LTE_LC_STATE_CACHE_PSM] = "psm",
+		[LTE_LC_STATE_CACHE_FUNC_MODE] = "func_mode",
+	};
+	struct lte_lc_state_cache_stats stats;
+
+	(void)lte_lc_state_cache_stats_get(&stats);
+
+	for (size_t i = 0; i < LTE_LC_STATE_CACHE_FIELD_COUNT; i++) {
+		uint32_t total = stats.hits[i] + stats.misses[i];
+
+		shell_print(shell, "%-14s hits %u, misses %u, hit rate %u%%", names[i],
+			    stats.hits[i], stats.misses[i],
+			    total ? (uint32_t)((uint64_t)stats.hits[i] * 100 / total) : 0);
+	}
+
+	return 0;
+}
+#endif
+
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_lte,
 	SHELL_CMD(normal, NULL, "Send the modem to normal mode", cmd_normal),
 	SHELL_CMD(offline, NULL, "Send the modem to offline mode", cmd_offline),
 	SHELL_CMD(power_off, NULL, "Send the modem to power off mode", cmd_power_off),
+	SHELL_COND_CMD(CONFIG_LTE_LC_STATE_CACHE, cache, NULL, "Print state cache hit rates",
+		       cmd_cache),
 	SHELL_SUBCMD_SET_END /* Array terminated. */
 );
 
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <modem/lte_lc.h>
+
+#include "lte_lc_state_cache.h"
+
+/* Largest cached value. */
+#define VALUE_SIZE_MAX sizeof(struct lte_lc_psm_cfg)
+
+static struct cache_entry {
+	bool valid;
+	int64_t updated;
+	uint8_t value[VALUE_SIZE_MAX];
+} entries[LTE_LC_STATE_CACHE_FIELD_COUNT];
+
+/* Maximum age of a cached value in milliseconds, zero for no limit. */
+static const uint32_t max_age[LTE_LC_STATE_CACHE_FIELD_COUNT] = {
+	[LTE_LC_STATE_CACHE_NW_REG_STATUS] = CONFIG_LTE_LC_STATE_CACHE_NW_REG_MAX_AGE_MS,
+	[LTE_LC_STATE_CACHE_LTE_MODE] = CONFIG_LTE_LC_STATE_CACHE_NW_REG_MAX_AGE_MS,
+	[LTE_LC_STATE_CACHE_PSM] = CONFIG_LTE_LC_STATE_CACHE_PSM_MAX_AGE_MS,
+	[LTE_LC_STATE_CACHE_FUNC_MODE] = CONFIG_LTE_LC_STATE_CACHE_FUNC_MODE_MAX_AGE_MS,
+};
+
+static struct lte_lc_state_cache_stats stats;
+
+static struct k_spinlock lock;
+
+static bool is_fresh(enum lte_lc_state_cache_field field)
+{
+	if (!entries[field].valid) {
+		return false;
+	}
+
+	if (max_age[field] == 0) {
+		return true;
+	}
+
+	return (k_uptime_get() - entries[field].updated) <= max_age[field];
+}
+
+int lte_lc_state_cache_get(enum lte_lc_state_cache_field field, void *value, size_t len)
+{
+	int err = 0;
+	k_spinlock_key_t key;
+
+	__ASSERT_NO_MSG(field < LTE_LC_STATE_CACHE_FIELD_COUNT);
+	__ASSERT_NO_MSG(len <= VALUE_SIZE_MAX);
+
+	key = k_spin_lock(&lock);
+
+	if (is_fresh(field)) {
+		memcpy(value, entries[field].value, len);
+		stats.hits[field]++;
+	} else {
+		stats.misses[field]++;
+		err = -ENODATA;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return err;
+}
+
+void lte_lc_state_cache_set(enum lte_lc_state_cache_field field, const void *value, size_t len)
+{
+	k_spinlock_key_t key;
+
+	__ASSERT_NO_MSG(field < LTE_LC_STATE_CACHE_FIELD_COUNT);
+	__ASSERT_NO_MSG(len <= VALUE_SIZE_MAX);
+
+	key = k_spin_lock(&lock);
+
+	memcpy(entries[field].value, value, len);
+	entries[field].updated = k_uptime_get();
+	entries[field].valid = true;
+
+	k_spin_unlock(&lock, key);
+}
+
+void lte_lc_state_cache_invalidate(enum lte_lc_state_cache_field field)
+{
+	k_spinlock_key_t key;
+
+	__ASSERT_NO_MSG(field < LTE_LC_STATE_CACHE_FIELD_COUNT);
+
+	key = k_spin_lock(&lock);
+	entries[field].valid = false;
+	k_spin_unlock(&lock, key);
+}
+
+void lte_lc_state_cache_invalidate_all(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+		entries[i].valid = false;
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+int lte_lc_state_cache_stats_get(struct lte_lc_state_cache_stats *out)
+{
+	k_spinlock_key_t key;
+
+	if (out == NULL) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+	memcpy(out, &stats, sizeof(stats));
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef LTE_LC_STATE_CACHE_H__
+#define LTE_LC_STATE_CACHE_H__
+
+#include <stddef.h>
+#include <errno.h>
+#include <modem/lte_lc.h>
+
+#if defined(CONFIG_LTE_LC_STATE_CACHE)
+
+/* Copy a fresh cached value of a field into @value.
+ * Returns 0 on a cache hit, -ENODATA if the field has no value or the value
+ * is older than the maximum age of the field.
+ */
+int lte_lc_state_cache_get(enum lte_lc_state_cache_field field, void *value, size_t len);
+
+/* Store a value of a field, read from a notification or an AT response. */
+void lte_lc_state_cache_set(enum lte_lc_state_cache_field field, const void *value, size_t len);
+
+void lte_lc_state_cache_invalidate(enum lte_lc_state_cache_field field);
+
+void lte_lc_state_cache_invalidate_all(void);
+
+#else
+
+static inline int lte_lc_state_cache_get(enum lte_lc_state_cache_field field, void *value,
+					 size_t len)
+{
+	return -ENODATA;
+}
+
+static inline void lte_lc_state_cache_set(enum lte_lc_state_cache_field field,
+					  const void *value, size_t len)
+{
+}
+
+static inline void lte_lc_state_cache_invalidate(enum lte_lc_state_cache_field field)
+{
+}
+
+static inline void lte_lc_state_cache_invalidate_all(void)
+{
+}
+
+#endif /* CONFIG_LTE_LC_STATE_CACHE */
+
+#endif /* LTE_LC_STATE_CACHE_H__ */
@@ -6,7 +6,7 @@
 
 #include <nrf_modem_at.h>
 #include <modem/at_monitor.h>
-#include <modem/at_cmd_parser.h>
+#include <modem/at_parser.h>
 #include <ctype.h>
 #include <zephyr/device.h>
 #include <errno.h>
@@ -73,62 +73,28 @@ LOG_MODULE_REGISTER(modem_info);
 #define IP_ADDR_SEPARATOR_LEN (sizeof(IP_ADDR_SEPARATOR)-1)
 
 #define RSRP_NOTIFY_PARAM_INDEX	1
-#define RSRP_NOTIFY_PARAM_COUNT	5
-
 #define RSRP_PARAM_INDEX	6
-#define RSRP_PARAM_COUNT	7
-
 #define BAND_PARAM_INDEX	1 /* Index of desired parameter */
-#define BAND_PARAM_COUNT	2 /* Number of parameters */
-
 #define MODE_PARAM_INDEX	1
-#define MODE_PARAM_COUNT	2
-
 #define OPERATOR_PARAM_INDEX	3
-#define OPERATOR_PARAM_COUNT	5
-
 #define CELLID_PARAM_INDEX	4
-#define CELLID_PARAM_COUNT	10
-
 #define AREA_CODE_PARAM_INDEX	3
-#define AREA_CODE_PARAM_COUNT	10
-
 #define IP_ADDRESS_PARAM_INDEX	4
-#define IP_ADDRESS_PARAM_COUNT	7
-
 #define UICC_PARAM_INDEX	1
-#define UICC_PARAM_COUNT	2
-
 #define VBAT_PARAM_INDEX	1
-#define VBAT_PARAM_COUNT	2
-
 #define TEMP_PARAM_INDEX	1
-#define TEMP_PARAM_COUNT	2
-
 #define MODEM_FW_PARAM_INDEX	0
-#define MODEM_FW_PARAM_COUNT	1
-
 #define ICCID_PARAM_INDEX	3
-#define ICCID_PARAM_COUNT	4
 #define ICCID_LEN		20
 #define ICCID_PAD_CHAR		'F'
 
 #define LTE_MODE_PARAM_INDEX	1
 #define NBIOT_MODE_PARAM_INDEX	2
 #define GPS_MODE_PARAM_INDEX	3
-#define SYSTEMMODE_PARAM_COUNT	5
-
 #define IMSI_PARAM_INDEX	0
-#define IMSI_PARAM_COUNT	1
-
 #define MODEM_IMEI_PARAM_INDEX	0
-#define MODEM_IMEI_PARAM_COUNT  1
-
 #define DATE_TIME_PARAM_INDEX	1
-#define DATE_TIME_PARAM_COUNT	2
-
 #define APN_PARAM_INDEX		3
-#define APN_PARAM_COUNT		7
 
 #define CELL_RSRP_INVALID	255
 
@@ -145,7 +111,6 @@ struct modem_info_data {
 	const char *cmd;
 	const char *data_name;
 	uint8_t param_index;
-	uint8_t param_count;
 	enum at_param_type data_type;
 };
 
@@ -153,7 +118,6 @@ static const struct modem_info_data rsrp_data = {
 	.cmd		= AT_CMD_CESQ,
 	.data_name	= RSRP_DATA_NAME,
 	.param_index	= RSRP_PARAM_INDEX,
-	.param_count	= RSRP_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -161,7 +125,6 @@ static const struct modem_info_data band_data = {
 	.cmd		= AT_CMD_CURRENT_BAND,
 	.data_name	= CUR_BAND_DATA_NAME,
 	.param_index	= BAND_PARAM_INDEX,
-	.param_count	= BAND_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -169,7 +132,6 @@ static const struct modem_info_data band_sup_data = {
 	.cmd		= AT_CMD_SUPPORTED_BAND,
 	.data_name	= SUP_BAND_DATA_NAME,
 	.param_index	= BAND_PARAM_INDEX,
-	.param_count	= BAND_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -177,7 +139,6 @@ static const struct modem_info_data mode_data = {
 	.cmd		= AT_CMD_CURRENT_MODE,
 	.data_name	= UE_MODE_DATA_NAME,
 	.param_index	= MODE_PARAM_INDEX,
-	.param_count	= MODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -185,7 +146,6 @@ static const struct modem_info_data operator_data = {
 	.cmd		= AT_CMD_CURRENT_OP,
 	.data_name	= OPERATOR_DATA_NAME,
 	.param_index	= OPERATOR_PARAM_INDEX,
-	.param_count	= OPERATOR_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -193,7 +153,6 @@ static const struct modem_info_data mcc_data = {
 	.cmd		= AT_CMD_CURRENT_OP,
 	.data_name	= MCC_DATA_NAME,
 	.param_index	= OPERATOR_PARAM_INDEX,
-	.param_count	= OPERATOR_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -201,7 +160,6 @@ static const struct modem_info_data mnc_data = {
 	.cmd		= AT_CMD_CURRENT_OP,
 	.data_name	= MNC_DATA_NAME,
 	.param_index	= OPERATOR_PARAM_INDEX,
-	.param_count	= OPERATOR_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -209,7 +167,6 @@ static const struct modem_info_data cellid_data = {
 	.cmd		= AT_CMD_NETWORK_STATUS,
 	.data_name	= CELLID_DATA_NAME,
 	.param_index	= CELLID_PARAM_INDEX,
-	.param_count	= CELLID_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -217,7 +174,6 @@ static const struct modem_info_data area_data = {
 	.cmd		= AT_CMD_NETWORK_STATUS,
 	.data_name	= AREA_CODE_DATA_NAME,
 	.param_index	= AREA_CODE_PARAM_INDEX,
-	.param_count	= AREA_CODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -225,7 +181,6 @@ static const struct modem_info_data ip_data = {
 	.cmd		= AT_CMD_PDP_CONTEXT,
 	.data_name	= IP_ADDRESS_DATA_NAME,
 	.param_index	= IP_ADDRESS_PARAM_INDEX,
-	.param_count	= IP_ADDRESS_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -233,7 +188,6 @@ static const struct modem_info_data uicc_data = {
 	.cmd		= AT_CMD_UICC_STATE,
 	.data_name	= UICC_DATA_NAME,
 	.param_index	= UICC_PARAM_INDEX,
-	.param_count	= UICC_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -241,7 +195,6 @@ static const struct modem_info_data battery_data = {
 	.cmd		= AT_CMD_VBAT,
 	.data_name	= BATTERY_DATA_NAME,
 	.param_index	= VBAT_PARAM_INDEX,
-	.param_count	= VBAT_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -249,7 +202,6 @@ static const struct modem_info_data temp_data = {
 	.cmd		= AT_CMD_TEMP,
 	.data_name	= TEMPERATURE_DATA_NAME,
 	.param_index	= TEMP_PARAM_INDEX,
-	.param_count	= TEMP_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -257,7 +209,6 @@ static const struct modem_info_data fw_data = {
 	.cmd		= AT_CMD_FW_VERSION,
 	.data_name	= MODEM_FW_DATA_NAME,
 	.param_index	= MODEM_FW_PARAM_INDEX,
-	.param_count	= MODEM_FW_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -265,7 +216,6 @@ static const struct modem_info_data iccid_data = {
 	.cmd		= AT_CMD_ICCID,
 	.data_name	= ICCID_DATA_NAME,
 	.param_index	= ICCID_PARAM_INDEX,
-	.param_count	= ICCID_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -273,7 +223,6 @@ static const struct modem_info_data lte_mode_data = {
 	.cmd		= AT_CMD_SYSTEMMODE,
 	.data_name	= LTE_MODE_DATA_NAME,
 	.param_index	= LTE_MODE_PARAM_INDEX,
-	.param_count	= SYSTEMMODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -281,7 +230,6 @@ static const struct modem_info_data nbiot_mode_data = {
 	.cmd		= AT_CMD_SYSTEMMODE,
 	.data_name	= NBIOT_MODE_DATA_NAME,
 	.param_index	= NBIOT_MODE_PARAM_INDEX,
-	.param_count	= SYSTEMMODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -289,7 +237,6 @@ static const struct modem_info_data gps_mode_data = {
 	.cmd		= AT_CMD_SYSTEMMODE,
 	.data_name	= GPS_MODE_DATA_NAME,
 	.param_index	= GPS_MODE_PARAM_INDEX,
-	.param_count	= SYSTEMMODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -297,7 +244,6 @@ static const struct modem_info_data imsi_data = {
 	.cmd		= AT_CMD_IMSI,
 	.data_name	= IMSI_DATA_NAME,
 	.param_index	= IMSI_PARAM_INDEX,
-	.param_count	= IMSI_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -305,7 +251,6 @@ static const struct modem_info_data imei_data = {
 	.cmd		= AT_CMD_IMEI,
 	.data_name	= MODEM_IMEI_DATA_NAME,
 	.param_index	= MODEM_IMEI_PARAM_INDEX,
-	.param_count	= MODEM_IMEI_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -313,7 +258,6 @@ static const struct modem_info_data date_time_data = {
 	.cmd		= AT_CMD_DATE_TIME,
 	.data_name	= DATE_TIME_DATA_NAME,
 	.param_index	= DATE_TIME_PARAM_INDEX,
-	.param_count	= DATE_TIME_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -321,7 +265,6 @@ static const struct modem_info_data apn_data = {
 	.cmd		= AT_CMD_PDP_CONTEXT,
 	.data_name	= APN_DATA_NAME,
 	.param_index	= APN_PARAM_INDEX,
-	.param_count	= APN_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -353,7 +296,6 @@ static const struct modem_info_data *const modem_data[] = {
 AT_MONITOR(modem_info_cesq_mon, "%CESQ", modem_info_rsrp_subscribe_handler, PAUSED);
 
 static rsrp_cb_t modem_info_rsrp_cb;
-static struct at_param_list m_param_list;
 
 static void flip_iccid_string(char *buf)
 {
@@ -370,25 +312,13 @@ static void flip_iccid_string(char *buf)
 }
 
 static int modem_info_parse(const struct modem_info_data *modem_data,
-			    const char *buf)
+			    const char *buf, struct at_parser *parser)
 {
 	int err;
-	uint32_t param_index;
-
-	err = at_parser_max_params_from_str(buf, NULL, &m_param_list,
-					    modem_data->param_count);
-
-	if (err == -EAGAIN) {
-		LOG_DBG("More items exist to parse for: %s",
-			modem_data->data_name);
-		err = 0;
-	} else if (err != 0) {
-		return err;
-	}
 
-	param_index = at_params_valid_count_get(&m_param_list);
-	if (param_index > modem_data->param_count) {
-		return -EAGAIN;
+	err = at_parser_init(parser, buf);
+	if (err) {
+		LOG_ERR("Could not parse %s, err %d", modem_data->data_name, err);
 	}
 
 	return err;
@@ -444,6 +374,7 @@ int modem_info_name_get(enum modem_info info, char *name)
 int modem_info_short_get(enum modem_info info, uint16_t *buf)
 {
 	int err;
+	struct at_parser parser;
 	char recv_buf[CONFIG_MODEM_INFO_BUFFER_SIZE] = {0};
 
 	if (buf == NULL) {
@@ -459,12 +390,12 @@ int modem_info_short_get(enum modem_info info, uint16_t *buf)
 		return -EIO;
 	}
 
-	err = modem_info_parse(modem_data[info], recv_buf);
+	err = modem_info_parse(modem_data[info], recv_buf, &parser);
 	if (err) {
 		return err;
 	}
 
-	err = at_params_unsigned_short_get(&m_param_list,
+	err = at_parser_unsigned_short_get(&parser,
 					   modem_data[info]->param_index,
 					   buf);
 
@@ -478,6 +409,7 @@ int modem_info_short_get(enum modem_info info, uint16_t *buf)
 static int parse_ip_addresses(char *out_buf, size_t out_buf_size, char *in_buf)
 {
 	int err;
+	struct at_parser parser;
 	char *p;
 	char *str_end = in_buf;
 	int current_ip_idx = 0;
@@ -530,14 +462,15 @@ parse_line:
 	line_len = str_end - &in_buf[line_start_idx];
 	in_buf[++line_len + line_start_idx] = '\0';
 
-	err = modem_info_parse(modem_data[MODEM_INFO_IP_ADDRESS], &in_buf[line_start_idx]);
+	err = modem_info_parse(modem_data[MODEM_INFO_IP_ADDRESS], &in_buf[line_start_idx],
+			       &parser);
 	if (err) {
 		LOG_ERR("Unable to parse data: %d", err);
 		return err;
 	}
 
 	len = sizeof(ip_buf);
-	err = at_params_string_get(&m_param_list,
+	err = at_parser_string_get(&parser,
 				   modem_data[MODEM_INFO_IP_ADDRESS]->param_index,
 				   ip_buf,
 				   &len);
@@ -600,6 +533,7 @@ parse_line:
 int modem_info_string_get(enum modem_info info, char *buf, const size_t buf_size)
 {
 	int err;
+	struct at_parser parser;
 	char recv_buf[CONFIG_MODEM_INFO_BUFFER_SIZE] = {0};
 	uint16_t param_value;
 	char *str_end = recv_buf;
@@ -649,7 +583,7 @@ int modem_info_string_get(enum modem_info info, char *buf, const size_t buf_size
 		return len;
 	}
 
-	err = modem_info_parse(modem_data[info], recv_buf);
+	err = modem_info_parse(modem_data[info], recv_buf, &parser);
 	if (err) {
 		LOG_ERR("Unable to parse data: %d", err);
 		return err;
@@ -660,7 +594,7 @@ int modem_info_string_get(enum modem_info info, char *buf, const size_t buf_size
 	}
 
 	if (modem_data[info]->data_type == AT_PARAM_TYPE_NUM_INT) {
-		err = at_params_unsigned_short_get(&m_param_list,
+		err = at_parser_unsigned_short_get(&parser,
 						    modem_data[info]->param_index,
 						    &param_value);
 		if (err) {
@@ -674,7 +608,7 @@ int modem_info_string_get(enum modem_info info, char *buf, const size_t buf_size
 		}
 	} else if (modem_data[info]->data_type == AT_PARAM_TYPE_STRING) {
 		len = buf_size - out_buf_len;
-		err = at_params_string_get(&m_param_list,
+		err = at_parser_string_get(&parser,
 					   modem_data[info]->param_index,
 					   &buf[out_buf_len],
 					   &len);
@@ -706,24 +640,24 @@ int modem_info_string_get(enum modem_info info, char *buf, const size_t buf_size
 static void modem_info_rsrp_subscribe_handler(const char *notif)
 {
 	int err;
+	struct at_parser parser;
 	uint16_t param_value;
 
 	const struct modem_info_data rsrp_notify_data = {
 		.cmd		= AT_CMD_CESQ,
 		.data_name	= RSRP_DATA_NAME,
 		.param_index	= RSRP_NOTIFY_PARAM_INDEX,
-		.param_count	= RSRP_NOTIFY_PARAM_COUNT,
 		.data_type	= AT_PARAM_TYPE_NUM_INT,
 	};
 
-	err = modem_info_parse(&rsrp_notify_data, notif);
+	err = modem_info_parse(&rsrp_notify_data, notif, &parser);
 	if (err != 0) {
 		LOG_ERR("modem_info_parse failed to parse "
 			"CESQ notification, %d", err);
 		return;
 	}
 
-	err = at_params_unsigned_short_get(&m_param_list,
+	err = at_parser_unsigned_short_get(&parser,
 					   rsrp_notify_data.param_index,
 					   &param_value);
 	if (err != 0) {
@@ -868,13 +802,5 @@ int modem_info_get_rsrp(int *val)
 
 int modem_info_init(void)
 {
-	int err = 0;
-
-	if (m_param_list.params == NULL) {
-		/* Init at_cmd_parser storage module */
-		err = at_params_list_init(&m_param_list,
-					  CONFIG_MODEM_INFO_MAX_AT_PARAMS_RSP);
-	}
-
-	return err;
+	return 0;
 }
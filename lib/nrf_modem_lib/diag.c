@@ -10,12 +10,16 @@
 #include <zephyr/sys/heap_listener.h>
 #include <zephyr/logging/log.h>
 #include <modem/nrf_modem_lib.h>
+#if CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB
+#include "shm_tx_slab.h"
+#endif
 
 LOG_MODULE_DECLARE(nrf_modem, CONFIG_NRF_MODEM_LIB_LOG_LEVEL);
 
 /* extern in nrf_modem_os.c */
 uint32_t nrf_modem_lib_shmem_failed_allocs;	/* failed allocations on shared memory heap */
 uint32_t nrf_modem_lib_failed_allocs;		/* failed allocations on library heap */
+uint32_t nrf_modem_lib_shmem_fragmented_allocs;	/* failed with enough free shared memory */
 
 /* from nrf_modem_os.c */
 extern struct k_heap nrf_modem_lib_shmem_heap;
@@ -35,8 +39,21 @@ int nrf_modem_lib_diag_stats_get(struct nrf_modem_lib_diag_stats *stats)
 	sys_heap_runtime_stats_get(&nrf_modem_lib_heap.heap, &stats->library.heap);
 
 	stats->shmem.failed_allocs = nrf_modem_lib_shmem_failed_allocs;
+	stats->shmem.fragmented_allocs = nrf_modem_lib_shmem_fragmented_allocs;
 	stats->library.failed_allocs = nrf_modem_lib_failed_allocs;
 
+#if CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB
+	shm_tx_slab_stats_get(stats->shmem.slab);
+
+	/* The classes are in increasing block size. */
+	stats->shmem.largest_free_slab_block = 0;
+	for (size_t i = 0; i < NRF_MODEM_LIB_DIAG_SLAB_CLASSES; i++) {
+		if (stats->shmem.slab[i].blocks_used < stats->shmem.slab[i].blocks) {
+			stats->shmem.largest_free_slab_block = stats->shmem.slab[i].block_size;
+		}
+	}
+#endif
+
 	return 0;
 }
 
@@ -69,13 +86,23 @@ static void diag_task(struct k_work *item)
 
 	(void)nrf_modem_lib_diag_stats_get(&stats);
 
-	LOG_INF("shm: free %.4u, allocated %.4u, max allocated %.4u, failed %u",
+	LOG_INF("shm: free %.4u, allocated %.4u, max allocated %.4u, failed %u, fragmented %u",
 		stats.shmem.heap.free_bytes, stats.shmem.heap.allocated_bytes,
-		stats.shmem.heap.max_allocated_bytes, nrf_modem_lib_shmem_failed_allocs);
+		stats.shmem.heap.max_allocated_bytes, nrf_modem_lib_shmem_failed_allocs,
+		nrf_modem_lib_shmem_fragmented_allocs);
 	LOG_INF("lib: free %.4u, allocated %.4u, max allocated %.4u, failed %u",
 		stats.library.heap.free_bytes, stats.library.heap.allocated_bytes,
 		stats.library.heap.max_allocated_bytes, nrf_modem_lib_failed_allocs);
 
+#if CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB
+	for (size_t i = 0; i < NRF_MODEM_LIB_DIAG_SLAB_CLASSES; i++) {
+		LOG_INF("shm %u-byte blocks: used %u/%u, max used %u, allocs %u, misses %u",
+			stats.shmem.slab[i].block_size, stats.shmem.slab[i].blocks_used,
+			stats.shmem.slab[i].blocks, stats.shmem.slab[i].blocks_max_used,
+			stats.shmem.slab[i].allocs, stats.shmem.slab[i].misses);
+	}
+#endif
+
 	k_work_reschedule(&diag_work, K_MSEC(CONFIG_NRF_MODEM_LIB_MEM_DIAG_DUMP_PERIOD_MS));
 }
 #endif
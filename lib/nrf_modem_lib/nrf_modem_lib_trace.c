@@ -4,8 +4,10 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
 #include <modem/nrf_modem_lib.h>
 #include <modem/nrf_modem_lib_trace.h>
 #include <modem/trace_backend.h>
@@ -14,6 +16,9 @@
 #include <nrf_modem_os.h>
 #include <nrf_modem_trace.h>
 #include <nrf_errno.h>
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_LZ4
+#include <lz4.h>
+#endif
 
 LOG_MODULE_REGISTER(nrf_modem_lib_trace, CONFIG_NRF_MODEM_LIB_LOG_LEVEL);
 
@@ -189,6 +194,172 @@ static int trace_fragment_write(struct nrf_modem_trace_data *frag)
 	return 0;
 }
 
+#if CONFIG_NRF_MODEM_LIB_TRACE_BATCH
+#define BATCH_TIMEOUT_MS CONFIG_NRF_MODEM_LIB_TRACE_BATCH_TIMEOUT_MS
+
+static uint8_t batch_buf[CONFIG_NRF_MODEM_LIB_TRACE_BATCH_SIZE];
+static size_t batch_len;
+
+static struct k_spinlock stats_lock;
+static struct nrf_modem_lib_trace_stats stats;
+
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_LZ4
+#define LZ4_FRAME_MAGIC 0x5a4c
+
+/* Each batch is written as a header followed by the LZ4 block,
+ * or by the uncompressed batch if it does not compress.
+ */
+struct lz4_frame_hdr {
+	uint16_t magic;
+	/** Length of the batch. */
+	uint16_t raw_len;
+	/** Length of the LZ4 block, or zero if the batch is not compressed. */
+	uint16_t lz4_len;
+} __packed;
+
+static LZ4_stream_t lz4_state;
+static uint8_t lz4_buf[sizeof(struct lz4_frame_hdr) +
+		       LZ4_COMPRESSBOUND(CONFIG_NRF_MODEM_LIB_TRACE_BATCH_SIZE)];
+
+static void batch_compress(struct nrf_modem_trace_data *frag)
+{
+	struct lz4_frame_hdr *hdr = (struct lz4_frame_hdr *)lz4_buf;
+	int len;
+
+	len = LZ4_compress_fast_extState(&lz4_state, (const char *)batch_buf,
+					 (char *)&lz4_buf[sizeof(*hdr)], batch_len,
+					 sizeof(lz4_buf) - sizeof(*hdr), 1);
+
+	hdr->magic = sys_cpu_to_le16(LZ4_FRAME_MAGIC);
+	hdr->raw_len = sys_cpu_to_le16(batch_len);
+
+	if (len <= 0 || len >= batch_len) {
+		hdr->lz4_len = 0;
+		memcpy(&lz4_buf[sizeof(*hdr)], batch_buf, batch_len);
+		len = batch_len;
+	} else {
+		hdr->lz4_len = sys_cpu_to_le16(len);
+	}
+
+	frag->data = lz4_buf;
+	frag->len = sizeof(*hdr) + len;
+}
+#endif /* CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_LZ4 */
+
+static void stats_backlog_update(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats.backlog = batch_len;
+	stats.backlog_max = MAX(stats.backlog_max, batch_len);
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+static int trace_batch_flush(void)
+{
+	int err;
+	struct nrf_modem_trace_data frag = {
+		.data = batch_buf,
+		.len = batch_len,
+	};
+
+	if (batch_len == 0) {
+		return 0;
+	}
+
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_LZ4
+	batch_compress(&frag);
+#endif
+
+	err = trace_fragment_write(&frag);
+
+	/* The batch is discarded if it could not be written. */
+	batch_len = 0;
+
+	if (!err) {
+		k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+		stats.bytes_written += frag.len;
+		stats.batches++;
+
+		k_spin_unlock(&stats_lock, key);
+	}
+
+	stats_backlog_update();
+
+	return err;
+}
+
+static int trace_batch_add(struct nrf_modem_trace_data *frag)
+{
+	int err;
+	size_t len;
+	size_t remaining = frag->len;
+	const uint8_t *data = frag->data;
+
+	while (remaining) {
+		len = MIN(remaining, sizeof(batch_buf) - batch_len);
+
+		memcpy(&batch_buf[batch_len], data, len);
+		batch_len += len;
+		data += len;
+		remaining -= len;
+
+		/* The modem can reuse the trace memory as soon as it has been copied. */
+		err = nrf_modem_trace_processed(len);
+		if (err) {
+			LOG_ERR("nrf_modem_trace_processed failed with err: %d", err);
+			return err;
+		}
+
+		if (batch_len == sizeof(batch_buf)) {
+			err = trace_batch_flush();
+			if (err) {
+				return err;
+			}
+		}
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats.bytes_received += frag->len;
+
+	k_spin_unlock(&stats_lock, key);
+
+	stats_backlog_update();
+
+	return 0;
+}
+
+/* Trace data has been copied to the batch buffer and released to the modem already. */
+static int trace_batch_processed(size_t len)
+{
+	ARG_UNUSED(len);
+
+	return 0;
+}
+
+void nrf_modem_lib_trace_stats_get(struct nrf_modem_lib_trace_stats *trace_stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	*trace_stats = stats;
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+#define TRACE_GET_TIMEOUT (batch_len ? BATCH_TIMEOUT_MS : NRF_MODEM_OS_FOREVER)
+#define TRACE_WRITE(frag) trace_batch_add(frag)
+#define TRACE_FLUSH() trace_batch_flush()
+#define TRACE_PROCESSED_CB trace_batch_processed
+#else
+#define TRACE_GET_TIMEOUT NRF_MODEM_OS_FOREVER
+#define TRACE_WRITE(frag) trace_fragment_write(frag)
+#define TRACE_FLUSH() 0
+#define TRACE_PROCESSED_CB nrf_modem_trace_processed
+#endif /* CONFIG_NRF_MODEM_LIB_TRACE_BATCH */
+
 void trace_thread_handler(void)
 {
 	int err;
@@ -199,12 +370,19 @@ trace_reset:
 	k_sem_take(&trace_sem, K_FOREVER);
 
 	while (true) {
-		err = nrf_modem_trace_get(&frags, &n_frags, NRF_MODEM_OS_FOREVER);
+		err = nrf_modem_trace_get(&frags, &n_frags, TRACE_GET_TIMEOUT);
 		switch (err) {
 		case 0:
 			/* Success */
 			UPDATE_TRACE_BYTES_RECEIVED(frags, n_frags);
 			break;
+		case -NRF_EAGAIN:
+			/* No new trace data within the batch timeout. */
+			err = TRACE_FLUSH();
+			if (err) {
+				goto out;
+			}
+			continue;
 		case -NRF_ESHUTDOWN:
 			LOG_INF("Modem was turned off, no more traces");
 			goto out;
@@ -220,7 +398,7 @@ trace_reset:
 		}
 
 		for (size_t i = 0; i < n_frags; i++) {
-			err = trace_fragment_write(&frags[i]);
+			err = TRACE_WRITE(&frags[i]);
 			if (err) {
 				goto out;
 			}
@@ -228,6 +406,12 @@ trace_reset:
 	}
 
 out:
+	/* Write what is left of the trace, for example, the end of a coredump. */
+	err = TRACE_FLUSH();
+	if (err) {
+		LOG_ERR("Failed to write batched trace data, err: %d", err);
+	}
+
 	err = trace_deinit();
 	if (err) {
 		LOG_ERR("trace_deinit failed with err: %d", err);
@@ -242,7 +426,7 @@ static int trace_init(void)
 
 	k_sem_take(&trace_done_sem, K_FOREVER);
 
-	err = trace_backend_init(nrf_modem_trace_processed);
+	err = trace_backend_init(TRACE_PROCESSED_CB);
 	if (err) {
 		LOG_ERR("trace_backend_init failed with err: %d", err);
 
@@ -16,6 +16,15 @@
 #include <pm_config.h>
 #include <zephyr/logging/log.h>
 
+#if CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB
+#include "shm_tx_slab.h"
+#define SHMEM_TX_HEAP_ADDR (PM_NRF_MODEM_LIB_TX_ADDRESS + SHM_TX_SLAB_SIZE)
+#define SHMEM_TX_HEAP_SIZE (CONFIG_NRF_MODEM_LIB_SHMEM_TX_SIZE - SHM_TX_SLAB_SIZE)
+#else
+#define SHMEM_TX_HEAP_ADDR PM_NRF_MODEM_LIB_TX_ADDRESS
+#define SHMEM_TX_HEAP_SIZE CONFIG_NRF_MODEM_LIB_SHMEM_TX_SIZE
+#endif
+
 #define UNUSED_FLAGS 0
 #define THREAD_MONITOR_ENTRIES 10
 
@@ -283,7 +292,7 @@ void *nrf_modem_os_alloc(size_t bytes)
 	extern uint32_t nrf_modem_lib_failed_allocs;
 	void * const addr = k_heap_alloc(&nrf_modem_lib_heap, bytes, K_NO_WAIT);
 
-	if (IS_ENABLED(CONFIG_NRF_MODEM_LIB_MEM_DIAG_ALLOC) && !addr) {
+	if (IS_ENABLED(CONFIG_NRF_MODEM_LIB_MEM_DIAG) && !addr) {
 		nrf_modem_lib_failed_allocs++;
 	}
 
@@ -295,20 +304,52 @@ void nrf_modem_os_free(void *mem)
 	k_heap_free(&nrf_modem_lib_heap, mem);
 }
 
-void *nrf_modem_os_shm_tx_alloc(size_t bytes)
+#if CONFIG_NRF_MODEM_LIB_MEM_DIAG
+static void shm_tx_failed_alloc(size_t bytes)
 {
 	extern uint32_t nrf_modem_lib_shmem_failed_allocs;
-	void * const addr = k_heap_alloc(&nrf_modem_lib_shmem_heap, bytes, K_NO_WAIT);
+	extern uint32_t nrf_modem_lib_shmem_fragmented_allocs;
+	struct sys_memory_stats stats;
+
+	nrf_modem_lib_shmem_failed_allocs++;
+
+	sys_heap_runtime_stats_get(&nrf_modem_lib_shmem_heap.heap, &stats);
+	if (stats.free_bytes >= bytes) {
+		nrf_modem_lib_shmem_fragmented_allocs++;
+	}
+}
+#endif
+
+void *nrf_modem_os_shm_tx_alloc(size_t bytes)
+{
+	void *addr = NULL;
+
+#if CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB
+	addr = shm_tx_slab_alloc(bytes);
+	if (addr) {
+		return addr;
+	}
+#endif
+
+	addr = k_heap_alloc(&nrf_modem_lib_shmem_heap, bytes, K_NO_WAIT);
 
-	if (IS_ENABLED(CONFIG_NRF_MODEM_LIB_MEM_DIAG_ALLOC) && !addr) {
-		nrf_modem_lib_shmem_failed_allocs++;
+#if CONFIG_NRF_MODEM_LIB_MEM_DIAG
+	if (!addr) {
+		shm_tx_failed_alloc(bytes);
 	}
+#endif
 
 	return addr;
 }
 
 void nrf_modem_os_shm_tx_free(void *mem)
 {
+#if CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB
+	if (shm_tx_slab_free(mem)) {
+		return;
+	}
+#endif
+
 	k_heap_free(&nrf_modem_lib_shmem_heap, mem);
 }
 
@@ -412,8 +453,10 @@ void nrf_modem_os_init(void)
 {
 	/* Initialize heaps */
 	k_heap_init(&nrf_modem_lib_heap, library_heap_buf, sizeof(library_heap_buf));
-	k_heap_init(&nrf_modem_lib_shmem_heap, (void *)PM_NRF_MODEM_LIB_TX_ADDRESS,
-		    CONFIG_NRF_MODEM_LIB_SHMEM_TX_SIZE);
+#if CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB
+	shm_tx_slab_init((void *)PM_NRF_MODEM_LIB_TX_ADDRESS);
+#endif
+	k_heap_init(&nrf_modem_lib_shmem_heap, (void *)SHMEM_TX_HEAP_ADDR, SHMEM_TX_HEAP_SIZE);
 }
 
 void nrf_modem_os_shutdown(void)
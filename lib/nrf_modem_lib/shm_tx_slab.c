@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include "shm_tx_slab.h"
+
+BUILD_ASSERT(SHM_TX_SLAB_SIZE < CONFIG_NRF_MODEM_LIB_SHMEM_TX_SIZE,
+	     "TX region blocks leave no room for the TX region heap");
+BUILD_ASSERT(CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_SMALL_SIZE <
+	     CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_LARGE_SIZE,
+	     "Small blocks must be smaller than large blocks");
+BUILD_ASSERT((CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_SMALL_SIZE % 4 == 0) &&
+	     (CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_LARGE_SIZE % 4 == 0),
+	     "Block sizes must be multiples of 4 bytes");
+
+/* Size classes, in increasing block size. */
+static struct shm_tx_class {
+	struct k_mem_slab slab;
+	uint8_t *start;
+	uint8_t *end;
+	size_t block_size;
+	uint32_t num_blocks;
+	uint32_t max_used;
+	uint32_t allocs;
+	uint32_t misses;
+} classes[] = {
+	{
+		.block_size = CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_SMALL_SIZE,
+		.num_blocks = CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_SMALL_COUNT,
+	},
+	{
+		.block_size = CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_LARGE_SIZE,
+		.num_blocks = CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_LARGE_COUNT,
+	},
+};
+
+static struct k_spinlock lock;
+
+void shm_tx_slab_init(void *addr)
+{
+	int err;
+	uint8_t *buf = addr;
+
+	for (size_t i = 0; i < ARRAY_SIZE(classes); i++) {
+		struct shm_tx_class *class = &classes[i];
+
+		class->start = buf;
+		class->end = buf + class->block_size * class->num_blocks;
+		class->max_used = 0;
+		class->allocs = 0;
+		class->misses = 0;
+		buf = class->end;
+
+		if (class->num_blocks == 0) {
+			continue;
+		}
+
+		err = k_mem_slab_init(&class->slab, class->start, class->block_size,
+				      class->num_blocks);
+		__ASSERT(err == 0, "k_mem_slab_init failed, err %d", err);
+	}
+}
+
+void *shm_tx_slab_alloc(size_t bytes)
+{
+	void *mem;
+	k_spinlock_key_t key;
+
+	for (size_t i = 0; i < ARRAY_SIZE(classes); i++) {
+		struct shm_tx_class *class = &classes[i];
+
+		if (bytes > class->block_size || class->num_blocks == 0) {
+			continue;
+		}
+
+		key = k_spin_lock(&lock);
+
+		if (k_mem_slab_alloc(&class->slab, &mem, K_NO_WAIT) == 0) {
+			class->allocs++;
+			class->max_used = MAX(class->max_used,
+					      k_mem_slab_num_used_get(&class->slab));
+			k_spin_unlock(&lock, key);
+			return mem;
+		}
+
+		/* Class exhausted, try a larger one. */
+		class->misses++;
+		k_spin_unlock(&lock, key);
+	}
+
+	return NULL;
+}
+
+bool shm_tx_slab_free(void *mem)
+{
+	uint8_t *ptr = mem;
+
+	for (size_t i = 0; i < ARRAY_SIZE(classes); i++) {
+		struct shm_tx_class *class = &classes[i];
+
+		if (ptr >= class->start && ptr < class->end) {
+			k_mem_slab_free(&class->slab, &mem);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+#if CONFIG_NRF_MODEM_LIB_MEM_DIAG
+void shm_tx_slab_stats_get(struct nrf_modem_lib_diag_slab_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (size_t i = 0; i < ARRAY_SIZE(classes); i++) {
+		struct shm_tx_class *class = &classes[i];
+
+		stats[i].block_size = class->block_size;
+		stats[i].blocks = class->num_blocks;
+		stats[i].blocks_used =
+			class->num_blocks ? k_mem_slab_num_used_get(&class->slab) : 0;
+		stats[i].blocks_max_used = class->max_used;
+		stats[i].allocs = class->allocs;
+		stats[i].misses = class->misses;
+	}
+
+	k_spin_unlock(&lock, key);
+}
+#endif
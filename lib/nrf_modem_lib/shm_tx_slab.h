@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SHM_TX_SLAB_H__
+#define SHM_TX_SLAB_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <modem/nrf_modem_lib.h>
+
+/* Size of the part of the TX region used for fixed-size blocks. */
+#define SHM_TX_SLAB_SIZE                                                                           \
+	(CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_SMALL_SIZE *                                           \
+		 CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_SMALL_COUNT +                                  \
+	 CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_LARGE_SIZE *                                           \
+		 CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_LARGE_COUNT)
+
+/* Initialize the blocks at the beginning of the TX region. */
+void shm_tx_slab_init(void *addr);
+
+/* Allocate a block, or return NULL if no block is large enough. */
+void *shm_tx_slab_alloc(size_t bytes);
+
+/* Free a block, or return false if @p mem is not a block. */
+bool shm_tx_slab_free(void *mem);
+
+#if CONFIG_NRF_MODEM_LIB_MEM_DIAG
+void shm_tx_slab_stats_get(struct nrf_modem_lib_diag_slab_stats *stats);
+#endif
+
+#endif /* SHM_TX_SLAB_H__ */
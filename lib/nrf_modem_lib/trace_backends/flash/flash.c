@@ -0,0 +1,531 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include <modem/trace_backend.h>
+#include <modem/nrf_modem_lib_trace.h>
+
+LOG_MODULE_REGISTER(modem_trace_backend, CONFIG_MODEM_TRACE_BACKEND_LOG_LEVEL);
+
+#define SECTOR_SIZE CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_FLASH_SECTOR_SIZE
+#define SECTOR_MAGIC 0x6d74726cUL
+#define SECTOR_NOT_CONSUMED 0xffffffffUL
+#define RECORD_FREE 0xffff
+
+BUILD_ASSERT(CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_FLASH_PARTITION_SIZE % SECTOR_SIZE == 0,
+	     "Partition size must be a multiple of the sector size");
+BUILD_ASSERT(CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_FLASH_PARTITION_SIZE >= 2 * SECTOR_SIZE,
+	     "Partition must have at least two sectors");
+BUILD_ASSERT(SECTOR_SIZE <= RECORD_FREE, "Sector size must fit in a record length");
+
+/* Each sector begins with a header. The sequence number grows by one for every
+ * sector that is entered, so that the oldest and the newest sector can be told
+ * apart after a reset. The `consumed` word is left erased until all trace data
+ * in the sector has been read.
+ */
+struct sector_hdr {
+	uint32_t magic;
+	uint32_t seq;
+	uint32_t consumed;
+};
+
+static K_MUTEX_DEFINE(trace_mutex);
+
+static const struct flash_area *trace_area;
+
+static trace_backend_processed_cb trace_processed_callback;
+
+/* The partition is used as a ring buffer of sectors. Sectors are erased as they
+ * are entered, discarding the oldest trace data when the partition is full.
+ * The trace data is stored in records, each prefixed by its 16-bit length.
+ * The length of the first free record in a sector is left erased.
+ *
+ * The next record is written at `write_offset`. When it is at the beginning of
+ * a sector, that sector has not been entered yet.
+ */
+static uint32_t seq;
+static size_t write_offset;
+
+/* Trace data is read from `read_sector`, at `read_pos`. When `read_left` is not
+ * zero, `read_pos` is in the middle of a record, else it is at the length of the
+ * next one. A `read_pos` of zero means that the sector has not been entered yet.
+ */
+static size_t read_sector;
+static size_t read_pos;
+static size_t read_left;
+
+static size_t stored;
+static size_t dropped;
+
+static size_t sector_next(size_t offset)
+{
+	return (offset - offset % SECTOR_SIZE + SECTOR_SIZE) % trace_area->fa_size;
+}
+
+static int sector_hdr_read(size_t offset, struct sector_hdr *hdr)
+{
+	int err;
+
+	err = flash_area_read(trace_area, offset, hdr, sizeof(*hdr));
+	if (err) {
+		LOG_ERR("flash_area_read failed with err: %d", err);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/* Read the length of the record at `pos` in the sector at `sector`. Zero is
+ * returned at the end of the trace data in the sector, a length is never zero
+ * otherwise.
+ */
+static int record_len_read(size_t sector, size_t pos, uint16_t *len)
+{
+	int err;
+	size_t space = SECTOR_SIZE - pos;
+
+	*len = 0;
+
+	if (space <= sizeof(*len)) {
+		return 0;
+	}
+
+	err = flash_area_read(trace_area, sector + pos, len, sizeof(*len));
+	if (err) {
+		LOG_ERR("flash_area_read failed with err: %d", err);
+		return -EIO;
+	}
+
+	if (*len == RECORD_FREE) {
+		*len = 0;
+	} else if (*len > space - sizeof(*len)) {
+		LOG_WRN("Invalid trace record at offset %zu", sector + pos);
+		*len = 0;
+	}
+
+	return 0;
+}
+
+/* Sum up the trace data in the records from `pos` to the end of the sector.
+ * `end` is set to the position where the next record would be written.
+ */
+static int records_walk(size_t sector, size_t pos, size_t *size, size_t *end)
+{
+	int err;
+	uint16_t len;
+
+	*size = 0;
+
+	while (true) {
+		err = record_len_read(sector, pos, &len);
+		if (err) {
+			return err;
+		}
+
+		if (len == 0) {
+			break;
+		}
+
+		pos += sizeof(len) + len;
+		*size += len;
+	}
+
+	*end = pos;
+
+	return 0;
+}
+
+static int sector_consume(size_t offset)
+{
+	int err;
+	uint32_t consumed = 0;
+
+	err = flash_area_write(trace_area, offset + offsetof(struct sector_hdr, consumed),
+			       &consumed, sizeof(consumed));
+	if (err) {
+		LOG_ERR("flash_area_write failed with err: %d", err);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/* Consume the sectors from the one being read to the one being written, and
+ * continue writing in the next sector.
+ */
+static int sectors_consume(void)
+{
+	int err;
+	size_t write_sector = write_offset - write_offset % SECTOR_SIZE;
+
+	while (read_sector != write_offset) {
+		err = sector_consume(read_sector);
+		if (err) {
+			return err;
+		}
+
+		if (read_sector == write_sector) {
+			write_offset = sector_next(write_sector);
+		}
+
+		read_sector = sector_next(read_sector);
+	}
+
+	read_pos = 0;
+	read_left = 0;
+	stored = 0;
+
+	return 0;
+}
+
+static int sector_enter(size_t offset)
+{
+	int err;
+	size_t unread;
+	size_t end;
+	struct sector_hdr hdr = {
+		.magic = SECTOR_MAGIC,
+		.seq = seq + 1,
+	};
+
+	/* When the partition is full, the sector has the oldest trace data. */
+	if (stored && read_sector == offset) {
+		err = records_walk(offset, MAX(read_pos + read_left, sizeof(hdr)), &unread, &end);
+		if (err) {
+			return err;
+		}
+
+		unread += read_left;
+		dropped += unread;
+		stored -= unread;
+		LOG_WRN("Trace partition full, dropping %zu bytes", unread);
+
+		read_sector = sector_next(offset);
+		read_pos = 0;
+		read_left = 0;
+	}
+
+	err = flash_area_erase(trace_area, offset, SECTOR_SIZE);
+	if (err) {
+		LOG_ERR("flash_area_erase failed with err: %d", err);
+		return -EIO;
+	}
+
+	/* The consumed word is left erased. */
+	err = flash_area_write(trace_area, offset, &hdr, offsetof(struct sector_hdr, consumed));
+	if (err) {
+		LOG_ERR("flash_area_write failed with err: %d", err);
+		return -EIO;
+	}
+
+	seq++;
+	write_offset = offset + sizeof(hdr);
+
+	return 0;
+}
+
+static int flash_write(const uint8_t *data, size_t len)
+{
+	int err;
+	uint16_t chunk;
+
+	while (len) {
+		/* Continue in the next sector when there is no room for another record. */
+		if (SECTOR_SIZE - write_offset % SECTOR_SIZE <= sizeof(chunk)) {
+			write_offset = sector_next(write_offset);
+		}
+
+		if (write_offset % SECTOR_SIZE == 0) {
+			err = sector_enter(write_offset);
+			if (err) {
+				return err;
+			}
+		}
+
+		chunk = MIN(len, SECTOR_SIZE - write_offset % SECTOR_SIZE - sizeof(chunk));
+
+		err = flash_area_write(trace_area, write_offset, &chunk, sizeof(chunk));
+		if (!err) {
+			err = flash_area_write(trace_area, write_offset + sizeof(chunk), data, chunk);
+		}
+		if (err) {
+			LOG_ERR("flash_area_write failed with err: %d", err);
+			return -EIO;
+		}
+
+		write_offset = (write_offset + sizeof(chunk) + chunk) % trace_area->fa_size;
+		stored += chunk;
+		data += chunk;
+		len -= chunk;
+	}
+
+	return 0;
+}
+
+/* Find the trace data stored before a reset. The sectors that follow the newest
+ * one are older, the unread trace data begins in the oldest sector that has not
+ * been consumed.
+ */
+static int trace_recover(void)
+{
+	int err;
+	size_t sectors = trace_area->fa_size / SECTOR_SIZE;
+	size_t newest = 0;
+	size_t offset;
+	size_t size;
+	size_t end;
+	bool found = false;
+	bool unread = false;
+	struct sector_hdr hdr;
+
+	seq = 0;
+	write_offset = 0;
+	read_pos = 0;
+	read_left = 0;
+	stored = 0;
+
+	for (size_t i = 0; i < sectors; i++) {
+		err = sector_hdr_read(i * SECTOR_SIZE, &hdr);
+		if (err) {
+			return err;
+		}
+
+		if (hdr.magic == SECTOR_MAGIC && (!found || hdr.seq > seq)) {
+			found = true;
+			newest = i;
+			seq = hdr.seq;
+		}
+	}
+
+	for (size_t i = 1; found && i <= sectors; i++) {
+		offset = ((newest + i) % sectors) * SECTOR_SIZE;
+
+		err = sector_hdr_read(offset, &hdr);
+		if (err) {
+			return err;
+		}
+
+		if (hdr.magic != SECTOR_MAGIC) {
+			continue;
+		}
+
+		if (hdr.consumed != SECTOR_NOT_CONSUMED) {
+			if (i == sectors) {
+				write_offset = sector_next(offset);
+			}
+			continue;
+		}
+
+		err = records_walk(offset, sizeof(hdr), &size, &end);
+		if (err) {
+			return err;
+		}
+
+		if (!unread) {
+			unread = true;
+			read_sector = offset;
+		}
+
+		stored += size;
+
+		if (i == sectors) {
+			write_offset = (offset + end) % trace_area->fa_size;
+		}
+	}
+
+	if (!unread) {
+		read_sector = write_offset;
+	}
+
+	if (stored) {
+		LOG_INF("%zu bytes of trace data found in flash", stored);
+	}
+
+	return 0;
+}
+
+/* Move to the next record to read, consuming the sectors that have been read. */
+static int record_next(void)
+{
+	int err;
+	uint16_t len;
+
+	while (true) {
+		if (read_pos == 0) {
+			read_pos = sizeof(struct sector_hdr);
+		}
+
+		err = record_len_read(read_sector, read_pos, &len);
+		if (err) {
+			return err;
+		}
+
+		if (len) {
+			read_pos += sizeof(len);
+			read_left = len;
+			return 0;
+		}
+
+		err = sector_consume(read_sector);
+		if (err) {
+			return err;
+		}
+
+		read_sector = sector_next(read_sector);
+		read_pos = 0;
+	}
+}
+
+int trace_backend_init(trace_backend_processed_cb trace_processed_cb)
+{
+	int err;
+
+	if (trace_processed_cb == NULL) {
+		return -EFAULT;
+	}
+
+	trace_processed_callback = trace_processed_cb;
+
+	/* Stored traces are kept when the modem is re-initialized. */
+	if (trace_area) {
+		return 0;
+	}
+
+	err = flash_area_open(FLASH_AREA_ID(MODEM_TRACE), &trace_area);
+	if (err) {
+		LOG_ERR("flash_area_open failed with err: %d", err);
+		return -ENODEV;
+	}
+
+	/* Trace fragments are written as they are, without alignment. */
+	if (flash_area_align(trace_area) != 1) {
+		LOG_ERR("Flash write block size %d not supported", flash_area_align(trace_area));
+		flash_area_close(trace_area);
+		trace_area = NULL;
+		return -ENOTSUP;
+	}
+
+	k_mutex_lock(&trace_mutex, K_FOREVER);
+	err = trace_recover();
+	k_mutex_unlock(&trace_mutex);
+
+	if (err) {
+		flash_area_close(trace_area);
+		trace_area = NULL;
+		return err;
+	}
+
+	return 0;
+}
+
+int trace_backend_deinit(void)
+{
+	if (dropped) {
+		LOG_WRN("%zu bytes of trace data dropped", dropped);
+	}
+
+	return 0;
+}
+
+int trace_backend_write(const void *data, size_t len)
+{
+	int err;
+
+	k_mutex_lock(&trace_mutex, K_FOREVER);
+	err = flash_write(data, len);
+	k_mutex_unlock(&trace_mutex);
+
+	if (err) {
+		return err;
+	}
+
+	err = trace_processed_callback(len);
+	if (err) {
+		return err;
+	}
+
+	return (int)len;
+}
+
+size_t nrf_modem_lib_trace_data_size(void)
+{
+	return stored;
+}
+
+int nrf_modem_lib_trace_read(uint8_t *buf, size_t len)
+{
+	int err = 0;
+	size_t chunk;
+	size_t read = 0;
+
+	if (trace_area == NULL) {
+		return -ENODATA;
+	}
+
+	k_mutex_lock(&trace_mutex, K_FOREVER);
+
+	if (stored == 0) {
+		k_mutex_unlock(&trace_mutex);
+		return -ENODATA;
+	}
+
+	while (read < len && stored) {
+		if (read_left == 0) {
+			err = record_next();
+			if (err) {
+				break;
+			}
+		}
+
+		chunk = MIN(len - read, read_left);
+
+		err = flash_area_read(trace_area, read_sector + read_pos, &buf[read], chunk);
+		if (err) {
+			LOG_ERR("flash_area_read failed with err: %d", err);
+			err = -EIO;
+			break;
+		}
+
+		read_pos += chunk;
+		read_left -= chunk;
+		stored -= chunk;
+		read += chunk;
+	}
+
+	/* Once all trace data has been read, it is not read again after a reset. */
+	if (!err && stored == 0) {
+		err = sectors_consume();
+	}
+
+	k_mutex_unlock(&trace_mutex);
+
+	if (err) {
+		return err;
+	}
+
+	return (int)read;
+}
+
+int nrf_modem_lib_trace_clear(void)
+{
+	int err = 0;
+
+	k_mutex_lock(&trace_mutex, K_FOREVER);
+
+	/* Sectors are erased when they are written to again. */
+	if (trace_area) {
+		err = sectors_consume();
+	}
+
+	stored = 0;
+	dropped = 0;
+
+	k_mutex_unlock(&trace_mutex);
+
+	return err;
+}
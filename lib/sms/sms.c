@@ -14,6 +14,7 @@
 
 #include "sms_submit.h"
 #include "sms_deliver.h"
+#include "sms_concat.h"
 #include "sms_internal.h"
 
 LOG_MODULE_REGISTER(sms, CONFIG_SMS_LOG_LEVEL);
@@ -31,6 +32,8 @@ LOG_MODULE_REGISTER(sms, CONFIG_SMS_LOG_LEVEL);
 
 /** @brief SMS structure where received SMS is parsed. */
 static struct sms_data sms_data_info;
+/** @brief Character set of the user data in sms_data_info. */
+static enum sms_deliver_alphabet sms_data_alphabet;
 
 /**
  * @brief Worker handling SMS acknowledgements because we cannot call
@@ -96,6 +99,13 @@ static void sms_ack(struct k_work *work)
  */
 static void sms_notify(struct k_work *work)
 {
+	if (IS_ENABLED(CONFIG_SMS_CONCAT_REASSEMBLY) && sms_data_info.type == SMS_TYPE_DELIVER) {
+		/* Parts of concatenated messages are held until the whole message is received. */
+		if (sms_concat_process(&sms_data_info, sms_data_alphabet)) {
+			return;
+		}
+	}
+
 	for (size_t i = 0; i < ARRAY_SIZE(subscribers); i++) {
 		if (subscribers[i].listener != NULL) {
 			subscribers[i].listener(&sms_data_info, subscribers[i].ctx);
@@ -162,7 +172,7 @@ static void sms_at_cmd_handler_cmt(const char *at_notif)
 	}
 
 	sms_data_info.type = SMS_TYPE_DELIVER;
-	err = sms_deliver_pdu_parse(sms_buf_tmp, &sms_data_info);
+	err = sms_deliver_pdu_parse(sms_buf_tmp, &sms_data_info, &sms_data_alphabet);
 	if (err) {
 		goto sms_ack_send;
 	}
@@ -346,6 +356,10 @@ static void sms_uninit(void)
 
 	LOG_DBG("SMS client unregistered");
 
+	if (IS_ENABLED(CONFIG_SMS_CONCAT_REASSEMBLY)) {
+		sms_concat_reset();
+	}
+
 	/* Pause AT commands notifications. */
 	at_monitor_pause(&sms_at_handler_cmt);
 	at_monitor_pause(&sms_at_handler_cds);
@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <modem/sms.h>
+#include <zephyr/logging/log.h>
+
+#include "sms_concat.h"
+#include "sms_internal.h"
+
+LOG_MODULE_DECLARE(sms, CONFIG_SMS_LOG_LEVEL);
+
+BUILD_ASSERT(CONFIG_SMS_CONCAT_PART_COUNT < UINT8_MAX, "Too many part buffers");
+
+/** @brief Marks a part that is not stored in a part buffer. */
+#define PART_NONE UINT8_MAX
+
+/** @brief Unicode replacement character for invalid UTF-16 data. */
+#define REPLACEMENT_CHAR 0xFFFD
+
+/** @brief Timeout for receiving the next part of a message in milliseconds. */
+#define CONCAT_TIMEOUT_MS (CONFIG_SMS_CONCAT_TIMEOUT_SEC * MSEC_PER_SEC)
+
+/**
+ * @brief Output buffer with the state of incremental UCS2 to UTF-8 decoding.
+ *
+ * @details A UTF-16 code unit or a surrogate pair may be split between two parts.
+ */
+struct concat_buf {
+	uint8_t *buf;
+	size_t size;
+	size_t len;
+	bool overflow;
+	bool has_byte;
+	uint8_t byte;
+	uint16_t high_surrogate;
+};
+
+/** @brief Message being reassembled. */
+struct concat_msg {
+	bool used;
+	/** @brief Uptime when the latest part was received. */
+	int64_t updated;
+	/** @brief Header of the first part. */
+	struct sms_deliver_header header;
+	enum sms_deliver_alphabet alphabet;
+	/** @brief Sequence number of the part that continues the decoded data. */
+	uint8_t next_seq;
+	/** @brief Part buffers of the parts received ahead of next_seq, indexed by seq - 1. */
+	uint8_t parts[CONFIG_SMS_CONCAT_MAX_PARTS];
+	struct concat_buf out;
+	uint8_t data[CONFIG_SMS_CONCAT_MAX_LEN];
+};
+
+/** @brief Part received out of order. */
+struct concat_part {
+	bool used;
+	uint8_t len;
+	uint8_t data[SMS_MAX_PAYLOAD_LEN_CHARS];
+};
+
+static struct concat_msg msgs[CONFIG_SMS_CONCAT_MSG_COUNT];
+static struct concat_part part_bufs[CONFIG_SMS_CONCAT_PART_COUNT];
+
+static void concat_timeout(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(concat_timeout_work, concat_timeout);
+
+static void concat_buf_init(struct concat_buf *out, uint8_t *buf, size_t size)
+{
+	memset(out, 0, sizeof(*out));
+	out->buf = buf;
+	out->size = size;
+}
+
+static void concat_buf_append(struct concat_buf *out, const uint8_t *data, size_t len)
+{
+	if (out->overflow || len > out->size - out->len) {
+		out->overflow = true;
+		return;
+	}
+
+	memcpy(&out->buf[out->len], data, len);
+	out->len += len;
+}
+
+static void concat_buf_put_utf8(struct concat_buf *out, uint32_t cp)
+{
+	uint8_t utf8[4];
+	size_t len;
+
+	if (cp < 0x80) {
+		utf8[0] = cp;
+		len = 1;
+	} else if (cp < 0x800) {
+		utf8[0] = 0xC0 | (cp >> 6);
+		utf8[1] = 0x80 | (cp & 0x3F);
+		len = 2;
+	} else if (cp < 0x10000) {
+		utf8[0] = 0xE0 | (cp >> 12);
+		utf8[1] = 0x80 | ((cp >> 6) & 0x3F);
+		utf8[2] = 0x80 | (cp & 0x3F);
+		len = 3;
+	} else {
+		utf8[0] = 0xF0 | (cp >> 18);
+		utf8[1] = 0x80 | ((cp >> 12) & 0x3F);
+		utf8[2] = 0x80 | ((cp >> 6) & 0x3F);
+		utf8[3] = 0x80 | (cp & 0x3F);
+		len = 4;
+	}
+
+	concat_buf_append(out, utf8, len);
+}
+
+/**
+ * @brief Decode UCS2 data into UTF-8.
+ *
+ * @details The network may send UTF-16 surrogate pairs in UCS2 messages,
+ * so they are decoded as well. Unpaired surrogates are replaced with U+FFFD.
+ */
+static void concat_buf_append_ucs2(struct concat_buf *out, const uint8_t *data, size_t len)
+{
+	uint16_t unit;
+
+	for (size_t i = 0; i < len; i++) {
+		if (!out->has_byte) {
+			out->byte = data[i];
+			out->has_byte = true;
+			continue;
+		}
+
+		unit = (out->byte << 8) | data[i];
+		out->has_byte = false;
+
+		if (out->high_surrogate) {
+			if (unit >= 0xDC00 && unit <= 0xDFFF) {
+				concat_buf_put_utf8(out, 0x10000 +
+						    ((out->high_surrogate - 0xD800) << 10) +
+						    (unit - 0xDC00));
+				out->high_surrogate = 0;
+				continue;
+			}
+
+			concat_buf_put_utf8(out, REPLACEMENT_CHAR);
+			out->high_surrogate = 0;
+		}
+
+		if (unit >= 0xD800 && unit <= 0xDBFF) {
+			out->high_surrogate = unit;
+		} else if (unit >= 0xDC00 && unit <= 0xDFFF) {
+			concat_buf_put_utf8(out, REPLACEMENT_CHAR);
+		} else {
+			concat_buf_put_utf8(out, unit);
+		}
+	}
+}
+
+static void concat_buf_finish(struct concat_buf *out)
+{
+	if (out->has_byte || out->high_surrogate) {
+		concat_buf_put_utf8(out, REPLACEMENT_CHAR);
+		out->has_byte = false;
+		out->high_surrogate = 0;
+	}
+}
+
+static void concat_msg_append(struct concat_msg *msg, const uint8_t *data, size_t len)
+{
+	if (msg->alphabet == SMS_DELIVER_ALPHABET_UCS2) {
+		concat_buf_append_ucs2(&msg->out, data, len);
+	} else {
+		concat_buf_append(&msg->out, data, len);
+	}
+}
+
+static void concat_msg_free(struct concat_msg *msg)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(msg->parts); i++) {
+		if (msg->parts[i] != PART_NONE) {
+			part_bufs[msg->parts[i]].used = false;
+		}
+	}
+
+	msg->used = false;
+}
+
+static void concat_msg_init(struct concat_msg *msg, const struct sms_deliver_header *header,
+			    enum sms_deliver_alphabet alphabet)
+{
+	msg->used = true;
+	msg->header = *header;
+	msg->alphabet = alphabet;
+	msg->next_seq = 1;
+	memset(msg->parts, PART_NONE, sizeof(msg->parts));
+	concat_buf_init(&msg->out, msg->data, sizeof(msg->data));
+}
+
+static struct concat_msg *concat_msg_find(const struct sms_deliver_header *header)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(msgs); i++) {
+		if (msgs[i].used &&
+		    msgs[i].header.concatenated.ref_number == header->concatenated.ref_number &&
+		    msgs[i].header.concatenated.total_msgs == header->concatenated.total_msgs &&
+		    strcmp(msgs[i].header.originating_address.address_str,
+			   header->originating_address.address_str) == 0) {
+			return &msgs[i];
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Get a free message, dropping the message that has waited for its next part
+ * the longest if none are free.
+ */
+static struct concat_msg *concat_msg_alloc(void)
+{
+	struct concat_msg *oldest = &msgs[0];
+
+	for (size_t i = 0; i < ARRAY_SIZE(msgs); i++) {
+		if (!msgs[i].used) {
+			return &msgs[i];
+		}
+
+		if (msgs[i].updated < oldest->updated) {
+			oldest = &msgs[i];
+		}
+	}
+
+	LOG_WRN("Dropping concatenated message with reference number %d to make room",
+		oldest->header.concatenated.ref_number);
+	concat_msg_free(oldest);
+
+	return oldest;
+}
+
+static int concat_part_store(struct concat_msg *msg, uint8_t seq, const uint8_t *data,
+			     size_t len)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(part_bufs); i++) {
+		if (!part_bufs[i].used) {
+			part_bufs[i].used = true;
+			part_bufs[i].len = len;
+			memcpy(part_bufs[i].data, data, len);
+			msg->parts[seq - 1] = i;
+
+			return 0;
+		}
+	}
+
+	return -ENOMEM;
+}
+
+static void concat_timeout_schedule(void)
+{
+	int64_t oldest = INT64_MAX;
+	int64_t remaining;
+
+	for (size_t i = 0; i < ARRAY_SIZE(msgs); i++) {
+		if (msgs[i].used) {
+			oldest = MIN(oldest, msgs[i].updated);
+		}
+	}
+
+	if (oldest == INT64_MAX) {
+		k_work_cancel_delayable(&concat_timeout_work);
+		return;
+	}
+
+	remaining = oldest + CONCAT_TIMEOUT_MS - k_uptime_get();
+
+	k_work_reschedule(&concat_timeout_work, K_MSEC(MAX(remaining, 0)));
+}
+
+static void concat_timeout(struct k_work *work)
+{
+	int64_t now = k_uptime_get();
+
+	for (size_t i = 0; i < ARRAY_SIZE(msgs); i++) {
+		if (msgs[i].used &&
+		    now - msgs[i].updated >= CONCAT_TIMEOUT_MS) {
+			LOG_WRN("Timeout in receiving concatenated message with reference number "
+				"%d, %d/%d parts received",
+				msgs[i].header.concatenated.ref_number,
+				msgs[i].next_seq - 1,
+				msgs[i].header.concatenated.total_msgs);
+			concat_msg_free(&msgs[i]);
+		}
+	}
+
+	concat_timeout_schedule();
+}
+
+/**
+ * @brief Decode a message that is not concatenated.
+ */
+static int concat_single(struct sms_data *data, enum sms_deliver_alphabet alphabet)
+{
+	struct concat_buf out;
+
+	if (alphabet != SMS_DELIVER_ALPHABET_UCS2) {
+		return 0;
+	}
+
+	/* Decode from a copy as UTF-8 takes more space than UCS2. */
+	memcpy(sms_payload_tmp, data->payload, data->payload_len);
+
+	concat_buf_init(&out, data->payload, SMS_MAX_PAYLOAD_LEN);
+	concat_buf_append_ucs2(&out, sms_payload_tmp, data->payload_len);
+	concat_buf_finish(&out);
+
+	data->payload_len = out.len;
+	data->payload[out.len] = '\0';
+
+	return 0;
+}
+
+int sms_concat_process(struct sms_data *data, enum sms_deliver_alphabet alphabet)
+{
+	int err;
+	struct sms_deliver_header *header = &data->header.deliver;
+	struct sms_udh_concat *concat = &header->concatenated;
+	struct concat_msg *msg;
+	struct concat_part *part;
+
+	if (!concat->present || concat->total_msgs == 1) {
+		return concat_single(data, alphabet);
+	}
+
+	if (concat->total_msgs > CONFIG_SMS_CONCAT_MAX_PARTS) {
+		LOG_ERR("Concatenated message with %d parts, maximum is %d",
+			concat->total_msgs, CONFIG_SMS_CONCAT_MAX_PARTS);
+		return -EMSGSIZE;
+	}
+
+	msg = concat_msg_find(header);
+	if (!msg) {
+		msg = concat_msg_alloc();
+		concat_msg_init(msg, header, alphabet);
+	}
+
+	msg->updated = k_uptime_get();
+
+	if (concat->seq_number < msg->next_seq || msg->parts[concat->seq_number - 1] != PART_NONE) {
+		LOG_DBG("Duplicate part %d of message with reference number %d",
+			concat->seq_number, concat->ref_number);
+		concat_timeout_schedule();
+		return -EALREADY;
+	}
+
+	if (concat->seq_number == 1) {
+		/* The timestamp of the message is the timestamp of the first part. */
+		msg->header = *header;
+	}
+
+	if (concat->seq_number != msg->next_seq) {
+		err = concat_part_store(msg, concat->seq_number, data->payload, data->payload_len);
+		if (err) {
+			LOG_WRN("No buffer for part %d of message with reference number %d",
+				concat->seq_number, concat->ref_number);
+		}
+
+		concat_timeout_schedule();
+		return err ? err : -EAGAIN;
+	}
+
+	concat_msg_append(msg, data->payload, data->payload_len);
+	msg->next_seq++;
+
+	/* Continue with the parts that were received ahead of this one. */
+	while (msg->next_seq <= concat->total_msgs &&
+	       msg->parts[msg->next_seq - 1] != PART_NONE) {
+		part = &part_bufs[msg->parts[msg->next_seq - 1]];
+
+		concat_msg_append(msg, part->data, part->len);
+
+		part->used = false;
+		msg->parts[msg->next_seq - 1] = PART_NONE;
+		msg->next_seq++;
+	}
+
+	if (msg->next_seq <= concat->total_msgs) {
+		concat_timeout_schedule();
+		return -EAGAIN;
+	}
+
+	concat_buf_finish(&msg->out);
+	concat_msg_free(msg);
+	concat_timeout_schedule();
+
+	if (msg->out.overflow) {
+		LOG_ERR("Concatenated message with reference number %d longer than %d bytes",
+			concat->ref_number, CONFIG_SMS_CONCAT_MAX_LEN);
+		return -EMSGSIZE;
+	}
+
+	data->header.deliver = msg->header;
+	data->header.deliver.concatenated.seq_number = 0;
+	memcpy(data->payload, msg->data, msg->out.len);
+	data->payload_len = msg->out.len;
+	data->payload[data->payload_len] = '\0';
+
+	return 0;
+}
+
+void sms_concat_reset(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(msgs); i++) {
+		if (msgs[i].used) {
+			concat_msg_free(&msgs[i]);
+		}
+	}
+
+	k_work_cancel_delayable(&concat_timeout_work);
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _SMS_CONCAT_INCLUDE_H_
+#define _SMS_CONCAT_INCLUDE_H_
+
+#include "sms_deliver.h"
+
+/* Forward declaration */
+struct sms_data;
+
+/**
+ * @brief Process a received SMS-DELIVER message for concatenated message reassembly
+ * as specified in 3GPP TS 23.040 Section 9.2.3.24.1 and 9.2.3.24.8.
+ *
+ * @details Parts of a concatenated message are identified by the originating address and
+ * the reference number, and they can be received in any order. A part that continues the
+ * message is decoded into the message buffer right away, while parts received ahead of it are
+ * kept until the missing parts are received. When the last part is received, @p data is filled
+ * with the whole message.
+ *
+ * UCS2 user data is decoded into UTF-8, also for messages that are not concatenated.
+ *
+ * Must be called from the system work queue.
+ *
+ * @param[in,out] data Received message. Filled with the reassembled message when 0 is returned.
+ * @param[in] alphabet Character set of the user data in @p data.
+ *
+ * @retval 0 @p data contains a message to be delivered to the listeners.
+ * @retval -EAGAIN The part has been stored until the rest of the message is received.
+ * @retval -EALREADY The part has already been received.
+ * @retval -ENOMEM No buffer is free for a part received out of order. The part is dropped.
+ * @retval -EMSGSIZE The reassembled message does not fit into the message buffer.
+ *                   The message is dropped.
+ */
+int sms_concat_process(struct sms_data *data, enum sms_deliver_alphabet alphabet);
+
+/**
+ * @brief Drop all messages being reassembled.
+ */
+void sms_concat_reset(void);
+
+#endif
@@ -713,6 +713,10 @@ static int decode_pdu_deliver_message(struct parser *parser, uint8_t *buf)
 	case 1:
 		return decode_pdu_ud_8bit(parser, buf);
 	case 2:
+		if (IS_ENABLED(CONFIG_SMS_CONCAT_REASSEMBLY)) {
+			/* UCS2 is decoded into UTF-8 when reassembling the message. */
+			return decode_pdu_ud_8bit(parser, buf);
+		}
 		LOG_ERR("Unsupported data coding scheme: UCS2");
 		return -ENOTSUP;
 	default: /* case 3: is a reserved value */
@@ -819,7 +823,8 @@ void *sms_deliver_get_api(void)
 	return (struct parser_api *)&sms_deliver_api;
 }
 
-int sms_deliver_pdu_parse(const char *pdu, struct sms_data *data)
+int sms_deliver_pdu_parse(const char *pdu, struct sms_data *data,
+			  enum sms_deliver_alphabet *alphabet)
 {
 	static struct parser sms_deliver;
 	struct sms_deliver_header *header;
@@ -827,6 +832,7 @@ int sms_deliver_pdu_parse(const char *pdu, struct sms_data *data)
 
 	__ASSERT(pdu != NULL, "Parameter 'pdu' cannot be NULL.");
 	__ASSERT(data != NULL, "Parameter 'data' cannot be NULL.");
+	__ASSERT(alphabet != NULL, "Parameter 'alphabet' cannot be NULL.");
 
 	header = &data->header.deliver;
 
@@ -855,6 +861,8 @@ int sms_deliver_pdu_parse(const char *pdu, struct sms_data *data)
 		return data->payload_len;
 	}
 
+	*alphabet = ((struct pdu_deliver_data *)sms_deliver.data)->dcs.alphabet;
+
 	LOG_DBG("Time:   %02d-%02d-%02d %02d:%02d:%02d",
 		header->time.year,
 		header->time.month,
@@ -10,17 +10,31 @@
 /* Forward declaration */
 struct sms_data;
 
+/**
+ * @brief Character set of the user data as specified in 3GPP TS 23.038 Section 4.
+ */
+enum sms_deliver_alphabet {
+	/** @brief GSM 7 bit default alphabet, decoded into ASCII. */
+	SMS_DELIVER_ALPHABET_GSM7 = 0,
+	/** @brief 8 bit data. */
+	SMS_DELIVER_ALPHABET_8BIT = 1,
+	/** @brief UCS2, given as big-endian UTF-16 code units. */
+	SMS_DELIVER_ALPHABET_UCS2 = 2,
+};
+
 /**
  * @brief Decode received SMS message, i.e., SMS-DELIVER message as specified
  * in 3GPP TS 23.040 Section 9.2.2.1.
  *
  * @param[in] pdu SMS-DELIVER PDU.
  * @param[out] out SMS message decoded into a structure.
+ * @param[out] alphabet Character set of the user data in @p out.
  *
  * @retval -EINVAL Invalid parameter.
  * @retval -ENOMEM No memory to register new observers.
  * @return Zero on success, otherwise error code.
  */
-int sms_deliver_pdu_parse(const char *pdu, struct sms_data *out);
+int sms_deliver_pdu_parse(const char *pdu, struct sms_data *out,
+			  enum sms_deliver_alphabet *alphabet);
 
 #endif
@@ -15,8 +15,6 @@
 #include <nrf_modem_at.h>
 #include <dk_buttons_and_leds.h>
 
-#include "trace_storage.h"
-
 LOG_MODULE_REGISTER(modem_trace_flash_sample, CONFIG_MODEM_TRACE_FLASH_SAMPLE_LOG_LEVEL);
 
 #define UART1_DT_NODE DT_NODELABEL(uart1)
@@ -46,20 +44,22 @@ static void print_traces(void)
 {
 	const size_t READ_BUF_SIZE = 1024;
 	uint8_t read_buf[READ_BUF_SIZE];
-	int ret = READ_BUF_SIZE;
-	size_t read_offset = 0;
+	int ret;
+	size_t read_total = 0;
 
 	/* Read out the trace data from flash */
-	while (ret == READ_BUF_SIZE) {
-		ret = trace_storage_read(read_buf, READ_BUF_SIZE, read_offset);
-		if (ret < 0) {
+	while (true) {
+		ret = nrf_modem_lib_trace_read(read_buf, READ_BUF_SIZE);
+		if (ret == -ENODATA) {
+			break;
+		} else if (ret < 0) {
 			LOG_ERR("Error reading modem traces: %d", ret);
 			break;
 		}
-		read_offset += ret;
+		read_total += ret;
 		print_uart1(read_buf, ret);
 	}
-	LOG_INF("Total trace bytes read from flash: %d", read_offset);
+	LOG_INF("Total trace bytes read from flash: %zu", read_total);
 }
 
 static void button_handler(uint32_t button_states, uint32_t has_changed)
@@ -124,11 +124,5 @@ void main(void)
 	 */
 	k_sleep(K_SECONDS(1));
 
-	err = trace_storage_flush();
-	if (err) {
-		LOG_ERR("Flushing modem traces to flash failed %d\n", err);
-	} else {
-		LOG_INF("Flushed modem traces to flash\n");
-	}
-
+	LOG_INF("%zu bytes of modem traces stored in flash\n", nrf_modem_lib_trace_data_size());
 }
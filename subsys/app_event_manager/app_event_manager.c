@@ -5,7 +5,9 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <zephyr/kernel.h>
+#include <zephyr/init.h>
 #include <zephyr/spinlock.h>
 #include <zephyr/sys/slist.h>
 #include <app_event_manager.h>
@@ -19,9 +21,70 @@ static void event_processor_fn(struct k_work *work);
 
 struct app_event_manager_event_display_bm _app_event_manager_event_display_bm;
 
-static K_WORK_DEFINE(event_processor, event_processor_fn);
-static sys_slist_t eventq = SYS_SLIST_STATIC_INIT(&eventq);
-static struct k_spinlock lock;
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LOCKLESS_QUEUE)
+/* Intrusive multi-producer single-consumer queue. Producers only exchange the head pointer,
+ * the consumer (event processor) owns the tail. The stub node keeps the queue non-empty.
+ */
+struct event_mpsc_queue {
+	atomic_ptr_t head;
+	sys_snode_t *tail;
+	sys_snode_t stub;
+};
+#endif
+
+/* Events of a lane are queued and processed in order by a single work item. */
+struct event_lane {
+	struct k_work work;
+	struct k_work_q *work_q;
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LOCKLESS_QUEUE)
+	struct event_mpsc_queue queue;
+#else
+	sys_slist_t queue;
+	struct k_spinlock lock;
+#endif
+};
+
+enum event_lane_id {
+	EVENT_LANE_NORMAL,
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES)
+	EVENT_LANE_HIGH,
+#endif
+	EVENT_LANE_COUNT
+};
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LOCKLESS_QUEUE)
+#define EVENT_LANE_QUEUE_INITIALIZER(id) {		\
+		.head = &lanes[id].queue.stub,		\
+		.tail = &lanes[id].queue.stub,		\
+	}
+#else
+#define EVENT_LANE_QUEUE_INITIALIZER(id) SYS_SLIST_STATIC_INIT(&lanes[id].queue)
+#endif
+
+#define EVENT_LANE_INITIALIZER(id, wq) {				\
+		.work = Z_WORK_INITIALIZER(event_processor_fn),		\
+		.work_q = (wq),						\
+		.queue = EVENT_LANE_QUEUE_INITIALIZER(id),		\
+	}
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES)
+static K_THREAD_STACK_DEFINE(high_lane_stack, CONFIG_APP_EVENT_MANAGER_HIGH_LANE_STACK_SIZE);
+static struct k_work_q high_lane_work_q;
+#endif
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCING)
+/* Queued and not yet processed instance of every coalescable event type.
+ * Protected by the lock of the lane that processes the event type.
+ */
+static struct app_event_header *coalesce_pending[CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT];
+#endif
+
+static struct event_lane lanes[EVENT_LANE_COUNT] = {
+	[EVENT_LANE_NORMAL] = EVENT_LANE_INITIALIZER(EVENT_LANE_NORMAL, &k_sys_work_q),
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES)
+	[EVENT_LANE_HIGH] = EVENT_LANE_INITIALIZER(EVENT_LANE_HIGH, &high_lane_work_q),
+#endif
+};
 
 static bool log_is_event_displayed(const struct event_type *et)
 {
@@ -132,27 +195,316 @@ void * __weak app_event_manager_alloc(size_t size)
 	return event;
 }
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_POOLS)
+static bool pool_owns(const struct app_event_pool *pool, const void *addr)
+{
+	const char *end = pool->buf + (pool->block_cnt * pool->block_size);
+
+	return ((const char *)addr >= pool->buf) && ((const char *)addr < end);
+}
+
+/* Return the event to the pool of its event type, if it was allocated from the pool. */
+static bool pool_free(void *event)
+{
+	const struct app_event_header *aeh = event;
+
+	APP_EVENT_ASSERT_ID(aeh->type_id);
+
+	struct app_event_pool *pool = aeh->type_id->pool;
+
+	if (!pool || !pool_owns(pool, event)) {
+		return false;
+	}
+
+	k_mem_slab_free(&pool->slab, &event);
+
+	return true;
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_EVENT_POOLS */
+
 void __weak app_event_manager_free(void *addr)
 {
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_POOLS)
+	if (pool_free(addr)) {
+		return;
+	}
+#endif
+
 	k_free(addr);
 }
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_POOLS)
+static int app_event_manager_pools_init(const struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	STRUCT_SECTION_FOREACH(event_type, et) {
+		struct app_event_pool *pool = et->pool;
+
+		if (pool) {
+			int err = k_mem_slab_init(&pool->slab, pool->buf, pool->block_size,
+						  pool->block_cnt);
+
+			__ASSERT_NO_MSG(!err);
+			ARG_UNUSED(err);
+		}
+	}
+
+	return 0;
+}
+
+SYS_INIT(app_event_manager_pools_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+static void pool_max_used_update(struct app_event_pool *pool)
+{
+	atomic_val_t used = k_mem_slab_num_used_get(&pool->slab);
+	atomic_val_t max_used = atomic_get(&pool->max_used);
+
+	while ((used > max_used) && !atomic_cas(&pool->max_used, max_used, used)) {
+		max_used = atomic_get(&pool->max_used);
+	}
+}
+
+void *_event_alloc(const struct event_type *et, size_t size)
+{
+	struct app_event_pool *pool = et->pool;
+	void *event;
+
+	if (pool) {
+		__ASSERT_NO_MSG(size <= pool->block_size);
+
+		if (!k_mem_slab_alloc(&pool->slab, &event, K_NO_WAIT)) {
+			pool_max_used_update(pool);
+			return event;
+		}
+
+		atomic_inc(&pool->heap_fallback_cnt);
+	}
+
+	return app_event_manager_alloc(size);
+}
+
+int app_event_manager_pool_stats_get(const struct event_type *et,
+				     struct app_event_manager_pool_stats *stats)
+{
+	const struct app_event_pool *pool = et->pool;
+
+	APP_EVENT_ASSERT_ID(et);
+
+	if (!pool) {
+		return -ENOTSUP;
+	}
+
+	stats->block_cnt = pool->block_cnt;
+	stats->used = k_mem_slab_num_used_get(&pool->slab);
+	stats->max_used = atomic_get(&pool->max_used);
+	stats->heap_fallback_cnt = atomic_get(&pool->heap_fallback_cnt);
+
+	return 0;
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_EVENT_POOLS */
+
+void app_event_manager_event_free(void *event)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_POOLS)
+	if (pool_free(event)) {
+		return;
+	}
+#endif
+
+	app_event_manager_free(event);
+}
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LOCKLESS_QUEUE)
+static void eventq_push(struct event_mpsc_queue *q, sys_snode_t *node)
+{
+	atomic_ptr_set((atomic_ptr_t *)&node->next, NULL);
+
+	sys_snode_t *prev = atomic_ptr_set(&q->head, node);
+
+	/* Link the node to the queue. Until then the consumer sees the queue as empty. */
+	atomic_ptr_set((atomic_ptr_t *)&prev->next, node);
+}
+
+static sys_snode_t *eventq_pop(struct event_mpsc_queue *q)
+{
+	sys_snode_t *tail = q->tail;
+	sys_snode_t *next = atomic_ptr_get((atomic_ptr_t *)&tail->next);
+
+	if (tail == &q->stub) {
+		if (!next) {
+			return NULL;
+		}
+		q->tail = next;
+		tail = next;
+		next = atomic_ptr_get((atomic_ptr_t *)&tail->next);
+	}
+
+	if (next) {
+		q->tail = next;
+		return tail;
+	}
+
+	if (tail != atomic_ptr_get(&q->head)) {
+		/* Producer is in the middle of linking a node. The producer submits
+		 * the processor work after the node is linked, so it is not lost.
+		 */
+		return NULL;
+	}
+
+	eventq_push(q, &q->stub);
+
+	next = atomic_ptr_get((atomic_ptr_t *)&tail->next);
+	if (next) {
+		q->tail = next;
+		return tail;
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_LOCKLESS_QUEUE */
+
+static struct event_lane *event_lane_get(const struct event_type *et)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES)
+	if (app_event_get_type_flag(et, APP_EVENT_TYPE_FLAGS_HIGH_PRIORITY)) {
+		return &lanes[EVENT_LANE_HIGH];
+	}
+#endif
+
+	return &lanes[EVENT_LANE_NORMAL];
+}
+
+static void eventq_get_all(struct event_lane *lane, sys_slist_t *events)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LOCKLESS_QUEUE)
+	sys_snode_t *node;
+
+	while ((node = eventq_pop(&lane->queue)) != NULL) {
+		sys_slist_append(events, node);
+	}
+#else
+	k_spinlock_key_t key = k_spin_lock(&lane->lock);
+
+	sys_slist_merge_slist(events, &lane->queue);
+
+	k_spin_unlock(&lane->lock, key);
+#endif
+}
+
+static bool subscriber_filter_match(const struct event_subscriber *es,
+				    const struct app_event_header *aeh)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTERS)
+	const struct event_subscriber_filter *filter = &es->filter;
+	const uint8_t *field = (const uint8_t *)aeh + filter->offset;
+
+	switch (filter->size) {
+	case 0:
+		return true;
+
+	case sizeof(uint8_t):
+		return *field == (uint8_t)filter->value;
+
+	case sizeof(uint16_t):
+		return UNALIGNED_GET((const uint16_t *)field) == (uint16_t)filter->value;
+
+	case sizeof(uint32_t):
+		return UNALIGNED_GET((const uint32_t *)field) == filter->value;
+
+	default:
+		__ASSERT_NO_MSG(false);
+		return true;
+	}
+#else
+	return true;
+#endif
+}
+
+static bool listener_notify(const struct app_event_header *aeh,
+			    const struct event_listener *el)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_HOOKS)) {
+		return el->notification(aeh);
+	}
+
+	uint32_t start = k_cycle_get_32();
+	bool consumed = el->notification(aeh);
+	uint32_t cycles = k_cycle_get_32() - start;
+
+	STRUCT_SECTION_FOREACH(event_listener_hook, h) {
+		h->hook(aeh, el, cycles);
+	}
+
+	return consumed;
+}
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCING)
+void app_event_coalesce_latest(struct app_event_header *pending,
+			       const struct app_event_header *aeh)
+{
+	size_t size = app_event_manager_event_size(aeh);
+
+	__ASSERT_NO_MSG(pending->type_id == aeh->type_id);
+
+	memcpy((uint8_t *)pending + sizeof(*pending), (const uint8_t *)aeh + sizeof(*aeh),
+	       size - sizeof(*aeh));
+}
+
+/* Must be called under the lane lock. */
+static bool event_coalesce(struct app_event_header *aeh)
+{
+	const struct event_type *et = aeh->type_id;
+
+	if (!et->coalesce_fn) {
+		return false;
+	}
+
+	size_t idx = et - _event_type_list_start;
+	struct app_event_header *pending = coalesce_pending[idx];
+
+	if (!pending) {
+		coalesce_pending[idx] = aeh;
+		return false;
+	}
+
+	et->coalesce_fn(pending, aeh);
+
+	return true;
+}
+
+static void event_coalesce_finish(struct event_lane *lane, const struct app_event_header *aeh)
+{
+	const struct event_type *et = aeh->type_id;
+
+	if (!et->coalesce_fn) {
+		return;
+	}
+
+	size_t idx = et - _event_type_list_start;
+	k_spinlock_key_t key = k_spin_lock(&lane->lock);
+
+	/* Events submitted from now on are queued as a new instance. */
+	if (coalesce_pending[idx] == aeh) {
+		coalesce_pending[idx] = NULL;
+	}
+
+	k_spin_unlock(&lane->lock, key);
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_COALESCING */
+
 static void event_processor_fn(struct k_work *work)
 {
+	struct event_lane *lane = CONTAINER_OF(work, struct event_lane, work);
 	sys_slist_t events = SYS_SLIST_STATIC_INIT(&events);
 
 	/* Make current event list local. */
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	eventq_get_all(lane, &events);
 
-	if (sys_slist_is_empty(&eventq)) {
-		k_spin_unlock(&lock, key);
+	if (sys_slist_is_empty(&events)) {
 		return;
 	}
 
-	sys_slist_merge_slist(&events, &eventq);
-
-	k_spin_unlock(&lock, key);
-
 	/* Traverse the list of events. */
 	sys_snode_t *node;
 	while (NULL != (node = sys_slist_get(&events))) {
@@ -164,6 +516,10 @@ static void event_processor_fn(struct k_work *work)
 
 		const struct event_type *et = aeh->type_id;
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCING)
+		event_coalesce_finish(lane, aeh);
+#endif
+
 		if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PREPROCESS_HOOKS)) {
 			STRUCT_SECTION_FOREACH(event_preprocess_hook, h) {
 				h->hook(aeh);
@@ -180,6 +536,10 @@ static void event_processor_fn(struct k_work *work)
 
 			__ASSERT_NO_MSG(es != NULL);
 
+			if (!subscriber_filter_match(es, aeh)) {
+				continue;
+			}
+
 			const struct event_listener *el = es->listener;
 
 			__ASSERT_NO_MSG(el != NULL);
@@ -187,7 +547,7 @@ static void event_processor_fn(struct k_work *work)
 
 			log_event_progress(et, el);
 
-			consumed = el->notification(aeh);
+			consumed = listener_notify(aeh, el);
 
 			if (consumed) {
 				log_event_consumed(et);
@@ -200,28 +560,126 @@ static void event_processor_fn(struct k_work *work)
 			}
 		}
 
-		app_event_manager_free(aeh);
+		app_event_manager_event_free(aeh);
 	}
 }
 
+/* Add the event to the lane queue. Must be called under the lane lock unless the lock-free
+ * queue is used. Returns false if the event was merged into an already queued event.
+ */
+static bool event_enqueue(struct event_lane *lane, struct app_event_header *aeh)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCING)
+	if (event_coalesce(aeh)) {
+		return false;
+	}
+#endif
+
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBMIT_HOOKS)) {
+		STRUCT_SECTION_FOREACH(event_submit_hook, h) {
+			h->hook(aeh);
+		}
+	}
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LOCKLESS_QUEUE)
+	eventq_push(&lane->queue, &aeh->node);
+#else
+	sys_slist_append(&lane->queue, &aeh->node);
+#endif
+
+	return true;
+}
+
 void _event_submit(struct app_event_header *aeh)
 {
 	__ASSERT_NO_MSG(aeh);
 	APP_EVENT_ASSERT_ID(aeh->type_id);
 
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	struct event_lane *lane = event_lane_get(aeh->type_id);
+	bool queued;
 
-	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBMIT_HOOKS)) {
-		STRUCT_SECTION_FOREACH(event_submit_hook, h) {
-			h->hook(aeh);
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LOCKLESS_QUEUE)
+	queued = event_enqueue(lane, aeh);
+#else
+	k_spinlock_key_t key = k_spin_lock(&lane->lock);
+
+	queued = event_enqueue(lane, aeh);
+
+	k_spin_unlock(&lane->lock, key);
+#endif
+
+	if (!queued) {
+		app_event_manager_event_free(aeh);
+		return;
+	}
+
+	k_work_submit_to_queue(lane->work_q, &lane->work);
+}
+
+void _event_submit_batch(struct app_event_header * const *aehs, size_t cnt)
+{
+	if (cnt == 0) {
+		return;
+	}
+
+	bool lane_used[EVENT_LANE_COUNT] = {false};
+
+	for (size_t i = 0; i < cnt; ) {
+		__ASSERT_NO_MSG(aehs[i]);
+		APP_EVENT_ASSERT_ID(aehs[i]->type_id);
+
+		struct event_lane *lane = event_lane_get(aehs[i]->type_id);
+		struct app_event_header *coalesced = NULL;
+
+#if !IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LOCKLESS_QUEUE)
+		k_spinlock_key_t key = k_spin_lock(&lane->lock);
+#endif
+
+		/* Queue all the subsequent events of the lane under a single lock. An event merged
+		 * into a queued one ends the run, so that it is freed outside of the lock.
+		 */
+		do {
+			if (event_enqueue(lane, aehs[i])) {
+				lane_used[lane - lanes] = true;
+			} else {
+				coalesced = aehs[i];
+			}
+
+			i++;
+		} while (!coalesced && (i < cnt) && (event_lane_get(aehs[i]->type_id) == lane));
+
+#if !IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LOCKLESS_QUEUE)
+		k_spin_unlock(&lane->lock, key);
+#endif
+
+		if (coalesced) {
+			app_event_manager_event_free(coalesced);
 		}
 	}
-	sys_slist_append(&eventq, &aeh->node);
-	k_spin_unlock(&lock, key);
 
-	k_work_submit(&event_processor);
+	for (size_t i = 0; i < ARRAY_SIZE(lanes); i++) {
+		if (lane_used[i]) {
+			k_work_submit_to_queue(lanes[i].work_q, &lanes[i].work);
+		}
+	}
 }
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES)
+static void high_lane_init(void)
+{
+	static const struct k_work_queue_config cfg = {
+		.name = "app_event_manager_high",
+	};
+
+	k_work_queue_start(&high_lane_work_q, high_lane_stack,
+			   K_THREAD_STACK_SIZEOF(high_lane_stack),
+			   CONFIG_APP_EVENT_MANAGER_HIGH_LANE_THREAD_PRIORITY, &cfg);
+
+	/* Process events submitted before the work queue was started. */
+	k_work_submit_to_queue(&high_lane_work_q, &lanes[EVENT_LANE_HIGH].work);
+}
+#endif
+
 int app_event_manager_init(void)
 {
 	int ret = 0;
@@ -231,6 +689,10 @@ int app_event_manager_init(void)
 
 	log_event_init();
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES)
+	high_lane_init();
+#endif
+
 	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_POSTINIT_HOOK)) {
 		STRUCT_SECTION_FOREACH(app_event_manager_postinit_hook, h) {
 			ret = h->hook();
@@ -116,11 +116,45 @@ extern "C" {
 		.listener = &_CONCAT(__event_listener_, lname),				\
 	}
 
+/* Subscribe a listener to events with a given value of the event field. */
+#define _APP_EVENT_SUBSCRIBE_FILTERED(lname, ename, prio, field, field_value)		\
+	BUILD_ASSERT(IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTERS),		\
+		     "Enable APP_EVENT_MANAGER_SUBSCRIBER_FILTERS before usage");	\
+	BUILD_ASSERT((sizeof(((struct ename *)0)->field) == sizeof(uint8_t)) ||		\
+		     (sizeof(((struct ename *)0)->field) == sizeof(uint16_t)) ||	\
+		     (sizeof(((struct ename *)0)->field) == sizeof(uint32_t)),		\
+		     "Unsupported size of the filtered field");				\
+	const struct event_subscriber _CONCAT(_CONCAT(__event_subscriber_, ename), lname)\
+	__used __aligned(__alignof(struct event_subscriber))				\
+	__attribute__((__section__(_APP_EVENT_SUBSCRIBERS_SECTION_NAME(ename, prio)))) = {\
+		.listener = &_CONCAT(__event_listener_, lname),				\
+		_APP_EVENT_SUBSCRIBER_FILTER(ename, field, field_value)			\
+	}
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTERS)
+#define _APP_EVENT_SUBSCRIBER_FILTER(ename, field, field_value)			\
+	.filter = {									\
+		.offset = offsetof(struct ename, field),				\
+		.size = sizeof(((struct ename *)0)->field),				\
+		.value = (uint32_t)(field_value),					\
+	},
+#else
+#define _APP_EVENT_SUBSCRIBER_FILTER(ename, field, field_value)
+#endif
+
 
 /* Pointer to event type definition is used as event type identifier. */
 #define _EVENT_ID(ename) (&_CONCAT(__event_type_, ename))
 
 
+/* Allocate memory for an event of the given ename type. */
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_POOLS)
+#define _APP_EVENT_ALLOC(ename, size) _event_alloc(_EVENT_ID(ename), (size))
+#else
+#define _APP_EVENT_ALLOC(ename, size) app_event_manager_alloc(size)
+#endif
+
+
 /* Macro generates a function of name new_ename where ename is provided as
  * an argument. Allocator function is used to create an event of the given
  * ename type.
@@ -129,7 +163,7 @@ extern "C" {
 	static inline struct ename *_CONCAT(new_, ename)(void)			\
 	{									\
 		struct ename *event =						\
-			(struct ename *)app_event_manager_alloc(sizeof(*event));\
+			(struct ename *)_APP_EVENT_ALLOC(ename, sizeof(*event));\
 		BUILD_ASSERT(offsetof(struct ename, header) == 0,		\
 				 "");						\
 		if (event != NULL) {						\
@@ -147,7 +181,7 @@ extern "C" {
 	static inline struct ename *_CONCAT(new_, ename)(size_t size)			\
 	{										\
 		struct ename *event =							\
-			(struct ename *)app_event_manager_alloc(sizeof(*event) + size);	\
+			(struct ename *)_APP_EVENT_ALLOC(ename, sizeof(*event) + size);	\
 		BUILD_ASSERT((offsetof(struct ename, dyndata) +				\
 				  sizeof(event->dyndata.size)) ==			\
 				 sizeof(*event), "");					\
@@ -189,6 +223,10 @@ extern "C" {
 
 
 
+/* Pointer to the header of the event, used to build event batches. */
+#define _APP_EVENT_HEADER_PTR(event) (&(event)->header)
+
+
 /* Declarations and definitions - for more details refer to public API. */
 #define _APP_EVENT_LISTENER(lname, notification_fn)					\
 	STRUCT_SECTION_ITERABLE(event_listener, _CONCAT(__event_listener_, lname)) = {	\
@@ -221,6 +259,33 @@ extern "C" {
 #define _APP_EVENT_TYPE_DEFINE_SIZES(ename)
 #endif
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_POOLS)
+#define _APP_EVENT_POOL_NAME(ename) _CONCAT(__event_pool_, ename)
+#define _APP_EVENT_POOL_BUF_NAME(ename) _CONCAT(__event_pool_buf_, ename)
+#define _APP_EVENT_POOL_BLOCK_SIZE(ename) WB_UP(sizeof(struct ename))
+#define _APP_EVENT_POOL_BLOCK_CNT(ename)						\
+	((_CONCAT(ename, _HAS_DYNDATA)) ? 0 : CONFIG_APP_EVENT_MANAGER_EVENT_POOL_SIZE)
+
+/* The slab is initialized on system startup. Events with dynamic data do not have a fixed
+ * size, so they have no pool. Their buffer is empty and the pool is not referenced.
+ */
+#define _APP_EVENT_POOL_DEFINE(ename)							\
+	static char __noinit __aligned(MAX(__alignof__(struct ename), sizeof(void *)))	\
+		_APP_EVENT_POOL_BUF_NAME(ename)[_APP_EVENT_POOL_BLOCK_CNT(ename) *	\
+						_APP_EVENT_POOL_BLOCK_SIZE(ename)];	\
+	static struct app_event_pool _APP_EVENT_POOL_NAME(ename) = {			\
+		.buf = _APP_EVENT_POOL_BUF_NAME(ename),					\
+		.block_size = _APP_EVENT_POOL_BLOCK_SIZE(ename),			\
+		.block_cnt = _APP_EVENT_POOL_BLOCK_CNT(ename),				\
+	};
+
+#define _APP_EVENT_TYPE_DEFINE_POOL(ename)						\
+	.pool = ((_CONCAT(ename, _HAS_DYNDATA)) ? NULL : &_APP_EVENT_POOL_NAME(ename)),
+#else
+#define _APP_EVENT_POOL_DEFINE(ename)
+#define _APP_EVENT_TYPE_DEFINE_POOL(ename)
+#endif
+
 /** @brief Event header.
  *
  * When defining an event structure, the application event header
@@ -237,6 +302,10 @@ struct app_event_header {
 /** Function to log data from this event. */
 typedef void (*log_event_data)(const struct app_event_header *aeh);
 
+/** Function merging a submitted event into the queued event of the same type. */
+typedef void (*app_event_coalesce_fn)(struct app_event_header *pending,
+				      const struct app_event_header *aeh);
+
 /** Deprecated function to log data from this event. */
 typedef	int (*log_event_data_dep)(const struct app_event_header *aeh,
 				  char *buf,
@@ -264,6 +333,28 @@ typedef	int (*log_event_data_dep)(const struct app_event_header *aeh,
 #define _APP_EVENT_TYPE_DEFINE_LOG_FUN(log_fun) .log_event_func = log_fun,
 #endif
 
+/** @brief Memory pool of an event type.
+ */
+struct app_event_pool {
+	/** Memory slab holding the events. */
+	struct k_mem_slab slab;
+
+	/** Buffer of the slab. */
+	char *buf;
+
+	/** Size of a block of the slab, in bytes. */
+	size_t block_size;
+
+	/** Number of blocks of the slab. */
+	uint32_t block_cnt;
+
+	/** Maximum number of events allocated from the slab at the same time. */
+	atomic_t max_used;
+
+	/** Number of allocations that fell back to the heap. */
+	atomic_t heap_fallback_cnt;
+};
+
 /** @brief Event type.
  */
 struct event_type {
@@ -294,6 +385,16 @@ struct event_type {
 	/** The size of the event structure */
 	uint16_t struct_size;
 #endif
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_POOLS)
+	/** Memory pool of the event type or NULL if events are allocated from the heap. */
+	struct app_event_pool *pool;
+#endif
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCING)
+	/** Function merging events of this type or NULL if events are not coalesced. */
+	app_event_coalesce_fn coalesce_fn;
+#endif
 };
 
 
@@ -301,11 +402,28 @@ extern struct event_type _event_type_list_start[];
 extern struct event_type _event_type_list_end[];
 
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCING)
+#define _APP_EVENT_TYPE_DEFINE_COALESCE_FN(coalesce_fn) .coalesce_fn = (coalesce_fn),
+#else
+#define _APP_EVENT_TYPE_DEFINE_COALESCE_FN(coalesce_fn)
+#endif
+
 #define _APP_EVENT_TYPE_DEFINE(ename, log_fn, trace_data_pointer, et_flags)		\
+	_APP_EVENT_TYPE_DEFINE_EXT(ename, log_fn, trace_data_pointer, et_flags, NULL)
+
+#define _APP_EVENT_TYPE_DEFINE_COALESCING(ename, log_fn, trace_data_pointer, et_flags,	\
+					  coalesce_fn)					\
+	BUILD_ASSERT(!_CONCAT(ename, _HAS_DYNDATA),					\
+		     "Events with dynamic data cannot be coalesced");			\
+	_APP_EVENT_TYPE_DEFINE_EXT(ename, log_fn, trace_data_pointer, et_flags, coalesce_fn)
+
+#define _APP_EVENT_TYPE_DEFINE_EXT(ename, log_fn, trace_data_pointer, et_flags,	\
+				   coalesce_fn)						\
 	BUILD_ASSERT(((et_flags) & ((BIT_MASK(APP_EVENT_TYPE_FLAGS_USER_SETTABLE_START-	\
 		APP_EVENT_TYPE_FLAGS_SYSTEM_START))<<					\
 		APP_EVENT_TYPE_FLAGS_SYSTEM_START)) == 0);				\
 	_APP_EVENT_SUBSCRIBERS_ARRAY_TAGS(ename);					\
+	_APP_EVENT_POOL_DEFINE(ename)							\
 	STRUCT_SECTION_ITERABLE(event_type, _CONCAT(__event_type_, ename)) = {		\
 		.name            = STRINGIFY(ename),					\
 		.subs_start      = _APP_EVENT_SUBSCRIBERS_START_TAG(ename),		\
@@ -317,6 +435,8 @@ extern struct event_type _event_type_list_end[];
 				((et_flags) | BIT(APP_EVENT_TYPE_FLAGS_HAS_DYNDATA)) :	\
 				((et_flags) & (~BIT(APP_EVENT_TYPE_FLAGS_HAS_DYNDATA)))),\
 		_APP_EVENT_TYPE_DEFINE_SIZES(ename) /* No comma here intentionally */	\
+		_APP_EVENT_TYPE_DEFINE_POOL(ename) /* No comma here intentionally */	\
+		_APP_EVENT_TYPE_DEFINE_COALESCE_FN(coalesce_fn) /* No comma here intentionally */\
 	}
 
 /**
@@ -356,6 +476,11 @@ extern struct app_event_manager_event_display_bm _app_event_manager_event_displa
 		     "Enable APP_EVENT_MANAGER_POSTPROCESS_HOOKS before usage"); \
 	_APP_EVENT_HOOK_REGISTER(event_postprocess_hook, hook_fn, prio)
 
+#define _APP_EVENT_HOOK_LISTENER_REGISTER(hook_fn, prio)                      \
+	BUILD_ASSERT(IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_HOOKS),     \
+		     "Enable APP_EVENT_MANAGER_LISTENER_HOOKS before usage"); \
+	_APP_EVENT_HOOK_REGISTER(event_listener_hook, hook_fn, prio)
+
 /**
  * @brief Joining together event type flags.
  */
@@ -392,11 +517,33 @@ struct event_listener {
 };
 
 
+/** @brief Event subscriber filter.
+ *
+ * The listener is notified only about events with the given value of the field located
+ * at the given offset.
+ */
+struct event_subscriber_filter {
+	/** Value of the field. */
+	uint32_t value;
+
+	/** Offset of the field in the event structure. */
+	uint16_t offset;
+
+	/** Size of the field in bytes. Zero means that the filter is not used. */
+	uint8_t size;
+};
+
+
 /** @brief Event subscriber.
  */
 struct event_subscriber {
 	/** Pointer to the listener. */
 	const struct event_listener *listener;
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTERS)
+	/** Filter applied before the listener is notified. */
+	struct event_subscriber_filter filter;
+#endif
 };
 
 
@@ -427,6 +574,26 @@ struct event_postprocess_hook {
 	void (*hook)(const struct app_event_header *aeh);
 };
 
+/** @brief Structure used to register event listener hook
+ */
+struct event_listener_hook {
+	/** @brief Hook function */
+	void (*hook)(const struct app_event_header *aeh, const struct event_listener *el,
+		     uint32_t cycles);
+};
+
+
+
+/** @brief Allocate an event of the given type.
+ *
+ * The event is taken from the event type pool. If the pool is not available or exhausted,
+ * the memory is allocated using @ref app_event_manager_alloc.
+ *
+ * @param et    Pointer to the event type.
+ * @param size  Size of the event (in bytes).
+ * @retval Address of the allocated memory if successful, otherwise NULL.
+ */
+void *_event_alloc(const struct event_type *et, size_t size);
 
 
 /** @brief Submit an event to the Application Event Manager.
@@ -435,6 +602,14 @@ struct event_postprocess_hook {
  */
 void _event_submit(struct app_event_header *aeh);
 
+
+/** @brief Submit multiple events to the Application Event Manager.
+ *
+ * @param aehs  Array of pointers to the application event header elements in the event objects.
+ * @param cnt   Number of events.
+ */
+void _event_submit_batch(struct app_event_header * const *aehs, size_t cnt);
+
 #ifdef __cplusplus
 }
 #endif
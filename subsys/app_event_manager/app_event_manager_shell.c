@@ -81,6 +81,31 @@ static int show_subscribers(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_POOLS)
+static int show_pools(const struct shell *shell, size_t argc,
+		      char **argv)
+{
+	shell_fprintf(shell, SHELL_NORMAL, "Event pools:\n");
+
+	STRUCT_SECTION_FOREACH(event_type, et) {
+		struct app_event_manager_pool_stats stats;
+
+		if (app_event_manager_pool_stats_get(et, &stats)) {
+			shell_fprintf(shell, SHELL_NORMAL, "|\t[E:%s] heap only\n",
+				      et->name);
+			continue;
+		}
+
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "|\t[E:%s] used: %u/%u max: %u heap fallbacks: %u\n",
+			      et->name, stats.used, stats.block_cnt, stats.max_used,
+			      stats.heap_fallback_cnt);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_EVENT_POOLS */
+
 static void set_event_displaying(const struct shell *shell, size_t argc,
 				 char **argv, bool enable)
 {
@@ -155,6 +180,9 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_app_event_manager,
 	SHELL_CMD_ARG(show_subscribers, NULL, "Show subscribers",
 		      show_subscribers, 0, 0),
 	SHELL_CMD_ARG(show_events, NULL, "Show events", show_events, 0, 0),
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_POOLS)
+	SHELL_CMD_ARG(show_pools, NULL, "Show event pools statistics", show_pools, 0, 0),
+#endif
 	SHELL_CMD_ARG(disable, NULL, "Disable displaying event with given ID",
 		      disable_event_displaying, 0,
 		      sizeof(_app_event_manager_event_display_bm) * 8 - 1),
@@ -10,7 +10,16 @@
 
 LOG_MODULE_REGISTER(app_event_manager_profiler_tracer, CONFIG_APP_EVENT_MANAGER_LOG_LEVEL);
 
-#define IDS_COUNT (CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT + 2)
+/* Offsets of the nrf_profiler events registered after the Application Event Manager events. */
+#define EXEC_START_ID_OFFSET	0
+#define EXEC_END_ID_OFFSET	1
+#define LISTENER_ID_OFFSET	2
+
+/* Number of the nrf_profiler events registered after the Application Event Manager events. */
+#define EXTRA_IDS_COUNT \
+	(IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_TRACE_LISTENERS) ? 3 : 2)
+
+#define IDS_COUNT (CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT + EXTRA_IDS_COUNT)
 
 extern struct nrf_profiler_info _nrf_profiler_info_list_start[];
 extern struct nrf_profiler_info _nrf_profiler_info_list_end[];
@@ -28,7 +37,7 @@ static void app_event_manager_trace_event_execution(const struct app_event_heade
 					      bool is_start)
 {
 	size_t event_cnt = _nrf_profiler_info_list_end - _nrf_profiler_info_list_start;
-	size_t event_idx = event_cnt + (is_start ? 0 : 1);
+	size_t event_idx = event_cnt + (is_start ? EXEC_START_ID_OFFSET : EXEC_END_ID_OFFSET);
 	size_t trace_evt_id = nrf_profiler_event_ids[event_idx];
 
 	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_TRACE_EVENT_EXECUTION) ||
@@ -58,6 +67,42 @@ static void app_event_manager_trace_event_postprocess(const struct app_event_hea
 APP_EVENT_HOOK_PREPROCESS_REGISTER_FIRST(app_event_manager_trace_event_preprocess);
 APP_EVENT_HOOK_POSTPROCESS_REGISTER_LAST(app_event_manager_trace_event_postprocess);
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_TRACE_LISTENERS)
+/** @brief Trace time spent in the event listener.
+ *
+ * @param aeh     Pointer to the application event header of the event that is
+ *                processed by app_event_manager.
+ * @param el      Pointer to the notified listener.
+ * @param cycles  Time spent in the listener in hardware cycles.
+ **/
+static void app_event_manager_trace_listener(const struct app_event_header *aeh,
+					     const struct event_listener *el,
+					     uint32_t cycles)
+{
+	size_t event_cnt = _nrf_profiler_info_list_end - _nrf_profiler_info_list_start;
+	size_t trace_evt_id = nrf_profiler_event_ids[event_cnt + LISTENER_ID_OFFSET];
+
+	if (!is_profiling_enabled(trace_evt_id)) {
+		return;
+	}
+
+	struct log_event_buf buf;
+
+	ARG_UNUSED(buf);
+
+	nrf_profiler_log_start(&buf);
+
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_TRACE_EVENT_EXECUTION)) {
+		nrf_profiler_log_add_mem_address(&buf, aeh);
+	}
+	nrf_profiler_log_encode_string(&buf, el->name);
+	nrf_profiler_log_encode_uint32(&buf, k_cyc_to_us_floor32(cycles));
+	nrf_profiler_log_send(&buf, trace_evt_id);
+}
+
+APP_EVENT_HOOK_LISTENER_REGISTER(app_event_manager_trace_listener);
+#endif /* CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_TRACE_LISTENERS */
+
 /** @brief Trace event submission.
  *
  * @param aeh Pointer to the application event header of the event that is
@@ -111,13 +156,28 @@ static void trace_register_execution_tracking_events(void)
 	nrf_profiler_event_id = nrf_profiler_register_event_type(
 				"event_processing_start",
 				labels, types, 1);
-	nrf_profiler_event_ids[event_cnt] = nrf_profiler_event_id;
+	nrf_profiler_event_ids[event_cnt + EXEC_START_ID_OFFSET] = nrf_profiler_event_id;
 
 	/* Event execution end event. */
 	nrf_profiler_event_id = nrf_profiler_register_event_type(
 				"event_processing_end",
 				labels, types, 1);
-	nrf_profiler_event_ids[event_cnt + 1] = nrf_profiler_event_id;
+	nrf_profiler_event_ids[event_cnt + EXEC_END_ID_OFFSET] = nrf_profiler_event_id;
+}
+
+static void trace_register_listener_tracking_event(void)
+{
+	static const char * const labels[] = {EM_MEM_ADDRESS_LABEL "listener", "time_us"};
+	enum nrf_profiler_arg types[] = {MEM_ADDRESS_TYPE NRF_PROFILER_ARG_STRING,
+					 NRF_PROFILER_ARG_U32};
+	size_t event_cnt = _nrf_profiler_info_list_end - _nrf_profiler_info_list_start;
+
+	ARG_UNUSED(types);
+	ARG_UNUSED(labels);
+
+	nrf_profiler_event_ids[event_cnt + LISTENER_ID_OFFSET] =
+		nrf_profiler_register_event_type("listener_processing", labels, types,
+						 ARRAY_SIZE(labels));
 }
 
 static void trace_register_events(void)
@@ -137,6 +197,10 @@ static void trace_register_events(void)
 	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_TRACE_EVENT_EXECUTION)) {
 		trace_register_execution_tracking_events();
 	}
+
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_TRACE_LISTENERS)) {
+		trace_register_listener_tracking_event();
+	}
 }
 
 /** @brief Initialize tracing in the Application Event Manager.
@@ -148,9 +212,11 @@ static int app_event_manager_trace_event_init(void)
 {
 	/* Every profiled Application Event Manager event registers a single nrf_profiler event.
 	 * Apart from that 2 additional nrf_profiler events are used to indicate processing
-	 * start and end of an Application Event Manager event.
+	 * start and end of an Application Event Manager event and, if listeners are traced,
+	 * 1 to report time spent in a listener.
 	 */
-	__ASSERT_NO_MSG(_nrf_profiler_info_list_end - _nrf_profiler_info_list_start + 2 <=
+	__ASSERT_NO_MSG(_nrf_profiler_info_list_end - _nrf_profiler_info_list_start +
+			EXTRA_IDS_COUNT <=
 			CONFIG_NRF_PROFILER_MAX_NUMBER_OF_APP_EVENTS);
 
 	if (nrf_profiler_init()) {
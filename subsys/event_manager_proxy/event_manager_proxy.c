@@ -16,6 +16,9 @@ LOG_MODULE_REGISTER(event_manager_proxy, CONFIG_APP_EVENT_MANAGER_LOG_LEVEL);
 
 #define EMP_BIND_TIMEOUT K_MSEC(CONFIG_EVENT_MANAGER_PROXY_BIND_TIMEOUT_MS)
 
+/* Number of received events passed to the Application Event Manager at once. */
+#define EMP_RX_SUBMIT_BATCH_SIZE 8
+
 /* Helpers - allow linker to get information about these structure sizes. */
 static struct event_type _emp_event_type_size_check
 	__used __attribute__((__section__("event_manager_proxy_event_type_size")));
@@ -51,6 +54,40 @@ struct emp_cmd_subscribe {
 	char name[];
 };
 
+/**
+ * @brief The header of a single event in the batch message.
+ *
+ * The event data is padded to the multiple of 4 bytes.
+ */
+struct emp_batch_record {
+	uint32_t len;
+	uint8_t data[];
+};
+
+/** @brief Transfer statistics. */
+struct emp_stats {
+	atomic_t events_sent;
+	atomic_t msgs_sent;
+	atomic_t bytes_sent;
+	atomic_t send_errors;
+	atomic_t events_received;
+	atomic_t msgs_received;
+};
+
+#ifdef CONFIG_EVENT_MANAGER_PROXY_TX_BUF_SIZE
+/** @brief The IPC message under preparation. */
+struct emp_tx {
+	struct k_mutex lock;
+	uint8_t *buf;
+	size_t len;
+	bool nocopy;
+	bool nocopy_unavailable;
+	size_t event_cnt;
+	uint32_t local_buf[ceiling_fraction(CONFIG_EVENT_MANAGER_PROXY_TX_BUF_SIZE,
+					    sizeof(uint32_t))];
+};
+#endif
+
 /** @brief Inter-core communication data. */
 struct emp_ipc_data {
 	struct ipc_ept ept;
@@ -59,6 +96,12 @@ struct emp_ipc_data {
 	bool started;
 	struct k_event bound;
 	const struct event_type **event_type_map;
+#ifdef CONFIG_EVENT_MANAGER_PROXY_TX_BUF_SIZE
+	struct emp_tx tx;
+#endif
+#ifdef CONFIG_EVENT_MANAGER_PROXY_STATS
+	struct emp_stats stats;
+#endif
 };
 
 
@@ -151,12 +194,91 @@ static void handle_ipc_endpoint_bound(void *priv)
 	k_event_set(&ipc->bound, 0x1);
 }
 
-static void handle_remote_event(struct emp_ipc_data *ipc, const void *data, size_t len)
+/**
+ * @brief Update transfer statistics counter.
+ *
+ * @param ipc   The related element of the @ref emp_ipc_data array.
+ * @param name  Name of the counter.
+ * @param value Value to be added to the counter.
+ */
+#ifdef CONFIG_EVENT_MANAGER_PROXY_STATS
+#define EMP_STATS_ADD(ipc, name, value) atomic_add(&(ipc)->stats.name, (value))
+#else
+#define EMP_STATS_ADD(ipc, name, value)
+#endif
+
+/**
+ * @brief Get the size of the event in the IPC message.
+ *
+ * @param event_size Size of the event.
+ *
+ * @return Number of bytes occupied by the event in the message.
+ */
+static size_t event_record_size(size_t event_size)
+{
+	size_t size = ROUND_UP(event_size, sizeof(uint32_t));
+
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_BATCHING)) {
+		size += sizeof(struct emp_batch_record);
+	}
+
+	return size;
+}
+
+static struct app_event_header *copy_remote_event(const void *data, size_t len)
 {
 	void *event = app_event_manager_alloc(len);
 
 	memcpy(event, data, len);
-	_event_submit(event);
+
+	return event;
+}
+
+static void handle_remote_event_batch(struct emp_ipc_data *ipc, const void *data, size_t len)
+{
+	struct app_event_header *events[EMP_RX_SUBMIT_BATCH_SIZE];
+	size_t event_cnt = 0;
+	const uint8_t *pos = data;
+	const uint8_t *end = pos + len;
+
+	while (pos < end) {
+		const struct emp_batch_record *record = (const void *)pos;
+		size_t left = end - pos;
+
+		if ((left < sizeof(*record)) ||
+		    (record->len < sizeof(struct app_event_header)) ||
+		    (record->len > (left - sizeof(*record)))) {
+			LOG_ERR("Malformed event batch from remote %p", ipc);
+			__ASSERT_NO_MSG(false);
+			break;
+		}
+
+		events[event_cnt++] = copy_remote_event(record->data, record->len);
+		if (event_cnt == ARRAY_SIZE(events)) {
+			_event_submit_batch(events, event_cnt);
+			EMP_STATS_ADD(ipc, events_received, event_cnt);
+			event_cnt = 0;
+		}
+
+		pos += event_record_size(record->len);
+	}
+
+	if (event_cnt > 0) {
+		_event_submit_batch(events, event_cnt);
+		EMP_STATS_ADD(ipc, events_received, event_cnt);
+	}
+}
+
+static void handle_remote_event(struct emp_ipc_data *ipc, const void *data, size_t len)
+{
+	EMP_STATS_ADD(ipc, msgs_received, 1);
+
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_BATCHING)) {
+		handle_remote_event_batch(ipc, data, len);
+	} else {
+		_event_submit(copy_remote_event(data, len));
+		EMP_STATS_ADD(ipc, events_received, 1);
+	}
 }
 
 static void handle_remote_command_subscribe(struct emp_ipc_data *ipc, const void *data, size_t len)
@@ -274,6 +396,194 @@ static void handle_ipc_endpoint_error(const char *message, void *priv)
 	__ASSERT_NO_MSG(false);
 }
 
+static int send_to_remote(struct emp_ipc_data *ipc, const void *data, size_t len)
+{
+	int ret;
+
+	for (size_t cnt = CONFIG_EVENT_MANAGER_PROXY_SEND_RETRIES + 1; cnt > 0; --cnt) {
+		ret = ipc_service_send(&ipc->ept, data, len);
+		if (ret >= 0) {
+			break;
+		}
+		k_usleep(1);
+	}
+
+	return ret;
+}
+
+#ifdef CONFIG_EVENT_MANAGER_PROXY_TX_BUF_SIZE
+static void tx_flush_work_handler(struct k_work *work);
+
+/** @brief Work used to send the collected events. */
+static K_WORK_DEFINE(emp_tx_flush_work, tx_flush_work_handler);
+
+/**
+ * @brief Get the buffer for the IPC message.
+ *
+ * The buffer is taken from the IPC service backend if possible.
+ * The local buffer is used otherwise.
+ *
+ * @param ipc The related element of the @ref emp_ipc_data array.
+ *
+ * @retval 0 On success.
+ * @retval other errno code, no free buffer in the IPC service backend.
+ */
+static int tx_buf_get(struct emp_ipc_data *ipc)
+{
+	struct emp_tx *tx = &ipc->tx;
+
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_NOCOPY) && !tx->nocopy_unavailable) {
+		int ret;
+
+		for (size_t cnt = CONFIG_EVENT_MANAGER_PROXY_SEND_RETRIES + 1; cnt > 0; --cnt) {
+			void *data;
+			uint32_t size = CONFIG_EVENT_MANAGER_PROXY_TX_BUF_SIZE;
+
+			ret = ipc_service_get_tx_buffer(&ipc->ept, &data, &size, K_NO_WAIT);
+			if (!ret) {
+				tx->buf = data;
+				tx->nocopy = true;
+				return 0;
+			}
+
+			if ((ret == -ENOTSUP) || (ret == -ENOMEM)) {
+				/* No-copy API not supported or backend buffers too small. */
+				LOG_WRN("Cannot use IPC buffers on remote %p (err: %d), copying events",
+					ipc, ret);
+				tx->nocopy_unavailable = true;
+				break;
+			}
+			k_usleep(1);
+		}
+
+		if (!tx->nocopy_unavailable) {
+			return ret;
+		}
+	}
+
+	tx->buf = (uint8_t *)tx->local_buf;
+	tx->nocopy = false;
+
+	return 0;
+}
+
+/**
+ * @brief Send the collected events to the remote core.
+ *
+ * Must be called with the transmit lock taken.
+ *
+ * @param ipc The related element of the @ref emp_ipc_data array.
+ *
+ * @return 0 on success or negative errno code.
+ */
+static int tx_flush(struct emp_ipc_data *ipc)
+{
+	struct emp_tx *tx = &ipc->tx;
+	int ret;
+
+	if (tx->len == 0) {
+		return 0;
+	}
+
+	if (tx->nocopy) {
+		ret = ipc_service_send_nocopy(&ipc->ept, tx->buf, tx->len);
+		if (ret < 0) {
+			/* The buffer is only released by a successful send */
+			ipc_service_drop_tx_buffer(&ipc->ept, tx->buf);
+		}
+	} else {
+		ret = send_to_remote(ipc, tx->buf, tx->len);
+	}
+
+	if (ret < 0) {
+		LOG_ERR("Cannot send %zu events to remote %p, err: %d", tx->event_cnt, ipc, ret);
+		EMP_STATS_ADD(ipc, send_errors, tx->event_cnt);
+	} else {
+		EMP_STATS_ADD(ipc, events_sent, tx->event_cnt);
+		EMP_STATS_ADD(ipc, msgs_sent, 1);
+		EMP_STATS_ADD(ipc, bytes_sent, tx->len);
+		ret = 0;
+	}
+
+	tx->buf = NULL;
+	tx->len = 0;
+	tx->event_cnt = 0;
+
+	return ret;
+}
+
+static void tx_flush_work_handler(struct k_work *work)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(emp_ipc_data); ++i) {
+		struct emp_ipc_data *ipc = &emp_ipc_data[i];
+
+		if (!ipc->used || !ipc->started) {
+			continue;
+		}
+
+		k_mutex_lock(&ipc->tx.lock, K_FOREVER);
+		(void)tx_flush(ipc);
+		k_mutex_unlock(&ipc->tx.lock);
+	}
+}
+
+static int tx_event_add(struct emp_ipc_data *ipc, const struct app_event_header *eh,
+			const struct event_type *remote_ev)
+{
+	struct emp_tx *tx = &ipc->tx;
+	size_t size = app_event_manager_event_size(eh);
+	size_t record_size = event_record_size(size);
+	int ret = 0;
+
+	if (record_size > CONFIG_EVENT_MANAGER_PROXY_TX_BUF_SIZE) {
+		LOG_ERR("Event %s too big to be sent: %zu", eh->type_id->name, size);
+		EMP_STATS_ADD(ipc, send_errors, 1);
+		return -ENOMEM;
+	}
+
+	k_mutex_lock(&tx->lock, K_FOREVER);
+
+	if (tx->len + record_size > CONFIG_EVENT_MANAGER_PROXY_TX_BUF_SIZE) {
+		ret = tx_flush(ipc);
+	}
+
+	if (!ret && !tx->buf) {
+		ret = tx_buf_get(ipc);
+	}
+
+	if (!ret) {
+		uint8_t *dst = tx->buf + tx->len;
+
+		if (IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_BATCHING)) {
+			struct emp_batch_record *record = (struct emp_batch_record *)dst;
+
+			record->len = size;
+			dst = record->data;
+		}
+
+		memcpy(dst, eh, size);
+		((struct app_event_header *)dst)->type_id = remote_ev;
+
+		tx->len += record_size;
+		tx->event_cnt++;
+
+		if (!IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_BATCHING)) {
+			ret = tx_flush(ipc);
+		}
+	} else {
+		EMP_STATS_ADD(ipc, send_errors, 1);
+	}
+
+	k_mutex_unlock(&tx->lock);
+
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_BATCHING) && !ret) {
+		k_work_submit(&emp_tx_flush_work);
+	}
+
+	return ret;
+}
+#endif /* CONFIG_EVENT_MANAGER_PROXY_TX_BUF_SIZE */
+
 static int send_event_to_remote(struct emp_ipc_data *ipc, const struct app_event_header *eh)
 {
 	const struct event_type *remote_ev = ipc->event_type_map[et2idx(eh->type_id)];
@@ -283,6 +593,9 @@ static int send_event_to_remote(struct emp_ipc_data *ipc, const struct app_event
 		return 0;
 	}
 
+#ifdef CONFIG_EVENT_MANAGER_PROXY_TX_BUF_SIZE
+	ret = tx_event_add(ipc, eh, remote_ev);
+#else
 	size_t size = app_event_manager_event_size(eh);
 	uint32_t buffer[ceiling_fraction(size, sizeof(uint32_t))];
 	struct app_event_header *remote_eh = (struct app_event_header *)buffer;
@@ -290,13 +603,15 @@ static int send_event_to_remote(struct emp_ipc_data *ipc, const struct app_event
 	memcpy(buffer, eh, sizeof(buffer));
 	remote_eh->type_id = remote_ev;
 
-	for (size_t cnt = CONFIG_EVENT_MANAGER_PROXY_SEND_RETRIES + 1; cnt > 0; --cnt) {
-		ret = ipc_service_send(&ipc->ept, buffer, sizeof(buffer));
-		if (ret >= 0) {
-			break;
-		}
-		k_usleep(1);
+	ret = send_to_remote(ipc, buffer, sizeof(buffer));
+	if (ret < 0) {
+		EMP_STATS_ADD(ipc, send_errors, 1);
+	} else {
+		EMP_STATS_ADD(ipc, events_sent, 1);
+		EMP_STATS_ADD(ipc, msgs_sent, 1);
+		EMP_STATS_ADD(ipc, bytes_sent, sizeof(buffer));
 	}
+#endif
 
 	if (ret < 0) {
 		LOG_ERR("Cannot send event to remote %p, err: %d", ipc, ret);
@@ -355,6 +670,9 @@ static int add_ipc_instace(struct emp_ipc_data *ipc, const struct device *instan
 	memset(ipc->event_type_map, 0, event_type_count * sizeof(ipc->event_type_map[0]));
 
 	k_event_init(&ipc->bound);
+#ifdef CONFIG_EVENT_MANAGER_PROXY_TX_BUF_SIZE
+	k_mutex_init(&ipc->tx.lock);
+#endif
 
 	ret = ipc_service_register_endpoint(instance, &ipc->ept, &ipc->ept_cfg);
 	if (ret) {
@@ -479,3 +797,30 @@ int event_manager_proxy_wait_for_remotes(k_timeout_t timeout)
 
 	return 0;
 }
+
+int event_manager_proxy_stats_get(const struct device *instance,
+				  struct event_manager_proxy_stats *stats)
+{
+	if (!IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_STATS)) {
+		return -ENOTSUP;
+	}
+
+	const struct emp_ipc_data *ipc = find_ipc_by_instance(instance);
+
+	if (!ipc) {
+		return -EINVAL;
+	}
+
+#ifdef CONFIG_EVENT_MANAGER_PROXY_STATS
+	*stats = (struct event_manager_proxy_stats) {
+		.events_sent     = atomic_get(&ipc->stats.events_sent),
+		.msgs_sent       = atomic_get(&ipc->stats.msgs_sent),
+		.bytes_sent      = atomic_get(&ipc->stats.bytes_sent),
+		.send_errors     = atomic_get(&ipc->stats.send_errors),
+		.events_received = atomic_get(&ipc->stats.events_received),
+		.msgs_received   = atomic_get(&ipc->stats.msgs_received),
+	};
+#endif
+
+	return 0;
+}
@@ -198,13 +198,36 @@ int coap_parse(struct download_client *client, size_t len)
 	return 0;
 }
 
-int coap_request_send(struct download_client *client)
+int coap_uri_path_append(const struct download_client *client, struct coap_packet *request)
 {
 	int err;
-	uint16_t id;
 	char file[FILENAME_SIZE];
 	char *path_elem;
 	char *path_elem_saveptr;
+
+	err = url_parse_file(client->file, file, sizeof(file));
+	if (err) {
+		LOG_ERR("Unable to parse url");
+		return err;
+	}
+
+	path_elem = strtok_r(file, COAP_PATH_ELEM_DELIM, &path_elem_saveptr);
+	do {
+		err = coap_packet_append_option(request, COAP_OPTION_URI_PATH,
+			path_elem, strlen(path_elem));
+		if (err) {
+			LOG_ERR("Unable add option to request");
+			return err;
+		}
+	} while ((path_elem = strtok_r(NULL, COAP_PATH_ELEM_DELIM, &path_elem_saveptr)));
+
+	return 0;
+}
+
+int coap_request_send(struct download_client *client)
+{
+	int err;
+	uint16_t id;
 	struct coap_packet request;
 
 	if (has_pending(client)) {
@@ -220,22 +243,11 @@ int coap_request_send(struct download_client *client)
 		return err;
 	}
 
-	err = url_parse_file(client->file, file, sizeof(file));
+	err = coap_uri_path_append(client, &request);
 	if (err) {
-		LOG_ERR("Unable to parse url");
 		return err;
 	}
 
-	path_elem = strtok_r(file, COAP_PATH_ELEM_DELIM, &path_elem_saveptr);
-	do {
-		err = coap_packet_append_option(&request, COAP_OPTION_URI_PATH,
-			path_elem, strlen(path_elem));
-		if (err) {
-			LOG_ERR("Unable add option to request");
-			return err;
-		}
-	} while ((path_elem = strtok_r(NULL, COAP_PATH_ELEM_DELIM, &path_elem_saveptr)));
-
 	err = coap_append_block2_option(&request, &client->coap.block_ctx);
 	if (err) {
 		LOG_ERR("Unable to add block2 option");
@@ -0,0 +1,475 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/coap.h>
+#if defined(CONFIG_POSIX_API)
+#include <zephyr/posix/poll.h>
+#include <zephyr/posix/sys/socket.h>
+#else
+#include <zephyr/net/socket.h>
+#endif
+#include <zephyr/logging/log.h>
+#include <net/download_client.h>
+
+LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
+
+#define COAP_VER 1
+#define BLOCK_BYTES DOWNLOAD_CLIENT_COAP_BLOCK_BYTES
+#define WINDOW_MAX CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE
+
+int socket_send(const struct download_client *client, size_t len, int timeout);
+int coap_uri_path_append(const struct download_client *client, struct coap_packet *request);
+
+struct window_state {
+	/* Next block to request. */
+	uint32_t next_num;
+	/* Current window size, in blocks. */
+	size_t size;
+	/* Responses received since the window was last resized. */
+	size_t acks;
+};
+
+static int error_evt_send(const struct download_client *dl, int error)
+{
+	const struct download_client_evt evt = {
+		.id = DOWNLOAD_CLIENT_EVT_ERROR,
+		.error = -error
+	};
+
+	return dl->callback(&evt);
+}
+
+static bool aborted(const struct download_client *dl)
+{
+	return dl->fd == -1;
+}
+
+static size_t blocks_busy(const struct download_client *dl)
+{
+	size_t busy = 0;
+
+	for (size_t i = 0; i < WINDOW_MAX; i++) {
+		busy += dl->coap.window[i].busy;
+	}
+
+	return busy;
+}
+
+static struct download_client_coap_block *block_free_get(struct download_client *dl)
+{
+	for (size_t i = 0; i < WINDOW_MAX; i++) {
+		if (!dl->coap.window[i].busy) {
+			return &dl->coap.window[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int block_request_send(struct download_client *dl,
+			      struct download_client_coap_block *blk, bool retransmit)
+{
+	int err;
+	uint16_t id;
+	struct coap_packet request;
+
+	if (retransmit) {
+		id = blk->pending.id;
+	} else {
+		id = coap_next_id();
+		memcpy(blk->token, coap_next_token(), sizeof(blk->token));
+	}
+
+	err = coap_packet_init(&request, dl->buf, sizeof(dl->buf), COAP_VER, COAP_TYPE_CON,
+			       sizeof(blk->token), blk->token, COAP_METHOD_GET, id);
+	if (err) {
+		LOG_ERR("Failed to init CoAP message, err %d", err);
+		return err;
+	}
+
+	err = coap_uri_path_append(dl, &request);
+	if (err) {
+		return err;
+	}
+
+	err = coap_append_option_int(&request, COAP_OPTION_BLOCK2,
+				     (blk->num << 4) | CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE);
+	if (err) {
+		LOG_ERR("Unable to add block2 option");
+		return err;
+	}
+
+	if (dl->file_size == 0) {
+		/* Ask the server for the size of the file */
+		err = coap_append_option_int(&request, COAP_OPTION_SIZE2, 0);
+		if (err) {
+			LOG_ERR("Unable to add size2 option");
+			return err;
+		}
+	}
+
+	if (!retransmit) {
+		err = coap_pending_init(&blk->pending, &request, &dl->remote_addr,
+					CONFIG_DOWNLOAD_CLIENT_COAP_MAX_RETRANSMIT_REQUEST_COUNT);
+		if (err < 0) {
+			return -EINVAL;
+		}
+
+		coap_pending_cycle(&blk->pending);
+	}
+
+	LOG_DBG("CoAP request block %u, id %u", blk->num, id);
+
+	err = socket_send(dl, request.offset, blk->pending.timeout);
+	if (err) {
+		LOG_ERR("Failed to send CoAP request, errno %d", errno);
+		return err;
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+		LOG_HEXDUMP_DBG(request.data, request.offset, "CoAP request");
+	}
+
+	return 0;
+}
+
+/* Request new blocks, as long as the window allows it. */
+static int blocks_request(struct download_client *dl, struct window_state *win)
+{
+	int err;
+	struct download_client_coap_block *blk;
+
+	while (blocks_busy(dl) < win->size) {
+		if (dl->file_size == 0) {
+			/* Until the file size is known, request one block at a time */
+			if (blocks_busy(dl) > 0) {
+				break;
+			}
+		} else if (win->next_num * BLOCK_BYTES >= dl->file_size) {
+			break;
+		}
+
+		blk = block_free_get(dl);
+		if (!blk) {
+			break;
+		}
+
+		blk->num = win->next_num;
+		blk->busy = true;
+		blk->received = false;
+
+		err = block_request_send(dl, blk, false);
+		if (err) {
+			return err;
+		}
+
+		win->next_num++;
+	}
+
+	return 0;
+}
+
+/* Returns:
+ *  0 if the response has been handled or ignored
+ * -1 on error
+ */
+static int response_handle(struct download_client *dl, size_t len, struct window_state *win)
+{
+	int err;
+	int block2;
+	int size2;
+	uint8_t code;
+	uint16_t id;
+	uint16_t payload_len;
+	const uint8_t *payload;
+	struct coap_packet response;
+	struct download_client_coap_block *blk = NULL;
+
+	err = coap_packet_parse(&response, dl->buf, len, NULL, 0);
+	if (err) {
+		LOG_WRN("Failed to parse CoAP packet, err %d", err);
+		return 0;
+	}
+
+	id = coap_header_get_id(&response);
+	for (size_t i = 0; i < WINDOW_MAX; i++) {
+		if (dl->coap.window[i].busy && !dl->coap.window[i].received &&
+		    dl->coap.window[i].pending.id == id) {
+			blk = &dl->coap.window[i];
+			break;
+		}
+	}
+
+	if (!blk) {
+		LOG_DBG("Ignoring response %u, not pending", id);
+		return 0;
+	}
+
+	if (coap_header_get_type(&response) != COAP_TYPE_ACK) {
+		LOG_ERR("Response must be of coap type ACK");
+		return -1;
+	}
+
+	code = coap_header_get_code(&response);
+	if (code != COAP_RESPONSE_CODE_OK && code != COAP_RESPONSE_CODE_CONTENT) {
+		LOG_ERR("Server responded with code 0x%x", code);
+		return -1;
+	}
+
+	block2 = coap_get_option_int(&response, COAP_OPTION_BLOCK2);
+	if (block2 < 0) {
+		LOG_ERR("No block2 option in response");
+		return -1;
+	}
+
+	if (GET_BLOCK_NUM(block2) != blk->num ||
+	    GET_BLOCK_SIZE(block2) != CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE) {
+		LOG_ERR("Unexpected block %d (size %d), requested %u",
+			GET_BLOCK_NUM(block2), GET_BLOCK_SIZE(block2), blk->num);
+		return -1;
+	}
+
+	payload = coap_packet_get_payload(&response, &payload_len);
+	if ((!payload && GET_MORE(block2)) || payload_len > BLOCK_BYTES) {
+		LOG_ERR("Invalid payload in block %u", blk->num);
+		return -1;
+	}
+
+	if (dl->file_size == 0) {
+		size2 = coap_get_option_int(&response, COAP_OPTION_SIZE2);
+		if (size2 > 0) {
+			dl->file_size = size2;
+		} else if (!GET_MORE(block2)) {
+			dl->file_size = blk->num * BLOCK_BYTES + payload_len;
+		}
+
+		if (dl->file_size) {
+			LOG_DBG("Total size: %d", dl->file_size);
+		}
+	}
+
+	coap_pending_clear(&blk->pending);
+
+	if (payload_len) {
+		memcpy(blk->buf, payload, payload_len);
+	}
+	blk->len = payload_len;
+	blk->received = true;
+
+	/* Grow the window by one block for each window of responses */
+	if (++win->acks >= win->size) {
+		win->acks = 0;
+		win->size = MIN(win->size + 1, WINDOW_MAX);
+	}
+
+	return 0;
+}
+
+/* Retransmit the requests that have timed out, and get the time until
+ * the next request times out, in milliseconds.
+ */
+static int timeouts_handle(struct download_client *dl, struct window_state *win, int *next)
+{
+	int err;
+	int32_t left;
+	bool timed_out = false;
+
+	*next = SYS_FOREVER_MS;
+
+	for (size_t i = 0; i < WINDOW_MAX; i++) {
+		struct download_client_coap_block *blk = &dl->coap.window[i];
+
+		if (!blk->busy || blk->received) {
+			continue;
+		}
+
+		left = (int32_t)(blk->pending.t0 + blk->pending.timeout - k_uptime_get_32());
+		if (left > 0) {
+			*next = (*next == SYS_FOREVER_MS) ? left : MIN(*next, left);
+			continue;
+		}
+
+		if (!coap_pending_cycle(&blk->pending)) {
+			LOG_ERR("CoAP max-retransmissions exceeded");
+			return -ETIMEDOUT;
+		}
+
+		LOG_DBG("Block %u timed out, resending", blk->num);
+		timed_out = true;
+
+		err = block_request_send(dl, blk, true);
+		if (err) {
+			return err;
+		}
+
+		*next = (*next == SYS_FOREVER_MS) ?
+			blk->pending.timeout : MIN(*next, blk->pending.timeout);
+	}
+
+	if (timed_out) {
+		/* Assume congestion, halve the window */
+		win->size = MAX(win->size / 2, 1);
+		win->acks = 0;
+		LOG_DBG("Window size %u", win->size);
+	}
+
+	return 0;
+}
+
+/* Deliver the received blocks to the application, in order.
+ *
+ * Returns:
+ *  0 if the download shall continue
+ *  1 if the download is complete or has been stopped by the application
+ */
+static int blocks_deliver(struct download_client *dl)
+{
+	bool delivered;
+	size_t skip;
+	int rc;
+
+	do {
+		delivered = false;
+
+		for (size_t i = 0; i < WINDOW_MAX; i++) {
+			struct download_client_coap_block *blk = &dl->coap.window[i];
+
+			if (!blk->received || blk->num != dl->progress / BLOCK_BYTES) {
+				continue;
+			}
+
+			/* When resuming, part of the first block may already be downloaded */
+			skip = dl->progress - blk->num * BLOCK_BYTES;
+			if (skip > blk->len) {
+				LOG_ERR("Block %u is too short", blk->num);
+				error_evt_send(dl, EBADMSG);
+				return 1;
+			}
+
+			const struct download_client_evt evt = {
+				.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
+				.fragment = {
+					.buf = blk->buf + skip,
+					.len = blk->len - skip,
+				}
+			};
+
+			if (blk->len < BLOCK_BYTES &&
+			    dl->progress + evt.fragment.len != dl->file_size) {
+				/* Only the last block may be shorter */
+				LOG_ERR("Short block %u before the end of the file", blk->num);
+				error_evt_send(dl, EBADMSG);
+				return 1;
+			}
+
+			blk->busy = false;
+			blk->received = false;
+			dl->progress += evt.fragment.len;
+			delivered = true;
+
+			if (dl->file_size) {
+				LOG_INF("Downloaded %u/%u bytes (%d%%)",
+					dl->progress, dl->file_size,
+					(dl->progress * 100) / dl->file_size);
+			}
+
+			rc = dl->callback(&evt);
+			if (rc) {
+				LOG_INF("Fragment refused, download stopped.");
+				return 1;
+			}
+		}
+	} while (delivered);
+
+	if (dl->file_size && dl->progress >= dl->file_size) {
+		LOG_INF("Download complete");
+		const struct download_client_evt evt = {
+			.id = DOWNLOAD_CLIENT_EVT_DONE,
+		};
+		dl->callback(&evt);
+		return 1;
+	}
+
+	return 0;
+}
+
+void coap_window_download(struct download_client *dl)
+{
+	struct window_state win = {
+		.next_num = dl->progress / BLOCK_BYTES,
+		.size = 1,
+	};
+	struct pollfd fds;
+	ssize_t len;
+	int timeout;
+	int rc;
+
+	for (size_t i = 0; i < WINDOW_MAX; i++) {
+		dl->coap.window[i].busy = false;
+		dl->coap.window[i].received = false;
+	}
+
+	while (!aborted(dl)) {
+		rc = blocks_request(dl, &win);
+		if (rc) {
+			if (!aborted(dl)) {
+				error_evt_send(dl, ECONNRESET);
+			}
+			break;
+		}
+
+		rc = timeouts_handle(dl, &win, &timeout);
+		if (rc) {
+			if (!aborted(dl)) {
+				error_evt_send(dl, rc == -ETIMEDOUT ? ETIMEDOUT : ECONNRESET);
+			}
+			break;
+		}
+
+		fds.fd = dl->fd;
+		fds.events = POLLIN;
+		fds.revents = 0;
+
+		rc = poll(&fds, 1, timeout);
+		if (rc == 0) {
+			/* Retransmit on the next iteration */
+			continue;
+		}
+
+		len = (rc > 0) ? recv(dl->fd, dl->buf, sizeof(dl->buf), 0) : -1;
+		if (len < 0) {
+			if (aborted(dl)) {
+				break;
+			}
+
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				continue;
+			}
+
+			LOG_ERR("Error in recv(), errno %d", errno);
+
+			/* Requests are retransmitted if the application lets us continue */
+			if (error_evt_send(dl, ECONNRESET)) {
+				break;
+			}
+			continue;
+		}
+
+		LOG_DBG("Read %d bytes from socket", len);
+
+		if (response_handle(dl, len, &win)) {
+			error_evt_send(dl, EBADMSG);
+			break;
+		}
+
+		if (blocks_deliver(dl)) {
+			break;
+		}
+	}
+}
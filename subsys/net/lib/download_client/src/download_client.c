@@ -41,6 +41,9 @@ int coap_initiate_retransmission(struct download_client *dl);
 int coap_parse(struct download_client *client, size_t len);
 int coap_request_send(struct download_client *client);
 
+void http_parallel_download(struct download_client *dl);
+void coap_window_download(struct download_client *dl);
+
 static const char *str_family(int family)
 {
 	switch (family) {
@@ -209,17 +212,97 @@ static int host_lookup(const char *host, int family, uint8_t pdn_id,
 	return 0;
 }
 
+/* Open a socket and connect it to the server, using the protocol,
+ * address and port resolved by client_connect().
+ */
+int socket_connect(const struct download_client *dl, int *fd)
+{
+	int err;
+	int type;
+	socklen_t addrlen;
+
+	if (dl->proto == IPPROTO_UDP || dl->proto == IPPROTO_DTLS_1_2) {
+		type = SOCK_DGRAM;
+	} else {
+		type = SOCK_STREAM;
+	}
+
+	switch (dl->remote_addr.sa_family) {
+	case AF_INET6:
+		addrlen = sizeof(struct sockaddr_in6);
+		break;
+	case AF_INET:
+		addrlen = sizeof(struct sockaddr_in);
+		break;
+	default:
+		return -EAFNOSUPPORT;
+	}
+
+	if (dl->set_native_tls) {
+		LOG_DBG("Enabled native TLS");
+		type |= SOCK_NATIVE_TLS;
+	}
+
+	LOG_DBG("family: %d, type: %d, proto: %d",
+		dl->remote_addr.sa_family, type, dl->proto);
+
+	*fd = socket(dl->remote_addr.sa_family, type, dl->proto);
+	if (*fd < 0) {
+		LOG_ERR("Failed to create socket, err %d", errno);
+		return -errno;
+	}
+
+	if (dl->config.pdn_id) {
+		err = socket_pdn_id_set(*fd, dl->config.pdn_id);
+		if (err) {
+			goto cleanup;
+		}
+	}
+
+	if ((dl->proto == IPPROTO_TLS_1_2 || dl->proto == IPPROTO_DTLS_1_2)
+	     && (dl->config.sec_tag != -1)) {
+		err = socket_sectag_set(*fd, dl->config.sec_tag);
+		if (err) {
+			goto cleanup;
+		}
+
+		if (dl->config.set_tls_hostname) {
+			err = socket_tls_hostname_set(*fd, dl->host);
+			if (err) {
+				goto cleanup;
+			}
+		}
+	}
+
+	LOG_INF("Connecting to %s", dl->host);
+	LOG_DBG("fd %d, addrlen %d, fam %s",
+		*fd, addrlen, str_family(dl->remote_addr.sa_family));
+
+	err = connect(*fd, &dl->remote_addr, addrlen);
+	if (err) {
+		LOG_ERR("Unable to connect, errno %d", errno);
+		err = -errno;
+	}
+
+cleanup:
+	if (err) {
+		/* Unable to connect, close socket */
+		close(*fd);
+		*fd = -1;
+	}
+
+	return err;
+}
+
 static int client_connect(struct download_client *dl)
 {
 	int err;
 	int type;
 	uint16_t port;
-	socklen_t addrlen;
 
 	err = url_parse_proto(dl->host, &dl->proto, &type);
 	if (err) {
 		LOG_DBG("Protocol not specified, defaulting to HTTP(S)");
-		type = SOCK_STREAM;
 		if (dl->config.sec_tag != -1) {
 			dl->proto = IPPROTO_TLS_1_2;
 		} else {
@@ -267,85 +350,30 @@ static int client_connect(struct download_client *dl)
 	switch (dl->remote_addr.sa_family) {
 	case AF_INET6:
 		SIN6(&dl->remote_addr)->sin6_port = htons(port);
-		addrlen = sizeof(struct sockaddr_in6);
 		break;
 	case AF_INET:
 		SIN(&dl->remote_addr)->sin_port = htons(port);
-		addrlen = sizeof(struct sockaddr_in);
 		break;
 	default:
 		return -EAFNOSUPPORT;
 	}
 
-	if (dl->set_native_tls) {
-		LOG_DBG("Enabled native TLS");
-		type |= SOCK_NATIVE_TLS;
-	}
-
-	LOG_DBG("family: %d, type: %d, proto: %d",
-		dl->remote_addr.sa_family, type, dl->proto);
-
-	dl->fd = socket(dl->remote_addr.sa_family, type, dl->proto);
-	if (dl->fd < 0) {
-		LOG_ERR("Failed to create socket, err %d", errno);
-		return -errno;
-	}
-
-	if (dl->config.pdn_id) {
-		err = socket_pdn_id_set(dl->fd, dl->config.pdn_id);
-		if (err) {
-			goto cleanup;
-		}
-	}
-
-	if ((dl->proto == IPPROTO_TLS_1_2 || dl->proto == IPPROTO_DTLS_1_2)
-	     && (dl->config.sec_tag != -1)) {
-		err = socket_sectag_set(dl->fd, dl->config.sec_tag);
-		if (err) {
-			goto cleanup;
-		}
-
-		if (dl->config.set_tls_hostname) {
-			err = socket_tls_hostname_set(dl->fd, dl->host);
-			if (err) {
-				goto cleanup;
-			}
-		}
-	}
-
-	LOG_INF("Connecting to %s", dl->host);
-	LOG_DBG("fd %d, addrlen %d, fam %s, port %d",
-		dl->fd, addrlen, str_family(dl->remote_addr.sa_family), port);
-
-	err = connect(dl->fd, &dl->remote_addr, addrlen);
-	if (err) {
-		LOG_ERR("Unable to connect, errno %d", errno);
-		err = -errno;
-	}
-
-cleanup:
-	if (err) {
-		/* Unable to connect, close socket */
-		close(dl->fd);
-		dl->fd = -1;
-	}
-
-	return err;
+	return socket_connect(dl, &dl->fd);
 }
 
-int socket_send(const struct download_client *client, size_t len, int timeout)
+int socket_send_buf(int fd, const char *buf, size_t len, int timeout)
 {
 	int err;
 	int sent;
 	size_t off = 0;
 
-	err = set_snd_socket_timeout(client->fd, timeout);
+	err = set_snd_socket_timeout(fd, timeout);
 	if (err) {
 		return -errno;
 	}
 
 	while (len) {
-		sent = send(client->fd, client->buf + off, len, 0);
+		sent = send(fd, buf + off, len, 0);
 		if (sent < 0) {
 			return -errno;
 		}
@@ -357,6 +385,11 @@ int socket_send(const struct download_client *client, size_t len, int timeout)
 	return 0;
 }
 
+int socket_send(const struct download_client *client, size_t len, int timeout)
+{
+	return socket_send_buf(client->fd, client->buf, len, timeout);
+}
+
 static int request_send(struct download_client *dl)
 {
 	switch (dl->proto) {
@@ -373,15 +406,174 @@ static int request_send(struct download_client *dl)
 	return 0;
 }
 
-static int fragment_evt_send(const struct download_client *client)
+#if defined(CONFIG_DOWNLOAD_CLIENT_BUF_LENDING)
+/* Interval at which to check whether the download was aborted
+ * while waiting for the application to lend a buffer.
+ */
+#define LENT_BUF_WAIT_MS 100
+
+static size_t http_frag_size_get(const struct download_client *dl)
+{
+	return dl->config.frag_size_override != 0 ?
+	       dl->config.frag_size_override :
+	       CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+}
+
+static bool is_http(const struct download_client *dl)
+{
+	return dl->proto == IPPROTO_TCP || dl->proto == IPPROTO_TLS_1_2;
+}
+
+static bool lending(const struct download_client *dl)
+{
+	return dl->lend.active;
+}
+
+/* Wait until a buffer is available for the current fragment. */
+static int lent_buf_take(struct download_client *dl)
+{
+	while (!dl->lend.cur.buf) {
+		if (dl->fd == -1) {
+			/* download was aborted */
+			return -ECANCELED;
+		}
+
+		(void)k_msgq_get(&dl->lend.queue, &dl->lend.cur,
+				 K_MSEC(LENT_BUF_WAIT_MS));
+	}
+
+	return 0;
+}
+
+/* Move the payload from the internal buffer to the lent buffer. */
+static int lent_buf_fill(struct download_client *dl)
+{
+	int err;
+
+	err = lent_buf_take(dl);
+	if (err) {
+		return err;
+	}
+
+	if (dl->offset > dl->lend.cur.len) {
+		LOG_ERR("Fragment does not fit in lent buffer (%u > %u)",
+			dl->offset, dl->lend.cur.len);
+		return -E2BIG;
+	}
+
+	memcpy(dl->lend.cur.buf, dl->buf, dl->offset);
+
+	return 0;
+}
+
+/* Return the buffer to receive into, and its free space. */
+static int rx_buf_get(struct download_client *dl, char **buf, size_t *len,
+		      bool *lent)
+{
+	int err;
+	size_t frag_size;
+
+	/* The HTTP header is always received into the internal buffer,
+	 * the payload is received directly into the lent buffer.
+	 */
+	if (!lending(dl) || !is_http(dl) || !dl->http.has_header) {
+		*buf = dl->buf + dl->offset;
+		*len = sizeof(dl->buf) - dl->offset;
+		*lent = false;
+		return 0;
+	}
+
+	err = lent_buf_take(dl);
+	if (err) {
+		return err;
+	}
+
+	frag_size = MIN(http_frag_size_get(dl), dl->lend.cur.len);
+	if (dl->offset >= frag_size) {
+		LOG_ERR("Lent buffer is smaller than the fragment (%u)",
+			dl->lend.cur.len);
+		return -E2BIG;
+	}
+
+	*buf = dl->lend.cur.buf + dl->offset;
+	*len = frag_size - dl->offset;
+	*lent = true;
+
+	return 0;
+}
+
+/* Return the buffer holding the fragment, handing it to the application. */
+static int frag_buf_get(struct download_client *dl, const void **buf)
+{
+	int err;
+
+	if (!lending(dl)) {
+		*buf = dl->buf;
+		return 0;
+	}
+
+	/* For HTTP, the payload is already in the lent buffer. */
+	if (is_http(dl)) {
+		err = lent_buf_take(dl);
+	} else {
+		err = lent_buf_fill(dl);
+	}
+
+	if (err) {
+		return err;
+	}
+
+	*buf = dl->lend.cur.buf;
+	dl->lend.cur.buf = NULL;
+
+	return 0;
+}
+#else
+static bool lending(const struct download_client *dl)
 {
+	return false;
+}
+
+static int lent_buf_fill(struct download_client *dl)
+{
+	return 0;
+}
+
+static int rx_buf_get(struct download_client *dl, char **buf, size_t *len,
+		      bool *lent)
+{
+	*buf = dl->buf + dl->offset;
+	*len = sizeof(dl->buf) - dl->offset;
+	*lent = false;
+
+	return 0;
+}
+
+static int frag_buf_get(struct download_client *dl, const void **buf)
+{
+	*buf = dl->buf;
+
+	return 0;
+}
+#endif /* CONFIG_DOWNLOAD_CLIENT_BUF_LENDING */
+
+static int fragment_evt_send(struct download_client *client)
+{
+	int err;
+	const void *buf;
+
 	__ASSERT(client->offset <= CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
 		 "Buffer overflow!");
 
+	err = frag_buf_get(client, &buf);
+	if (err) {
+		return err;
+	}
+
 	const struct download_client_evt evt = {
 		.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
 		.fragment = {
-			.buf = client->buf,
+			.buf = buf,
 			.len = client->offset,
 		}
 	};
@@ -420,7 +612,7 @@ static int reconnect(struct download_client *dl)
 	return 0;
 }
 
-static size_t socket_recv(struct download_client *dl)
+static size_t socket_recv(struct download_client *dl, char *buf, size_t len)
 {
 	int err, timeout = 0;
 
@@ -449,7 +641,7 @@ static size_t socket_recv(struct download_client *dl)
 		return -1;
 	}
 
-	return recv(dl->fd, dl->buf + dl->offset, sizeof(dl->buf) - dl->offset, 0);
+	return recv(dl->fd, buf, len, 0);
 }
 
 static int request_resend(struct download_client *dl)
@@ -478,11 +670,26 @@ void download_thread(void *client, void *a, void *b)
 	int rc = 0;
 	int error_cause;
 	size_t len;
+	char *rx_buf;
+	size_t rx_len;
+	bool rx_lent;
 	struct download_client *const dl = client;
 
 wait_for_download:
 	k_sem_take(&dl->wait_for_download, K_FOREVER);
 
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_HTTP_PARALLEL) &&
+	    (dl->proto == IPPROTO_TCP || dl->proto == IPPROTO_TLS_1_2)) {
+		http_parallel_download(dl);
+		goto wait_for_download;
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW) &&
+	    (dl->proto == IPPROTO_UDP || dl->proto == IPPROTO_DTLS_1_2)) {
+		coap_window_download(dl);
+		goto wait_for_download;
+	}
+
 	while (dl->fd != -1) {
 		__ASSERT(dl->offset < sizeof(dl->buf), "Buffer overflow");
 
@@ -493,10 +700,17 @@ wait_for_download:
 			break;
 		}
 
-		LOG_DBG("Receiving up to %d bytes at %p...",
-			(sizeof(dl->buf) - dl->offset), (dl->buf + dl->offset));
+		rc = rx_buf_get(dl, &rx_buf, &rx_len, &rx_lent);
+		if (rc) {
+			if (rc == -E2BIG) {
+				error_evt_send(dl, E2BIG);
+			}
+			break;
+		}
+
+		LOG_DBG("Receiving up to %d bytes at %p...", rx_len, rx_buf);
 
-		len = socket_recv(dl);
+		len = socket_recv(dl, rx_buf, rx_len);
 
 		if ((len == 0) || (len == -1)) {
 			/* We just had an unexpected socket error or closure */
@@ -562,6 +776,13 @@ wait_for_download:
 
 		if (dl->proto == IPPROTO_TCP || dl->proto == IPPROTO_TLS_1_2) {
 			rc = http_parse(client, len);
+			if (rc >= 0 && lending(dl) && dl->http.has_header && !rx_lent) {
+				/* Move the payload received with the header */
+				if (lent_buf_fill(dl)) {
+					error_evt_send(dl, E2BIG);
+					break;
+				}
+			}
 			if (rc > 0) {
 				/* Wait for more data (fragment/header) */
 				continue;
@@ -660,6 +881,19 @@ int download_client_init(struct download_client *const client,
 
 	client->fd = -1;
 	client->callback = callback;
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PARALLEL)
+	for (size_t i = 0; i < ARRAY_SIZE(client->range_conn); i++) {
+		client->range_conn[i].fd = -1;
+	}
+#endif
+#if defined(CONFIG_DOWNLOAD_CLIENT_BUF_LENDING)
+	k_msgq_init(&client->lend.queue, (char *)client->lend.queue_buf,
+		    sizeof(struct download_client_lent_buf),
+		    ARRAY_SIZE(client->lend.queue_buf));
+	client->lend.cur.buf = NULL;
+	client->lend.active = false;
+#endif
 	k_sem_init(&client->wait_for_download, 0, 1);
 
 	/* The thread is spawned now, but it will suspend itself;
@@ -727,6 +961,11 @@ int download_client_disconnect(struct download_client *const client)
 		return -EINVAL;
 	}
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PARALLEL)
+	/* Set before closing the sockets, to tell the stop apart from an error. */
+	client->range_abort = true;
+#endif
+
 	err = close(client->fd);
 	if (err) {
 		LOG_ERR("Failed to close socket, errno %d", errno);
@@ -735,6 +974,17 @@ int download_client_disconnect(struct download_client *const client)
 
 	client->fd = -1;
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PARALLEL)
+	/* The first range connection uses the main socket. */
+	for (size_t i = 1; i < ARRAY_SIZE(client->range_conn); i++) {
+		if (client->range_conn[i].fd != -1) {
+			(void)close(client->range_conn[i].fd);
+			client->range_conn[i].fd = -1;
+		}
+	}
+	client->range_conn[0].fd = -1;
+#endif
+
 	return 0;
 }
 
@@ -757,6 +1007,9 @@ int download_client_start(struct download_client *client, const char *file,
 
 	client->offset = 0;
 	client->http.has_header = false;
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PARALLEL)
+	client->range_abort = false;
+#endif
 
 	if (client->proto == IPPROTO_UDP || client->proto == IPPROTO_DTLS_1_2) {
 		if (IS_ENABLED(CONFIG_COAP)) {
@@ -764,9 +1017,17 @@ int download_client_start(struct download_client *client, const char *file,
 		}
 	}
 
-	err = request_send(client);
-	if (err) {
-		return err;
+	/* In the parallel HTTP and windowed CoAP modes,
+	 * the download thread sends the requests.
+	 */
+	if (!(IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_HTTP_PARALLEL) &&
+	      (client->proto == IPPROTO_TCP || client->proto == IPPROTO_TLS_1_2)) &&
+	    !(IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW) &&
+	      (client->proto == IPPROTO_UDP || client->proto == IPPROTO_DTLS_1_2))) {
+		err = request_send(client);
+		if (err) {
+			return err;
+		}
 	}
 
 	LOG_INF("Downloading: %s [%u]", client->file, client->progress);
@@ -777,6 +1038,29 @@ int download_client_start(struct download_client *client, const char *file,
 	return 0;
 }
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_BUF_LENDING)
+int download_client_buf_lend(struct download_client *client, void *buf,
+			     size_t len)
+{
+	const struct download_client_lent_buf lent = {
+		.buf = buf,
+		.len = len,
+	};
+
+	if (client == NULL || buf == NULL || len == 0) {
+		return -EINVAL;
+	}
+
+	if (k_msgq_put(&client->lend.queue, &lent, K_NO_WAIT)) {
+		return -ENOMEM;
+	}
+
+	client->lend.active = true;
+
+	return 0;
+}
+#endif
+
 void download_client_pause(struct download_client *client)
 {
 	k_thread_suspend(client->tid);
@@ -43,6 +43,7 @@ LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 int url_parse_host(const char *url, char *host, size_t len);
 int url_parse_file(const char *url, char *file, size_t len);
 int socket_send(const struct download_client *client, size_t len, int timeout);
+int socket_send_buf(int fd, const char *buf, size_t len, int timeout);
 
 int http_get_request_send(struct download_client *client)
 {
@@ -288,3 +289,148 @@ int http_parse(struct download_client *client, size_t len)
 
 	return 0;
 }
+
+int http_range_request_send(const struct download_client *client, int fd,
+			    char *buf, size_t from, size_t to)
+{
+	int err;
+	int len;
+	char host[HOSTNAME_SIZE];
+	char file[FILENAME_SIZE];
+
+	__ASSERT_NO_MSG(client->host);
+	__ASSERT_NO_MSG(client->file);
+
+	err = url_parse_host(client->host, host, sizeof(host));
+	if (err) {
+		return err;
+	}
+
+	err = url_parse_file(client->file, file, sizeof(file));
+	if (err) {
+		return err;
+	}
+
+	len = snprintf(buf, CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
+		       HTTP_GET_RANGE, file, host, from, to);
+	if (len < 0 || len > CONFIG_DOWNLOAD_CLIENT_BUF_SIZE) {
+		LOG_ERR("Cannot create GET request, buffer too small");
+		return -ENOMEM;
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+		LOG_HEXDUMP_DBG(buf, len, "HTTP request");
+	}
+
+	err = socket_send_buf(fd, buf, len, 0);
+	if (err) {
+		LOG_ERR("Failed to send HTTP request, errno %d", errno);
+		return err;
+	}
+
+	return 0;
+}
+
+/* Parse the fields of the null-terminated response header to a range request. */
+static int http_range_header_fields_parse(const char *hdr, size_t *range_start,
+					  size_t *file_size, bool *connection_close,
+					  bool *whole_file)
+{
+	const char *p;
+	const char *q;
+	unsigned int http_status;
+
+	p = strstr(hdr, "http/1.1 ");
+	if (!p) {
+		LOG_ERR("Server response missing HTTP/1.1");
+		return -1;
+	}
+
+	*connection_close = (strstr(hdr, "connection: close") != NULL);
+
+	http_status = strtoul(p + strlen("http/1.1 "), NULL, 10);
+	if (http_status == 200) {
+		/* The server does not support ranges and sends the whole file. */
+		p = strstr(hdr, "content-length:");
+		if (!p) {
+			LOG_ERR("Server did not send \"Content-Length\" in response");
+			return -1;
+		}
+
+		*range_start = 0;
+		*file_size = strtoul(p + strlen("content-length:"), NULL, 10);
+		*whole_file = true;
+
+		return 0;
+	}
+
+	if (http_status != 206) {
+		LOG_ERR("Unexpected HTTP response status: %u", http_status);
+		return -1;
+	}
+
+	/* Content-Range: bytes <start>-<end>/<file size> */
+	p = strstr(hdr, "content-range");
+	if (!p) {
+		LOG_ERR("Server did not send \"Content-Range\" in response");
+		return -1;
+	}
+
+	p = strstr(p, "bytes ");
+	q = p ? strstr(p, "/") : NULL;
+	if (!q) {
+		LOG_ERR("Malformed \"Content-Range\" in response");
+		return -1;
+	}
+
+	*range_start = strtoul(p + strlen("bytes "), NULL, 10);
+	*file_size = strtoul(q + 1, NULL, 10);
+	*whole_file = false;
+
+	return 0;
+}
+
+/* Parse the header of the response to a range request.
+ * The buffer must be null-terminated after the received data.
+ * If the server responds with the whole file instead of the range,
+ * whole_file is set and range_start is zero.
+ *
+ * Returns:
+ *  1 while the header is being received
+ *  0 if the header has been fully received
+ * -1 on error
+ */
+int http_range_header_parse(char *buf, size_t *hdr_len, size_t *range_start,
+			    size_t *file_size, bool *connection_close, bool *whole_file)
+{
+	char *p;
+	char payload_first;
+	int rc;
+
+	p = strstr(buf, "\r\n\r\n");
+	if (!p) {
+		/* Waiting full HTTP header */
+		return 1;
+	}
+
+	*hdr_len = p + strlen("\r\n\r\n") - buf;
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+		LOG_HEXDUMP_DBG(buf, *hdr_len, "HTTP response");
+	}
+
+	for (size_t i = 0; i < *hdr_len; i++) {
+		buf[i] = tolower(buf[i]);
+	}
+
+	/* Do not look for the header fields in the payload. */
+	payload_first = buf[*hdr_len];
+	buf[*hdr_len] = '\0';
+
+	rc = http_range_header_fields_parse(buf, range_start, file_size, connection_close,
+					    whole_file);
+
+	buf[*hdr_len] = payload_first;
+
+	return rc;
+}
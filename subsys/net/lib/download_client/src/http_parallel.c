@@ -0,0 +1,528 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#if defined(CONFIG_POSIX_API)
+#include <zephyr/posix/unistd.h>
+#include <zephyr/posix/poll.h>
+#include <zephyr/posix/sys/socket.h>
+#else
+#include <zephyr/net/socket.h>
+#endif
+#include <zephyr/logging/log.h>
+#include <net/download_client.h>
+
+LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
+
+#define CONN_COUNT CONFIG_DOWNLOAD_CLIENT_HTTP_PARALLEL_CONNS
+
+int socket_connect(const struct download_client *dl, int *fd);
+int http_range_request_send(const struct download_client *client, int fd,
+			    char *buf, size_t from, size_t to);
+int http_range_header_parse(char *buf, size_t *hdr_len, size_t *range_start,
+			    size_t *file_size, bool *connection_close, bool *whole_file);
+
+static size_t frag_size_get(const struct download_client *dl)
+{
+	return dl->config.frag_size_override ? dl->config.frag_size_override :
+					       CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+}
+
+static int error_evt_send(const struct download_client *dl, int error)
+{
+	const struct download_client_evt evt = {
+		.id = DOWNLOAD_CLIENT_EVT_ERROR,
+		.error = -error
+	};
+
+	return dl->callback(&evt);
+}
+
+static bool aborted(const struct download_client *dl)
+{
+	return dl->range_abort;
+}
+
+static int conn_request_send(struct download_client *dl,
+			     struct download_client_range_conn *conn)
+{
+	conn->offset = 0;
+	conn->received = 0;
+	conn->has_header = false;
+
+	LOG_DBG("Requesting range %u-%u on fd %d",
+		conn->start, conn->start + conn->len - 1, conn->fd);
+
+	return http_range_request_send(dl, conn->fd, conn->buf, conn->start,
+				       conn->start + conn->len - 1);
+}
+
+static int conn_reconnect(struct download_client *dl,
+			  struct download_client_range_conn *conn)
+{
+	int err;
+
+	if (conn->fd != -1) {
+		(void)close(conn->fd);
+		conn->fd = -1;
+	}
+
+	err = socket_connect(dl, &conn->fd);
+
+	if (conn == &dl->range_conn[0]) {
+		dl->fd = conn->fd;
+	}
+
+	return err;
+}
+
+/* Notify the application about the error. If the application returns zero,
+ * reconnect and request the range again.
+ */
+static int conn_error_handle(struct download_client *dl,
+			     struct download_client_range_conn *conn, int error)
+{
+	int rc;
+
+	if (aborted(dl)) {
+		return -1;
+	}
+
+	rc = error_evt_send(dl, error);
+	if (rc) {
+		return rc;
+	}
+
+	rc = conn_reconnect(dl, conn);
+	if (!rc && conn->len) {
+		rc = conn_request_send(dl, conn);
+	}
+
+	if (rc) {
+		error_evt_send(dl, EHOSTDOWN);
+	}
+
+	return rc;
+}
+
+/* Assign the next ranges to the idle connections. */
+static int ranges_assign(struct download_client *dl, size_t *next)
+{
+	int err;
+	/* Use a single connection until the file size is known. */
+	size_t conn_cnt = dl->file_size ? CONN_COUNT : 1;
+
+	for (size_t i = 0; i < conn_cnt; i++) {
+		struct download_client_range_conn *conn = &dl->range_conn[i];
+
+		if (conn->len) {
+			continue;
+		}
+
+		if (dl->file_size && (*next >= dl->file_size)) {
+			break;
+		}
+
+		if (conn->fd == -1) {
+			err = conn_reconnect(dl, conn);
+			if (err) {
+				if (i == 0) {
+					if (!aborted(dl)) {
+						error_evt_send(dl, EHOSTDOWN);
+					}
+					return err;
+				}
+				/* Continue with fewer connections. */
+				LOG_WRN("Range connection %u not available, err %d", i, err);
+				continue;
+			}
+		}
+
+		conn->start = *next;
+		/* Leave room for the null terminator used by the header parser. */
+		conn->len = MIN(frag_size_get(dl), sizeof(conn->buf) - 1);
+		if (dl->file_size) {
+			conn->len = MIN(conn->len, dl->file_size - conn->start);
+		}
+
+		err = conn_request_send(dl, conn);
+		if (err) {
+			err = conn_error_handle(dl, conn, ECONNRESET);
+			if (err) {
+				return err;
+			}
+		}
+
+		*next += conn->len;
+	}
+
+	return 0;
+}
+
+/* Returns:
+ *  2 if the server sends the whole file instead of the range
+ *  1 if more data is expected
+ *  0 if the whole range has been received
+ * -1 on error
+ */
+static int conn_parse(struct download_client *dl,
+		      struct download_client_range_conn *conn, size_t len, size_t *next)
+{
+	int rc;
+	size_t hdr_len;
+	size_t range_start;
+	size_t file_size;
+	bool whole_file;
+
+	conn->offset += len;
+	conn->buf[conn->offset] = '\0';
+
+	if (!conn->has_header) {
+		rc = http_range_header_parse(conn->buf, &hdr_len, &range_start,
+					     &file_size, &conn->connection_close, &whole_file);
+		if (rc) {
+			return rc;
+		}
+
+		if (whole_file) {
+			if (dl->file_size == 0) {
+				dl->file_size = file_size;
+				LOG_DBG("File size = %u", dl->file_size);
+			}
+
+			conn->offset -= hdr_len;
+			memmove(conn->buf, conn->buf + hdr_len, conn->offset);
+			conn->has_header = true;
+
+			return 2;
+		}
+
+		if (range_start != conn->start) {
+			LOG_ERR("Unexpected range start %u, expected %u",
+				range_start, conn->start);
+			return -1;
+		}
+
+		if (dl->file_size == 0) {
+			dl->file_size = file_size;
+			LOG_DBG("File size = %u", dl->file_size);
+
+			/* The first range may be shorter than requested. */
+			conn->len = MIN(conn->len, file_size - conn->start);
+			*next = conn->start + conn->len;
+		}
+
+		conn->offset -= hdr_len;
+		memmove(conn->buf, conn->buf + hdr_len, conn->offset);
+		conn->has_header = true;
+	}
+
+	conn->received = conn->offset;
+
+	if (conn->received > conn->len) {
+		LOG_ERR("Received more data than requested");
+		return -1;
+	}
+
+	return (conn->received == conn->len) ? 0 : 1;
+}
+
+/* Deliver the received ranges to the application, in order.
+ *
+ * Returns:
+ *  0 if the download shall continue
+ *  1 if the download is complete or has been stopped by the application
+ */
+static int fragments_deliver(struct download_client *dl)
+{
+	bool delivered;
+	int rc;
+
+	do {
+		delivered = false;
+
+		for (size_t i = 0; i < CONN_COUNT; i++) {
+			struct download_client_range_conn *conn = &dl->range_conn[i];
+
+			if (!conn->len || !conn->has_header ||
+			    (conn->received != conn->len) || (conn->start != dl->progress)) {
+				continue;
+			}
+
+			const struct download_client_evt evt = {
+				.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
+				.fragment = {
+					.buf = conn->buf,
+					.len = conn->len,
+				}
+			};
+
+			dl->progress += conn->len;
+			conn->len = 0;
+			delivered = true;
+
+			LOG_INF("Downloaded %u/%u bytes (%d%%)",
+				dl->progress, dl->file_size,
+				(dl->progress * 100) / dl->file_size);
+
+			rc = dl->callback(&evt);
+			if (rc) {
+				LOG_INF("Fragment refused, download stopped.");
+				return 1;
+			}
+
+			if (conn->connection_close) {
+				/* Reconnect when the next range is assigned,
+				 * except for the first connection, which holds
+				 * the client socket and is reconnected right away.
+				 */
+				conn->connection_close = false;
+				(void)close(conn->fd);
+				conn->fd = -1;
+				if ((i == 0) && !aborted(dl) && conn_reconnect(dl, conn)) {
+					LOG_ERR("Failed to reconnect");
+					error_evt_send(dl, EHOSTDOWN);
+					return 1;
+				}
+			}
+		}
+	} while (delivered);
+
+	if (dl->progress == dl->file_size) {
+		LOG_INF("Download complete");
+		const struct download_client_evt evt = {
+			.id = DOWNLOAD_CLIENT_EVT_DONE,
+		};
+		dl->callback(&evt);
+		return 1;
+	}
+
+	return 0;
+}
+
+/* The server does not support ranges and sends the whole file over the connection,
+ * with the beginning of the payload already in the connection buffer.
+ * Close the other connections and deliver the file as it is received.
+ */
+static void single_stream_download(struct download_client *dl,
+				   struct download_client_range_conn *conn)
+{
+	/* File offset of the first byte in the buffer. */
+	size_t pos = 0;
+	size_t skip;
+	size_t len;
+	ssize_t rx_len;
+	int rc;
+
+	LOG_WRN("Server does not support ranges, using a single connection");
+
+	for (size_t i = 0; i < CONN_COUNT; i++) {
+		struct download_client_range_conn *other = &dl->range_conn[i];
+
+		other->len = 0;
+		if ((other != conn) && (other->fd != -1)) {
+			(void)close(other->fd);
+			other->fd = -1;
+		}
+	}
+
+	/* The first connection holds the client socket. */
+	dl->range_conn[0].fd = conn->fd;
+	if (conn != &dl->range_conn[0]) {
+		conn->fd = -1;
+		conn = &dl->range_conn[0];
+	}
+	dl->fd = conn->fd;
+
+	while (!aborted(dl)) {
+		/* Skip the part of the file that has been downloaded already. */
+		skip = (dl->progress > pos) ? MIN(dl->progress - pos, conn->offset) : 0;
+		len = MIN(conn->offset - skip, dl->file_size - dl->progress);
+
+		if (len) {
+			const struct download_client_evt evt = {
+				.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
+				.fragment = {
+					.buf = conn->buf + skip,
+					.len = len,
+				}
+			};
+
+			dl->progress += len;
+
+			LOG_INF("Downloaded %u/%u bytes (%d%%)",
+				dl->progress, dl->file_size,
+				(dl->progress * 100) / dl->file_size);
+
+			rc = dl->callback(&evt);
+			if (rc) {
+				LOG_INF("Fragment refused, download stopped.");
+				return;
+			}
+		}
+
+		pos += conn->offset;
+		conn->offset = 0;
+
+		if (dl->progress >= dl->file_size) {
+			LOG_INF("Download complete");
+			const struct download_client_evt evt = {
+				.id = DOWNLOAD_CLIENT_EVT_DONE,
+			};
+			dl->callback(&evt);
+			return;
+		}
+
+		rx_len = recv(conn->fd, conn->buf,
+			      MIN(frag_size_get(dl), sizeof(conn->buf) - 1), 0);
+		if (rx_len <= 0) {
+			if (!aborted(dl)) {
+				LOG_ERR("Connection closed, errno %d", errno);
+				error_evt_send(dl, ECONNRESET);
+			}
+			return;
+		}
+
+		conn->offset = rx_len;
+	}
+}
+
+/* Close the connections opened for the ranges. The first connection holds the client
+ * socket, which is closed by download_client_disconnect().
+ */
+static void range_conns_close(struct download_client *dl)
+{
+	for (size_t i = 1; i < CONN_COUNT; i++) {
+		struct download_client_range_conn *conn = &dl->range_conn[i];
+
+		if (conn->fd != -1) {
+			(void)close(conn->fd);
+			conn->fd = -1;
+		}
+	}
+}
+
+static void ranges_download(struct download_client *dl)
+{
+	struct pollfd fds[CONN_COUNT];
+	struct download_client_range_conn *polled[CONN_COUNT];
+	size_t next = dl->progress;
+	size_t nfds;
+	ssize_t len;
+	int rc;
+
+	dl->range_conn[0].fd = dl->fd;
+	for (size_t i = 0; i < CONN_COUNT; i++) {
+		dl->range_conn[i].len = 0;
+		dl->range_conn[i].connection_close = false;
+	}
+
+	while (!aborted(dl)) {
+		rc = ranges_assign(dl, &next);
+		if (rc) {
+			/* The error has been reported already. */
+			break;
+		}
+
+		nfds = 0;
+		for (size_t i = 0; i < CONN_COUNT; i++) {
+			struct download_client_range_conn *conn = &dl->range_conn[i];
+
+			if (conn->len && (!conn->has_header || conn->received < conn->len)) {
+				fds[nfds].fd = conn->fd;
+				fds[nfds].events = POLLIN;
+				fds[nfds].revents = 0;
+				polled[nfds] = conn;
+				nfds++;
+			}
+		}
+
+		if (nfds == 0) {
+			/* Nothing to receive and nothing to deliver. */
+			break;
+		}
+
+		rc = poll(fds, nfds, CONFIG_DOWNLOAD_CLIENT_TCP_SOCK_TIMEO_MS);
+		if (rc <= 0) {
+			if (aborted(dl)) {
+				break;
+			}
+
+			LOG_ERR("Error in poll(), rc %d, errno %d", rc, errno);
+
+			/* Request all pending ranges again. */
+			int error = rc ? ECONNRESET : ETIMEDOUT;
+
+			rc = 0;
+			for (size_t i = 0; (i < nfds) && !rc; i++) {
+				rc = conn_error_handle(dl, polled[i], error);
+			}
+
+			if (rc) {
+				break;
+			}
+			continue;
+		}
+
+		rc = 0;
+		for (size_t i = 0; (i < nfds) && !rc; i++) {
+			struct download_client_range_conn *conn = polled[i];
+
+			if (!fds[i].revents) {
+				continue;
+			}
+
+			if (conn->offset == sizeof(conn->buf) - 1) {
+				LOG_ERR("HTTP header does not fit in buffer");
+				error_evt_send(dl, EBADMSG);
+				rc = -1;
+				break;
+			}
+
+			len = recv(conn->fd, conn->buf + conn->offset,
+				   sizeof(conn->buf) - conn->offset - 1, 0);
+			if (len <= 0) {
+				if (aborted(dl)) {
+					rc = -1;
+					break;
+				}
+
+				LOG_WRN("Range connection %d closed, errno %d", conn->fd, errno);
+				rc = conn_error_handle(dl, conn, ECONNRESET);
+				continue;
+			}
+
+			LOG_DBG("Read %d bytes from socket %d", len, conn->fd);
+
+			rc = conn_parse(dl, conn, len, &next);
+			if (rc == 2) {
+				single_stream_download(dl, conn);
+				return;
+			} else if (rc < 0) {
+				error_evt_send(dl, EBADMSG);
+				rc = -1;
+			} else {
+				rc = 0;
+			}
+		}
+
+		if (rc) {
+			break;
+		}
+
+		if (fragments_deliver(dl)) {
+			break;
+		}
+	}
+}
+
+void http_parallel_download(struct download_client *dl)
+{
+	ranges_download(dl);
+	range_conns_close(dl);
+}
@@ -45,6 +45,28 @@ static enum dfu_target_image_type img_type;
 static enum dfu_target_image_type img_type_expected = DFU_TARGET_IMAGE_TYPE_ANY;
 static bool first_fragment;
 static bool downloading;
+static size_t file_size;
+static int64_t download_start_time;
+
+#if defined(CONFIG_FOTA_DOWNLOAD_DOUBLE_BUFFERING)
+/* Fragments are received directly into these buffers, and written to the
+ * DFU target by the writer thread while the next fragment is downloaded.
+ */
+static uint8_t frag_buf[2][CONFIG_DOWNLOAD_CLIENT_BUF_SIZE] __aligned(4);
+K_MSGQ_DEFINE(fota_download_frag_queue, sizeof(struct download_fragment),
+	      ARRAY_SIZE(frag_buf), 4);
+static K_SEM_DEFINE(frag_writes_done, 0, 1);
+static atomic_t frag_writes_pending;
+/* Error cause of a failed write, set by the writer thread and reported
+ * from the download client callback.
+ */
+static atomic_t frag_write_failed;
+static void frag_writer(void *p1, void *p2, void *p3);
+
+K_THREAD_DEFINE(fota_download_writer, CONFIG_FOTA_DOWNLOAD_WRITER_STACK_SIZE,
+		frag_writer, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+#endif
 
 static void send_evt(enum fota_download_evt_id id)
 {
@@ -90,9 +112,149 @@ static void dfu_target_callback_handler(enum dfu_target_evt_id evt)
 	}
 }
 
+/* Write a fragment to the DFU target. On failure, the download must be
+ * stopped with fragment_write_failed() and the error cause in @p cause.
+ */
+static int fragment_write(const void *buf, size_t len, enum fota_download_error_cause *cause)
+{
+	size_t offset;
+	int err;
+
+	err = dfu_target_write(buf, len);
+	if (err != 0) {
+		LOG_ERR("dfu_target_write error %d", err);
+		*cause = FOTA_DOWNLOAD_ERROR_CAUSE_INVALID_UPDATE;
+		return err;
+	}
+
+	if (IS_ENABLED(CONFIG_FOTA_DOWNLOAD_PROGRESS_EVT) &&
+	    !first_fragment) {
+		err = dfu_target_offset_get(&offset);
+		if (err != 0) {
+			LOG_DBG("unable to get dfu target "
+					"offset err: %d", err);
+			*cause = FOTA_DOWNLOAD_ERROR_CAUSE_DOWNLOAD_FAILED;
+			return err;
+		}
+
+		if (file_size == 0) {
+			LOG_DBG("invalid file size: %d", file_size);
+			*cause = FOTA_DOWNLOAD_ERROR_CAUSE_DOWNLOAD_FAILED;
+			return -EINVAL;
+		}
+
+		send_progress((offset * 100) / file_size);
+		LOG_DBG("Progress: %d/%d bytes", offset, file_size);
+	}
+
+	return 0;
+}
+
+static void fragment_write_failed(enum fota_download_error_cause cause)
+{
+	if (cause == FOTA_DOWNLOAD_ERROR_CAUSE_INVALID_UPDATE) {
+		int res = dfu_target_done(false);
+
+		if (res != 0) {
+			LOG_ERR("Unable to free DFU target resources");
+		}
+		first_fragment = true;
+		(void) download_client_disconnect(&dlc);
+	}
+
+	send_error_evt(cause);
+}
+
+#if defined(CONFIG_FOTA_DOWNLOAD_DOUBLE_BUFFERING)
+/* Lend the buffer back to the download client. */
+static void frag_buf_release(const void *buf)
+{
+	int err = download_client_buf_lend(&dlc, (void *)buf, sizeof(frag_buf[0]));
+
+	if (err != 0) {
+		LOG_ERR("Unable to lend fragment buffer, err %d", err);
+	}
+}
+
+/* Wait until all the received fragments have been written. */
+static void frag_writes_wait(void)
+{
+	if (k_current_get() == fota_download_writer) {
+		/* Called from an event sent by the writer */
+		return;
+	}
+
+	k_sem_reset(&frag_writes_done);
+	if (atomic_get(&frag_writes_pending) > 0) {
+		(void)k_sem_take(&frag_writes_done, K_FOREVER);
+	}
+}
+
+/* Stop the download if the writer thread failed to write a fragment.
+ * Called from the download client callback, once the writer is idle.
+ */
+static bool frag_write_failed_report(void)
+{
+	enum fota_download_error_cause cause = atomic_get(&frag_write_failed);
+
+	if (cause == FOTA_DOWNLOAD_ERROR_CAUSE_NO_ERROR) {
+		return false;
+	}
+
+	fragment_write_failed(cause);
+
+	return true;
+}
+
+static int fragment_enqueue(const struct download_fragment *fragment)
+{
+	if (atomic_get(&frag_write_failed) != FOTA_DOWNLOAD_ERROR_CAUSE_NO_ERROR) {
+		frag_buf_release(fragment->buf);
+		frag_writes_wait();
+		(void)frag_write_failed_report();
+		return -EIO;
+	}
+
+	atomic_inc(&frag_writes_pending);
+
+	/* There are never more fragments than buffers, so the queue is never full */
+	(void)k_msgq_put(&fota_download_frag_queue, fragment, K_NO_WAIT);
+
+	return 0;
+}
+
+static void frag_writer(void *p1, void *p2, void *p3)
+{
+	enum fota_download_error_cause cause;
+	struct download_fragment fragment;
+
+	while (true) {
+		(void)k_msgq_get(&fota_download_frag_queue, &fragment, K_FOREVER);
+
+		if ((atomic_get(&frag_write_failed) == FOTA_DOWNLOAD_ERROR_CAUSE_NO_ERROR) &&
+		    fragment_write(fragment.buf, fragment.len, &cause) != 0) {
+			/* Skip the remaining fragments, the callback stops the download */
+			atomic_set(&frag_write_failed, cause);
+		}
+
+		frag_buf_release(fragment.buf);
+
+		if (atomic_dec(&frag_writes_pending) == 1) {
+			k_sem_give(&frag_writes_done);
+		}
+	}
+}
+#else
+static void frag_buf_release(const void *buf) {}
+static void frag_writes_wait(void) {}
+static bool frag_write_failed_report(void)
+{
+	return false;
+}
+#endif /* CONFIG_FOTA_DOWNLOAD_DOUBLE_BUFFERING */
+
 static int download_client_callback(const struct download_client_evt *event)
 {
-	static size_t file_size;
 	size_t offset;
 	int err;
 
@@ -102,14 +264,15 @@ static int download_client_callback(const struct download_client_evt *event)
 
 	switch (event->id) {
 	case DOWNLOAD_CLIENT_EVT_FRAGMENT: {
-		if (first_fragment) {
-			enum fota_download_error_cause err_cause =
-				FOTA_DOWNLOAD_ERROR_CAUSE_NO_ERROR;
+		enum fota_download_error_cause err_cause =
+			FOTA_DOWNLOAD_ERROR_CAUSE_NO_ERROR;
 
+		if (first_fragment) {
 			err = download_client_file_size_get(&dlc, &file_size);
 			if (err != 0) {
 				LOG_DBG("download_client_file_size_get err: %d",
 					err);
+				frag_buf_release(event->fragment.buf);
 				send_error_evt(FOTA_DOWNLOAD_ERROR_CAUSE_INTERNAL);
 				return err;
 			}
@@ -139,6 +302,7 @@ static int download_client_callback(const struct download_client_evt *event)
 			}
 
 			if (err_cause != FOTA_DOWNLOAD_ERROR_CAUSE_NO_ERROR) {
+				frag_buf_release(event->fragment.buf);
 				(void)download_client_disconnect(&dlc);
 				send_error_evt(err_cause);
 				int res = dfu_target_reset();
@@ -162,6 +326,7 @@ static int download_client_callback(const struct download_client_evt *event)
 				/* Abort current download procedure, and
 				 * schedule new download from offset.
 				 */
+				frag_buf_release(event->fragment.buf);
 				(void)download_client_disconnect(&dlc);
 				k_work_schedule(&dlc_with_offset_work,
 						K_SECONDS(1));
@@ -171,44 +336,24 @@ static int download_client_callback(const struct download_client_evt *event)
 			}
 		}
 
-		err = dfu_target_write(event->fragment.buf,
-				       event->fragment.len);
+#if defined(CONFIG_FOTA_DOWNLOAD_DOUBLE_BUFFERING)
+		return fragment_enqueue(&event->fragment);
+#else
+		err = fragment_write(event->fragment.buf, event->fragment.len, &err_cause);
 		if (err != 0) {
-			LOG_ERR("dfu_target_write error %d", err);
-			int res = dfu_target_done(false);
-
-			if (res != 0) {
-				LOG_ERR("Unable to free DFU target resources");
-			}
-			first_fragment = true;
-			(void) download_client_disconnect(&dlc);
-			send_error_evt(FOTA_DOWNLOAD_ERROR_CAUSE_INVALID_UPDATE);
+			fragment_write_failed(err_cause);
 			return err;
 		}
-
-		if (IS_ENABLED(CONFIG_FOTA_DOWNLOAD_PROGRESS_EVT) &&
-		    !first_fragment) {
-			err = dfu_target_offset_get(&offset);
-			if (err != 0) {
-				LOG_DBG("unable to get dfu target "
-						"offset err: %d", err);
-				send_error_evt(FOTA_DOWNLOAD_ERROR_CAUSE_DOWNLOAD_FAILED);
-				return err;
-			}
-
-			if (file_size == 0) {
-				LOG_DBG("invalid file size: %d", file_size);
-				send_error_evt(FOTA_DOWNLOAD_ERROR_CAUSE_DOWNLOAD_FAILED);
-				return err;
-			}
-
-			send_progress((offset * 100) / file_size);
-			LOG_DBG("Progress: %d/%d bytes", offset, file_size);
-		}
 	break;
+#endif
 	}
 
 	case DOWNLOAD_CLIENT_EVT_DONE:
+		frag_writes_wait();
+		if (frag_write_failed_report()) {
+			return -EIO;
+		}
+
 		err = dfu_target_done(true);
 		if (err == 0 && IS_ENABLED(CONFIG_FOTA_CLIENT_AUTOSCHEDULE_UPDATE)) {
 			err = dfu_target_schedule_update(0);
@@ -225,6 +370,8 @@ static int download_client_callback(const struct download_client_evt *event)
 			send_error_evt(FOTA_DOWNLOAD_ERROR_CAUSE_DOWNLOAD_FAILED);
 			return err;
 		}
+		LOG_INF("Downloaded %u bytes in %lld ms", file_size,
+			k_uptime_get() - download_start_time);
 		send_evt(FOTA_DOWNLOAD_EVT_FINISHED);
 		first_fragment = true;
 		downloading = false;
@@ -246,6 +393,7 @@ static int download_client_callback(const struct download_client_evt *event)
 		} else {
 			download_client_disconnect(&dlc);
 			LOG_ERR("Download client error");
+			frag_writes_wait();
 			err = dfu_target_done(false);
 			if (err == -EACCES) {
 				LOG_DBG("No DFU target was initialized");
@@ -432,6 +580,10 @@ int fota_download_start_with_image_type(const char *host, const char *file,
 	}
 
 	img_type_expected = expected_type;
+	download_start_time = k_uptime_get();
+#if defined(CONFIG_FOTA_DOWNLOAD_DOUBLE_BUFFERING)
+	atomic_set(&frag_write_failed, FOTA_DOWNLOAD_ERROR_CAUSE_NO_ERROR);
+#endif
 
 	err = download_client_start(&dlc, file_buf_ptr, 0);
 	if (err != 0) {
@@ -478,6 +630,15 @@ int fota_download_init(fota_download_callback_t client_callback)
 		return err;
 	}
 
+#if defined(CONFIG_FOTA_DOWNLOAD_DOUBLE_BUFFERING)
+	for (size_t i = 0; i < ARRAY_SIZE(frag_buf); i++) {
+		err = download_client_buf_lend(&dlc, frag_buf[i], sizeof(frag_buf[i]));
+		if (err != 0) {
+			return err;
+		}
+	}
+#endif
+
 	first_fragment = true;
 	return 0;
 }
@@ -500,6 +661,8 @@ int fota_download_cancel(void)
 		return err;
 	}
 
+	frag_writes_wait();
+
 	err = dfu_target_done(false);
 	if (err && err != -EACCES) {
 		LOG_ERR("%s failed to clean up: %d", __func__, err);
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRF_CLOUD_JSON_WRITER_H__
+#define NRF_CLOUD_JSON_WRITER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <cJSON.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum nesting depth of objects and arrays. */
+#define JSON_WRITER_MAX_DEPTH 16
+
+/** Output encodings of the writer. */
+enum json_writer_format {
+	/** JSON text, as printed by cJSON_PrintUnformatted() */
+	JSON_WRITER_FORMAT_JSON,
+	/** CBOR (RFC 8949) */
+	JSON_WRITER_FORMAT_CBOR,
+	/** cJSON items, added to an existing object */
+	JSON_WRITER_FORMAT_CJSON,
+};
+
+/**
+ * @brief Streaming JSON writer.
+ *
+ * Encodes JSON directly into a buffer, without building a tree first.
+ * The output is identical to that of cJSON_PrintUnformatted() for the same
+ * members in the same order.
+ *
+ * The same values can be encoded as CBOR instead, so that one encoder
+ * function describes a message in both formats. In CBOR, objects and arrays
+ * are maps and arrays of indefinite length, and numbers are integers when
+ * they have no fraction, or else the shortest floating-point type that
+ * represents them exactly. Not-a-number and infinity are null, as in JSON.
+ *
+ * For callers that need a cJSON tree, the values can also be added to an
+ * existing cJSON object. The items are created directly, without printing
+ * and parsing JSON text.
+ *
+ * Errors are sticky: after an error, the following calls do nothing, and the
+ * error is returned by @ref json_writer_finish. This allows a sequence of
+ * calls to be checked once.
+ *
+ * If the writer is initialized without a buffer, it only counts the length
+ * of the output. This can be used to allocate a buffer of the exact size.
+ */
+struct json_writer {
+	char *buf;
+	size_t size;
+	/* Length of the output, also when it does not fit into the buffer */
+	size_t len;
+	int err;
+	enum json_writer_format format;
+	uint8_t depth;
+	/* Bit n is set when the container at depth n has members */
+	uint32_t has_members;
+	/* Bit n is set when the container at depth n is an array */
+	uint32_t is_array;
+	/* cJSON format: the container at each depth, the target object first */
+	cJSON *tree[JSON_WRITER_MAX_DEPTH];
+};
+
+/**
+ * @brief Initialize a writer.
+ *
+ * @param w Writer.
+ * @param buf Output buffer, or NULL to only count the length of the output.
+ * @param size Size of the output buffer, including the null terminator.
+ */
+void json_writer_init(struct json_writer *w, char *buf, size_t size);
+
+/**
+ * @brief Initialize a writer for the given output format.
+ *
+ * @param w Writer.
+ * @param format Output format.
+ * @param buf Output buffer, or NULL to only count the length of the output.
+ * @param size Size of the output buffer. In JSON format, the size includes
+ *             the null terminator.
+ */
+void json_writer_init_format(struct json_writer *w, enum json_writer_format format,
+			     char *buf, size_t size);
+
+/**
+ * @brief Initialize a writer that adds cJSON items to an object.
+ *
+ * The root value must be an object. Its members are added to @p obj.
+ * On failure, the members that were added remain in @p obj.
+ *
+ * @param w Writer.
+ * @param obj Object to add the members to.
+ */
+void json_writer_init_cjson(struct json_writer *w, cJSON *obj);
+
+/**
+ * @brief Start an object.
+ *
+ * @param w Writer.
+ * @param key Member name, or NULL for the root object and for array elements.
+ */
+void json_writer_obj_start(struct json_writer *w, const char *key);
+
+/** @brief End the current object. */
+void json_writer_obj_end(struct json_writer *w);
+
+/** @brief Start an array. See @ref json_writer_obj_start. */
+void json_writer_arr_start(struct json_writer *w, const char *key);
+
+/** @brief End the current array. */
+void json_writer_arr_end(struct json_writer *w);
+
+/** @brief Add a string. The string is escaped as needed. */
+void json_writer_str(struct json_writer *w, const char *key, const char *val);
+
+/** @brief Add a number, formatted as cJSON formats numbers. */
+void json_writer_num(struct json_writer *w, const char *key, double val);
+
+/** @brief Add a boolean value. */
+void json_writer_bool(struct json_writer *w, const char *key, bool val);
+
+/** @brief Add a null value. */
+void json_writer_null(struct json_writer *w, const char *key);
+
+/**
+ * @brief Add a cJSON item with all its children.
+ *
+ * Raw items cannot be written in CBOR format.
+ *
+ * @param w Writer.
+ * @param key Member name, see @ref json_writer_obj_start.
+ * @param item Item to write.
+ */
+void json_writer_cjson(struct json_writer *w, const char *key, const cJSON *item);
+
+/**
+ * @brief Finish the output. JSON output is null-terminated.
+ *
+ * @retval Length of the output, excluding the null terminator.
+ *         Zero in cJSON format.
+ * @retval -ENOMEM The output does not fit into the buffer or its length
+ *                 exceeds INT_MAX, or a cJSON item could not be allocated.
+ * @retval -EINVAL Invalid arguments, or objects and arrays are not closed.
+ * @retval -E2BIG Objects and arrays are nested too deep.
+ * @retval -ENOTSUP The value cannot be encoded in the output format.
+ */
+int json_writer_finish(struct json_writer *w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_CLOUD_JSON_WRITER_H__ */
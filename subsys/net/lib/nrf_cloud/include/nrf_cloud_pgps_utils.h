@@ -42,7 +42,14 @@ struct gps_location {
 	int64_t gps_sec;
 };
 
+/* Index entry of a stored prediction; gps_sec is zero if there is no entry */
+struct npgps_block_info {
+	uint32_t gps_sec;
+	uint32_t crc;
+};
+
 struct nrf_cloud_pgps_header;
+struct nrf_cloud_pgps_prediction;
 
 typedef int (*npgps_buffer_handler_t)(uint8_t *buf, size_t len);
 
@@ -58,6 +65,19 @@ const struct nrf_cloud_pgps_header *npgps_get_saved_header(void);
 const struct gps_location *npgps_get_saved_location(void);
 int npgps_settings_init(void);
 
+/* prediction index functions */
+int npgps_save_block_info(int block, const struct npgps_block_info *info);
+const struct npgps_block_info *npgps_get_saved_block_info(int block);
+int npgps_clear_block_info(int block);
+/* Find the blocks of the predictions of the set starting at start_sec in the
+ * index; blocks[pnum] is NO_BLOCK if prediction pnum is not indexed. Returns
+ * the number of predictions indexed in time order, or -ENODATA if there are
+ * none or a prediction is indexed more than once.
+ */
+int npgps_find_indexed_blocks(int64_t start_sec, uint32_t period_sec, int count, int *blocks);
+/* Returns -EBADMSG if the prediction does not match the index entry of its block */
+int npgps_check_block_info(int block, const struct nrf_cloud_pgps_prediction *p);
+
 /* time functions */
 int64_t npgps_gps_day_time_to_sec(uint16_t gps_day, uint32_t gps_time_of_day);
 void npgps_gps_sec_to_day_time(int64_t gps_sec, uint16_t *gps_day, uint32_t *gps_time_of_day);
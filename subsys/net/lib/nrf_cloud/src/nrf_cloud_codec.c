@@ -7,6 +7,7 @@
 #include "nrf_cloud_codec.h"
 #include "nrf_cloud_mem.h"
 #include "nrf_cloud_fsm.h"
+#include "nrf_cloud_json_writer.h"
 #include <net/nrf_cloud_location.h>
 #include <stdbool.h>
 #include <string.h>
@@ -143,6 +144,103 @@ cJSON *json_create_req_obj(const char *const app_id, const char *const msg_type)
 	return req_obj;
 }
 
+/* Writes a message using the streaming JSON writer */
+typedef int (*json_encode_fn)(struct json_writer *w, const void *ctx);
+
+/**
+ * @brief Encode a message into a buffer allocated with the cJSON allocator,
+ * so it can be freed as the output of cJSON_PrintUnformatted().
+ *
+ * The message is encoded twice: first to measure it, then into a buffer of
+ * the exact size. No other memory is allocated.
+ */
+static int json_encode_alloc(enum json_writer_format format, json_encode_fn encode,
+			     const void *ctx, struct nrf_cloud_data *output)
+{
+	/* JSON output is null-terminated */
+	const size_t term = (format == JSON_WRITER_FORMAT_JSON) ? 1 : 0;
+	struct json_writer w;
+	char *buffer;
+	int len;
+	int err;
+
+	json_writer_init_format(&w, format, NULL, 0);
+	err = encode(&w, ctx);
+	if (err) {
+		return err;
+	}
+
+	len = json_writer_finish(&w);
+	if (len < 0) {
+		return len;
+	}
+
+	buffer = cJSON_malloc(len + term);
+	if (!buffer) {
+		return -ENOMEM;
+	}
+
+	json_writer_init_format(&w, format, buffer, len + term);
+	err = encode(&w, ctx);
+	if (!err) {
+		err = json_writer_finish(&w);
+	}
+
+	if (err != len) {
+		LOG_ERR("Failed to encode message: %d", err);
+		cJSON_free(buffer);
+		return (err < 0) ? err : -EIO;
+	}
+
+	output->ptr = buffer;
+	output->len = len;
+
+	return 0;
+}
+
+/**
+ * @brief Encode the members of an object and add them to a cJSON object.
+ * @p encode must write exactly one object. The items are created directly,
+ * without printing and parsing the message.
+ */
+static int json_encode_to_obj(json_encode_fn encode, const void *ctx, cJSON *const obj)
+{
+	struct json_writer w;
+	int err;
+
+	json_writer_init_cjson(&w, obj);
+	err = encode(&w, ctx);
+	if (!err) {
+		err = json_writer_finish(&w);
+	}
+
+	return err;
+}
+
+static int encode_cjson(struct json_writer *w, const void *ctx)
+{
+	json_writer_cjson(w, NULL, ctx);
+
+	return 0;
+}
+
+int nrf_cloud_cbor_encode(const cJSON *const obj, struct nrf_cloud_data *const output)
+{
+	int err;
+
+	if (!obj || !output) {
+		return -EINVAL;
+	}
+
+	err = json_encode_alloc(JSON_WRITER_FORMAT_CBOR, encode_cjson, obj, output);
+	if (err) {
+		LOG_ERR("Failed to encode CBOR: %d", err);
+		return (err == -ENOMEM) ? err : -EINVAL;
+	}
+
+	return 0;
+}
+
 static char *json_strdup(cJSON *const string_obj)
 {
 	char *dest;
@@ -344,46 +442,32 @@ int nrf_cloud_encode_shadow_data(const struct nrf_cloud_sensor_data *sensor,
 	return ret;
 }
 
+static int encode_sensor_data(struct json_writer *w, const void *ctx)
+{
+	const struct nrf_cloud_sensor_data *sensor = ctx;
+
+	json_writer_obj_start(w, NULL);
+	json_writer_str(w, NRF_CLOUD_JSON_APPID_KEY, sensor_type_str[sensor->type]);
+	json_writer_str(w, NRF_CLOUD_JSON_DATA_KEY, sensor->data.ptr);
+	json_writer_str(w, NRF_CLOUD_JSON_MSG_TYPE_KEY, NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	json_writer_obj_end(w);
+
+	return 0;
+}
+
 int nrf_cloud_encode_sensor_data(const struct nrf_cloud_sensor_data *sensor,
 				 struct nrf_cloud_data *output)
 {
-	int ret;
-
 	__ASSERT_NO_MSG(sensor != NULL);
 	__ASSERT_NO_MSG(sensor->data.ptr != NULL);
 	__ASSERT_NO_MSG(sensor->data.len != 0);
 	__ASSERT_NO_MSG(output != NULL);
 	__ASSERT_NO_MSG(sensor->type < SENSOR_TYPE_ARRAY_SIZE);
 
-	cJSON *root_obj = cJSON_CreateObject();
-
-	if (root_obj == NULL) {
-		return -ENOMEM;
-	}
-
-	ret = json_add_str_cs(root_obj, NRF_CLOUD_JSON_APPID_KEY, sensor_type_str[sensor->type]);
-	ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_DATA_KEY, sensor->data.ptr);
-	ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_MSG_TYPE_KEY,
-			       NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
-
-	if (ret != 0) {
-		cJSON_Delete(root_obj);
-		return -ENOMEM;
-	}
+	const enum json_writer_format format = IS_ENABLED(CONFIG_NRF_CLOUD_CBOR_SENSOR_DATA) ?
+					       JSON_WRITER_FORMAT_CBOR : JSON_WRITER_FORMAT_JSON;
 
-	char *buffer;
-
-	buffer = cJSON_PrintUnformatted(root_obj);
-	cJSON_Delete(root_obj);
-
-	if (buffer == NULL) {
-		return -ENOMEM;
-	}
-
-	output->ptr = buffer;
-	output->len = strlen(buffer);
-
-	return 0;
+	return json_encode_alloc(format, encode_sensor_data, sensor, output) ? -ENOMEM : 0;
 }
 
 #ifdef CONFIG_NRF_CLOUD_GATEWAY
@@ -547,94 +631,104 @@ int nrf_cloud_encode_config_response(struct nrf_cloud_data const *const input,
 	return 0;
 }
 
-int nrf_cloud_encode_state(uint32_t reported_state, const bool update_desired_topic,
-			   struct nrf_cloud_data *output)
+struct state_ctx {
+	uint32_t reported_state;
+	bool update_desired_topic;
+	struct nrf_cloud_data tx_endp;
+	struct nrf_cloud_data rx_endp;
+	struct nrf_cloud_data m_endp;
+};
+
+static int encode_state(struct json_writer *w, const void *ctx)
 {
-	__ASSERT_NO_MSG(output != NULL);
+	const struct state_ctx *state = ctx;
 
-	char *buffer;
-	int ret = 0;
-	cJSON *root_obj = cJSON_CreateObject();
-	cJSON *state_obj = cJSON_AddObjectToObjectCS(root_obj, JSON_KEY_STATE);
-	cJSON *reported_obj = cJSON_AddObjectToObjectCS(state_obj, JSON_KEY_REP);
-	cJSON *pairing_obj = cJSON_AddObjectToObjectCS(reported_obj, JSON_KEY_PAIRING);
-	cJSON *connection_obj = cJSON_AddObjectToObjectCS(reported_obj, JSON_KEY_CONN);
+	json_writer_obj_start(w, NULL);
+	json_writer_obj_start(w, JSON_KEY_STATE);
+	json_writer_obj_start(w, JSON_KEY_REP);
 
-	if (!pairing_obj || !connection_obj) {
-		cJSON_Delete(root_obj);
-		return -ENOMEM;
-	}
-
-	switch (reported_state) {
+	switch (state->reported_state) {
 	case STATE_UA_PIN_WAIT: {
-		ret += json_add_str_cs(pairing_obj, JSON_KEY_STATE, DUA_PIN_STR);
-		ret += json_add_null_cs(pairing_obj, JSON_KEY_TOPICS);
-		ret += json_add_null_cs(pairing_obj, JSON_KEY_CFG);
-		ret += json_add_null_cs(reported_obj, JSON_KEY_STAGE);
-		ret += json_add_null_cs(reported_obj, JSON_KEY_TOPIC_PRFX);
-		ret += json_add_null_cs(connection_obj, JSON_KEY_KEEPALIVE);
-		if (ret != 0) {
-			cJSON_Delete(root_obj);
-			return -ENOMEM;
-		}
+		json_writer_obj_start(w, JSON_KEY_PAIRING);
+		json_writer_str(w, JSON_KEY_STATE, DUA_PIN_STR);
+		json_writer_null(w, JSON_KEY_TOPICS);
+		json_writer_null(w, JSON_KEY_CFG);
+		json_writer_obj_end(w);
+
+		json_writer_obj_start(w, JSON_KEY_CONN);
+		json_writer_null(w, JSON_KEY_KEEPALIVE);
+		json_writer_obj_end(w);
+
+		json_writer_null(w, JSON_KEY_STAGE);
+		json_writer_null(w, JSON_KEY_TOPIC_PRFX);
+		json_writer_obj_end(w);
 		break;
 	}
 	case STATE_UA_PIN_COMPLETE: {
-		struct nrf_cloud_data rx_endp;
-		struct nrf_cloud_data tx_endp;
-		struct nrf_cloud_data m_endp;
-
-		/* Get the endpoint information. */
-		nct_dc_endpoint_get(&tx_endp, &rx_endp, NULL, &m_endp);
-		ret += json_add_str_cs(reported_obj, JSON_KEY_TOPIC_PRFX, m_endp.ptr);
-
-		/* Clear pairing config and pairingStatus fields. */
-		ret += json_add_str_cs(pairing_obj, JSON_KEY_STATE, PAIRED_STR);
-		ret += json_add_null_cs(pairing_obj, JSON_KEY_CFG);
-		ret += json_add_null_cs(reported_obj, JSON_KEY_PAIR_STAT);
+		/* Clear pairing config and report pairing topics. */
+		json_writer_obj_start(w, JSON_KEY_PAIRING);
+		json_writer_str(w, JSON_KEY_STATE, PAIRED_STR);
+		json_writer_null(w, JSON_KEY_CFG);
+		json_writer_obj_start(w, JSON_KEY_TOPICS);
+		json_writer_str(w, JSON_KEY_DEVICE_TO_CLOUD, state->tx_endp.ptr);
+		json_writer_str(w, JSON_KEY_CLOUD_TO_DEVICE, state->rx_endp.ptr);
+		json_writer_obj_end(w);
+		json_writer_obj_end(w);
 
 		/* Report keepalive value. */
-		ret += json_add_num_cs(connection_obj, JSON_KEY_KEEPALIVE,
-				       CONFIG_NRF_CLOUD_MQTT_KEEPALIVE);
-
-		/* Report pairing topics. */
-		cJSON *topics_obj = cJSON_AddObjectToObjectCS(pairing_obj, JSON_KEY_TOPICS);
+		json_writer_obj_start(w, JSON_KEY_CONN);
+		json_writer_num(w, JSON_KEY_KEEPALIVE, CONFIG_NRF_CLOUD_MQTT_KEEPALIVE);
+		json_writer_obj_end(w);
 
-		ret += json_add_str_cs(topics_obj, JSON_KEY_DEVICE_TO_CLOUD, tx_endp.ptr);
-		ret += json_add_str_cs(topics_obj, JSON_KEY_CLOUD_TO_DEVICE, rx_endp.ptr);
+		/* Report the topic prefix and clear pairingStatus field. */
+		json_writer_str(w, JSON_KEY_TOPIC_PRFX, state->m_endp.ptr);
+		json_writer_null(w, JSON_KEY_PAIR_STAT);
+		json_writer_obj_end(w);
 
-		if (update_desired_topic) {
+		if (state->update_desired_topic) {
 			/* Align desired c2d topic with reported to prevent delta events */
-			cJSON *des_obj = cJSON_AddObjectToObjectCS(state_obj, JSON_KEY_DES);
-			cJSON *pair_obj = cJSON_AddObjectToObjectCS(des_obj, JSON_KEY_PAIRING);
-			cJSON *topic_obj = cJSON_AddObjectToObjectCS(pair_obj, JSON_KEY_TOPICS);
-
-			ret += json_add_str_cs(topic_obj, JSON_KEY_CLOUD_TO_DEVICE, rx_endp.ptr);
-		}
-
-		if (ret != 0) {
-			cJSON_Delete(root_obj);
-			return -ENOMEM;
+			json_writer_obj_start(w, JSON_KEY_DES);
+			json_writer_obj_start(w, JSON_KEY_PAIRING);
+			json_writer_obj_start(w, JSON_KEY_TOPICS);
+			json_writer_str(w, JSON_KEY_CLOUD_TO_DEVICE, state->rx_endp.ptr);
+			json_writer_obj_end(w);
+			json_writer_obj_end(w);
+			json_writer_obj_end(w);
 		}
 		break;
 	}
-	default: {
-		cJSON_Delete(root_obj);
+	default:
 		return -ENOTSUP;
 	}
-	}
 
-	buffer = cJSON_PrintUnformatted(root_obj);
-	cJSON_Delete(root_obj);
+	json_writer_obj_end(w);
+	json_writer_obj_end(w);
 
-	if (buffer == NULL) {
-		return -ENOMEM;
+	return 0;
+}
+
+int nrf_cloud_encode_state(uint32_t reported_state, const bool update_desired_topic,
+			   struct nrf_cloud_data *output)
+{
+	__ASSERT_NO_MSG(output != NULL);
+
+	struct state_ctx state = {
+		.reported_state = reported_state,
+		.update_desired_topic = update_desired_topic,
+	};
+	int ret;
+
+	if (reported_state == STATE_UA_PIN_COMPLETE) {
+		/* Get the endpoint information. */
+		nct_dc_endpoint_get(&state.tx_endp, &state.rx_endp, NULL, &state.m_endp);
 	}
 
-	output->ptr = buffer;
-	output->len = strlen(buffer);
+	ret = json_encode_alloc(JSON_WRITER_FORMAT_JSON, encode_state, &state, output);
+	if (ret == -ENOTSUP) {
+		return ret;
+	}
 
-	return 0;
+	return ret ? -ENOMEM : 0;
 }
 
 /**
@@ -816,169 +910,88 @@ int json_send_to_cloud(cJSON *const request)
 }
 #endif /* CONFIG_NRF_CLOUD_MQTT */
 
-static int nrf_cloud_encode_service_info_fota(const struct nrf_cloud_svc_info_fota *const fota,
-					      cJSON *const svc_inf_obj)
+static void encode_service_info_fota(struct json_writer *w,
+				     const struct nrf_cloud_svc_info_fota *const fota)
 {
-	if (!svc_inf_obj) {
-		return -EINVAL;
-	}
-
 	if (fota == NULL ||
 	    (IS_ENABLED(CONFIG_NRF_CLOUD_MQTT) && !IS_ENABLED(CONFIG_NRF_CLOUD_FOTA))) {
 		if (fota && (fota->application || fota->modem || fota->bootloader)) {
 			LOG_WRN("CONFIG_NRF_CLOUD_FOTA not enabled, setting FOTA array to 'null'");
 		}
 
-		if (json_add_null_cs(svc_inf_obj, JSON_KEY_SRVC_INFO_FOTA) != 0) {
-			return -ENOMEM;
-		}
-	} else if (fota) {
-		int item_cnt = 0;
-		cJSON *array = cJSON_AddArrayToObjectCS(svc_inf_obj, JSON_KEY_SRVC_INFO_FOTA);
-
-		if (!array) {
-			return -ENOMEM;
-		}
-		if (fota->bootloader) {
-			cJSON_AddItemToArray(array, cJSON_CreateString(NRF_CLOUD_FOTA_TYPE_BOOT));
-			++item_cnt;
-		}
-		if (fota->modem) {
-			cJSON_AddItemToArray(array,
-					     cJSON_CreateString(NRF_CLOUD_FOTA_TYPE_MODEM_DELTA));
-			++item_cnt;
-		}
-		if (fota->application) {
-			cJSON_AddItemToArray(array, cJSON_CreateString(NRF_CLOUD_FOTA_TYPE_APP));
-			++item_cnt;
-		}
-		if (fota->modem_full) {
-			cJSON_AddItemToArray(array,
-					     cJSON_CreateString(NRF_CLOUD_FOTA_TYPE_MODEM_FULL));
-			++item_cnt;
-		}
-
-		if (cJSON_GetArraySize(array) != item_cnt) {
-			cJSON_DeleteItemFromObject(svc_inf_obj, JSON_KEY_SRVC_INFO_FOTA);
-			return -ENOMEM;
-		}
+		json_writer_null(w, JSON_KEY_SRVC_INFO_FOTA);
+		return;
 	}
 
-	return 0;
+	json_writer_arr_start(w, JSON_KEY_SRVC_INFO_FOTA);
+	if (fota->bootloader) {
+		json_writer_str(w, NULL, NRF_CLOUD_FOTA_TYPE_BOOT);
+	}
+	if (fota->modem) {
+		json_writer_str(w, NULL, NRF_CLOUD_FOTA_TYPE_MODEM_DELTA);
+	}
+	if (fota->application) {
+		json_writer_str(w, NULL, NRF_CLOUD_FOTA_TYPE_APP);
+	}
+	if (fota->modem_full) {
+		json_writer_str(w, NULL, NRF_CLOUD_FOTA_TYPE_MODEM_FULL);
+	}
+	json_writer_arr_end(w);
 }
 
-static int nrf_cloud_encode_service_info_ui(const struct nrf_cloud_svc_info_ui *const ui,
-					    cJSON *const svc_inf_obj)
+static void encode_service_info_ui(struct json_writer *w,
+				   const struct nrf_cloud_svc_info_ui *const ui)
 {
-	if (!svc_inf_obj) {
-		return -EINVAL;
-	}
-
 	if (ui == NULL) {
-		if (json_add_null_cs(svc_inf_obj, JSON_KEY_SRVC_INFO_UI) != 0) {
-			return -ENOMEM;
-		}
-	} else {
-		int item_cnt = 0;
-		cJSON *array = cJSON_AddArrayToObjectCS(svc_inf_obj, JSON_KEY_SRVC_INFO_UI);
-
-		if (!array) {
-			return -ENOMEM;
-		}
-		if (ui->air_pressure) {
-			cJSON_AddItemToArray(array,
-				cJSON_CreateString(sensor_type_str[NRF_CLOUD_SENSOR_AIR_PRESS]));
-			++item_cnt;
-		}
-		if (ui->gnss) {
-			cJSON_AddItemToArray(array,
-				cJSON_CreateString(sensor_type_str[NRF_CLOUD_SENSOR_GNSS]));
-			++item_cnt;
-		}
-		if (ui->flip) {
-			cJSON_AddItemToArray(array,
-				cJSON_CreateString(sensor_type_str[NRF_CLOUD_SENSOR_FLIP]));
-			++item_cnt;
-		}
-		if (ui->button) {
-			cJSON_AddItemToArray(array,
-				cJSON_CreateString(sensor_type_str[NRF_CLOUD_SENSOR_BUTTON]));
-			++item_cnt;
-		}
-		if (ui->temperature) {
-			cJSON_AddItemToArray(array,
-				cJSON_CreateString(sensor_type_str[NRF_CLOUD_SENSOR_TEMP]));
-			++item_cnt;
-		}
-		if (ui->humidity) {
-			cJSON_AddItemToArray(array,
-				cJSON_CreateString(sensor_type_str[NRF_CLOUD_SENSOR_HUMID]));
-			++item_cnt;
-		}
-		if (ui->light_sensor) {
-			cJSON_AddItemToArray(array,
-				cJSON_CreateString(sensor_type_str[NRF_CLOUD_SENSOR_LIGHT]));
-			++item_cnt;
-		}
-		if (ui->rsrp) {
-			cJSON_AddItemToArray(array,
-				cJSON_CreateString(sensor_type_str[NRF_CLOUD_LTE_LINK_RSRP]));
-			++item_cnt;
-		}
-
-		if (cJSON_GetArraySize(array) != item_cnt) {
-			cJSON_DeleteItemFromObject(svc_inf_obj, JSON_KEY_SRVC_INFO_UI);
-			return -ENOMEM;
-		}
+		json_writer_null(w, JSON_KEY_SRVC_INFO_UI);
+		return;
 	}
 
-	return 0;
+	json_writer_arr_start(w, JSON_KEY_SRVC_INFO_UI);
+	if (ui->air_pressure) {
+		json_writer_str(w, NULL, sensor_type_str[NRF_CLOUD_SENSOR_AIR_PRESS]);
+	}
+	if (ui->gnss) {
+		json_writer_str(w, NULL, sensor_type_str[NRF_CLOUD_SENSOR_GNSS]);
+	}
+	if (ui->flip) {
+		json_writer_str(w, NULL, sensor_type_str[NRF_CLOUD_SENSOR_FLIP]);
+	}
+	if (ui->button) {
+		json_writer_str(w, NULL, sensor_type_str[NRF_CLOUD_SENSOR_BUTTON]);
+	}
+	if (ui->temperature) {
+		json_writer_str(w, NULL, sensor_type_str[NRF_CLOUD_SENSOR_TEMP]);
+	}
+	if (ui->humidity) {
+		json_writer_str(w, NULL, sensor_type_str[NRF_CLOUD_SENSOR_HUMID]);
+	}
+	if (ui->light_sensor) {
+		json_writer_str(w, NULL, sensor_type_str[NRF_CLOUD_SENSOR_LIGHT]);
+	}
+	if (ui->rsrp) {
+		json_writer_str(w, NULL, sensor_type_str[NRF_CLOUD_LTE_LINK_RSRP]);
+	}
+	json_writer_arr_end(w);
 }
 
-static int encode_info_item_cs(const enum nrf_cloud_shadow_info inf, const char *const inf_name,
-			    cJSON *const inf_obj, cJSON *const root_obj)
+/* Write the service info members into the current object */
+static void encode_service_info(struct json_writer *w,
+				const struct nrf_cloud_svc_info *const svc_inf)
 {
-	cJSON *move_obj;
-
-	switch (inf) {
-	case NRF_CLOUD_INFO_SET:
-		move_obj = cJSON_DetachItemFromObject(inf_obj, inf_name);
-
-		if (!move_obj) {
-			LOG_ERR("Info item \"%s\" not found", inf_name);
-			return -ENOMSG;
-		}
-
-		if (json_add_obj_cs(root_obj, inf_name, move_obj)) {
-			cJSON_Delete(move_obj);
-			LOG_ERR("Failed to add info item \"%s\"", inf_name);
-			return -ENOMEM;
-		}
-		break;
-	case NRF_CLOUD_INFO_CLEAR:
-		if (json_add_null_cs(root_obj, inf_name)) {
-			LOG_ERR("Failed to create NULL item for \"%s\"", inf_name);
-			return -ENOMEM;
-		}
-		break;
-	case NRF_CLOUD_INFO_NO_CHANGE:
-	default:
-		break;
-	}
-
-	return 0;
+	encode_service_info_fota(w, svc_inf->fota);
+	encode_service_info_ui(w, svc_inf->ui);
 }
 
 #ifdef CONFIG_MODEM_INFO
 
-static int add_modem_info_data(struct lte_param *param, cJSON *json_obj)
+static int add_modem_info_data(struct json_writer *w, const struct lte_param *param)
 {
 	char data_name[MODEM_INFO_MAX_RESPONSE_SIZE];
 	enum at_param_type data_type;
 	int ret;
 
 	__ASSERT_NO_MSG(param != NULL);
-	__ASSERT_NO_MSG(json_obj != NULL);
 
 	memset(data_name, 0, ARRAY_SIZE(data_name));
 	ret = modem_info_name_get(param->type,
@@ -995,53 +1008,49 @@ static int add_modem_info_data(struct lte_param *param, cJSON *json_obj)
 
 	if (data_type == AT_PARAM_TYPE_STRING &&
 	    param->type != MODEM_INFO_AREA_CODE) {
-		if (cJSON_AddStringToObject(json_obj, data_name, param->value_string) == NULL) {
-			return -ENOMEM;
-		}
+		json_writer_str(w, data_name, param->value_string);
 	} else {
-		if (cJSON_AddNumberToObject(json_obj, data_name, param->value) == NULL) {
-			return -ENOMEM;
-		}
+		json_writer_num(w, data_name, param->value);
 	}
 
 	return 0;
 }
 
-static int encode_modem_info_network(struct network_param *network, cJSON *json_obj)
+static int encode_modem_info_network(struct json_writer *w, const struct modem_param_info *mpi)
 {
+	const struct network_param *network = &mpi->network;
 	char network_mode[12] = {0};
 	char data_name[MODEM_INFO_MAX_RESPONSE_SIZE] = {0};
 	int ret;
 
 	__ASSERT_NO_MSG(network != NULL);
-	__ASSERT_NO_MSG(json_obj != NULL);
 
-	ret = add_modem_info_data(&network->current_band, json_obj);
+	ret = add_modem_info_data(w, &network->current_band);
 	if (ret) {
 		return ret;
 	}
 
-	ret = add_modem_info_data(&network->sup_band, json_obj);
+	ret = add_modem_info_data(w, &network->sup_band);
 	if (ret) {
 		return ret;
 	}
 
-	ret = add_modem_info_data(&network->area_code, json_obj);
+	ret = add_modem_info_data(w, &network->area_code);
 	if (ret) {
 		return ret;
 	}
 
-	ret = add_modem_info_data(&network->current_operator, json_obj);
+	ret = add_modem_info_data(w, &network->current_operator);
 	if (ret) {
 		return ret;
 	}
 
-	ret = add_modem_info_data(&network->ip_address, json_obj);
+	ret = add_modem_info_data(w, &network->ip_address);
 	if (ret) {
 		return ret;
 	}
 
-	ret = add_modem_info_data(&network->ue_mode, json_obj);
+	ret = add_modem_info_data(w, &network->ue_mode);
 	if (ret) {
 		return ret;
 	}
@@ -1051,9 +1060,7 @@ static int encode_modem_info_network(struct network_param *network, cJSON *json_
 		return ret;
 	}
 
-	if (cJSON_AddNumberToObjectCS(json_obj, data_name, network->cellid_dec) == NULL) {
-		return -EINVAL;
-	}
+	json_writer_num(w, data_name, network->cellid_dec);
 
 	if (network->lte_mode.value == 1) {
 		strcat(network_mode, "LTE-M");
@@ -1064,31 +1071,29 @@ static int encode_modem_info_network(struct network_param *network, cJSON *json_
 		strcat(network_mode, " GPS");
 	}
 
-	if (cJSON_AddStringToObject(json_obj, "networkMode", network_mode) == NULL) {
-		return -EINVAL;
-	}
+	json_writer_str(w, "networkMode", network_mode);
 
 	return 0;
 }
 
-static int encode_modem_info_sim(struct sim_param *sim, cJSON *json_obj)
+static int encode_modem_info_sim(struct json_writer *w, const struct modem_param_info *mpi)
 {
+	const struct sim_param *sim = &mpi->sim;
 	int ret;
 
 	__ASSERT_NO_MSG(sim != NULL);
-	__ASSERT_NO_MSG(json_obj != NULL);
 
-	ret = add_modem_info_data(&sim->uicc, json_obj);
+	ret = add_modem_info_data(w, &sim->uicc);
 	if (ret) {
 		return ret;
 	}
 
-	ret = add_modem_info_data(&sim->iccid, json_obj);
+	ret = add_modem_info_data(w, &sim->iccid);
 	if (ret) {
 		LOG_DBG("sim_param object does not contain an ICCID");
 	}
 
-	ret = add_modem_info_data(&sim->imsi, json_obj);
+	ret = add_modem_info_data(w, &sim->imsi);
 	if (ret) {
 		LOG_DBG("sim_param object does not contain an IMSI");
 	}
@@ -1096,118 +1101,41 @@ static int encode_modem_info_sim(struct sim_param *sim, cJSON *json_obj)
 	return 0;
 }
 
-static int encode_modem_info_device(struct device_param *device, cJSON *json_obj)
+static int encode_modem_info_device(struct json_writer *w, const struct modem_param_info *mpi)
 {
+	const struct device_param *device = &mpi->device;
 	int ret;
 
 	__ASSERT_NO_MSG(device != NULL);
-	__ASSERT_NO_MSG(json_obj != NULL);
 
-	ret = add_modem_info_data(&device->modem_fw, json_obj);
+	ret = add_modem_info_data(w, &device->modem_fw);
 	if (ret) {
 		return ret;
 	}
 
-	ret = add_modem_info_data(&device->battery, json_obj);
+	ret = add_modem_info_data(w, &device->battery);
 	if (ret) {
 		return ret;
 	}
 
-	ret = add_modem_info_data(&device->imei, json_obj);
+	ret = add_modem_info_data(w, &device->imei);
 	if (ret) {
 		return ret;
 	}
 
-	if (cJSON_AddStringToObject(json_obj, "board", device->board) == NULL) {
-		return -EINVAL;
-	}
-
-	if (cJSON_AddStringToObject(json_obj, "appVersion", device->app_version) == NULL) {
-		return -EINVAL;
-	}
-
-	if (cJSON_AddStringToObject(json_obj, "appName", device->app_name) == NULL) {
-		return -EINVAL;
-	}
-
-	return 0;
-}
-
-static int encode_modem_info_json_object(struct modem_param_info *modem,
-				  cJSON *root_obj)
-{
-	int ret;
-
-	__ASSERT_NO_MSG(root_obj != NULL);
-	__ASSERT_NO_MSG(modem != NULL);
-
-	cJSON *network_obj = NULL;
-	cJSON *sim_obj = NULL;
-	cJSON *device_obj = NULL;
-
-	if (IS_ENABLED(CONFIG_MODEM_INFO_ADD_NETWORK)) {
-		network_obj = cJSON_CreateObject();
-		if (network_obj == NULL) {
-			return -ENOMEM;
-		}
-		ret = encode_modem_info_network(&modem->network, network_obj);
-		if (!ret) {
-			ret = json_add_obj_cs(root_obj,
-					      NRF_CLOUD_DEVICE_JSON_KEY_NET_INF, network_obj);
-			if (ret) {
-				cJSON_Delete(network_obj);
-				return -ENOMEM;
-			}
-		} else {
-			cJSON_Delete(network_obj);
-		}
-	}
-
-	if (IS_ENABLED(CONFIG_MODEM_INFO_ADD_SIM)) {
-		sim_obj = cJSON_CreateObject();
-		if (sim_obj == NULL) {
-			return -ENOMEM;
-		}
-		ret = encode_modem_info_sim(&modem->sim, sim_obj);
-		if (!ret) {
-			ret = json_add_obj_cs(root_obj,
-					      NRF_CLOUD_DEVICE_JSON_KEY_SIM_INF, sim_obj);
-			if (ret) {
-				cJSON_Delete(sim_obj);
-				return -ENOMEM;
-			}
-		} else {
-			cJSON_Delete(sim_obj);
-		}
-	}
-
-	if (IS_ENABLED(CONFIG_MODEM_INFO_ADD_DEVICE)) {
-		device_obj = cJSON_CreateObject();
-		if (device_obj == NULL) {
-			return -ENOMEM;
-		}
-		ret = encode_modem_info_device(&modem->device, device_obj);
-		if (!ret) {
-			ret = json_add_obj_cs(root_obj,
-					      NRF_CLOUD_DEVICE_JSON_KEY_DEV_INF, device_obj);
-			if (ret) {
-				cJSON_Delete(device_obj);
-				return -ENOMEM;
-			}
-		} else {
-			cJSON_Delete(device_obj);
-		}
-	}
+	json_writer_str(w, "board", device->board);
+	json_writer_str(w, "appVersion", device->app_version);
+	json_writer_str(w, "appName", device->app_name);
 
 	return 0;
 }
 
-int nrf_cloud_modem_info_json_encode(const struct nrf_cloud_modem_info *const mod_inf,
-				     cJSON *const mod_inf_obj)
+/* Check the requested modem info and fetch it from the modem if not provided */
+static int modem_info_prepare(const struct nrf_cloud_modem_info *const mod_inf,
+			      struct modem_param_info *const fetched_mod_inf,
+			      const struct modem_param_info **mpi)
 {
-	if (!mod_inf_obj || !mod_inf) {
-		return -EINVAL;
-	}
+	int err;
 
 	if ((!IS_ENABLED(CONFIG_MODEM_INFO_ADD_DEVICE)) &&
 		   (mod_inf->device == NRF_CLOUD_INFO_SET)) {
@@ -1223,94 +1151,197 @@ int nrf_cloud_modem_info_json_encode(const struct nrf_cloud_modem_info *const mo
 		return -EACCES;
 	}
 
-	int err = 0;
-	cJSON *tmp = cJSON_CreateObject();
+	*mpi = mod_inf->mpi;
+	if (*mpi) {
+		return 0;
+	}
 
-	if (!tmp) {
-		err = -ENOMEM;
-		goto cleanup;
+	err = modem_info_init();
+	if (err) {
+		LOG_ERR("modem_info_init() failed: %d", err);
+		return err;
 	}
 
-	struct modem_param_info *mpi = (struct modem_param_info *)mod_inf->mpi;
-	struct modem_param_info fetched_mod_inf;
+	err = modem_info_params_init(fetched_mod_inf);
+	if (err) {
+		LOG_ERR("modem_info_params_init() failed: %d", err);
+		return err;
+	}
 
-	if (!mpi) {
-		err = modem_info_init();
-		if (err) {
-			LOG_ERR("modem_info_init() failed: %d", err);
-			goto cleanup;
+	err = modem_info_params_get(fetched_mod_inf);
+	if (err < 0) {
+		LOG_ERR("modem_info_params_get() failed: %d", err);
+		return err;
+	}
+
+	*mpi = fetched_mod_inf;
+
+	return 0;
+}
+#endif /* CONFIG_MODEM_INFO */
+
+/* Writes the members of a modem info item */
+typedef int (*info_item_encode_fn)(struct json_writer *w, const struct modem_param_info *mpi);
+
+/* Write a modem info item into the current object, as requested by @p inf */
+static int encode_info_item(struct json_writer *w, const enum nrf_cloud_shadow_info inf,
+			    const char *const inf_name, info_item_encode_fn encode,
+			    const struct modem_param_info *mpi)
+{
+	int err;
+
+	switch (inf) {
+	case NRF_CLOUD_INFO_SET:
+		if (!encode) {
+			LOG_ERR("Info item \"%s\" not found", inf_name);
+			return -ENOMSG;
 		}
 
-		err = modem_info_params_init(&fetched_mod_inf);
+		json_writer_obj_start(w, inf_name);
+		err = encode(w, mpi);
+		json_writer_obj_end(w);
+
 		if (err) {
-			LOG_ERR("modem_info_params_init() failed: %d", err);
-			goto cleanup;
+			LOG_ERR("Failed to add info item \"%s\": %d", inf_name, err);
+			return err;
 		}
+		break;
+	case NRF_CLOUD_INFO_CLEAR:
+		json_writer_null(w, inf_name);
+		break;
+	case NRF_CLOUD_INFO_NO_CHANGE:
+	default:
+		break;
+	}
 
-		err = modem_info_params_get(&fetched_mod_inf);
-		if (err < 0) {
-			LOG_ERR("modem_info_params_get() failed: %d", err);
-			goto cleanup;
-		}
-		mpi = &fetched_mod_inf;
+	return 0;
+}
+
+/* Write the modem info members into the current object */
+static int encode_modem_info(struct json_writer *w,
+			     const struct nrf_cloud_modem_info *const mod_inf,
+			     const struct modem_param_info *mpi)
+{
+#ifdef CONFIG_MODEM_INFO
+	const info_item_encode_fn encode_device = encode_modem_info_device;
+	const info_item_encode_fn encode_network = encode_modem_info_network;
+	const info_item_encode_fn encode_sim = encode_modem_info_sim;
+#else
+	const info_item_encode_fn encode_device = NULL;
+	const info_item_encode_fn encode_network = NULL;
+	const info_item_encode_fn encode_sim = NULL;
+#endif
+
+	if (encode_info_item(w, mod_inf->device, NRF_CLOUD_DEVICE_JSON_KEY_DEV_INF,
+			     encode_device, mpi) ||
+	    encode_info_item(w, mod_inf->network, NRF_CLOUD_DEVICE_JSON_KEY_NET_INF,
+			     encode_network, mpi) ||
+	    encode_info_item(w, mod_inf->sim, NRF_CLOUD_DEVICE_JSON_KEY_SIM_INF,
+			     encode_sim, mpi)) {
+		LOG_ERR("Failed to encode modem info");
+		return -EIO;
 	}
 
-	err = encode_modem_info_json_object(mpi, tmp);
-	if (err) {
-		LOG_ERR("Failed to encode modem info: %d", err);
-		goto cleanup;
+	return 0;
+}
+
+struct device_status_ctx {
+	const struct nrf_cloud_device_status *dev_status;
+	const struct modem_param_info *mpi;
+	bool include_state;
+};
+
+static int encode_device_status(struct json_writer *w, const void *ctx)
+{
+	const struct device_status_ctx *status = ctx;
+	const struct nrf_cloud_device_status *dev_status = status->dev_status;
+	int err = 0;
+
+	json_writer_obj_start(w, NULL);
+	if (status->include_state) {
+		json_writer_obj_start(w, JSON_KEY_STATE);
 	}
+	json_writer_obj_start(w, JSON_KEY_REP);
+	json_writer_obj_start(w, JSON_KEY_DEVICE);
 
-	if (encode_info_item_cs(mod_inf->device,
-				NRF_CLOUD_DEVICE_JSON_KEY_DEV_INF, tmp, mod_inf_obj) ||
-	    encode_info_item_cs(mod_inf->network,
-				NRF_CLOUD_DEVICE_JSON_KEY_NET_INF, tmp, mod_inf_obj) ||
-	    encode_info_item_cs(mod_inf->sim,
-				NRF_CLOUD_DEVICE_JSON_KEY_SIM_INF, tmp, mod_inf_obj)) {
-		LOG_ERR("Failed to encode modem info");
-		err = -EIO;
-		goto cleanup;
+	json_writer_obj_start(w, JSON_KEY_SRVC_INFO);
+	if (dev_status->svc) {
+		encode_service_info(w, dev_status->svc);
 	}
+	json_writer_obj_end(w);
+
+	if (dev_status->modem) {
+		err = encode_modem_info(w, dev_status->modem, status->mpi);
+	}
+
+	json_writer_obj_end(w);
+	json_writer_obj_end(w);
+	if (status->include_state) {
+		json_writer_obj_end(w);
+	}
+	json_writer_obj_end(w);
 
-cleanup:
-	cJSON_Delete(tmp);
 	return err;
 }
-#else
-int nrf_cloud_modem_info_json_encode(const struct nrf_cloud_modem_info *const mod_inf,
-				     cJSON *const mod_inf_obj)
+
+static int encode_modem_info_obj(struct json_writer *w, const void *ctx)
 {
-	cJSON *tmp = cJSON_CreateObject();
+	const struct device_status_ctx *status = ctx;
+	int err;
+
+	json_writer_obj_start(w, NULL);
+	err = encode_modem_info(w, status->dev_status->modem, status->mpi);
+	json_writer_obj_end(w);
+
+	return err;
+}
+
+static int encode_service_info_obj(struct json_writer *w, const void *ctx)
+{
+	json_writer_obj_start(w, NULL);
+	encode_service_info(w, ctx);
+	json_writer_obj_end(w);
 
-	if (encode_info_item_cs(mod_inf->device,
-				NRF_CLOUD_DEVICE_JSON_KEY_DEV_INF, tmp, mod_inf_obj) ||
-	    encode_info_item_cs(mod_inf->network,
-				NRF_CLOUD_DEVICE_JSON_KEY_NET_INF, tmp, mod_inf_obj) ||
-	    encode_info_item_cs(mod_inf->sim,
-				NRF_CLOUD_DEVICE_JSON_KEY_SIM_INF, tmp, mod_inf_obj)) {
-		LOG_ERR("Failed to encode modem info");
-		cJSON_Delete(tmp);
-		return -EIO;
-	}
-	cJSON_Delete(tmp);
 	return 0;
 }
-#endif /* CONFIG_MODEM_INFO */
 
-int nrf_cloud_service_info_json_encode(const struct nrf_cloud_svc_info *const svc_inf,
-	cJSON *const svc_inf_obj)
+int nrf_cloud_modem_info_json_encode(const struct nrf_cloud_modem_info *const mod_inf,
+				     cJSON *const mod_inf_obj)
 {
-	if (!svc_inf || !svc_inf_obj) {
+	if (!mod_inf_obj || !mod_inf) {
 		return -EINVAL;
 	}
 
-	int err = nrf_cloud_encode_service_info_fota(svc_inf->fota, svc_inf_obj);
+	const struct nrf_cloud_device_status dev_status = {
+		.modem = (struct nrf_cloud_modem_info *)mod_inf,
+	};
+	struct device_status_ctx status = {
+		.dev_status = &dev_status,
+	};
+	int err;
+
+#ifdef CONFIG_MODEM_INFO
+	struct modem_param_info fetched_mod_inf;
 
+	err = modem_info_prepare(mod_inf, &fetched_mod_inf, &status.mpi);
 	if (err) {
 		return err;
 	}
+#endif
+
+	err = json_encode_to_obj(encode_modem_info_obj, &status, mod_inf_obj);
+
+	return (err == -EIO) ? err : (err ? -ENOMEM : 0);
+}
+
+int nrf_cloud_service_info_json_encode(const struct nrf_cloud_svc_info *const svc_inf,
+	cJSON *const svc_inf_obj)
+{
+	if (!svc_inf || !svc_inf_obj) {
+		return -EINVAL;
+	}
 
-	return nrf_cloud_encode_service_info_ui(svc_inf->ui, svc_inf_obj);
+	return json_encode_to_obj(encode_service_info_obj, svc_inf, svc_inf_obj) ? -ENOMEM : 0;
 }
 
 void nrf_cloud_device_status_free(struct nrf_cloud_data *status)
@@ -1329,50 +1360,32 @@ int nrf_cloud_device_status_encode(const struct nrf_cloud_device_status *const d
 		return -EINVAL;
 	}
 
-	int err = 0;
-	cJSON *state_obj = NULL;
-	cJSON *reported_obj = NULL;
-	cJSON *root_obj = cJSON_CreateObject();
-
-	if (include_state) {
-		state_obj = cJSON_AddObjectToObjectCS(root_obj, JSON_KEY_STATE);
-		reported_obj = cJSON_AddObjectToObjectCS(state_obj, JSON_KEY_REP);
-	} else {
-		reported_obj = cJSON_AddObjectToObjectCS(root_obj, JSON_KEY_REP);
-	}
-
-	cJSON *device_obj = cJSON_AddObjectToObjectCS(reported_obj, JSON_KEY_DEVICE);
-	cJSON *svc_inf_obj = cJSON_AddObjectToObjectCS(device_obj, JSON_KEY_SRVC_INFO);
+	struct device_status_ctx status = {
+		.dev_status = dev_status,
+		.include_state = include_state,
+	};
+	int err;
 
-	if (svc_inf_obj == NULL) {
-		err = -ENOMEM;
-		goto cleanup;
-	}
+#ifdef CONFIG_MODEM_INFO
+	/* Fetch the modem info once, it is encoded twice */
+	struct modem_param_info fetched_mod_inf;
 
 	if (dev_status->modem) {
-		err = nrf_cloud_modem_info_json_encode(dev_status->modem, device_obj);
-		if (err) {
-			goto cleanup;
-		}
-	}
-
-	if (dev_status->svc) {
-		err = nrf_cloud_service_info_json_encode(dev_status->svc, svc_inf_obj);
+		err = modem_info_prepare(dev_status->modem, &fetched_mod_inf, &status.mpi);
 		if (err) {
 			goto cleanup;
 		}
 	}
+#endif
 
-	output->ptr = cJSON_PrintUnformatted(root_obj);
-	if (output->ptr) {
-		output->len = strlen(output->ptr);
-	} else {
+	err = json_encode_alloc(JSON_WRITER_FORMAT_JSON, encode_device_status, &status, output);
+	if (err && (err != -EIO)) {
 		err = -ENOMEM;
 	}
 
+#ifdef CONFIG_MODEM_INFO
 cleanup:
-	cJSON_Delete(root_obj);
-
+#endif
 	if (err) {
 		output->ptr = NULL;
 		output->len = 0;
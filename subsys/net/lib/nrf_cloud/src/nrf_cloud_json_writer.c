@@ -0,0 +1,591 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/toolchain.h>
+#include <zephyr/sys/util.h>
+
+#include "nrf_cloud_json_writer.h"
+
+BUILD_ASSERT(JSON_WRITER_MAX_DEPTH <= 32, "Container flags do not fit");
+
+/* CBOR major types and simple values, RFC 8949 section 3 */
+#define CBOR_MAJOR_UINT		0
+#define CBOR_MAJOR_NINT		1
+#define CBOR_MAJOR_TEXT		3
+#define CBOR_MAJOR_ARRAY	4
+#define CBOR_MAJOR_MAP		5
+#define CBOR_INDEFINITE		31
+#define CBOR_FALSE		0xF4
+#define CBOR_TRUE		0xF5
+#define CBOR_NULL		0xF6
+#define CBOR_FLOAT32		0xFA
+#define CBOR_FLOAT64		0xFB
+#define CBOR_BREAK		0xFF
+
+static bool is_cbor(const struct json_writer *w)
+{
+	return w->format == JSON_WRITER_FORMAT_CBOR;
+}
+
+static bool is_cjson(const struct json_writer *w)
+{
+	return w->format == JSON_WRITER_FORMAT_CJSON;
+}
+
+/* Add a new item to the current container of the cJSON tree.
+ * The length counts the items, so that an empty output can be detected.
+ */
+static void cjson_add(struct json_writer *w, const char *key, cJSON *item)
+{
+	cJSON *parent;
+	bool added;
+
+	if (!item) {
+		w->err = -ENOMEM;
+		return;
+	}
+
+	if (w->depth == 0) {
+		/* The root value is the target object */
+		cJSON_Delete(item);
+		w->err = -EINVAL;
+		return;
+	}
+
+	parent = w->tree[w->depth - 1];
+	if (key) {
+		added = cJSON_AddItemToObject(parent, key, item);
+	} else {
+		added = cJSON_AddItemToArray(parent, item);
+	}
+
+	if (!added) {
+		cJSON_Delete(item);
+		w->err = -ENOMEM;
+		return;
+	}
+
+	w->len++;
+}
+
+static bool cjson_container_start(struct json_writer *w, const char *key, bool array)
+{
+	cJSON *item;
+
+	if (w->depth == 0) {
+		/* Members of the root object are added to the target object */
+		if (array || !w->tree[0]) {
+			w->err = -EINVAL;
+			return false;
+		}
+		w->len++;
+		return true;
+	}
+
+	item = array ? cJSON_CreateArray() : cJSON_CreateObject();
+	cjson_add(w, key, item);
+	if (w->err) {
+		return false;
+	}
+
+	w->tree[w->depth] = item;
+
+	return true;
+}
+
+static void put(struct json_writer *w, const char *data, size_t len)
+{
+	if (w->buf && (w->len < w->size)) {
+		memcpy(&w->buf[w->len], data, MIN(len, w->size - w->len));
+	}
+
+	w->len += len;
+}
+
+static void put_char(struct json_writer *w, char c)
+{
+	put(w, &c, 1);
+}
+
+static void put_be(struct json_writer *w, uint64_t val, size_t len)
+{
+	char bytes[sizeof(val)];
+
+	for (size_t i = len; i > 0; i--) {
+		bytes[i - 1] = val & 0xFF;
+		val >>= 8;
+	}
+
+	put(w, bytes, len);
+}
+
+static void cbor_head(struct json_writer *w, uint8_t major, uint64_t val)
+{
+	major <<= 5;
+
+	if (val < 24) {
+		put_char(w, major | val);
+	} else if (val <= UINT8_MAX) {
+		put_char(w, major | 24);
+		put_be(w, val, 1);
+	} else if (val <= UINT16_MAX) {
+		put_char(w, major | 25);
+		put_be(w, val, 2);
+	} else if (val <= UINT32_MAX) {
+		put_char(w, major | 26);
+		put_be(w, val, 4);
+	} else {
+		put_char(w, major | 27);
+		put_be(w, val, 8);
+	}
+}
+
+static void cbor_text(struct json_writer *w, const char *str)
+{
+	size_t len = strlen(str);
+
+	cbor_head(w, CBOR_MAJOR_TEXT, len);
+	put(w, str, len);
+}
+
+static void cbor_num(struct json_writer *w, double val)
+{
+	float val32 = (float)val;
+	uint32_t bits32;
+	uint64_t bits64;
+	int64_t valint;
+
+	if ((val == floor(val)) && (val >= -9223372036854775808.0) &&
+	    (val < 9223372036854775808.0)) {
+		valint = (int64_t)val;
+		if (valint >= 0) {
+			cbor_head(w, CBOR_MAJOR_UINT, valint);
+		} else {
+			cbor_head(w, CBOR_MAJOR_NINT, -1 - valint);
+		}
+	} else if ((double)val32 == val) {
+		memcpy(&bits32, &val32, sizeof(bits32));
+		put_char(w, CBOR_FLOAT32);
+		put_be(w, bits32, sizeof(bits32));
+	} else {
+		memcpy(&bits64, &val, sizeof(bits64));
+		put_char(w, CBOR_FLOAT64);
+		put_be(w, bits64, sizeof(bits64));
+	}
+}
+
+static void put_string(struct json_writer *w, const char *str)
+{
+	static const char hex[] = "0123456789abcdef";
+	const char *start = str;
+	char esc[6] = { '\\', 'u', '0', '0' };
+	unsigned char c;
+
+	put_char(w, '"');
+
+	for (; *str; str++) {
+		c = *str;
+		if ((c >= 32) && (c != '"') && (c != '\\')) {
+			continue;
+		}
+
+		/* Copy the run of characters that need no escaping */
+		put(w, start, str - start);
+		start = str + 1;
+
+		switch (c) {
+		case '"':
+			put(w, "\\\"", 2);
+			break;
+		case '\\':
+			put(w, "\\\\", 2);
+			break;
+		case '\b':
+			put(w, "\\b", 2);
+			break;
+		case '\f':
+			put(w, "\\f", 2);
+			break;
+		case '\n':
+			put(w, "\\n", 2);
+			break;
+		case '\r':
+			put(w, "\\r", 2);
+			break;
+		case '\t':
+			put(w, "\\t", 2);
+			break;
+		default:
+			esc[4] = hex[c >> 4];
+			esc[5] = hex[c & 0xF];
+			put(w, esc, sizeof(esc));
+			break;
+		}
+	}
+
+	put(w, start, str - start);
+	put_char(w, '"');
+}
+
+static void put_null(struct json_writer *w)
+{
+	if (is_cbor(w)) {
+		put_char(w, CBOR_NULL);
+	} else {
+		put(w, "null", 4);
+	}
+}
+
+/* Write the separator and the member name of a new value. */
+static bool begin_value(struct json_writer *w, const char *key)
+{
+	uint32_t bit;
+
+	if (w->err) {
+		return false;
+	}
+
+	if (w->depth == 0) {
+		/* Only one root value */
+		if (key || w->len) {
+			w->err = -EINVAL;
+			return false;
+		}
+		return true;
+	}
+
+	bit = BIT(w->depth - 1);
+
+	/* Members of objects have names, array elements do not */
+	if (!key != !!(w->is_array & bit)) {
+		w->err = -EINVAL;
+		return false;
+	}
+
+	if (is_cjson(w)) {
+		return true;
+	}
+
+	if (is_cbor(w)) {
+		if (key) {
+			cbor_text(w, key);
+		}
+		return true;
+	}
+
+	if (w->has_members & bit) {
+		put_char(w, ',');
+	}
+	w->has_members |= bit;
+
+	if (key) {
+		put_string(w, key);
+		put_char(w, ':');
+	}
+
+	return true;
+}
+
+static void container_start(struct json_writer *w, const char *key, bool array)
+{
+	uint32_t bit;
+
+	if (!begin_value(w, key)) {
+		return;
+	}
+
+	if (w->depth == JSON_WRITER_MAX_DEPTH) {
+		w->err = -E2BIG;
+		return;
+	}
+
+	if (is_cjson(w) && !cjson_container_start(w, key, array)) {
+		return;
+	}
+
+	bit = BIT(w->depth);
+	w->depth++;
+	w->has_members &= ~bit;
+	if (array) {
+		w->is_array |= bit;
+	} else {
+		w->is_array &= ~bit;
+	}
+
+	if (is_cbor(w)) {
+		cbor_head(w, array ? CBOR_MAJOR_ARRAY : CBOR_MAJOR_MAP, CBOR_INDEFINITE);
+	} else if (!is_cjson(w)) {
+		put_char(w, array ? '[' : '{');
+	}
+}
+
+static void container_end(struct json_writer *w, bool array)
+{
+	if (w->err) {
+		return;
+	}
+
+	if ((w->depth == 0) || (!!(w->is_array & BIT(w->depth - 1)) != array)) {
+		w->err = -EINVAL;
+		return;
+	}
+
+	w->depth--;
+
+	if (is_cbor(w)) {
+		put_char(w, CBOR_BREAK);
+	} else if (!is_cjson(w)) {
+		put_char(w, array ? ']' : '}');
+	}
+}
+
+void json_writer_init(struct json_writer *w, char *buf, size_t size)
+{
+	json_writer_init_format(w, JSON_WRITER_FORMAT_JSON, buf, size);
+}
+
+void json_writer_init_format(struct json_writer *w, enum json_writer_format format,
+			     char *buf, size_t size)
+{
+	memset(w, 0, sizeof(*w));
+	w->format = format;
+	w->buf = buf;
+	w->size = buf ? size : 0;
+}
+
+void json_writer_init_cjson(struct json_writer *w, cJSON *obj)
+{
+	json_writer_init_format(w, JSON_WRITER_FORMAT_CJSON, NULL, 0);
+	w->tree[0] = obj;
+}
+
+void json_writer_obj_start(struct json_writer *w, const char *key)
+{
+	container_start(w, key, false);
+}
+
+void json_writer_obj_end(struct json_writer *w)
+{
+	container_end(w, false);
+}
+
+void json_writer_arr_start(struct json_writer *w, const char *key)
+{
+	container_start(w, key, true);
+}
+
+void json_writer_arr_end(struct json_writer *w)
+{
+	container_end(w, true);
+}
+
+void json_writer_str(struct json_writer *w, const char *key, const char *val)
+{
+	if (!val) {
+		if (!w->err) {
+			w->err = -EINVAL;
+		}
+		return;
+	}
+
+	if (!begin_value(w, key)) {
+		return;
+	}
+
+	if (is_cjson(w)) {
+		cjson_add(w, key, cJSON_CreateString(val));
+	} else if (is_cbor(w)) {
+		cbor_text(w, val);
+	} else {
+		put_string(w, val);
+	}
+}
+
+void json_writer_num(struct json_writer *w, const char *key, double val)
+{
+	/* Large enough for any double in %1.17g, as in cJSON */
+	char num[26];
+	int valueint;
+	int len;
+
+	if (!begin_value(w, key)) {
+		return;
+	}
+
+	if (is_cjson(w)) {
+		cjson_add(w, key, cJSON_CreateNumber(val));
+		return;
+	}
+
+	if (isnan(val) || isinf(val)) {
+		put_null(w);
+		return;
+	}
+
+	if (is_cbor(w)) {
+		cbor_num(w, val);
+		return;
+	}
+
+	/* cJSON prints numbers that equal their saturated integer value as integers */
+	if (val >= INT_MAX) {
+		valueint = INT_MAX;
+	} else if (val <= (double)INT_MIN) {
+		valueint = INT_MIN;
+	} else {
+		valueint = (int)val;
+	}
+
+	if (val == (double)valueint) {
+		len = snprintf(num, sizeof(num), "%d", valueint);
+	} else {
+		/* Use 15 digits if they are enough to represent the value exactly */
+		len = snprintf(num, sizeof(num), "%1.15g", val);
+		if (strtod(num, NULL) != val) {
+			len = snprintf(num, sizeof(num), "%1.17g", val);
+		}
+	}
+
+	if ((len < 0) || (len >= (int)sizeof(num))) {
+		w->err = -EINVAL;
+		return;
+	}
+
+	put(w, num, len);
+}
+
+void json_writer_bool(struct json_writer *w, const char *key, bool val)
+{
+	if (!begin_value(w, key)) {
+		return;
+	}
+
+	if (is_cjson(w)) {
+		cjson_add(w, key, cJSON_CreateBool(val));
+	} else if (is_cbor(w)) {
+		put_char(w, val ? CBOR_TRUE : CBOR_FALSE);
+	} else if (val) {
+		put(w, "true", 4);
+	} else {
+		put(w, "false", 5);
+	}
+}
+
+void json_writer_null(struct json_writer *w, const char *key)
+{
+	if (!begin_value(w, key)) {
+		return;
+	}
+
+	if (is_cjson(w)) {
+		cjson_add(w, key, cJSON_CreateNull());
+	} else {
+		put_null(w);
+	}
+}
+
+void json_writer_cjson(struct json_writer *w, const char *key, const cJSON *item)
+{
+	const cJSON *child;
+
+	if (w->err) {
+		return;
+	}
+
+	if (!item) {
+		w->err = -EINVAL;
+		return;
+	}
+
+	switch (item->type & 0xFF) {
+	case cJSON_False:
+		json_writer_bool(w, key, false);
+		break;
+	case cJSON_True:
+		json_writer_bool(w, key, true);
+		break;
+	case cJSON_NULL:
+		json_writer_null(w, key);
+		break;
+	case cJSON_Number:
+		json_writer_num(w, key, item->valuedouble);
+		break;
+	case cJSON_String:
+		json_writer_str(w, key, item->valuestring);
+		break;
+	case cJSON_Raw:
+		/* Raw JSON cannot be converted without parsing it */
+		if (is_cbor(w) || !item->valuestring) {
+			w->err = -ENOTSUP;
+		} else if (!begin_value(w, key)) {
+			break;
+		} else if (is_cjson(w)) {
+			cjson_add(w, key, cJSON_CreateRaw(item->valuestring));
+		} else {
+			put(w, item->valuestring, strlen(item->valuestring));
+		}
+		break;
+	case cJSON_Array:
+		json_writer_arr_start(w, key);
+		cJSON_ArrayForEach(child, item) {
+			json_writer_cjson(w, NULL, child);
+		}
+		json_writer_arr_end(w);
+		break;
+	case cJSON_Object:
+		json_writer_obj_start(w, key);
+		cJSON_ArrayForEach(child, item) {
+			json_writer_cjson(w, child->string, child);
+		}
+		json_writer_obj_end(w);
+		break;
+	default:
+		w->err = -EINVAL;
+		break;
+	}
+}
+
+int json_writer_finish(struct json_writer *w)
+{
+	if (w->err) {
+		return w->err;
+	}
+
+	if ((w->depth != 0) || (w->len == 0)) {
+		return -EINVAL;
+	}
+
+	if (is_cjson(w)) {
+		return 0;
+	}
+
+	/* The length is returned as int. */
+	if (w->len > INT_MAX) {
+		return -ENOMEM;
+	}
+
+	if (!w->buf) {
+		return (int)w->len;
+	}
+
+	if (is_cbor(w)) {
+		return (w->len > w->size) ? -ENOMEM : (int)w->len;
+	}
+
+	if (w->len >= w->size) {
+		return -ENOMEM;
+	}
+
+	w->buf[w->len] = '\0';
+
+	return (int)w->len;
+}
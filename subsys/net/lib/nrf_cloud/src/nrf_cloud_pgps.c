@@ -9,6 +9,7 @@
 #include <zephyr/device.h>
 #include <zephyr/storage/stream_flash.h>
 #include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
 
 #include <cJSON.h>
 #include <modem/modem_info.h>
@@ -103,6 +104,11 @@ static uint8_t prediction_buf[PGPS_PREDICTION_STORAGE_SIZE];
 static atomic_t accept_packets;
 static atomic_t pgps_need_assistance;
 
+#if defined(CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX)
+/* Blocks whose contents have been checked against the prediction index since boot */
+static bool block_verified[NUM_BLOCKS];
+#endif
+
 static int validate_stored_predictions(uint16_t *bad_day, uint32_t *bad_time);
 static void log_pgps_header(const char *msg, const struct nrf_cloud_pgps_header *header);
 static int consume_pgps_header(const char *buf, size_t buf_len);
@@ -312,6 +318,9 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 	}
 
 	npgps_reset_block_pool();
+#if defined(CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX)
+	memset(block_verified, 0, sizeof(block_verified));
+#endif
 
 	/* build catalog of predictions by block */
 	for (i = 0; i < count; i++) {
@@ -363,7 +372,26 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 		LOG_DBG("Prediction num:%u, loc:%p, blk:%d", pnum, pred, i);
 		__ASSERT(i != -1, "unexpected pointer value %p", pred);
 		npgps_mark_block_used(i, true);
+
+#if defined(CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX)
+		struct npgps_block_info info = {
+			.gps_sec = (uint32_t)gps_sec,
+			.crc = crc32_ieee((const uint8_t *)pred, sizeof(*pred))
+		};
+
+		(void)npgps_save_block_info(i, &info);
+		block_verified[i] = true;
+#endif
+	}
+
+#if defined(CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX)
+	/* remove index entries of blocks not holding a valid prediction */
+	for (int blk = 0; blk < NUM_BLOCKS; blk++) {
+		if (!block_verified[blk]) {
+			(void)npgps_clear_block_info(blk);
+		}
 	}
+#endif
 
 	/* find first free block in flash, if any, after chronologicaly
 	 * last good prediction, if any; this is where any new downloads
@@ -383,6 +411,77 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 	return pnum;
 }
 
+#if defined(CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX)
+/* Build the catalog of predictions from the prediction index, without
+ * reading the predictions from flash. Each prediction is checked against
+ * its index entry by verify_prediction() when it is first used.
+ * Returns the number of predictions available in time order, or
+ * -ENODATA if the index cannot be used and all stored predictions need
+ * to be validated instead.
+ */
+static int load_prediction_index(void)
+{
+	int blocks[NUM_PREDICTIONS];
+	int count;
+	int pnum;
+
+	discard_prediction_buffer();
+	for (pnum = 0; pnum < index.header.prediction_count; pnum++) {
+		index.predictions[pnum] = NULL;
+	}
+
+	npgps_reset_block_pool();
+	memset(block_verified, 0, sizeof(block_verified));
+
+	count = npgps_find_indexed_blocks(index.start_sec, index.period_sec,
+					  index.header.prediction_count, blocks);
+	if (count < 0) {
+		return count;
+	}
+
+	for (pnum = 0; pnum < count; pnum++) {
+		index.predictions[pnum] = npgps_block_to_pointer(blocks[pnum]);
+		npgps_mark_block_used(blocks[pnum], true);
+	}
+
+	/* new downloads begin after the chronologically last prediction */
+	(void)npgps_find_first_free(blocks[count - 1]);
+	npgps_print_blocks();
+
+	return count;
+}
+
+/* Check a prediction against its index entry the first time it is used. */
+static int verify_prediction(int pnum, const struct nrf_cloud_pgps_prediction *p)
+{
+	int block = get_prediction_block(pnum);
+	int err;
+
+	if ((block == NO_BLOCK) || block_verified[block]) {
+		return 0;
+	}
+
+	err = npgps_check_block_info(block, p);
+	if (err) {
+		LOG_ERR("Prediction num:%u does not match index", pnum);
+		return err;
+	}
+
+	block_verified[block] = true;
+	return 0;
+}
+#else
+static int load_prediction_index(void)
+{
+	return -ENODATA;
+}
+
+static int verify_prediction(int pnum, const struct nrf_cloud_pgps_prediction *p)
+{
+	return 0;
+}
+#endif /* CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX */
+
 static void get_prediction_day_time(int pnum, int64_t *gps_sec, uint16_t *gps_day,
 				    uint32_t *gps_time_of_day)
 {
@@ -649,6 +748,11 @@ int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction
 	index.cur_pnum = pnum;
 	*prediction = get_prediction(pnum);
 	if (*prediction) {
+		err = verify_prediction(pnum, *prediction);
+		if (err) {
+			*prediction = NULL;
+			return err;
+		}
 		err = validate_prediction(*prediction,
 					  cur_gps_day, cur_gps_time_of_day,
 					  period_min, false, margin);
@@ -1206,7 +1310,8 @@ static int open_storage(uint32_t offset, bool preserve)
 	return err;
 }
 
-static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last)
+static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last,
+			    uint32_t *crc)
 {
 	static bool first = true;
 	static uint8_t pad[PGPS_PREDICTION_PAD];
@@ -1241,6 +1346,13 @@ static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last
 	if (err) {
 		LOG_ERR("Error writing sentinel:%d", err);
 	}
+	if (crc) {
+		/* checksum of the prediction as stored in flash */
+		*crc = crc32_ieee_update(0, p - schema_offset, schema_offset);
+		*crc = crc32_ieee_update(*crc, &schema, sizeof(schema));
+		*crc = crc32_ieee_update(*crc, p, len);
+		*crc = crc32_ieee_update(*crc, (uint8_t *)&sentinel, sizeof(sentinel));
+	}
 	err = stream_flash_buffered_write(&stream, pad, PGPS_PREDICTION_PAD, last);
 	if (err) {
 		LOG_ERR("Error writing sentinel:%d", err);
@@ -1490,8 +1602,22 @@ static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len)
 
 			index.loading_count++;
 			finished = (index.loading_count == index.expected_count);
+#if defined(CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX)
+			struct npgps_block_info info = {
+				.gps_sec = (uint32_t)gps_sec
+			};
+
+			store_prediction(prediction_ptr, buf_len, (uint32_t)gps_sec,
+					 finished || (index.storage_extent == 1), &info.crc);
+			err = npgps_save_block_info(index.store_block, &info);
+			if (err) {
+				LOG_WRN("Error saving index of prediction num:%u: %d", pnum, err);
+			}
+			block_verified[index.store_block] = true;
+#else
 			store_prediction(prediction_ptr, buf_len, (uint32_t)gps_sec,
-					 finished || (index.storage_extent == 1));
+					 finished || (index.storage_extent == 1), NULL);
+#endif
 			index.predictions[pnum] = npgps_block_to_pointer(index.store_block);
 
 			if (pgps_need_assistance &&
@@ -1740,7 +1866,13 @@ int nrf_cloud_pgps_init(struct nrf_cloud_pgps_init_param *param)
 		 */
 		LOG_INF("Checking stored P-GPS data; count:%u, period_min:%u",
 			count, period_min);
-		num_valid = validate_stored_predictions(&gps_day, &gps_time_of_day);
+		err = load_prediction_index();
+		if (err >= 0) {
+			LOG_INF("Found %d predictions in index", err);
+			num_valid = err;
+		} else {
+			num_valid = validate_stored_predictions(&gps_day, &gps_time_of_day);
+		}
 	}
 
 	struct nrf_cloud_pgps_prediction *found_prediction = NULL;
@@ -1750,6 +1882,13 @@ int nrf_cloud_pgps_init(struct nrf_cloud_pgps_init_param *param)
 	if (num_valid) {
 		LOG_INF("Checking if P-GPS data is expired...");
 		err = nrf_cloud_pgps_find_prediction(&found_prediction);
+		if (err == -EBADMSG) {
+			LOG_WRN("Prediction index is out of date; checking stored P-GPS data");
+			num_valid = validate_stored_predictions(&gps_day, &gps_time_of_day);
+			if (num_valid) {
+				err = nrf_cloud_pgps_find_prediction(&found_prediction);
+			}
+		}
 		if (err == -ETIMEDOUT) {
 			LOG_WRN("Predictions expired. Requesting predictions...");
 			num_valid = 0;
@@ -5,6 +5,7 @@
  */
 
 #include <zephyr/kernel.h>
+#include <zephyr/sys/crc.h>
 #include <stdlib.h>
 
 #include <net/nrf_cloud_pgps.h>
@@ -28,6 +29,9 @@ LOG_MODULE_DECLARE(nrf_cloud_pgps, CONFIG_NRF_CLOUD_GPS_LOG_LEVEL);
 #define SETTINGS_FULL_LOCATION			SETTINGS_NAME "/" SETTINGS_KEY_LOCATION
 #define SETTINGS_KEY_LEAP_SEC			"g2u_leap_sec"
 #define SETTINGS_FULL_LEAP_SEC			SETTINGS_NAME "/" SETTINGS_KEY_LEAP_SEC
+#define SETTINGS_KEY_BLOCK_INFO			"blk"
+#define SETTINGS_FULL_BLOCK_INFO		SETTINGS_NAME "/" SETTINGS_KEY_BLOCK_INFO
+#define SETTINGS_BLOCK_INFO_NAME_SIZE		(sizeof(SETTINGS_FULL_BLOCK_INFO) + 4)
 
 struct block_pool {
 	int first_free;
@@ -43,6 +47,9 @@ static int num_blocks;
 static int gps_leap_seconds = GPS_TO_UTC_LEAP_SECONDS;
 static struct gps_location saved_location;
 static struct nrf_cloud_pgps_header saved_header;
+#if defined(CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX)
+static struct npgps_block_info saved_block_info[NUM_BLOCKS];
+#endif
 
 static K_SEM_DEFINE(pgps_active, 1, 1);
 static struct download_client dlc;
@@ -95,6 +102,22 @@ static int settings_set(const char *key, size_t len_rd,
 			return 0;
 		}
 	}
+#if defined(CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX)
+	const char *next;
+
+	if (settings_name_steq(key, SETTINGS_KEY_BLOCK_INFO, &next) && next &&
+	    (len_rd == sizeof(struct npgps_block_info))) {
+		char *end;
+		long block = strtol(next, &end, 10);
+
+		if ((end != next) && (*end == '\0') && (block >= 0) && (block < NUM_BLOCKS) &&
+		    (read_cb(cb_arg, (void *)&saved_block_info[block], len_rd) == len_rd)) {
+			LOG_DBG("Read block:%ld info: gps sec:%u, crc:0x%08X", block,
+				saved_block_info[block].gps_sec, saved_block_info[block].crc);
+			return 0;
+		}
+	}
+#endif
 	return -ENOTSUP;
 }
 
@@ -132,6 +155,99 @@ const struct nrf_cloud_pgps_header *npgps_get_saved_header(void)
 	return &saved_header;
 }
 
+#if defined(CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX)
+int npgps_save_block_info(int block, const struct npgps_block_info *info)
+{
+	char name[SETTINGS_BLOCK_INFO_NAME_SIZE];
+
+	__ASSERT((block >= 0) && (block < NUM_BLOCKS), "block %d out of range", block);
+
+	if (!memcmp(&saved_block_info[block], info, sizeof(*info))) {
+		return 0;
+	}
+
+	LOG_DBG("Saving block:%d info: gps sec:%u, crc:0x%08X", block, info->gps_sec, info->crc);
+	saved_block_info[block] = *info;
+	snprintk(name, sizeof(name), SETTINGS_FULL_BLOCK_INFO "/%d", block);
+	return settings_save_one(name, info, sizeof(*info));
+}
+
+const struct npgps_block_info *npgps_get_saved_block_info(int block)
+{
+	__ASSERT((block >= 0) && (block < NUM_BLOCKS), "block %d out of range", block);
+
+	return &saved_block_info[block];
+}
+
+int npgps_clear_block_info(int block)
+{
+	char name[SETTINGS_BLOCK_INFO_NAME_SIZE];
+
+	__ASSERT((block >= 0) && (block < NUM_BLOCKS), "block %d out of range", block);
+
+	if (!saved_block_info[block].gps_sec) {
+		return 0;
+	}
+
+	LOG_DBG("Clearing block:%d info", block);
+	memset(&saved_block_info[block], 0, sizeof(saved_block_info[block]));
+	snprintk(name, sizeof(name), SETTINGS_FULL_BLOCK_INFO "/%d", block);
+	return settings_delete(name);
+}
+
+int npgps_find_indexed_blocks(int64_t start_sec, uint32_t period_sec, int count, int *blocks)
+{
+	int64_t end_sec = start_sec + (int64_t)count * period_sec;
+	int64_t pred_sec;
+	int pnum;
+	int i;
+
+	__ASSERT((count > 0) && (count <= NUM_PREDICTIONS), "count %d out of range", count);
+
+	for (pnum = 0; pnum < count; pnum++) {
+		blocks[pnum] = NO_BLOCK;
+	}
+
+	for (i = 0; i < NUM_BLOCKS; i++) {
+		pred_sec = saved_block_info[i].gps_sec;
+		if ((pred_sec == 0) || (pred_sec < start_sec) || (pred_sec >= end_sec) ||
+		    ((pred_sec - start_sec) % period_sec)) {
+			/* no entry, or entry of a prediction from an older set */
+			continue;
+		}
+
+		pnum = (pred_sec - start_sec) / period_sec;
+		if (blocks[pnum] != NO_BLOCK) {
+			LOG_WRN("Prediction num:%d indexed more than once", pnum);
+			return -ENODATA;
+		}
+		blocks[pnum] = i;
+	}
+
+	for (pnum = 0; pnum < count; pnum++) {
+		if (blocks[pnum] == NO_BLOCK) {
+			LOG_WRN("Prediction num:%d missing", pnum);
+			break;
+		}
+	}
+
+	return pnum ? pnum : -ENODATA;
+}
+
+int npgps_check_block_info(int block, const struct nrf_cloud_pgps_prediction *p)
+{
+	const struct npgps_block_info *info = npgps_get_saved_block_info(block);
+	uint32_t crc = crc32_ieee((const uint8_t *)p, sizeof(*p));
+
+	if ((info->crc != crc) || (info->gps_sec != p->sentinel)) {
+		LOG_ERR("Prediction in blk:%d does not match index; "
+			"crc:0x%08X, expected:0x%08X", block, crc, info->crc);
+		return -EBADMSG;
+	}
+	return 0;
+}
+#endif /* CONFIG_NRF_CLOUD_PGPS_PREDICTION_INDEX */
+
 /* @TODO: consider rate-limiting these updates to reduce Flash wear */
 static int save_location(void)
 {
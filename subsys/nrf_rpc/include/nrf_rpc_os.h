@@ -89,6 +89,40 @@ static inline void nrf_rpc_os_tls_set(void *data)
 uint32_t nrf_rpc_os_ctx_pool_reserve(void);
 void nrf_rpc_os_ctx_pool_release(uint32_t number);
 
+/** @brief Thread pool and command context statistics. */
+struct nrf_rpc_os_stats {
+	/** Number of packets passed to the thread pool. */
+	uint32_t pool_msg_cnt;
+
+	/** Number of times the thread pool queue was full. */
+	uint32_t pool_queue_full_cnt;
+
+	/** Total time the packets waited for a thread in microseconds. */
+	uint64_t pool_wait_total_us;
+
+	/** Longest time a packet waited for a thread in microseconds. */
+	uint32_t pool_wait_max_us;
+
+	/** Number of times a command context was not available immediately. */
+	uint32_t ctx_exhausted_cnt;
+
+	/** Longest time spent waiting for a command context in microseconds. */
+	uint32_t ctx_wait_max_us;
+
+	/** Maximum number of command contexts reserved at the same time. */
+	uint32_t ctx_used_max;
+};
+
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+/** @brief Get thread pool and command context statistics.
+ *
+ * Requires @kconfig{CONFIG_NRF_RPC_OS_STATS}.
+ *
+ * @param[out] stats Structure to be filled with the statistics.
+ */
+void nrf_rpc_os_stats_get(struct nrf_rpc_os_stats *stats);
+#endif /* CONFIG_NRF_RPC_OS_STATS */
+
 #ifdef __cplusplus
 }
 #endif
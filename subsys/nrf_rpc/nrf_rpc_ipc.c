@@ -11,6 +11,7 @@
 
 #include <openamp/rpmsg.h>
 #include <zephyr/ipc/ipc_service.h>
+#include <zephyr/sys/slist.h>
 
 #include <zephyr/logging/log.h>
 
@@ -30,6 +31,77 @@ do {									       \
 	}								       \
 } while (0)
 
+/* Kind of memory the Tx buffer comes from. */
+enum tx_buf_type {
+	TX_BUF_IPC,
+	TX_BUF_POOL,
+	TX_BUF_HEAP,
+};
+
+#if defined(CONFIG_NRF_RPC_IPC_SERVICE_TX_POOL)
+K_MEM_SLAB_DEFINE(nrf_rpc_ipc_tx_pool, CONFIG_NRF_RPC_IPC_SERVICE_TX_POOL_BLOCK_SIZE,
+		  CONFIG_NRF_RPC_IPC_SERVICE_TX_POOL_BLOCK_COUNT, sizeof(uint32_t));
+#endif
+
+#if defined(CONFIG_NRF_RPC_IPC_SERVICE_NOCOPY)
+/* In the no-copy mode, packets that fit neither an IPC Service buffer nor a
+ * pool block are allocated from the heap. IPC Service buffers cannot be told
+ * apart by address, so these heap buffers are kept in a list.
+ */
+struct tx_heap_buf {
+	sys_snode_t node;
+} __aligned(sizeof(uint64_t));
+
+static sys_slist_t tx_heap_bufs = SYS_SLIST_STATIC_INIT(&tx_heap_bufs);
+static struct k_spinlock tx_heap_bufs_lock;
+
+static void *tx_buf_heap_alloc(size_t size)
+{
+	struct tx_heap_buf *hdr = k_malloc(sizeof(*hdr) + size);
+	k_spinlock_key_t key;
+
+	if (!hdr) {
+		return NULL;
+	}
+
+	key = k_spin_lock(&tx_heap_bufs_lock);
+	sys_slist_append(&tx_heap_bufs, &hdr->node);
+	k_spin_unlock(&tx_heap_bufs_lock, key);
+
+	return hdr + 1;
+}
+
+static bool tx_buf_heap_owns(const void *buf)
+{
+	struct tx_heap_buf *hdr;
+	k_spinlock_key_t key;
+	bool found = false;
+
+	key = k_spin_lock(&tx_heap_bufs_lock);
+	SYS_SLIST_FOR_EACH_CONTAINER(&tx_heap_bufs, hdr, node) {
+		if ((const void *)(hdr + 1) == buf) {
+			found = true;
+			break;
+		}
+	}
+	k_spin_unlock(&tx_heap_bufs_lock, key);
+
+	return found;
+}
+
+static void tx_buf_heap_free(void *buf)
+{
+	struct tx_heap_buf *hdr = (struct tx_heap_buf *)buf - 1;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&tx_heap_bufs_lock);
+	sys_slist_find_and_remove(&tx_heap_bufs, &hdr->node);
+	k_spin_unlock(&tx_heap_bufs_lock, key);
+
+	k_free(hdr);
+}
+#endif /* CONFIG_NRF_RPC_IPC_SERVICE_NOCOPY */
+
 /* Translates error code from the lower layer to nRF RPC error code. */
 static int translate_error(int ll_err)
 {
@@ -145,6 +217,83 @@ static int init(const struct nrf_rpc_tr *transport, nrf_rpc_tr_receive_handler_t
 	return 0;
 }
 
+static enum tx_buf_type tx_buf_type_get(const void *buf)
+{
+#if defined(CONFIG_NRF_RPC_IPC_SERVICE_TX_POOL)
+	const char *pool_start = nrf_rpc_ipc_tx_pool.buffer;
+	const char *pool_end = pool_start +
+			       nrf_rpc_ipc_tx_pool.num_blocks * nrf_rpc_ipc_tx_pool.block_size;
+
+	if (((const char *)buf >= pool_start) && ((const char *)buf < pool_end)) {
+		return TX_BUF_POOL;
+	}
+#endif
+
+#if defined(CONFIG_NRF_RPC_IPC_SERVICE_NOCOPY)
+	return tx_buf_heap_owns(buf) ? TX_BUF_HEAP : TX_BUF_IPC;
+#else
+	return TX_BUF_HEAP;
+#endif
+}
+
+static void *tx_buf_local_alloc(size_t size)
+{
+#if defined(CONFIG_NRF_RPC_IPC_SERVICE_TX_POOL)
+	void *data;
+
+	if (size <= nrf_rpc_ipc_tx_pool.block_size) {
+		/* Never wait for a pool block, the heap is used when the pool is exhausted. */
+		if (!k_mem_slab_alloc(&nrf_rpc_ipc_tx_pool, &data, K_NO_WAIT)) {
+			return data;
+		}
+	}
+#endif
+
+#if defined(CONFIG_NRF_RPC_IPC_SERVICE_NOCOPY)
+	/* Too big for the pool, send it with a copy as without the no-copy mode */
+	return tx_buf_heap_alloc(size);
+#else
+	return k_malloc(size);
+#endif
+}
+
+static void tx_buf_local_free(enum tx_buf_type type, void *buf)
+{
+#if defined(CONFIG_NRF_RPC_IPC_SERVICE_TX_POOL)
+	if (type == TX_BUF_POOL) {
+		k_mem_slab_free(&nrf_rpc_ipc_tx_pool, &buf);
+		return;
+	}
+#endif
+
+#if defined(CONFIG_NRF_RPC_IPC_SERVICE_NOCOPY)
+	tx_buf_heap_free(buf);
+#else
+	k_free(buf);
+#endif
+}
+
+static void *tx_buf_ipc_alloc(struct nrf_rpc_ipc *ipc_config, size_t size)
+{
+	void *data;
+	uint32_t ipc_size = size;
+	int err;
+
+	err = ipc_service_get_tx_buffer(&ipc_config->endpoint.ept, &data, &ipc_size, K_NO_WAIT);
+	if (!err) {
+		return data;
+	}
+
+	if ((err == -EIO) || (err == -ENOTSUP)) {
+		LOG_INF("IPC Service backend does not support no-copy Tx buffers");
+		ipc_config->nocopy_unavailable = true;
+	} else {
+		LOG_DBG("No IPC Service Tx buffer of %zu bytes (err: %d)", size, err);
+	}
+
+	return NULL;
+}
+
 int send(const struct nrf_rpc_tr *transport, const uint8_t *data, size_t length)
 {
 	int err;
@@ -159,16 +308,28 @@ int send(const struct nrf_rpc_tr *transport, const uint8_t *data, size_t length)
 	LOG_DBG("Sending %u bytes", length);
 	DUMP_LIMITED_DBG(data, length, "Data: ");
 
-	err = ipc_service_send(&endpoint->ept, data, length);
-	if (err < 0) {
-		LOG_ERR("ipc_service_send returned err: %d", err);
-	} else if (err > 0) {
+	enum tx_buf_type type = tx_buf_type_get(data);
+
+	if (type == TX_BUF_IPC) {
+		err = ipc_service_send_nocopy(&endpoint->ept, data, length);
+		if (err < 0) {
+			LOG_ERR("ipc_service_send_nocopy returned err: %d", err);
+			ipc_service_drop_tx_buffer(&endpoint->ept, data);
+		}
+	} else {
+		err = ipc_service_send(&endpoint->ept, data, length);
+		if (err < 0) {
+			LOG_ERR("ipc_service_send returned err: %d", err);
+		}
+
+		tx_buf_local_free(type, (void *)data);
+	}
+
+	if (err > 0) {
 		LOG_DBG("Sent %u bytes", err);
 		err = 0;
 	}
 
-	k_free((void *)data);
-
 	return translate_error(err);
 }
 
@@ -182,7 +343,14 @@ void *tx_buf_alloc(const struct nrf_rpc_tr *transport, size_t *size)
 		goto error;
 	}
 
-	data = k_malloc(*size);
+	if (IS_ENABLED(CONFIG_NRF_RPC_IPC_SERVICE_NOCOPY) && !ipc_config->nocopy_unavailable) {
+		data = tx_buf_ipc_alloc(ipc_config, *size);
+		if (data) {
+			return data;
+		}
+	}
+
+	data = tx_buf_local_alloc(*size);
 	if (!data) {
 		LOG_ERR("Failed to allocate Tx buffer.");
 		goto error;
@@ -206,7 +374,13 @@ void tx_buf_free(const struct nrf_rpc_tr *transport, void *buf)
 		return;
 	}
 
-	k_free(buf);
+	enum tx_buf_type type = tx_buf_type_get(buf);
+
+	if (type == TX_BUF_IPC) {
+		ipc_service_drop_tx_buffer(&ipc_config->endpoint.ept, buf);
+	} else {
+		tx_buf_local_free(type, buf);
+	}
 }
 
 const struct nrf_rpc_tr_api nrf_rpc_ipc_service_api = {
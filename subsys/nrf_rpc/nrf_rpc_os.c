@@ -7,30 +7,42 @@
 #define NRF_RPC_LOG_MODULE NRF_RPC_OS
 #include <nrf_rpc_log.h>
 
+#include <zephyr/sys/atomic.h>
+
 #include "nrf_rpc_os.h"
 
 /* Maximum number of remote thread that this implementation allows. */
 #define MAX_REMOTE_THREADS 255
 
-/* Initial value contains ones (context free) on the
- * CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE most significant bits.
- */
-#define CONTEXT_MASK_INIT_VALUE						       \
-	(~(((atomic_val_t)1 << (8 * sizeof(atomic_val_t) -		       \
-				CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE)) - 1))
+/* Number of atomic words in the command context bitmap. */
+#define CONTEXT_MASK_WORDS ATOMIC_BITMAP_SIZE(CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE)
+
+/* Number of bits in a single word of the command context bitmap. */
+#define CONTEXT_MASK_WORD_BITS (8 * sizeof(atomic_val_t))
 
 struct pool_start_msg {
 	const uint8_t *data;
 	size_t len;
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+	uint32_t timestamp;
+#endif
 };
 
 static nrf_rpc_os_work_t thread_pool_callback;
 
-static struct pool_start_msg pool_start_msg_buf[2];
+static struct pool_start_msg pool_start_msg_buf[CONFIG_NRF_RPC_THREAD_POOL_QUEUE_SIZE];
 static struct k_msgq pool_start_msg;
 
 static struct k_sem context_reserved;
-static atomic_t context_mask;
+
+/* Bits set for the free contexts. */
+static atomic_t context_mask[CONTEXT_MASK_WORDS];
+
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+static struct nrf_rpc_os_stats stats;
+static struct k_spinlock stats_lock;
+static atomic_t context_used;
+#endif
 
 static K_THREAD_STACK_ARRAY_DEFINE(pool_stacks,
 	CONFIG_NRF_RPC_THREAD_POOL_SIZE,
@@ -40,17 +52,66 @@ static struct k_thread pool_threads[CONFIG_NRF_RPC_THREAD_POOL_SIZE];
 
 BUILD_ASSERT(CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE > 0,
 	     "CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE must be greaten than zero");
-BUILD_ASSERT(CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE <= 8 * sizeof(atomic_val_t),
+BUILD_ASSERT(CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE < MAX_REMOTE_THREADS,
 	     "CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE too big");
 BUILD_ASSERT(sizeof(uint32_t) == sizeof(atomic_val_t),
 	     "Only atomic_val_t is implemented that is the same as uint32_t");
 
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+static void pool_wait_stats_update(uint32_t timestamp)
+{
+	uint32_t wait_us = k_cyc_to_us_floor32(k_cycle_get_32() - timestamp);
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats.pool_msg_cnt++;
+	stats.pool_wait_total_us += wait_us;
+	stats.pool_wait_max_us = MAX(stats.pool_wait_max_us, wait_us);
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+static void pool_queue_full_stats_update(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats.pool_queue_full_cnt++;
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+static void ctx_stats_update(bool exhausted, uint32_t wait_us)
+{
+	uint32_t used = atomic_inc(&context_used) + 1;
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	if (exhausted) {
+		stats.ctx_exhausted_cnt++;
+		stats.ctx_wait_max_us = MAX(stats.ctx_wait_max_us, wait_us);
+	}
+	stats.ctx_used_max = MAX(stats.ctx_used_max, used);
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+void nrf_rpc_os_stats_get(struct nrf_rpc_os_stats *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	*out = stats;
+
+	k_spin_unlock(&stats_lock, key);
+}
+#endif /* CONFIG_NRF_RPC_OS_STATS */
+
 static void thread_pool_entry(void *p1, void *p2, void *p3)
 {
 	struct pool_start_msg msg;
 
 	do {
 		k_msgq_get(&pool_start_msg, &msg, K_FOREVER);
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+		pool_wait_stats_update(msg.timestamp);
+#endif
 		thread_pool_callback(msg.data, msg.len);
 	} while (1);
 }
@@ -70,7 +131,9 @@ int nrf_rpc_os_init(nrf_rpc_os_work_t callback)
 		return err;
 	}
 
-	atomic_set(&context_mask, CONTEXT_MASK_INIT_VALUE);
+	for (i = 0; i < CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE; i++) {
+		atomic_set_bit(context_mask, i);
+	}
 
 	k_msgq_init(&pool_start_msg, (char *)pool_start_msg_buf,
 		    sizeof(struct pool_start_msg),
@@ -93,6 +156,17 @@ void nrf_rpc_os_thread_pool_send(const uint8_t *data, size_t len)
 
 	msg.data = data;
 	msg.len = len;
+
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+	msg.timestamp = k_cycle_get_32();
+
+	if (k_msgq_put(&pool_start_msg, &msg, K_NO_WAIT) == 0) {
+		return;
+	}
+
+	pool_queue_full_stats_update();
+#endif
+
 	k_msgq_put(&pool_start_msg, &msg, K_FOREVER);
 }
 
@@ -116,27 +190,58 @@ void nrf_rpc_os_msg_get(struct nrf_rpc_os_msg *msg, const uint8_t **data,
 	k_sched_unlock();
 }
 
+static void ctx_pool_wait(void)
+{
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+	uint32_t start;
+
+	if (k_sem_take(&context_reserved, K_NO_WAIT) == 0) {
+		ctx_stats_update(false, 0);
+		return;
+	}
+
+	start = k_cycle_get_32();
+	k_sem_take(&context_reserved, K_FOREVER);
+	ctx_stats_update(true, k_cyc_to_us_floor32(k_cycle_get_32() - start));
+#else
+	k_sem_take(&context_reserved, K_FOREVER);
+#endif
+}
+
 uint32_t nrf_rpc_os_ctx_pool_reserve(void)
 {
-	uint32_t number;
 	atomic_val_t old_mask;
-	atomic_val_t new_mask;
+	uint32_t bit;
 
-	k_sem_take(&context_reserved, K_FOREVER);
+	ctx_pool_wait();
 
-	do {
-		old_mask = atomic_get(&context_mask);
-		number = __CLZ(old_mask);
-		new_mask = old_mask & ~(0x80000000u >> number);
-	} while (!atomic_cas(&context_mask, old_mask, new_mask));
+	/* The semaphore guarantees that at least one bit is set. Take the lowest one. */
+	while (true) {
+		for (size_t i = 0; i < ARRAY_SIZE(context_mask); i++) {
+			old_mask = atomic_get(&context_mask[i]);
+
+			while (old_mask != 0) {
+				bit = find_lsb_set(old_mask) - 1;
+
+				if (atomic_cas(&context_mask[i], old_mask,
+					       old_mask & ~BIT(bit))) {
+					return i * CONTEXT_MASK_WORD_BITS + bit;
+				}
 
-	return number;
+				old_mask = atomic_get(&context_mask[i]);
+			}
+		}
+	}
 }
 
 void nrf_rpc_os_ctx_pool_release(uint32_t number)
 {
 	__ASSERT_NO_MSG(number < CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE);
 
-	atomic_or(&context_mask, 0x80000000u >> number);
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+	atomic_dec(&context_used);
+#endif
+
+	atomic_set_bit(context_mask, number);
 	k_sem_give(&context_reserved);
 }
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <limits.h>
+#include <stddef.h>
+#include <zephyr/ztest.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <modem/at_parser.h>
+#include <modem/at_cmd_parser.h>
+#include <modem/at_params.h>
+
+#define BENCHMARK_ITERATIONS 1000
+
+/* Responses recorded from the modem. */
+static const char cereg[] =
+	"+CEREG: 5,1,\"0A0B\",\"01020304\",7,,,\"00100110\",\"01011111\"\r\nOK\r\n";
+static const char xt3412[] = "%XT3412: 35712000000\r\n";
+static const char ncellmeas[] =
+	"%NCELLMEAS: 0,\"021D140C\",\"24201\",\"0821\",65535,5300,449,50,15,107179,"
+	"5300,194,46,8,0,6200,194,39,-5,0,6200,51,42,-3,0,6200,290,36,-8,0,"
+	"6200,308,31,-12,0,6200,131,30,-15,0,6200,423,28,-16,0,6200,209,27,-18,0,"
+	"6400,194,46,8,0,6400,51,42,-3,0,6400,290,36,-8,0,6400,308,31,-12,0,"
+	"6400,131,30,-15,0,6400,423,28,-16,0,6400,209,27,-18,0,1300,449,50,15,0,"
+	"1300,194,46,8,0,107384\r\n";
+
+#define NCELLMEAS_NCELLS 17
+#define NCELLMEAS_PARAMS (11 + 5 * NCELLMEAS_NCELLS + 1)
+
+static void test_at_parser_init(void)
+{
+	struct at_parser parser;
+
+	zassert_equal(-EINVAL, at_parser_init(NULL, cereg), NULL);
+	zassert_equal(-EINVAL, at_parser_init(&parser, NULL), NULL);
+	zassert_equal(0, at_parser_init(&parser, cereg), NULL);
+}
+
+static void test_at_parser_cereg(void)
+{
+	struct at_parser parser;
+	const char *str;
+	size_t len;
+	int32_t val;
+	size_t count;
+	char buf[16];
+
+	zassert_equal(0, at_parser_init(&parser, cereg), NULL);
+
+	zassert_equal(0, at_parser_string_ptr_get(&parser, 0, &str, &len), NULL);
+	zassert_equal(strlen("+CEREG"), len, NULL);
+	zassert_mem_equal("+CEREG", str, len, NULL);
+
+	zassert_equal(0, at_parser_int_get(&parser, 1, &val), NULL);
+	zassert_equal(5, val, NULL);
+	zassert_equal(0, at_parser_int_get(&parser, 2, &val), NULL);
+	zassert_equal(1, val, NULL);
+
+	/* Quoted strings are returned without the quotes. */
+	len = sizeof(buf);
+	zassert_equal(0, at_parser_string_get(&parser, 3, buf, &len), NULL);
+	zassert_equal(4, len, NULL);
+	zassert_mem_equal("0A0B", buf, len, NULL);
+
+	/* Strings are not numbers. */
+	zassert_equal(-EINVAL, at_parser_int_get(&parser, 4, &val), NULL);
+
+	/* Empty parameters. */
+	zassert_equal(-EINVAL, at_parser_int_get(&parser, 6, &val), NULL);
+	zassert_equal(-EINVAL, at_parser_string_ptr_get(&parser, 7, &str, &len), NULL);
+
+	/* Going back starts over. */
+	zassert_equal(0, at_parser_int_get(&parser, 5, &val), NULL);
+	zassert_equal(7, val, NULL);
+
+	len = 4;
+	zassert_equal(-ENOMEM, at_parser_string_get(&parser, 9, buf, &len), NULL);
+
+	/* Parameters after the end of the line. */
+	zassert_equal(-EINVAL, at_parser_int_get(&parser, 10, &val), NULL);
+
+	zassert_equal(0, at_parser_count_get(&parser, &count), NULL);
+	zassert_equal(10, count, NULL);
+}
+
+static void test_at_parser_next(void)
+{
+	struct at_parser parser;
+	struct at_token token;
+	const enum at_param_type types[] = {
+		AT_PARAM_TYPE_STRING, AT_PARAM_TYPE_NUM_INT, AT_PARAM_TYPE_ARRAY,
+		AT_PARAM_TYPE_EMPTY, AT_PARAM_TYPE_STRING, AT_PARAM_TYPE_EMPTY,
+	};
+
+	zassert_equal(0, at_parser_init(&parser, "%XCBAND: 1, (1,2,3),,unquoted ,\r\n"), NULL);
+
+	for (size_t i = 0; i < ARRAY_SIZE(types); i++) {
+		zassert_equal(0, at_parser_next(&parser, &token), "param %d", i);
+		zassert_equal(types[i], token.type, "param %d", i);
+	}
+
+	zassert_equal(-ENODATA, at_parser_next(&parser, &token), NULL);
+
+	zassert_equal(0, at_parser_token_get(&parser, 2, &token), NULL);
+	zassert_equal(5, token.len, NULL);
+	zassert_mem_equal("1,2,3", token.start, token.len, NULL);
+
+	/* Trailing blanks are not part of the parameter. */
+	zassert_equal(0, at_parser_token_get(&parser, 4, &token), NULL);
+	zassert_mem_equal("unquoted", token.start, token.len, NULL);
+	zassert_equal(strlen("unquoted"), token.len, NULL);
+}
+
+static void test_at_parser_no_prefix(void)
+{
+	struct at_parser parser;
+	const char *str;
+	size_t len;
+	size_t count;
+
+	/* Lines without a prefix are a single parameter. */
+	zassert_equal(0, at_parser_init(&parser, "mfw_nrf9160_1.3.2\r\nOK\r\n"), NULL);
+	zassert_equal(0, at_parser_string_ptr_get(&parser, 0, &str, &len), NULL);
+	zassert_equal(strlen("mfw_nrf9160_1.3.2"), len, NULL);
+	zassert_mem_equal("mfw_nrf9160_1.3.2", str, len, NULL);
+	zassert_equal(0, at_parser_count_get(&parser, &count), NULL);
+	zassert_equal(1, count, NULL);
+}
+
+static void test_at_parser_numbers(void)
+{
+	struct at_parser parser;
+	int16_t s;
+	uint16_t us;
+	int32_t i;
+	uint32_t ui;
+	int64_t i64;
+
+	zassert_equal(0, at_parser_init(&parser, "+TEST: -32769,65536,4294967296,-1,+7"),
+		      NULL);
+
+	zassert_equal(-EINVAL, at_parser_short_get(&parser, 1, &s), NULL);
+	zassert_equal(0, at_parser_int_get(&parser, 1, &i), NULL);
+	zassert_equal(-32769, i, NULL);
+
+	zassert_equal(-EINVAL, at_parser_unsigned_short_get(&parser, 2, &us), NULL);
+	zassert_equal(0, at_parser_unsigned_int_get(&parser, 2, &ui), NULL);
+	zassert_equal(65536, ui, NULL);
+
+	zassert_equal(-EINVAL, at_parser_unsigned_int_get(&parser, 3, &ui), NULL);
+	zassert_equal(0, at_parser_int64_get(&parser, 3, &i64), NULL);
+	zassert_equal(4294967296LL, i64, NULL);
+
+	zassert_equal(-EINVAL, at_parser_unsigned_short_get(&parser, 4, &us), NULL);
+	zassert_equal(0, at_parser_short_get(&parser, 4, &s), NULL);
+	zassert_equal(-1, s, NULL);
+
+	zassert_equal(0, at_parser_short_get(&parser, 5, &s), NULL);
+	zassert_equal(7, s, NULL);
+
+	/* Digits in the prefix are part of the prefix. */
+	zassert_equal(0, at_parser_init(&parser, xt3412), NULL);
+	zassert_equal(0, at_parser_int64_get(&parser, 1, &i64), NULL);
+	zassert_equal(35712000000LL, i64, NULL);
+}
+
+static void test_at_parser_malformed(void)
+{
+	struct at_parser parser;
+	struct at_token token;
+	size_t count;
+
+	zassert_equal(0, at_parser_init(&parser, "+TEST: 1,\"unterminated"), NULL);
+	zassert_equal(0, at_parser_token_get(&parser, 1, &token), NULL);
+	zassert_equal(-EBADMSG, at_parser_next(&parser, &token), NULL);
+	zassert_equal(-ENODATA, at_parser_next(&parser, &token), NULL);
+	zassert_equal(-EBADMSG, at_parser_count_get(&parser, &count), NULL);
+
+	zassert_equal(0, at_parser_init(&parser, "+TEST: \"quoted\"garbage,1"), NULL);
+	zassert_equal(-EBADMSG, at_parser_token_get(&parser, 1, &token), NULL);
+}
+
+static int ncellmeas_sum_at_parser(void)
+{
+	struct at_parser parser;
+	int32_t val;
+	int sum = 0;
+
+	(void)at_parser_init(&parser, ncellmeas);
+
+	for (size_t i = 5; i < NCELLMEAS_PARAMS - 1; i++) {
+		if (at_parser_int_get(&parser, i, &val)) {
+			return INT_MIN;
+		}
+		sum += val;
+	}
+
+	return sum;
+}
+
+static int ncellmeas_sum_at_params(void)
+{
+	struct at_param_list list;
+	int32_t val;
+	int sum = 0;
+
+	if (at_params_list_init(&list, NCELLMEAS_PARAMS + 1)) {
+		return INT_MIN;
+	}
+
+	if (at_parser_params_from_str(ncellmeas, NULL, &list)) {
+		sum = INT_MIN;
+		goto exit;
+	}
+
+	for (size_t i = 5; i < NCELLMEAS_PARAMS - 1; i++) {
+		if (at_params_int_get(&list, i, &val)) {
+			sum = INT_MIN;
+			goto exit;
+		}
+		sum += val;
+	}
+
+exit:
+	at_params_list_free(&list);
+
+	return sum;
+}
+
+/* Compare the time taken to parse a recorded %NCELLMEAS notification with
+ * 17 neighbor cells, using at_parser and at_parser_params_from_str().
+ */
+static void test_at_parser_benchmark(void)
+{
+	int expected;
+	uint32_t start;
+	uint64_t cycles_at_parser;
+	uint64_t cycles_at_params;
+
+	expected = ncellmeas_sum_at_params();
+	zassert_not_equal(INT_MIN, expected, "at_params failed");
+	zassert_equal(expected, ncellmeas_sum_at_parser(), "Results differ");
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		(void)ncellmeas_sum_at_parser();
+	}
+	cycles_at_parser = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		(void)ncellmeas_sum_at_params();
+	}
+	cycles_at_params = k_cycle_get_32() - start;
+
+	TC_PRINT("%%NCELLMEAS, %d iterations: at_parser %llu ns, at_params %llu ns\n",
+		 BENCHMARK_ITERATIONS,
+		 k_cyc_to_ns_floor64(cycles_at_parser) / BENCHMARK_ITERATIONS,
+		 k_cyc_to_ns_floor64(cycles_at_params) / BENCHMARK_ITERATIONS);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(at_parser,
+			 ztest_unit_test(test_at_parser_init),
+			 ztest_unit_test(test_at_parser_cereg),
+			 ztest_unit_test(test_at_parser_next),
+			 ztest_unit_test(test_at_parser_no_prefix),
+			 ztest_unit_test(test_at_parser_numbers),
+			 ztest_unit_test(test_at_parser_malformed),
+			 ztest_unit_test(test_at_parser_benchmark)
+			);
+
+	ztest_run_test_suite(at_parser);
+}
@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/fff.h>
+#include <modem/at_monitor.h>
+#include <nrf_modem_at.h>
+
+DEFINE_FFF_GLOBALS;
+
+FAKE_VALUE_FUNC(int, nrf_modem_at_notif_handler_set, nrf_modem_at_notif_handler_t);
+
+/* Called by the modem library, from an ISR */
+void at_monitor_dispatch(const char *notif);
+
+#define RECORD_MAX 8
+
+/* Monitors that received the last notification, in the order they received it */
+static const char *record[RECORD_MAX];
+static size_t record_cnt;
+
+static void record_add(const char *name)
+{
+	zassert_true(record_cnt < RECORD_MAX, "Too many monitors dispatched");
+	record[record_cnt++] = name;
+}
+
+#define RECORDING_HANDLER(name)                                                                    \
+	static void name(const char *notif)                                                        \
+	{                                                                                          \
+		record_add(#name);                                                                 \
+	}
+
+/* The monitors are dispatched in the order of their names.
+ * With CONFIG_AT_MONITOR_FILTER_INDEX_BUCKETS=4, "+CFUN" and "+CMTI" share
+ * a bucket, "+COLA" and "+COLB" share the characters that are hashed.
+ */
+AT_MONITOR_ISR(mon_a_any, ANY, on_a_any, PAUSED);
+AT_MONITOR_ISR(mon_b_cfun, "+CFUN", on_b_cfun, PAUSED);
+AT_MONITOR_ISR(mon_c_cmti, "+CMTI", on_c_cmti, PAUSED);
+AT_MONITOR_ISR(mon_d_cola, "+COLA", on_d_cola, PAUSED);
+AT_MONITOR_ISR(mon_e_colb, "+COLB", on_e_colb, PAUSED);
+AT_MONITOR_ISR(mon_f_pref, "+PREF", on_f_pref, PAUSED);
+AT_MONITOR_ISR(mon_g_pref_plain, "PREF", on_g_pref_plain, PAUSED);
+AT_MONITOR_ISR(mon_h_short, "+CF", on_h_short, PAUSED);
+AT_MONITOR_ISR(mon_i_any, ANY, on_i_any, PAUSED);
+
+RECORDING_HANDLER(on_a_any);
+RECORDING_HANDLER(on_b_cfun);
+RECORDING_HANDLER(on_c_cmti);
+RECORDING_HANDLER(on_d_cola);
+RECORDING_HANDLER(on_e_colb);
+RECORDING_HANDLER(on_f_pref);
+RECORDING_HANDLER(on_g_pref_plain);
+RECORDING_HANDLER(on_h_short);
+RECORDING_HANDLER(on_i_any);
+
+/* Both monitors receive the same notifications, from the workqueue */
+AT_MONITOR(mon_r_ring, "+RING", on_r_ring, PAUSED);
+AT_MONITOR(mon_s_ring, "+RING", on_s_ring, PAUSED);
+
+#define HELD_MAX 4
+
+/* The notification buffer holds two of these, and not three */
+#define RING_NOTIF_FMT "+RING: %02d-5678901234567890123456789012\r\n"
+#define RING_NOTIF_LEN 40
+
+static char ring_notif[RING_NOTIF_LEN + 1];
+static const char *ring_received;
+static const char *ring_received_too;
+static size_t ring_cnt;
+static bool ring_hold;
+static const char *held[HELD_MAX];
+static size_t held_cnt;
+
+static void on_r_ring(const char *notif)
+{
+	ring_received = notif;
+	ring_cnt++;
+
+	if (ring_hold) {
+		zassert_true(held_cnt < HELD_MAX, "Too many notifications held");
+		at_monitor_notif_hold(notif);
+		held[held_cnt++] = notif;
+	}
+}
+
+static void on_s_ring(const char *notif)
+{
+	ring_received_too = notif;
+}
+
+static void dispatch_expect(const char *notif, const char *const *expected, size_t expected_cnt)
+{
+	record_cnt = 0;
+
+	at_monitor_dispatch(notif);
+
+	zassert_equal(record_cnt, expected_cnt, "%s dispatched to %zu monitors, expected %zu",
+		      notif, record_cnt, expected_cnt);
+
+	for (size_t i = 0; i < expected_cnt; i++) {
+		zassert_true(!strcmp(record[i], expected[i]), "%s dispatched to %s, expected %s",
+			     notif, record[i], expected[i]);
+	}
+}
+
+#define DISPATCH_EXPECT(notif, ...)                                                                \
+	do {                                                                                       \
+		static const char *const expected[] = { __VA_ARGS__ };                             \
+		dispatch_expect(notif, expected, ARRAY_SIZE(expected));                            \
+	} while (0)
+
+#define DISPATCH_EXPECT_NONE(notif) dispatch_expect(notif, NULL, 0)
+
+static void pause_all(void)
+{
+	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
+		at_monitor_pause(e);
+	}
+}
+
+static void test_filter_collision(void)
+{
+	at_monitor_resume(&mon_b_cfun);
+	at_monitor_resume(&mon_c_cmti);
+	at_monitor_resume(&mon_d_cola);
+	at_monitor_resume(&mon_e_colb);
+
+	DISPATCH_EXPECT("+CFUN: 1\r\n", "on_b_cfun");
+	DISPATCH_EXPECT("+CMTI: \"SM\",1\r\n", "on_c_cmti");
+	DISPATCH_EXPECT("+COLA: 1\r\n", "on_d_cola");
+	DISPATCH_EXPECT("+COLB: 1\r\n", "on_e_colb");
+	DISPATCH_EXPECT_NONE("+COLC: 1\r\n");
+}
+
+static void test_filter_prefix(void)
+{
+	at_monitor_resume(&mon_f_pref);
+	at_monitor_resume(&mon_g_pref_plain);
+
+	DISPATCH_EXPECT("+PREF: 1\r\n", "on_f_pref", "on_g_pref_plain");
+	/* Also filters that begin with '+' match anywhere */
+	DISPATCH_EXPECT("%XNOTIF: +PREF\r\n", "on_f_pref", "on_g_pref_plain");
+}
+
+static void test_filter_short(void)
+{
+	at_monitor_resume(&mon_b_cfun);
+	at_monitor_resume(&mon_h_short);
+
+	/* Filters shorter than the hashed characters match anywhere */
+	DISPATCH_EXPECT("+CFUN: 1\r\n", "on_b_cfun", "on_h_short");
+	DISPATCH_EXPECT("%XNOTIF: +CF\r\n", "on_h_short");
+}
+
+static void test_filter_any(void)
+{
+	at_monitor_resume(&mon_a_any);
+	at_monitor_resume(&mon_b_cfun);
+	at_monitor_resume(&mon_i_any);
+
+	/* The monitors are dispatched in order, indexed or not */
+	DISPATCH_EXPECT("+CFUN: 1\r\n", "on_a_any", "on_b_cfun", "on_i_any");
+	DISPATCH_EXPECT("+CMTI: \"SM\",1\r\n", "on_a_any", "on_i_any");
+	DISPATCH_EXPECT("OK\r\n", "on_a_any", "on_i_any");
+}
+
+/* The monitors whose filter is found in the notification, in section order */
+static void reference_dispatch(const char *notif)
+{
+	record_cnt = 0;
+
+	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
+		if (!e->flags.paused && (e->filter == ANY || strstr(notif, e->filter))) {
+			e->handler(notif);
+		}
+	}
+}
+
+static void test_filter_reference(void)
+{
+	static const char *const notifs[] = {
+		"+CFUN: 1\r\n",
+		"+CFUNC: 1\r\n",
+		"+CMTI: \"SM\",1\r\n",
+		"+COLC: 1\r\n",
+		"%XNOTIF: +PREF\r\n",
+		"%XNOTIF: +CMTI +CFUN +CMTI\r\n",
+		"%XNOTIF: +PRE\r\n",
+		"+PREF+PREF+COLB\r\n",
+		"PREF\r\n",
+		"+CF\r\n",
+		"%+CF+%\r\n",
+		"OK\r\n",
+		"",
+	};
+	const char *expected[RECORD_MAX];
+	size_t expected_cnt;
+
+	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
+		if (e->flags.direct) {
+			at_monitor_resume(e);
+		}
+	}
+
+	/* With or without the index, the monitors whose filter is found anywhere
+	 * in the notification are dispatched, in section order.
+	 */
+	for (size_t i = 0; i < ARRAY_SIZE(notifs); i++) {
+		reference_dispatch(notifs[i]);
+		memcpy(expected, record, sizeof(expected));
+		expected_cnt = record_cnt;
+
+		dispatch_expect(notifs[i], expected, expected_cnt);
+	}
+}
+
+static void test_filter_paused(void)
+{
+	at_monitor_resume(&mon_a_any);
+	at_monitor_resume(&mon_b_cfun);
+
+	at_monitor_pause(&mon_a_any);
+	DISPATCH_EXPECT("+CFUN: 1\r\n", "on_b_cfun");
+
+	at_monitor_pause(&mon_b_cfun);
+	DISPATCH_EXPECT_NONE("+CFUN: 1\r\n");
+}
+
+static const char *ring_dispatch(int n)
+{
+	snprintf(ring_notif, sizeof(ring_notif), RING_NOTIF_FMT, n);
+	zassert_equal(strlen(ring_notif), RING_NOTIF_LEN, NULL);
+
+	ring_received = NULL;
+	at_monitor_dispatch(ring_notif);
+
+	/* Let the workqueue dispatch the notification */
+	k_sleep(K_MSEC(10));
+
+	if (ring_received) {
+		zassert_true(!strcmp(ring_received, ring_notif), "Notification corrupted");
+	}
+
+	return ring_received;
+}
+
+static void ring_release(const char *notif)
+{
+	for (size_t i = 0; i < held_cnt; i++) {
+		if (held[i] == notif) {
+			at_monitor_notif_release(notif);
+			held[i] = held[--held_cnt];
+			return;
+		}
+	}
+
+	zassert_unreachable("Notification not held");
+}
+
+static uint32_t drops_get(void)
+{
+	struct at_monitor_stats stats;
+
+	at_monitor_stats_get(&stats);
+
+	return stats.drops;
+}
+
+static void ring_setup(void)
+{
+	ring_cnt = 0;
+	ring_hold = false;
+	at_monitor_resume(&mon_r_ring);
+}
+
+static void ring_teardown(void)
+{
+	while (held_cnt) {
+		ring_release(held[0]);
+	}
+
+	pause_all();
+}
+
+static void test_notif_shared(void)
+{
+	const char *first;
+	const char *second;
+
+	at_monitor_resume(&mon_s_ring);
+
+	/* Only one of the monitors holds the notification */
+	ring_hold = true;
+	first = ring_dispatch(1);
+	zassert_not_null(first, NULL);
+	zassert_equal(ring_received_too, first, "Monitors must share the notification");
+
+	ring_hold = false;
+	second = ring_dispatch(2);
+	zassert_not_null(second, NULL);
+	zassert_not_equal(second, first, "Held notification overwritten");
+	zassert_equal(ring_received_too, second, "Monitors must share the notification");
+
+	snprintf(ring_notif, sizeof(ring_notif), RING_NOTIF_FMT, 1);
+	zassert_true(!strcmp(first, ring_notif), "Held notification corrupted");
+
+	/* Once released, the space of both notifications is reused */
+	ring_release(first);
+	zassert_equal(ring_dispatch(3), first, NULL);
+}
+
+static void test_notif_alloc_fail(void)
+{
+	const char *first;
+	const char *second;
+	uint32_t drops = drops_get();
+
+	ring_hold = true;
+	first = ring_dispatch(1);
+	second = ring_dispatch(2);
+	zassert_not_null(first, NULL);
+	zassert_not_null(second, NULL);
+
+	/* No space left, the notification is dropped */
+	zassert_is_null(ring_dispatch(3), "Notification must have been dropped");
+	zassert_equal(ring_cnt, 2, NULL);
+	zassert_equal(drops_get(), drops + 1, NULL);
+
+	ring_release(first);
+	ring_release(second);
+
+	ring_hold = false;
+	zassert_not_null(ring_dispatch(4), "Released space must be reused");
+	zassert_equal(drops_get(), drops + 1, NULL);
+}
+
+static void test_notif_wrap_around(void)
+{
+	const char *first;
+	const char *second;
+	const char *third;
+
+	ring_hold = true;
+	first = ring_dispatch(1);
+	second = ring_dispatch(2);
+	zassert_not_null(first, NULL);
+	zassert_not_null(second, NULL);
+
+	/* The third notification only fits before the second one */
+	ring_release(first);
+	third = ring_dispatch(3);
+	zassert_equal(third, first, "Notification must have wrapped around");
+
+	snprintf(ring_notif, sizeof(ring_notif), RING_NOTIF_FMT, 2);
+	zassert_true(!strcmp(second, ring_notif), "Notification overwritten");
+
+	/* The buffer is full again */
+	zassert_is_null(ring_dispatch(4), "Notification must have been dropped");
+
+	ring_release(second);
+	zassert_not_null(ring_dispatch(5), NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(at_monitor,
+		ztest_unit_test_setup_teardown(test_filter_collision, unit_test_noop, pause_all),
+		ztest_unit_test_setup_teardown(test_filter_prefix, unit_test_noop, pause_all),
+		ztest_unit_test_setup_teardown(test_filter_short, unit_test_noop, pause_all),
+		ztest_unit_test_setup_teardown(test_filter_any, unit_test_noop, pause_all),
+		ztest_unit_test_setup_teardown(test_filter_reference, unit_test_noop, pause_all),
+		ztest_unit_test_setup_teardown(test_filter_paused, unit_test_noop, pause_all),
+		ztest_unit_test_setup_teardown(test_notif_shared, ring_setup, ring_teardown),
+		ztest_unit_test_setup_teardown(test_notif_alloc_fail, ring_setup, ring_teardown),
+		ztest_unit_test_setup_teardown(test_notif_wrap_around, ring_setup, ring_teardown)
+	);
+
+	ztest_run_test_suite(at_monitor);
+}
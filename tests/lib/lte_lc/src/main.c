@@ -10,6 +10,7 @@
 #include <string.h>
 
 #include "lte_lc_helpers.h"
+#include "lte_lc_state_cache.h"
 #include "lte_lc.h"
 
 static void test_parse_edrx(void)
@@ -801,6 +802,83 @@ static void test_parse_periodic_search_pattern(void)
 	zassert_equal(err, -EBADMSG, "Expected %d, but %d was returned", -EBADMSG, err);
 }
 
+static void test_state_cache(void)
+{
+	int err;
+	struct lte_lc_state_cache_stats stats;
+	enum lte_lc_nw_reg_status status = LTE_LC_NW_REG_REGISTERED_HOME;
+	struct lte_lc_psm_cfg psm_cfg = { .tau = 3240, .active_time = 60 };
+	struct lte_lc_psm_cfg psm_cfg_cached = {0};
+
+	lte_lc_state_cache_invalidate_all();
+
+	err = lte_lc_state_cache_get(LTE_LC_STATE_CACHE_NW_REG_STATUS, &status, sizeof(status));
+	zassert_equal(err, -ENODATA, "Empty cache returned %d", err);
+
+	lte_lc_state_cache_set(LTE_LC_STATE_CACHE_PSM, &psm_cfg, sizeof(psm_cfg));
+
+	err = lte_lc_state_cache_get(LTE_LC_STATE_CACHE_PSM, &psm_cfg_cached,
+				     sizeof(psm_cfg_cached));
+	zassert_equal(err, 0, "Cache miss, error: %d", err);
+	zassert_mem_equal(&psm_cfg, &psm_cfg_cached, sizeof(psm_cfg), "Wrong PSM configuration");
+
+	lte_lc_state_cache_invalidate(LTE_LC_STATE_CACHE_PSM);
+
+	err = lte_lc_state_cache_get(LTE_LC_STATE_CACHE_PSM, &psm_cfg_cached,
+				     sizeof(psm_cfg_cached));
+	zassert_equal(err, -ENODATA, "Invalidated field returned %d", err);
+
+	err = lte_lc_state_cache_stats_get(&stats);
+	zassert_equal(err, 0, "lte_lc_state_cache_stats_get failed, error: %d", err);
+	zassert_equal(stats.hits[LTE_LC_STATE_CACHE_PSM], 1, "Wrong number of hits");
+	zassert_equal(stats.misses[LTE_LC_STATE_CACHE_PSM], 1, "Wrong number of misses");
+	zassert_equal(stats.misses[LTE_LC_STATE_CACHE_NW_REG_STATUS], 1,
+		      "Wrong number of misses");
+
+	err = lte_lc_state_cache_stats_get(NULL);
+	zassert_equal(err, -EINVAL, "Expected %d, but %d was returned", -EINVAL, err);
+}
+
+static void test_state_cache_max_age(void)
+{
+	int err;
+	enum lte_lc_func_mode mode = LTE_LC_FUNC_MODE_NORMAL;
+	enum lte_lc_nw_reg_status status = LTE_LC_NW_REG_REGISTERED_ROAMING;
+	struct lte_lc_psm_cfg psm_cfg = { .tau = 3600, .active_time = 60 };
+	struct lte_lc_psm_cfg psm_cfg_cached = {0};
+
+	lte_lc_state_cache_set(LTE_LC_STATE_CACHE_FUNC_MODE, &mode, sizeof(mode));
+	lte_lc_state_cache_set(LTE_LC_STATE_CACHE_NW_REG_STATUS, &status, sizeof(status));
+	lte_lc_state_cache_set(LTE_LC_STATE_CACHE_PSM, &psm_cfg, sizeof(psm_cfg));
+
+	err = lte_lc_state_cache_get(LTE_LC_STATE_CACHE_FUNC_MODE, &mode, sizeof(mode));
+	zassert_equal(err, 0, "Cache miss, error: %d", err);
+	zassert_equal(mode, LTE_LC_FUNC_MODE_NORMAL, "Wrong functional mode");
+
+	k_sleep(K_MSEC(CONFIG_LTE_LC_STATE_CACHE_FUNC_MODE_MAX_AGE_MS + 10));
+
+	/* The functional mode has expired, the registration status has not. */
+	err = lte_lc_state_cache_get(LTE_LC_STATE_CACHE_FUNC_MODE, &mode, sizeof(mode));
+	zassert_equal(err, -ENODATA, "Expired field returned %d", err);
+
+	status = LTE_LC_NW_REG_UNKNOWN;
+	err = lte_lc_state_cache_get(LTE_LC_STATE_CACHE_NW_REG_STATUS, &status, sizeof(status));
+	zassert_equal(err, 0, "Cache miss, error: %d", err);
+	zassert_equal(status, LTE_LC_NW_REG_REGISTERED_ROAMING, "Wrong registration status");
+
+	k_sleep(K_MSEC(CONFIG_LTE_LC_STATE_CACHE_NW_REG_MAX_AGE_MS -
+		       CONFIG_LTE_LC_STATE_CACHE_FUNC_MODE_MAX_AGE_MS));
+
+	/* The registration status has expired, the PSM configuration has no age limit. */
+	err = lte_lc_state_cache_get(LTE_LC_STATE_CACHE_NW_REG_STATUS, &status, sizeof(status));
+	zassert_equal(err, -ENODATA, "Expired field returned %d", err);
+
+	err = lte_lc_state_cache_get(LTE_LC_STATE_CACHE_PSM, &psm_cfg_cached,
+				     sizeof(psm_cfg_cached));
+	zassert_equal(err, 0, "Cache miss, error: %d", err);
+	zassert_mem_equal(&psm_cfg, &psm_cfg_cached, sizeof(psm_cfg), "Wrong PSM configuration");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_lte_lc,
@@ -815,7 +893,9 @@ void test_main(void)
 		ztest_unit_test(test_parse_mdmev),
 		ztest_unit_test(test_parse_psm),
 		ztest_unit_test(test_periodic_search_pattern_get),
-		ztest_unit_test(test_parse_periodic_search_pattern)
+		ztest_unit_test(test_parse_periodic_search_pattern),
+		ztest_unit_test(test_state_cache),
+		ztest_unit_test(test_state_cache_max_age)
 	);
 
 	ztest_run_test_suite(test_lte_lc);
@@ -20,7 +20,6 @@
 DEFINE_FFF_GLOBALS;
 
 FAKE_VALUE_FUNC(int, nrf_modem_at_notif_handler_set, nrf_modem_at_notif_handler_t);
-FAKE_VALUE_FUNC(int, at_params_list_init, struct at_param_list *, size_t);
 FAKE_VALUE_FUNC_VARARG(int, nrf_modem_at_scanf, const char *, const char *, ...);
 
 #define FW_UUID_SIZE 37
@@ -34,12 +33,6 @@ FAKE_VALUE_FUNC_VARARG(int, nrf_modem_at_scanf, const char *, const char *, ...)
 #define EXAMPLE_RSRP_VALID 160
 #define RSRP_OFFSET 140
 
-struct at_param at_params[10] = {};
-static struct at_param_list m_param_list = {
-	.param_count = 0,
-	.params = at_params,
-};
-
 static int nrf_modem_at_scanf_custom_no_match(const char *cmd, const char *fmt, va_list args)
 {
 	return 0;
@@ -133,7 +126,6 @@ static int nrf_modem_at_scanf_custom_cesq_invalid(const char *cmd, const char *f
 void setUp(void)
 {
 	RESET_FAKE(nrf_modem_at_notif_handler_set);
-	RESET_FAKE(at_params_list_init);
 	RESET_FAKE(nrf_modem_at_scanf);
 }
 
@@ -141,20 +133,12 @@ void tearDown(void)
 {
 }
 
-int at_params_list_init_custom(struct at_param_list *list, size_t max_params_count)
-{
-	*list = m_param_list;
-	return EXIT_SUCCESS;
-}
-
 void test_modem_info_init_success(void)
 {
 	int ret;
 
-	at_params_list_init_fake.custom_fake = at_params_list_init_custom;
 	ret = modem_info_init();
 	TEST_ASSERT_EQUAL(0, ret);
-	TEST_ASSERT_EQUAL(1, at_params_list_init_fake.call_count);
 }
 
 void test_modem_info_get_fw_uuid_null(void)
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <unity.h>
+#include <zephyr/kernel.h>
+#include <modem/nrf_modem_lib.h>
+#include <nrf_errno.h>
+
+#include "nrf_modem_lib_trace.h"
+
+#include "mock_trace_backend.h"
+#include "mock_nrf_modem.h"
+#include "mock_nrf_modem_trace.h"
+#include "mock_nrf_modem_os.h"
+
+extern int unity_main(void);
+
+/* Suite teardown shall finalize with mandatory call to generic_suiteTearDown. */
+extern int generic_suiteTearDown(int num_failures);
+
+#define BATCH_SIZE CONFIG_NRF_MODEM_LIB_TRACE_BATCH_SIZE
+#define MAX_WRITES 8
+
+static uint8_t trace_data[2 * BATCH_SIZE + BATCH_SIZE / 2];
+static struct nrf_modem_trace_data get_frags[4];
+static size_t n_get_frags;
+static size_t batch_fill;
+static int nrf_modem_trace_get_error;
+
+static uint8_t written[sizeof(trace_data)];
+static size_t written_len;
+static size_t write_lens[MAX_WRITES];
+static int n_writes;
+
+K_SEM_DEFINE(backend_write_sem, 0, MAX_WRITES);
+K_SEM_DEFINE(backend_deinit_sem, 0, 1);
+
+void setUp(void)
+{
+	mock_nrf_modem_Init();
+	mock_nrf_modem_trace_Init();
+	mock_trace_backend_Init();
+
+	for (size_t i = 0; i < sizeof(trace_data); i++) {
+		trace_data[i] = i % 251;
+	}
+
+	n_get_frags = 0;
+	batch_fill = 0;
+	nrf_modem_trace_get_error = 0;
+	written_len = 0;
+	n_writes = 0;
+	k_sem_reset(&backend_write_sem);
+}
+
+void tearDown(void)
+{
+	mock_nrf_modem_Verify();
+	mock_nrf_modem_trace_Verify();
+	mock_trace_backend_Verify();
+}
+
+static void NRF_MODEM_LIB_ON_INIT_callback(void)
+{
+	STRUCT_SECTION_FOREACH(nrf_modem_lib_init_cb, e) {
+		e->callback(0, e->context);
+	}
+}
+
+/* Trace level set on initialization. */
+int nrf_modem_at_printf(const char *fmt, ...)
+{
+	return 0;
+}
+
+static void trace_frag_add(const uint8_t *data, size_t len)
+{
+	size_t chunk;
+
+	get_frags[n_get_frags].data = data;
+	get_frags[n_get_frags].len = len;
+	n_get_frags++;
+
+	/* Trace memory is released as it is copied to the batch buffer. */
+	while (len) {
+		chunk = MIN(len, BATCH_SIZE - batch_fill);
+		__cmock_nrf_modem_trace_processed_ExpectAndReturn(chunk, 0);
+		batch_fill = (batch_fill + chunk) % BATCH_SIZE;
+		len -= chunk;
+	}
+}
+
+int nrf_modem_trace_get_stub(struct nrf_modem_trace_data **frags, size_t *n_frags, int timeout,
+			     int cmock_num_calls)
+{
+	if (n_get_frags) {
+		*frags = get_frags;
+		*n_frags = n_get_frags;
+		n_get_frags = 0;
+		return 0;
+	}
+
+	if (nrf_modem_trace_get_error) {
+		return nrf_modem_trace_get_error;
+	}
+
+	if (timeout != NRF_MODEM_OS_FOREVER) {
+		return -NRF_EAGAIN;
+	}
+
+	/* Block until the test ends tracing. */
+	while (!nrf_modem_trace_get_error) {
+		k_sleep(K_MSEC(1));
+	}
+
+	return nrf_modem_trace_get_error;
+}
+
+int trace_backend_write_stub(const void *data, size_t len, int cmock_num_calls)
+{
+	TEST_ASSERT_LESS_OR_EQUAL(sizeof(written), written_len + len);
+	TEST_ASSERT_LESS_THAN(MAX_WRITES, n_writes);
+
+	memcpy(&written[written_len], data, len);
+	written_len += len;
+	write_lens[n_writes++] = len;
+
+	k_sem_give(&backend_write_sem);
+
+	return (int)len;
+}
+
+int trace_backend_deinit_stub(int cmock_num_calls)
+{
+	k_sem_give(&backend_deinit_sem);
+
+	return 0;
+}
+
+int test_suiteTearDown(int num_failures)
+{
+	return generic_suiteTearDown(num_failures);
+}
+
+static void trace_start(void)
+{
+	__cmock_trace_backend_init_ExpectAnyArgsAndReturn(0);
+	__cmock_nrf_modem_trace_get_Stub(nrf_modem_trace_get_stub);
+	__cmock_trace_backend_write_Stub(trace_backend_write_stub);
+	__cmock_trace_backend_deinit_Stub(trace_backend_deinit_stub);
+
+	NRF_MODEM_LIB_ON_INIT_callback();
+}
+
+static void trace_stop(int err)
+{
+	nrf_modem_trace_get_error = err;
+
+	k_sem_take(&backend_deinit_sem, K_FOREVER);
+}
+
+static void wait_writes(int count)
+{
+	for (int i = 0; i < count; i++) {
+		TEST_ASSERT_EQUAL(0, k_sem_take(&backend_write_sem, K_SECONDS(1)));
+	}
+}
+
+void test_trace_batch_flush_on_timeout(void)
+{
+	trace_frag_add(trace_data, 10);
+	trace_frag_add(&trace_data[10], 20);
+
+	trace_start();
+
+	/* Both fragments are written at once when no more trace data arrives. */
+	wait_writes(1);
+
+	TEST_ASSERT_EQUAL(1, n_writes);
+	TEST_ASSERT_EQUAL(30, write_lens[0]);
+	TEST_ASSERT_EQUAL_MEMORY(trace_data, written, 30);
+
+	trace_stop(-NRF_ESHUTDOWN);
+
+	TEST_ASSERT_EQUAL(1, n_writes);
+}
+
+void test_trace_batch_flush_when_full(void)
+{
+	trace_frag_add(trace_data, sizeof(trace_data));
+
+	trace_start();
+
+	wait_writes(3);
+
+	TEST_ASSERT_EQUAL(BATCH_SIZE, write_lens[0]);
+	TEST_ASSERT_EQUAL(BATCH_SIZE, write_lens[1]);
+	TEST_ASSERT_EQUAL(BATCH_SIZE / 2, write_lens[2]);
+	TEST_ASSERT_EQUAL_MEMORY(trace_data, written, sizeof(trace_data));
+
+	trace_stop(-NRF_ESHUTDOWN);
+}
+
+void test_trace_batch_flush_on_shutdown(void)
+{
+	/* The backend is not written to before tracing stops. */
+	nrf_modem_trace_get_error = -NRF_ENODATA;
+
+	trace_frag_add(trace_data, 100);
+
+	trace_start();
+
+	k_sem_take(&backend_deinit_sem, K_FOREVER);
+
+	TEST_ASSERT_EQUAL(1, n_writes);
+	TEST_ASSERT_EQUAL(100, write_lens[0]);
+	TEST_ASSERT_EQUAL_MEMORY(trace_data, written, 100);
+}
+
+void test_trace_batch_stats(void)
+{
+	struct nrf_modem_lib_trace_stats before;
+	struct nrf_modem_lib_trace_stats after;
+
+	nrf_modem_lib_trace_stats_get(&before);
+
+	trace_frag_add(trace_data, BATCH_SIZE + 10);
+
+	trace_start();
+
+	wait_writes(2);
+
+	trace_stop(-NRF_ESHUTDOWN);
+
+	nrf_modem_lib_trace_stats_get(&after);
+
+	TEST_ASSERT_EQUAL(BATCH_SIZE + 10, after.bytes_received - before.bytes_received);
+	TEST_ASSERT_EQUAL(BATCH_SIZE + 10, after.bytes_written - before.bytes_written);
+	TEST_ASSERT_EQUAL(2, after.batches - before.batches);
+	TEST_ASSERT_EQUAL(0, after.backlog);
+	TEST_ASSERT_GREATER_OR_EQUAL(10, after.backlog_max);
+}
+
+void main(void)
+{
+	(void)unity_main();
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+
+#include <zephyr/kernel.h>
+
+#include "shm_tx_slab.h"
+
+#define SMALL_SIZE CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_SMALL_SIZE
+#define SMALL_COUNT CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_SMALL_COUNT
+#define LARGE_SIZE CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_LARGE_SIZE
+#define LARGE_COUNT CONFIG_NRF_MODEM_LIB_SHMEM_TX_SLAB_LARGE_COUNT
+
+static uint8_t tx_region[CONFIG_NRF_MODEM_LIB_SHMEM_TX_SIZE] __aligned(4);
+
+void setUp(void)
+{
+	shm_tx_slab_init(tx_region);
+}
+
+void tearDown(void)
+{
+}
+
+static void assert_in_slab(void *mem)
+{
+	TEST_ASSERT_NOT_NULL(mem);
+	TEST_ASSERT_TRUE((uint8_t *)mem >= tx_region);
+	TEST_ASSERT_TRUE((uint8_t *)mem < tx_region + SHM_TX_SLAB_SIZE);
+}
+
+void test_shm_tx_slab_size_classes(void)
+{
+	struct nrf_modem_lib_diag_slab_stats stats[NRF_MODEM_LIB_DIAG_SLAB_CLASSES];
+	void *small = shm_tx_slab_alloc(1);
+	void *exact = shm_tx_slab_alloc(SMALL_SIZE);
+	void *large = shm_tx_slab_alloc(SMALL_SIZE + 1);
+
+	assert_in_slab(small);
+	assert_in_slab(exact);
+	assert_in_slab(large);
+
+	/* Small blocks come first in the region. */
+	TEST_ASSERT_TRUE((uint8_t *)small < tx_region + SMALL_SIZE * SMALL_COUNT);
+	TEST_ASSERT_TRUE((uint8_t *)large >= tx_region + SMALL_SIZE * SMALL_COUNT);
+
+	shm_tx_slab_stats_get(stats);
+	TEST_ASSERT_EQUAL(SMALL_SIZE, stats[0].block_size);
+	TEST_ASSERT_EQUAL(2, stats[0].blocks_used);
+	TEST_ASSERT_EQUAL(2, stats[0].allocs);
+	TEST_ASSERT_EQUAL(LARGE_SIZE, stats[1].block_size);
+	TEST_ASSERT_EQUAL(1, stats[1].blocks_used);
+
+	TEST_ASSERT_TRUE(shm_tx_slab_free(small));
+	TEST_ASSERT_TRUE(shm_tx_slab_free(exact));
+	TEST_ASSERT_TRUE(shm_tx_slab_free(large));
+
+	shm_tx_slab_stats_get(stats);
+	TEST_ASSERT_EQUAL(0, stats[0].blocks_used);
+	TEST_ASSERT_EQUAL(2, stats[0].blocks_max_used);
+	TEST_ASSERT_EQUAL(0, stats[1].blocks_used);
+}
+
+void test_shm_tx_slab_too_large(void)
+{
+	/* Allocations larger than the largest block are left to the heap. */
+	TEST_ASSERT_NULL(shm_tx_slab_alloc(LARGE_SIZE + 1));
+}
+
+void test_shm_tx_slab_fallback_to_larger_class(void)
+{
+	struct nrf_modem_lib_diag_slab_stats stats[NRF_MODEM_LIB_DIAG_SLAB_CLASSES];
+	void *small[SMALL_COUNT];
+	void *large[LARGE_COUNT];
+	void *mem;
+
+	for (size_t i = 0; i < SMALL_COUNT; i++) {
+		small[i] = shm_tx_slab_alloc(SMALL_SIZE);
+		assert_in_slab(small[i]);
+	}
+
+	/* Small blocks are exhausted, large blocks are used instead. */
+	for (size_t i = 0; i < LARGE_COUNT; i++) {
+		large[i] = shm_tx_slab_alloc(1);
+		assert_in_slab(large[i]);
+		TEST_ASSERT_TRUE((uint8_t *)large[i] >= tx_region + SMALL_SIZE * SMALL_COUNT);
+	}
+
+	/* All blocks are exhausted. */
+	TEST_ASSERT_NULL(shm_tx_slab_alloc(1));
+
+	shm_tx_slab_stats_get(stats);
+	TEST_ASSERT_EQUAL(LARGE_COUNT + 1, stats[0].misses);
+	TEST_ASSERT_EQUAL(1, stats[1].misses);
+
+	/* A freed block is reused. */
+	TEST_ASSERT_TRUE(shm_tx_slab_free(small[0]));
+	mem = shm_tx_slab_alloc(1);
+	TEST_ASSERT_EQUAL_PTR(small[0], mem);
+	small[0] = mem;
+
+	for (size_t i = 0; i < SMALL_COUNT; i++) {
+		TEST_ASSERT_TRUE(shm_tx_slab_free(small[i]));
+	}
+	for (size_t i = 0; i < LARGE_COUNT; i++) {
+		TEST_ASSERT_TRUE(shm_tx_slab_free(large[i]));
+	}
+}
+
+void test_shm_tx_slab_free_not_a_block(void)
+{
+	TEST_ASSERT_FALSE(shm_tx_slab_free(tx_region + SHM_TX_SLAB_SIZE));
+}
+
+/* It is required to be added to each test. That is because unity is using
+ * different main signature (returns int) and zephyr expects main which does
+ * not return value.
+ */
+extern int unity_main(void);
+
+void main(void)
+{
+	(void)unity_main();
+}
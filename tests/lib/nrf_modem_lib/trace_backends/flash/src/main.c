@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <unity.h>
+#include <zephyr/kernel.h>
+
+#include "flash.c"
+
+#define PARTITION_SIZE CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_FLASH_PARTITION_SIZE
+#define SECTOR_CNT (PARTITION_SIZE / SECTOR_SIZE)
+/* Four fragments of this size fill a sector, with the sector and record headers */
+#define FRAG_SIZE 251
+#define SECTOR_DATA (4 * FRAG_SIZE)
+
+extern int unity_main(void);
+
+/* Suite teardown shall finalize with mandatory call to generic_suiteTearDown. */
+extern int generic_suiteTearDown(int num_failures);
+
+static uint8_t flash[PARTITION_SIZE];
+
+static const struct flash_area fake_area = {
+	.fa_id = PM_MODEM_TRACE_ID,
+	.fa_size = PARTITION_SIZE,
+};
+
+static size_t processed;
+
+static int callback(size_t len)
+{
+	processed += len;
+	return 0;
+}
+
+int flash_area_open(uint8_t id, const struct flash_area **fa)
+{
+	TEST_ASSERT_EQUAL(PM_MODEM_TRACE_ID, id);
+	*fa = &fake_area;
+	return 0;
+}
+
+void flash_area_close(const struct flash_area *fa)
+{
+}
+
+uint32_t flash_area_align(const struct flash_area *fa)
+{
+	return 1;
+}
+
+int flash_area_read(const struct flash_area *fa, off_t off, void *dst, size_t len)
+{
+	TEST_ASSERT_TRUE(off + len <= PARTITION_SIZE);
+	memcpy(dst, &flash[off], len);
+	return 0;
+}
+
+/* Like NOR flash, bits can only be cleared by a write */
+int flash_area_write(const struct flash_area *fa, off_t off, const void *src, size_t len)
+{
+	const uint8_t *data = src;
+
+	TEST_ASSERT_TRUE(off + len <= PARTITION_SIZE);
+
+	for (size_t i = 0; i < len; i++) {
+		TEST_ASSERT_EQUAL_HEX8_MESSAGE(data[i], flash[off + i] & data[i],
+					       "Write to flash that is not erased");
+		flash[off + i] &= data[i];
+	}
+
+	return 0;
+}
+
+int flash_area_erase(const struct flash_area *fa, off_t off, size_t len)
+{
+	TEST_ASSERT_EQUAL(0, off % SECTOR_SIZE);
+	TEST_ASSERT_EQUAL(0, len % SECTOR_SIZE);
+	TEST_ASSERT_TRUE(off + len <= PARTITION_SIZE);
+	memset(&flash[off], 0xff, len);
+	return 0;
+}
+
+static uint8_t stream_byte(size_t offset)
+{
+	return (uint8_t)(offset * 7 + (offset >> 8) * 13);
+}
+
+/* Forget everything but the contents of the flash, as a reset does. */
+static void reboot(void)
+{
+	trace_area = NULL;
+	seq = 0;
+	write_offset = 0;
+	read_sector = 0;
+	read_pos = 0;
+	read_left = 0;
+	stored = 0;
+	dropped = 0;
+
+	TEST_ASSERT_EQUAL(0, trace_backend_init(callback));
+}
+
+void setUp(void)
+{
+	memset(flash, 0xff, sizeof(flash));
+	processed = 0;
+	reboot();
+}
+
+void tearDown(void)
+{
+	TEST_ASSERT_EQUAL(0, trace_backend_deinit());
+}
+
+int test_suiteTearDown(int num_failures)
+{
+	return generic_suiteTearDown(num_failures);
+}
+
+/* Write the trace stream from `from`, in `cnt` fragments */
+static void trace_write(size_t from, size_t cnt)
+{
+	uint8_t frag[FRAG_SIZE];
+
+	for (size_t i = 0; i < cnt; i++) {
+		for (size_t j = 0; j < FRAG_SIZE; j++) {
+			frag[j] = stream_byte(from + i * FRAG_SIZE + j);
+		}
+
+		TEST_ASSERT_EQUAL(FRAG_SIZE, trace_backend_write(frag, FRAG_SIZE));
+	}
+}
+
+/* Read all stored trace data and expect the trace stream from `from` to `to` */
+static void trace_read_expect(size_t from, size_t to)
+{
+	uint8_t buf[300];
+	int ret;
+
+	TEST_ASSERT_EQUAL(to - from, nrf_modem_lib_trace_data_size());
+
+	while (from < to) {
+		ret = nrf_modem_lib_trace_read(buf, sizeof(buf));
+		TEST_ASSERT_EQUAL(MIN(sizeof(buf), to - from), ret);
+
+		for (size_t i = 0; i < ret; i++) {
+			TEST_ASSERT_EQUAL_HEX8(stream_byte(from + i), buf[i]);
+		}
+
+		from += ret;
+	}
+
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_trace_data_size());
+	TEST_ASSERT_EQUAL(-ENODATA, nrf_modem_lib_trace_read(buf, sizeof(buf)));
+}
+
+void test_trace_backend_init_flash_efault(void)
+{
+	TEST_ASSERT_EQUAL(-EFAULT, trace_backend_init(NULL));
+}
+
+void test_trace_backend_write_flash(void)
+{
+	trace_write(0, 3);
+
+	TEST_ASSERT_EQUAL(3 * FRAG_SIZE, processed);
+	TEST_ASSERT_EQUAL(3 * FRAG_SIZE, nrf_modem_lib_trace_data_size());
+}
+
+void test_trace_read_flash(void)
+{
+	uint8_t buf[8];
+
+	TEST_ASSERT_EQUAL(-ENODATA, nrf_modem_lib_trace_read(buf, sizeof(buf)));
+
+	/* Spans three sectors */
+	trace_write(0, 10);
+	trace_read_expect(0, 10 * FRAG_SIZE);
+
+	/* Writing continues after the data that has been read */
+	trace_write(10 * FRAG_SIZE, 1);
+	trace_read_expect(10 * FRAG_SIZE, 11 * FRAG_SIZE);
+}
+
+/* When the partition is full, the oldest sector of trace data is dropped */
+void test_trace_wrap_around_flash(void)
+{
+	trace_write(0, 5 * SECTOR_CNT);
+
+	trace_read_expect(SECTOR_DATA, 5 * SECTOR_CNT * FRAG_SIZE);
+}
+
+void test_trace_read_after_reboot_flash(void)
+{
+	trace_write(0, 10);
+
+	reboot();
+	trace_read_expect(0, 10 * FRAG_SIZE);
+
+	/* Trace data that has been read is not read again */
+	reboot();
+	trace_read_expect(0, 0);
+
+	trace_write(10 * FRAG_SIZE, 2);
+	trace_read_expect(10 * FRAG_SIZE, 12 * FRAG_SIZE);
+}
+
+/* Reading resumes at the beginning of the oldest sector that has not been read completely */
+void test_trace_read_after_reboot_partially_read_flash(void)
+{
+	uint8_t buf[SECTOR_DATA + 100];
+
+	trace_write(0, 8);
+
+	TEST_ASSERT_EQUAL(sizeof(buf), nrf_modem_lib_trace_read(buf, sizeof(buf)));
+
+	reboot();
+	trace_read_expect(SECTOR_DATA, 2 * SECTOR_DATA);
+}
+
+void test_trace_wrap_around_after_reboot_flash(void)
+{
+	trace_write(0, 5 * SECTOR_CNT);
+
+	reboot();
+	TEST_ASSERT_EQUAL(4 * SECTOR_DATA, nrf_modem_lib_trace_data_size());
+
+	/* The oldest sector is the one after the newest, also after a reset */
+	trace_write(5 * SECTOR_CNT * FRAG_SIZE, 4);
+	trace_read_expect(2 * SECTOR_DATA, (5 * SECTOR_CNT + 4) * FRAG_SIZE);
+}
+
+void test_trace_clear_flash(void)
+{
+	uint8_t buf[8];
+
+	trace_write(0, 10);
+
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_trace_clear());
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_trace_data_size());
+	TEST_ASSERT_EQUAL(-ENODATA, nrf_modem_lib_trace_read(buf, sizeof(buf)));
+
+	reboot();
+	TEST_ASSERT_EQUAL(-ENODATA, nrf_modem_lib_trace_read(buf, sizeof(buf)));
+
+	trace_write(10 * FRAG_SIZE, 2);
+	trace_read_expect(10 * FRAG_SIZE, 12 * FRAG_SIZE);
+}
+
+void main(void)
+{
+	(void)unity_main();
+}
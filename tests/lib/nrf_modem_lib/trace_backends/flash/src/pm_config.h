@@ -0,0 +1,11 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* DUMMY FILE ONLY TO BE USED FOR TESTING */
+#ifndef PM_CONFIG_H__
+#define PM_CONFIG_H__
+#define PM_MODEM_TRACE_ID 1
+#endif /* PM_CONFIG_H__ */
@@ -0,0 +1,531 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <modem/sms.h>
+#include <modem/at_monitor.h>
+#include <mock_nrf_modem_at.h>
+
+/* at_monitor_dispatch() is implemented in at_monitor library and
+ * we'll call it directly to fake received SMS message
+ */
+extern void at_monitor_dispatch(const char *at_notif);
+
+#define PARTS 5
+
+/* Offsets of the concatenation information element fields in the recorded PDUs. */
+#define PDU_REF_OFFSET 58
+#define PDU_TOTAL_OFFSET 60
+#define PDU_SEQ_OFFSET 62
+
+#define CMT_PREFIX "+CMT: \"1234567890\",159\r\n"
+
+/* Recorded SMS-DELIVER PDUs of a message with 755 characters split into 5 parts,
+ * reference number 128.
+ */
+static const char *const pdus[PARTS] = {
+	/* Part 1 */
+	"0791534874894310440A912143658709000012202280655080A0050003800501C2E231B96C3EA3D3"
+	"EA35BBED7EC3E3F239BD6EBFE3F37A50583C2697CD67745ABD66B7DD6F785C3EA7D7ED777C5E0F0A"
+	"8BC7E4B2F98C4EABD7ECB6FB0D8FCBE7F4BAFD8ECFEB4161F1985C369FD169F59ADD76BFE171F99C"
+	"5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9FD3EBF63B3EAF0785C56372D97C46A7D56B"
+	"76DBFD86C7E5",
+	/* Part 2 */
+	"0791534874894370440A912143658709000012202280656080A0050003800502E6F4BAFD8ECFEB41"
+	"61F1985C369FD169F59ADD76BFE171F99C5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9F"
+	"D3EBF63B3EAF0785C56372D97C46A7D56B76DBFD86C7E5737ADD7EC7E7F5A0B0784C2E9BCFE8B47A"
+	"CD6EBBDFF0B87C4EAFDBEFF8BC1E14168FC965F3199D56AFD96DF71B1E97CFE975FB1D9FD783C2E2"
+	"31B96C3EA3D3",
+	/* Part 3 */
+	"0791534874894310440A912143658709000012202280656080A0050003800503D46B76DBFD86C7E5"
+	"737ADD7EC7E7F5A0B0784C2E9BCFE8B47ACD6EBBDFF0B87C4EAFDBEFF8BC1E14168FC965F3199D56"
+	"AFD96DF71B1E97CFE975FB1D9FD783C2E231B96C3EA3D3EA35BBED7EC3E3F239BD6EBFE3F37A5058"
+	"3C2697CD67745ABD66B7DD6F785C3EA7D7ED777C5E0F0A8BC7E4B2F98C4EABD7ECB6FB0D8FCBE7F4"
+	"BAFD8ECFEB41",
+	/* Part 4 */
+	"0791534874894370440A912143658709000012202280656080A0050003800504C2E231B96C3EA3D3"
+	"EA35BBED7EC3E3F239BD6EBFE3F37A50583C2697CD67745ABD66B7DD6F785C3EA7D7ED777C5E0F0A"
+	"8BC7E4B2F98C4EABD7ECB6FB0D8FCBE7F4BAFD8ECFEB4161F1985C369FD169F59ADD76BFE171F99C"
+	"5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9FD3EBF63B3EAF0785C56372D97C46A7D56B"
+	"76DBFD86C7E5",
+	/* Part 5 */
+	"0791534874894310440A91214365870900001220228065608096050003800505E6F4BAFD8ECFEB41"
+	"61F1985C369FD169F59ADD76BFE171F99C5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9F"
+	"D3EBF63B3EAF0785C56372D97C46A7D56B76DBFD86C7E5737ADD7EC7E7F5A0B0784C2E9BCFE8B47A"
+	"CD6EBBDFF0B87C4EAFDBEFF8BC1E14168FC965F3199D56AFD96DF71B1E97CFE975FB1D9FD703",
+};
+
+#define ALPHABET "abcdefghijklmnopqrstuvwxyz "
+
+static const char expected_text[] =
+	/* Part 1 */
+	ALPHABET ALPHABET ALPHABET ALPHABET ALPHABET "abcdefghijklmnopqr"
+	/* Part 2 */
+	"stuvwxyz " ALPHABET ALPHABET ALPHABET ALPHABET ALPHABET "abcdefghi"
+	/* Part 3 */
+	"jklmnopqrstuvwxyz " ALPHABET ALPHABET ALPHABET ALPHABET ALPHABET
+	/* Part 4 */
+	ALPHABET ALPHABET ALPHABET ALPHABET ALPHABET "abcdefghijklmnopqr"
+	/* Part 5 */
+	"stuvwxyz " ALPHABET ALPHABET ALPHABET ALPHABET "abcdefghijklmnopqrstuvwxyz";
+
+/* UCS2 message in 2 parts, reference number 42. The surrogate pair of U+1F600 is split
+ * between the parts.
+ */
+static const char *const pdus_ucs2[] = {
+	"00440A912143658709000812202280656080880500032A020100480079007600E400E40020007000"
+	"E40069007600E400E4002020AC0021002000480079007600E400E40020007000E40069007600E400"
+	"E4002020AC0021002000480079007600E400E40020007000E40069007600E400E4002020AC002100"
+	"2000480079007600E400E40020007000E40069007600E400E4002020AC00210020D83D",
+	"00440A912143658709000812202280656080240500032A0202DE0000DC006E00EF006300F6006400"
+	"E90020271300200064006F006E0065",
+};
+
+static const char expected_text_ucs2[] =
+	"Hyv\xC3\xA4\xC3\xA4 p\xC3\xA4iv\xC3\xA4\xC3\xA4 \xE2\x82\xAC! "
+	"Hyv\xC3\xA4\xC3\xA4 p\xC3\xA4iv\xC3\xA4\xC3\xA4 \xE2\x82\xAC! "
+	"Hyv\xC3\xA4\xC3\xA4 p\xC3\xA4iv\xC3\xA4\xC3\xA4 \xE2\x82\xAC! "
+	"Hyv\xC3\xA4\xC3\xA4 p\xC3\xA4iv\xC3\xA4\xC3\xA4 \xE2\x82\xAC! "
+	"\xF0\x9F\x98\x80"
+	"\xC3\x9Cn\xC3\xAF" "c\xC3\xB6" "d\xC3\xA9 \xE2\x9C\x93 done";
+
+static struct sms_data received;
+static int received_count;
+static int test_handle;
+static char notif[512];
+
+static void sms_callback(struct sms_data *const data, void *context)
+{
+	TEST_ASSERT_EQUAL(SMS_TYPE_DELIVER, data->type);
+	TEST_ASSERT_LESS_OR_EQUAL(SMS_MAX_PAYLOAD_LEN, data->payload_len);
+
+	memcpy(&received, data, sizeof(received));
+	received_count++;
+}
+
+void setUp(void)
+{
+	memset(&received, 0, sizeof(received));
+	received_count = 0;
+
+	mock_nrf_modem_at_Init();
+}
+
+void tearDown(void)
+{
+	mock_nrf_modem_at_Verify();
+}
+
+static void sms_reg_helper(void)
+{
+	char resp[] = "+CNMI: 0,0,0,0,1\r\n";
+
+	__cmock_nrf_modem_at_cmd_ExpectAndReturn(NULL, 0, "AT+CNMI?", 0);
+	__cmock_nrf_modem_at_cmd_IgnoreArg_buf();
+	__cmock_nrf_modem_at_cmd_IgnoreArg_len();
+	__cmock_nrf_modem_at_cmd_ReturnArrayThruPtr_buf(resp, sizeof(resp));
+
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT+CNMI=3,2,0,1", 0);
+
+	test_handle = sms_register_listener(sms_callback, NULL);
+	TEST_ASSERT_EQUAL(0, test_handle);
+
+	/* Each received message is acknowledged with AT+CNMA=1. */
+	__cmock_nrf_modem_at_printf_IgnoreAndReturn(0);
+}
+
+static void sms_unreg_helper(void)
+{
+	/* Also drops the messages that have not been completely received. */
+	sms_unregister_listener(test_handle);
+	test_handle = -1;
+}
+
+static void hex_put(char *hex, uint8_t value)
+{
+	static const char digits[] = "0123456789ABCDEF";
+
+	hex[0] = digits[value >> 4];
+	hex[1] = digits[value & 0xF];
+}
+
+/* Receive a part, optionally with a different reference number. */
+static void recv_part(int seq, int ref)
+{
+	snprintf(notif, sizeof(notif), CMT_PREFIX "%s\r\n", pdus[seq - 1]);
+
+	if (ref >= 0) {
+		hex_put(&notif[strlen(CMT_PREFIX) + PDU_REF_OFFSET], ref);
+	}
+
+	at_monitor_dispatch(notif);
+}
+
+static void recv_ucs2_part(int seq)
+{
+	snprintf(notif, sizeof(notif), CMT_PREFIX "%s\r\n", pdus_ucs2[seq - 1]);
+	at_monitor_dispatch(notif);
+}
+
+static void assert_received_text(void)
+{
+	TEST_ASSERT_EQUAL(1, received_count);
+	TEST_ASSERT_EQUAL(strlen(expected_text), received.payload_len);
+	TEST_ASSERT_EQUAL_STRING(expected_text, received.payload);
+}
+
+/** Parts received in order are delivered as one message. */
+void test_concat_in_order(void)
+{
+	struct sms_deliver_header *header = &received.header.deliver;
+
+	sms_reg_helper();
+
+	for (int seq = 1; seq <= PARTS; seq++) {
+		TEST_ASSERT_EQUAL(0, received_count);
+		recv_part(seq, -1);
+	}
+
+	assert_received_text();
+
+	TEST_ASSERT_EQUAL_STRING("1234567890", header->originating_address.address_str);
+	TEST_ASSERT_TRUE(header->concatenated.present);
+	TEST_ASSERT_EQUAL(128, header->concatenated.ref_number);
+	TEST_ASSERT_EQUAL(PARTS, header->concatenated.total_msgs);
+	TEST_ASSERT_EQUAL(0, header->concatenated.seq_number);
+	/* Timestamp of the first part */
+	TEST_ASSERT_EQUAL(5, header->time.second);
+
+	sms_unreg_helper();
+}
+
+/** Parts received out of order, as in the recorded sequence. */
+void test_concat_out_of_order(void)
+{
+	static const int order[PARTS] = { 1, 4, 2, 3, 5 };
+
+	sms_reg_helper();
+
+	for (int i = 0; i < PARTS; i++) {
+		recv_part(order[i], -1);
+	}
+
+	assert_received_text();
+	TEST_ASSERT_EQUAL(5, received.header.deliver.time.second);
+
+	sms_unreg_helper();
+}
+
+/** A part that has already been received is ignored. */
+void test_concat_duplicate_part(void)
+{
+	sms_reg_helper();
+
+	recv_part(1, -1);
+	recv_part(3, -1);
+	recv_part(1, -1);
+	recv_part(3, -1);
+	recv_part(2, -1);
+	recv_part(4, -1);
+	recv_part(5, -1);
+
+	assert_received_text();
+
+	sms_unreg_helper();
+}
+
+/** Messages with different reference numbers are reassembled separately. */
+void test_concat_interleaved(void)
+{
+	sms_reg_helper();
+
+	for (int seq = PARTS; seq >= 1; seq--) {
+		recv_part(seq, 1);
+		recv_part(PARTS + 1 - seq, 2);
+	}
+
+	TEST_ASSERT_EQUAL(2, received_count);
+	TEST_ASSERT_EQUAL_STRING(expected_text, received.payload);
+
+	sms_unreg_helper();
+}
+
+/** The message that has waited the longest is dropped for a new one. */
+void test_concat_too_many_messages(void)
+{
+	sms_reg_helper();
+
+	recv_part(1, 1);
+	k_sleep(K_MSEC(10));
+	recv_part(1, 2);
+	k_sleep(K_MSEC(10));
+	/* Drops message 1 */
+	recv_part(1, 3);
+
+	for (int seq = 2; seq <= PARTS; seq++) {
+		recv_part(seq, 1);
+	}
+
+	TEST_ASSERT_EQUAL(0, received_count);
+
+	for (int seq = 2; seq <= PARTS; seq++) {
+		recv_part(seq, 3);
+	}
+
+	assert_received_text();
+
+	sms_unreg_helper();
+}
+
+/** A part is dropped when all part buffers are in use. */
+void test_concat_no_part_buffer(void)
+{
+	sms_reg_helper();
+
+	/* Parts 2 to 5 of message 1 take all part buffers. */
+	for (int seq = PARTS; seq >= 2; seq--) {
+		recv_part(seq, 1);
+	}
+
+	/* Dropped */
+	recv_part(3, 2);
+
+	recv_part(1, 1);
+	assert_received_text();
+
+	/* Message 2 is not completed until the dropped part is received again. */
+	recv_part(1, 2);
+	recv_part(2, 2);
+	recv_part(4, 2);
+	recv_part(5, 2);
+
+	TEST_ASSERT_EQUAL(1, received_count);
+
+	recv_part(3, 2);
+
+	TEST_ASSERT_EQUAL(2, received_count);
+	TEST_ASSERT_EQUAL_STRING(expected_text, received.payload);
+
+	sms_unreg_helper();
+}
+
+/** A message is dropped when its next part is not received in time. */
+void test_concat_timeout(void)
+{
+	sms_reg_helper();
+
+	recv_part(1, -1);
+	recv_part(2, -1);
+
+	k_sleep(K_MSEC(CONFIG_SMS_CONCAT_TIMEOUT_SEC * MSEC_PER_SEC + 100));
+
+	for (int seq = 3; seq <= PARTS; seq++) {
+		recv_part(seq, -1);
+	}
+
+	TEST_ASSERT_EQUAL(0, received_count);
+
+	/* The whole message is received again. */
+	recv_part(1, -1);
+	recv_part(2, -1);
+
+	assert_received_text();
+
+	sms_unreg_helper();
+}
+
+/** UCS2 is decoded into UTF-8, also when a surrogate pair is split between parts. */
+void test_concat_ucs2(void)
+{
+	sms_reg_helper();
+
+	recv_ucs2_part(2);
+	recv_ucs2_part(1);
+
+	TEST_ASSERT_EQUAL(1, received_count);
+	TEST_ASSERT_EQUAL(strlen(expected_text_ucs2), received.payload_len);
+	TEST_ASSERT_EQUAL_STRING(expected_text_ucs2, received.payload);
+
+	sms_unreg_helper();
+}
+
+/** Message that is not concatenated is delivered as it is. */
+void test_concat_single_message(void)
+{
+	sms_reg_helper();
+
+	at_monitor_dispatch("+CMT: \"+1234567890123\",22\r\n"
+		"0791534874894320040D91214365870921F300001220900285438003CD771A\r\n");
+
+	TEST_ASSERT_EQUAL(1, received_count);
+	TEST_ASSERT_EQUAL(3, received.payload_len);
+	TEST_ASSERT_EQUAL_STRING("Moi", received.payload);
+	TEST_ASSERT_FALSE(received.header.deliver.concatenated.present);
+
+	sms_unreg_helper();
+}
+
+/********* FUZZING AND STRESS ******************/
+
+static uint32_t prng_state = 0x12345678;
+
+static uint32_t prng(void)
+{
+	/* xorshift32 */
+	prng_state ^= prng_state << 13;
+	prng_state ^= prng_state >> 17;
+	prng_state ^= prng_state << 5;
+
+	return prng_state;
+}
+
+static bool next_permutation(int *order, int len)
+{
+	int i = len - 2;
+	int j = len - 1;
+	int tmp;
+
+	while (i >= 0 && order[i] >= order[i + 1]) {
+		i--;
+	}
+
+	if (i < 0) {
+		return false;
+	}
+
+	while (order[j] <= order[i]) {
+		j--;
+	}
+
+	tmp = order[i];
+	order[i] = order[j];
+	order[j] = tmp;
+
+	for (i++, j = len - 1; i < j; i++, j--) {
+		tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+
+	return true;
+}
+
+/**
+ * Receive the parts in every possible order, with a duplicate of an already received part
+ * injected at a random position before the last part.
+ */
+void test_concat_fuzz_order(void)
+{
+	int order[PARTS] = { 1, 2, 3, 4, 5 };
+	int permutations = 0;
+	int dup_pos;
+
+	sms_reg_helper();
+
+	do {
+		received_count = 0;
+		dup_pos = 1 + prng() % (PARTS - 1);
+
+		for (int i = 0; i < PARTS; i++) {
+			if (i == dup_pos) {
+				recv_part(order[prng() % dup_pos], -1);
+			}
+
+			recv_part(order[i], -1);
+		}
+
+		assert_received_text();
+		permutations++;
+	} while (next_permutation(order, PARTS));
+
+	TEST_ASSERT_EQUAL(120, permutations);
+
+	sms_unreg_helper();
+}
+
+/**
+ * Receive parts with random reference numbers, total numbers of parts and sequence numbers.
+ * There is no expected output, but delivered messages must fit the payload buffer.
+ * The message received at the end checks that the reassembly state stays consistent.
+ */
+void test_concat_fuzz_udh(void)
+{
+	char *udh;
+	int total;
+
+	sms_reg_helper();
+
+	for (int i = 0; i < 2000; i++) {
+		snprintf(notif, sizeof(notif), CMT_PREFIX "%s\r\n", pdus[prng() % PARTS]);
+		udh = &notif[strlen(CMT_PREFIX)];
+
+		/* Also invalid values, with which the concatenation information is ignored
+		 * by the parser or the message is too long to be reassembled.
+		 */
+		total = prng() % (CONFIG_SMS_CONCAT_MAX_PARTS + 3);
+		hex_put(&udh[PDU_REF_OFFSET], prng() % 4);
+		hex_put(&udh[PDU_TOTAL_OFFSET], total);
+		hex_put(&udh[PDU_SEQ_OFFSET], prng() % (total + 2));
+
+		at_monitor_dispatch(notif);
+	}
+
+	received_count = 0;
+
+	for (int seq = 1; seq <= PARTS; seq++) {
+		recv_part(seq, 200);
+	}
+
+	assert_received_text();
+
+	sms_unreg_helper();
+}
+
+/**
+ * Reassemble many messages with the first part received last, which is the worst case for
+ * the part buffers. Every message must be delivered.
+ */
+void test_concat_many_messages(void)
+{
+	const int rounds = 200;
+
+	sms_reg_helper();
+
+	for (int i = 0; i < rounds; i++) {
+		for (int seq = PARTS; seq >= 1; seq--) {
+			recv_part(seq, -1);
+		}
+	}
+
+	TEST_ASSERT_EQUAL(rounds, received_count);
+
+	sms_unreg_helper();
+}
+
+/* This is needed because AT Monitor library is initialized in SYS_INIT. */
+static int sms_test_sys_init(const struct device *unused)
+{
+	__cmock_nrf_modem_at_notif_handler_set_ExpectAnyArgsAndReturn(0);
+
+	return 0;
+}
+
+/* It is required to be added to each test. That is because unity is using
+ * different main signature (returns int) and zephyr expects main which does
+ * not return value.
+ */
+extern int unity_main(void);
+
+void main(void)
+{
+	(void)unity_main();
+}
+
+SYS_INIT(sms_test_sys_init, POST_KERNEL, 0);
@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+#include "asrc.h"
+
+#define SAMPLE_RATE_HZ 48000
+/* 10 ms frames, as from the LC3 decoder */
+#define FRAME_FRAMES 480
+/* Room for the extra output of the largest ratio offset */
+#define OUT_FRAMES_MAX (FRAME_FRAMES + 8)
+#define TEST_FRAMES_NUM 100
+/* -1 dBFS */
+#define TONE_AMPLITUDE (0.891f * INT16_MAX)
+
+static struct asrc_ctx ctx;
+static int16_t in_buf[FRAME_FRAMES * ASRC_CH_MAX];
+static int16_t out_buf[OUT_FRAMES_MAX * ASRC_CH_MAX];
+
+/* Least squares fit of a sine at a known frequency, and a DC offset, to the
+ * output. What the fit does not explain is noise and distortion. The sums
+ * are updated per sample, so the output does not have to be stored.
+ */
+struct sine_fit {
+	double w;
+	uint32_t n;
+	double xtx[3][3];
+	double xty[3];
+	double yty;
+};
+
+static void sine_fit_init(struct sine_fit *fit, double freq_hz)
+{
+	memset(fit, 0, sizeof(*fit));
+	fit->w = 2.0 * M_PI * freq_hz / SAMPLE_RATE_HZ;
+}
+
+static void sine_fit_add(struct sine_fit *fit, int16_t y)
+{
+	double x[3] = { sin(fit->w * fit->n), cos(fit->w * fit->n), 1.0 };
+
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			fit->xtx[i][j] += x[i] * x[j];
+		}
+		fit->xty[i] += x[i] * y;
+	}
+
+	fit->yty += (double)y * y;
+	fit->n++;
+}
+
+/* THD+N in dB, relative to the fitted sine */
+static double sine_fit_thd_n_db(struct sine_fit *fit)
+{
+	double a[3][4];
+	double beta[3];
+	double residual;
+	double signal;
+
+	for (int i = 0; i < 3; i++) {
+		memcpy(a[i], fit->xtx[i], sizeof(fit->xtx[i]));
+		a[i][3] = fit->xty[i];
+	}
+
+	/* Gaussian elimination. The matrix is well conditioned */
+	for (int i = 0; i < 3; i++) {
+		for (int k = i + 1; k < 3; k++) {
+			double f = a[k][i] / a[i][i];
+
+			for (int j = i; j < 4; j++) {
+				a[k][j] -= f * a[i][j];
+			}
+		}
+	}
+
+	for (int i = 2; i >= 0; i--) {
+		beta[i] = a[i][3];
+		for (int j = i + 1; j < 3; j++) {
+			beta[i] -= a[i][j] * beta[j];
+		}
+		beta[i] /= a[i][i];
+	}
+
+	residual = fit->yty;
+	for (int i = 0; i < 3; i++) {
+		residual -= beta[i] * fit->xty[i];
+	}
+
+	signal = (beta[0] * beta[0] + beta[1] * beta[1]) / 2.0 * fit->n;
+
+	return 10.0 * log10(residual / signal);
+}
+
+/* Stereo tone, with the right channel inverted. Returns the phase to
+ * continue from in the next frame.
+ */
+static double tone_frame_make(int16_t *buf, double phase, double freq_hz)
+{
+	double w = 2.0 * M_PI * freq_hz / SAMPLE_RATE_HZ;
+
+	for (int i = 0; i < FRAME_FRAMES; i++) {
+		int16_t val = lrint(TONE_AMPLITUDE * sin(phase));
+
+		buf[i * 2] = val;
+		buf[i * 2 + 1] = -val;
+		phase = fmod(phase + w, 2.0 * M_PI);
+	}
+
+	return phase;
+}
+
+static double thd_n_measure(double freq_hz, int32_t ppm)
+{
+	int ret;
+	size_t out_frames;
+	double phase = 0;
+	struct sine_fit fit;
+	/* Skip the start, where the history is silence */
+	uint32_t skip = ASRC_TAPS;
+
+	ret = asrc_init(&ctx, 2);
+	zassert_equal(ret, 0, "init did not return 0");
+	ret = asrc_ratio_set(&ctx, ppm);
+	zassert_equal(ret, 0, "ratio_set did not return 0");
+
+	/* Each output sample advances the input by the ratio, so the tone is
+	 * scaled up by the ratio at the output sample rate
+	 */
+	sine_fit_init(&fit, freq_hz * (1.0 + ppm / 1e6));
+
+	for (int f = 0; f < TEST_FRAMES_NUM; f++) {
+		phase = tone_frame_make(in_buf, phase, freq_hz);
+
+		ret = asrc_process(&ctx, in_buf, FRAME_FRAMES, out_buf, OUT_FRAMES_MAX,
+				   &out_frames);
+		zassert_equal(ret, 0, "process did not return 0");
+
+		for (size_t i = 0; i < out_frames; i++) {
+			zassert_equal(out_buf[i * 2], -out_buf[i * 2 + 1],
+				      "Channels are not converted the same");
+
+			if (skip) {
+				skip--;
+				/* Keep the time base of the fit */
+				fit.n++;
+				continue;
+			}
+
+			sine_fit_add(&fit, out_buf[i * 2]);
+		}
+	}
+
+	/* The samples skipped are not in the sums */
+	fit.n -= ASRC_TAPS;
+
+	return sine_fit_thd_n_db(&fit);
+}
+
+void test_init_invalid(void)
+{
+	int ret;
+
+	ret = asrc_init(NULL, 1);
+	zassert_equal(ret, -EINVAL, "NULL ctx did not return -EINVAL");
+
+	ret = asrc_init(&ctx, 0);
+	zassert_equal(ret, -EINVAL, "0 channels did not return -EINVAL");
+
+	ret = asrc_init(&ctx, ASRC_CH_MAX + 1);
+	zassert_equal(ret, -EINVAL, "Too many channels did not return -EINVAL");
+
+	ret = asrc_init(&ctx, 1);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	ret = asrc_ratio_set(&ctx, ASRC_PPM_MAX + 1);
+	zassert_equal(ret, -EINVAL, "Too high ratio did not return -EINVAL");
+
+	ret = asrc_ratio_set(&ctx, -ASRC_PPM_MAX - 1);
+	zassert_equal(ret, -EINVAL, "Too low ratio did not return -EINVAL");
+
+	ret = asrc_ratio_set(&ctx, ASRC_PPM_MAX);
+	zassert_equal(ret, 0, "ratio_set did not return 0");
+}
+
+void test_process_invalid(void)
+{
+	int ret;
+	size_t out_frames;
+
+	memset(&ctx, 0, sizeof(ctx));
+	ret = asrc_process(&ctx, in_buf, FRAME_FRAMES, out_buf, OUT_FRAMES_MAX, &out_frames);
+	zassert_equal(ret, -EINVAL, "Uninitialized ctx did not return -EINVAL");
+
+	ret = asrc_init(&ctx, 2);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	ret = asrc_process(&ctx, NULL, FRAME_FRAMES, out_buf, OUT_FRAMES_MAX, &out_frames);
+	zassert_equal(ret, -EINVAL, "NULL input did not return -EINVAL");
+
+	ret = asrc_process(&ctx, in_buf, FRAME_FRAMES, NULL, OUT_FRAMES_MAX, &out_frames);
+	zassert_equal(ret, -EINVAL, "NULL output did not return -EINVAL");
+
+	ret = asrc_process(&ctx, in_buf, ASRC_IN_FRAMES_MAX + 1, out_buf, OUT_FRAMES_MAX,
+			   &out_frames);
+	zassert_equal(ret, -EINVAL, "Too many input frames did not return -EINVAL");
+}
+
+void test_output_too_small(void)
+{
+	int ret;
+	size_t out_frames;
+
+	ret = asrc_init(&ctx, 2);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	ret = asrc_process(&ctx, in_buf, FRAME_FRAMES, out_buf, FRAME_FRAMES / 2, &out_frames);
+	zassert_equal(ret, -ENOMEM, "Too small output did not return -ENOMEM");
+	zassert_equal(out_frames, FRAME_FRAMES / 2, "Output was not filled");
+}
+
+void test_dc_unity_gain(void)
+{
+	int ret;
+	size_t out_frames;
+	uint32_t skip = ASRC_TAPS;
+
+	ret = asrc_init(&ctx, 1);
+	zassert_equal(ret, 0, "init did not return 0");
+	ret = asrc_ratio_set(&ctx, 321);
+	zassert_equal(ret, 0, "ratio_set did not return 0");
+
+	for (int i = 0; i < FRAME_FRAMES; i++) {
+		in_buf[i] = 12345;
+	}
+
+	for (int f = 0; f < 10; f++) {
+		ret = asrc_process(&ctx, in_buf, FRAME_FRAMES, out_buf, OUT_FRAMES_MAX,
+				   &out_frames);
+		zassert_equal(ret, 0, "process did not return 0");
+
+		for (size_t i = 0; i < out_frames; i++) {
+			if (skip) {
+				skip--;
+				continue;
+			}
+
+			zassert_equal(out_buf[i], 12345, "DC gain is not unity");
+		}
+	}
+}
+
+void test_output_rate(void)
+{
+	int ret;
+	size_t out_frames;
+	int32_t ppm[] = { 0, 1000, -1000, ASRC_PPM_MAX, -ASRC_PPM_MAX };
+
+	for (int p = 0; p < ARRAY_SIZE(ppm); p++) {
+		uint32_t total = 0;
+		uint32_t expected = (uint64_t)FRAME_FRAMES * TEST_FRAMES_NUM * 1000000 /
+				    (1000000 + ppm[p]);
+
+		ret = asrc_init(&ctx, 1);
+		zassert_equal(ret, 0, "init did not return 0");
+		ret = asrc_ratio_set(&ctx, ppm[p]);
+		zassert_equal(ret, 0, "ratio_set did not return 0");
+
+		for (int f = 0; f < TEST_FRAMES_NUM; f++) {
+			ret = asrc_process(&ctx, in_buf, FRAME_FRAMES, out_buf, OUT_FRAMES_MAX,
+					   &out_frames);
+			zassert_equal(ret, 0, "process did not return 0");
+			total += out_frames;
+		}
+
+		/* The output lags the input by the filter delay */
+		zassert_within(total + ASRC_DELAY_SAMPLES, expected, 2,
+			       "Wrong number of output frames %d at %d ppm", total, ppm[p]);
+	}
+}
+
+void test_next_pos(void)
+{
+	int ret;
+	size_t out_frames;
+
+	ret = asrc_init(&ctx, 1);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	ret = asrc_process(&ctx, in_buf, FRAME_FRAMES, out_buf, OUT_FRAMES_MAX, &out_frames);
+	zassert_equal(ret, 0, "process did not return 0");
+
+	/* The output lags the end of the input by the filter delay */
+	zassert_equal(out_frames, FRAME_FRAMES - ASRC_DELAY_SAMPLES,
+		      "Wrong number of output frames");
+	zassert_equal(asrc_next_pos_get(&ctx), -((int64_t)ASRC_DELAY_SAMPLES << 32),
+		      "Wrong position of next output");
+	zassert_equal(asrc_step_get(&ctx), 1LL << 32, "Ratio is not 1.0");
+}
+
+void test_thd_n(void)
+{
+	double freq_hz[] = { 1000, 10000 };
+	int32_t ppm[] = { 0, 100, -100, 1000, -1000, ASRC_PPM_MAX };
+	double thd_n;
+
+	for (int f = 0; f < ARRAY_SIZE(freq_hz); f++) {
+		for (int p = 0; p < ARRAY_SIZE(ppm); p++) {
+			thd_n = thd_n_measure(freq_hz[f], ppm[p]);
+
+			TC_PRINT("THD+N at %d Hz, %d ppm: %d.%d dB\n", (int)freq_hz[f], ppm[p],
+				 (int)thd_n, abs((int)(thd_n * 10) % 10));
+			zassert_true(thd_n < -80.0, "THD+N too high");
+		}
+	}
+}
+
+void test_ratio_change_continuous(void)
+{
+	int ret;
+	size_t out_frames;
+	double phase = 0;
+	int16_t prev = 0;
+	uint32_t skip = ASRC_TAPS;
+	/* Largest change between two samples of the tone, with margin for the
+	 * ratio and rounding
+	 */
+	int32_t max_step = TONE_AMPLITUDE * 2.0 * M_PI * 1000 / SAMPLE_RATE_HZ * 1.02 + 2;
+
+	ret = asrc_init(&ctx, 2);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	for (int f = 0; f < TEST_FRAMES_NUM; f++) {
+		ret = asrc_ratio_set(&ctx, (f % 2) ? ASRC_PPM_MAX : -ASRC_PPM_MAX);
+		zassert_equal(ret, 0, "ratio_set did not return 0");
+
+		phase = tone_frame_make(in_buf, phase, 1000);
+
+		ret = asrc_process(&ctx, in_buf, FRAME_FRAMES, out_buf, OUT_FRAMES_MAX,
+				   &out_frames);
+		zassert_equal(ret, 0, "process did not return 0");
+
+		for (size_t i = 0; i < out_frames; i++) {
+			if (skip) {
+				skip--;
+			} else {
+				zassert_true(abs(out_buf[i * 2] - prev) <= max_step,
+					     "Discontinuity after ratio change");
+			}
+
+			prev = out_buf[i * 2];
+		}
+	}
+}
+
+void test_benchmark(void)
+{
+	int ret;
+	size_t out_frames;
+	uint32_t start;
+	uint32_t cycles;
+	uint32_t frame_cycles = sys_clock_hw_cycles_per_sec() / (SAMPLE_RATE_HZ / FRAME_FRAMES);
+
+	ret = asrc_init(&ctx, 2);
+	zassert_equal(ret, 0, "init did not return 0");
+	ret = asrc_ratio_set(&ctx, 100);
+	zassert_equal(ret, 0, "ratio_set did not return 0");
+
+	(void)tone_frame_make(in_buf, 0, 1000);
+
+	start = k_cycle_get_32();
+	for (int f = 0; f < TEST_FRAMES_NUM; f++) {
+		(void)asrc_process(&ctx, in_buf, FRAME_FRAMES, out_buf, OUT_FRAMES_MAX,
+				   &out_frames);
+	}
+	cycles = (k_cycle_get_32() - start) / TEST_FRAMES_NUM;
+
+	TC_PRINT("Stereo 10 ms frame: %u cycles, %u permille of real time\n", cycles,
+		 (uint32_t)((uint64_t)cycles * 1000 / frame_cycles));
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_suite_asrc,
+		ztest_unit_test(test_init_invalid),
+		ztest_unit_test(test_process_invalid),
+		ztest_unit_test(test_output_too_small),
+		ztest_unit_test(test_dc_unity_gain),
+		ztest_unit_test(test_output_rate),
+		ztest_unit_test(test_next_pos),
+		ztest_unit_test(test_thd_n),
+		ztest_unit_test(test_ratio_change_continuous),
+		ztest_unit_test(test_benchmark)
+	);
+
+	ztest_run_test_suite(test_suite_asrc);
+}
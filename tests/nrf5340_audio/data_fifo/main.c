@@ -6,8 +6,11 @@
 
 #include <zephyr/ztest.h>
 #include <errno.h>
+#include <string.h>
 #include "data_fifo.h"
 
+#define BENCHMARK_ITERATIONS 10000
+
 /* Catch asserts to fail test */
 void assert_post_action(const char *file, unsigned int line)
 {
@@ -189,13 +192,376 @@ void test_data_fifo_data_put_size_zero(void)
 	zassert_equal(ret, -EINVAL, "block_lock did not return -EINVAL");
 }
 
+void test_data_fifo_free_out_of_order(void)
+{
+	DATA_FIFO_DEFINE(data_fifo, 3, 16);
+
+	int ret;
+	void *data_ptr[3];
+	void *data_ptr_read[2];
+	size_t data_size;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(data_ptr); i++) {
+		ret = data_fifo_pointer_first_vacant_get(&data_fifo, &data_ptr[i], K_NO_WAIT);
+		zassert_equal(ret, 0, "first_vacant_get did not return 0");
+		ret = data_fifo_block_lock(&data_fifo, &data_ptr[i], 1);
+		zassert_equal(ret, 0, "block_lock did not return 0");
+	}
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(data_ptr_read); i++) {
+		ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_read[i], &data_size,
+							K_NO_WAIT);
+		zassert_equal(ret, 0, "_last_filled_get did not return 0");
+		zassert_equal(data_ptr_read[i], data_ptr[i], "blocks not read in order");
+	}
+
+	internal_test_remaining_elements(&data_fifo, 3, 1, __LINE__);
+
+	/* Free the newest of the read blocks first, it is the one alloced again */
+	data_fifo_block_free(&data_fifo, &data_ptr_read[1]);
+
+	internal_test_remaining_elements(&data_fifo, 2, 1, __LINE__);
+
+	ret = data_fifo_pointer_first_vacant_get(&data_fifo, &data_ptr[0], K_NO_WAIT);
+	zassert_equal(ret, 0, "first_vacant_get did not return 0");
+	zassert_equal(data_ptr[0], data_ptr[1], "freed block was not alloced");
+
+	ret = data_fifo_pointer_first_vacant_get(&data_fifo, &data_ptr[1], K_NO_WAIT);
+	zassert_equal(ret, -ENOMEM, "first_vacant_get did not return -ENOMEM");
+
+	data_fifo_block_free(&data_fifo, &data_ptr_read[0]);
+	data_fifo_block_free(&data_fifo, &data_ptr[0]);
+
+	internal_test_remaining_elements(&data_fifo, 1, 1, __LINE__);
+}
+
+/* The I2S and BLE RX producers drop the oldest block when the FIFO is full,
+ * also while the consumer holds a block it has read
+ */
+void test_data_fifo_overrun_drop_oldest(void)
+{
+#define OVERRUN_BLOCKS_NUM 4
+	DATA_FIFO_DEFINE(data_fifo, OVERRUN_BLOCKS_NUM, 16);
+
+	int ret;
+	uint8_t *data_ptr;
+	void *data_ptr_held;
+	void *data_ptr_read;
+	size_t data_size;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	for (uint8_t i = 0; i < OVERRUN_BLOCKS_NUM; i++) {
+		ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr, K_NO_WAIT);
+		zassert_equal(ret, 0, "first_vacant_get did not return 0");
+		data_ptr[0] = i;
+		ret = data_fifo_block_lock(&data_fifo, (void **)&data_ptr, 1);
+		zassert_equal(ret, 0, "block_lock did not return 0");
+	}
+
+	/* Consumer holds the oldest block */
+	ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_held, &data_size, K_NO_WAIT);
+	zassert_equal(ret, 0, "_last_filled_get did not return 0");
+
+	/* Producer drops the oldest remaining block to make space */
+	ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_read, &data_size, K_NO_WAIT);
+	zassert_equal(ret, 0, "_last_filled_get did not return 0");
+	zassert_equal(((uint8_t *)data_ptr_read)[0], 1, "wrong block dropped");
+	data_fifo_block_free(&data_fifo, &data_ptr_read);
+
+	ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr, K_NO_WAIT);
+	zassert_equal(ret, 0, "first_vacant_get did not return 0");
+	data_ptr[0] = OVERRUN_BLOCKS_NUM;
+	ret = data_fifo_block_lock(&data_fifo, (void **)&data_ptr, 1);
+	zassert_equal(ret, 0, "block_lock did not return 0");
+
+	data_fifo_block_free(&data_fifo, &data_ptr_held);
+
+	internal_test_remaining_elements(&data_fifo, OVERRUN_BLOCKS_NUM - 1,
+					 OVERRUN_BLOCKS_NUM - 1, __LINE__);
+
+	for (uint8_t i = 2; i <= OVERRUN_BLOCKS_NUM; i++) {
+		ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_read, &data_size,
+							K_NO_WAIT);
+		zassert_equal(ret, 0, "_last_filled_get did not return 0");
+		zassert_equal(((uint8_t *)data_ptr_read)[0], i, "blocks not read in order");
+		data_fifo_block_free(&data_fifo, &data_ptr_read);
+	}
+
+	internal_test_remaining_elements(&data_fifo, 0, 0, __LINE__);
+}
+
+void test_data_fifo_wrap_around(void)
+{
+	/* Not a power of two, so the ring wraps at a multiple of the size */
+	DATA_FIFO_DEFINE(data_fifo, 5, 4);
+
+	int ret;
+	uint32_t *data_ptr;
+	void *data_ptr_read;
+	size_t data_size;
+	uint32_t written = 0;
+	uint32_t read = 0;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	/* Vary the fill level, so the ring is read and written at all offsets */
+	for (uint32_t i = 0; i < 100; i++) {
+		uint32_t num = (i % 5) + 1;
+
+		for (uint32_t j = 0; j < num; j++) {
+			ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr,
+								 K_NO_WAIT);
+			zassert_equal(ret, 0, "first_vacant_get did not return 0");
+			*data_ptr = written++;
+			ret = data_fifo_block_lock(&data_fifo, (void **)&data_ptr,
+						   sizeof(*data_ptr));
+			zassert_equal(ret, 0, "block_lock did not return 0");
+		}
+
+		internal_test_remaining_elements(&data_fifo, num, num, __LINE__);
+
+		for (uint32_t j = 0; j < num; j++) {
+			ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_read,
+								&data_size, K_NO_WAIT);
+			zassert_equal(ret, 0, "_last_filled_get did not return 0");
+			zassert_equal(*(uint32_t *)data_ptr_read, read++, "blocks not in order");
+			data_fifo_block_free(&data_fifo, &data_ptr_read);
+		}
+	}
+
+	ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_read, &data_size, K_NO_WAIT);
+	zassert_equal(ret, -ENOMSG, "_last_filled_get did not return -ENOMSG");
+}
+
+void test_data_fifo_empty(void)
+{
+	DATA_FIFO_DEFINE(data_fifo, 4, 16);
+
+	int ret;
+	void *data_ptr;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	for (uint32_t i = 0; i < 3; i++) {
+		ret = data_fifo_pointer_first_vacant_get(&data_fifo, &data_ptr, K_NO_WAIT);
+		zassert_equal(ret, 0, "first_vacant_get did not return 0");
+	}
+
+	/* The last block stays alloced, like an I2S buffer in use */
+	ret = data_fifo_block_lock(&data_fifo, &data_ptr, 1);
+	zassert_equal(ret, 0, "block_lock did not return 0");
+
+	internal_test_remaining_elements(&data_fifo, 3, 1, __LINE__);
+
+	ret = data_fifo_empty(&data_fifo);
+	zassert_equal(ret, 0, "empty did not return 0");
+
+	internal_test_remaining_elements(&data_fifo, 0, 0, __LINE__);
+
+	for (uint32_t i = 0; i < 4; i++) {
+		ret = data_fifo_pointer_first_vacant_get(&data_fifo, &data_ptr, K_NO_WAIT);
+		zassert_equal(ret, 0, "first_vacant_get did not return 0");
+	}
+}
+
+DATA_FIFO_DEFINE(timer_fifo, 2, 16);
+static void *timer_block;
+static int timer_ret;
+
+static void timer_produce(struct k_timer *timer)
+{
+	void *data_ptr;
+
+	timer_ret = data_fifo_pointer_first_vacant_get(&timer_fifo, &data_ptr, K_NO_WAIT);
+	if (timer_ret == 0) {
+		timer_ret = data_fifo_block_lock(&timer_fifo, &data_ptr, 1);
+	}
+}
+
+static void timer_free(struct k_timer *timer)
+{
+	data_fifo_block_free(&timer_fifo, &timer_block);
+}
+
+K_TIMER_DEFINE(produce_timer, timer_produce, NULL);
+K_TIMER_DEFINE(free_timer, timer_free, NULL);
+
+void test_data_fifo_wait(void)
+{
+	int ret;
+	void *data_ptr;
+	void *data_ptr_read;
+	size_t data_size;
+
+	ret = data_fifo_init(&timer_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	ret = data_fifo_pointer_last_filled_get(&timer_fifo, &data_ptr_read, &data_size,
+						K_MSEC(10));
+	zassert_equal(ret, -EAGAIN, "_last_filled_get did not time out");
+
+	/* Consumer waits for a block locked from an ISR */
+	k_timer_start(&produce_timer, K_MSEC(10), K_NO_WAIT);
+	ret = data_fifo_pointer_last_filled_get(&timer_fifo, &data_ptr_read, &data_size,
+						K_FOREVER);
+	zassert_equal(ret, 0, "_last_filled_get did not return 0");
+	zassert_equal(timer_ret, 0, "producing from ISR failed");
+	zassert_equal(data_size, 1, "data size incorrect");
+
+	ret = data_fifo_pointer_first_vacant_get(&timer_fifo, &data_ptr, K_NO_WAIT);
+	zassert_equal(ret, 0, "first_vacant_get did not return 0");
+
+	ret = data_fifo_pointer_first_vacant_get(&timer_fifo, &data_ptr, K_MSEC(10));
+	zassert_equal(ret, -EAGAIN, "first_vacant_get did not time out");
+
+	/* Producer waits for a block freed from an ISR */
+	timer_block = data_ptr_read;
+	k_timer_start(&free_timer, K_MSEC(10), K_NO_WAIT);
+	ret = data_fifo_pointer_first_vacant_get(&timer_fifo, &data_ptr, K_FOREVER);
+	zassert_equal(ret, 0, "first_vacant_get did not return 0");
+	zassert_equal(data_ptr, data_ptr_read, "freed block was not alloced");
+
+	internal_test_remaining_elements(&timer_fifo, 2, 0, __LINE__);
+}
+
+/* The FIFO as it was before the lock-free ring, with a memory slab for the
+ * blocks and a message queue for the filled ones. Used as the benchmark
+ * reference.
+ */
+struct ref_fifo {
+	struct k_mem_slab mem_slab;
+	struct k_msgq msgq;
+	struct k_spinlock lock;
+};
+
+static int ref_fifo_num_used_get(struct ref_fifo *ref, uint32_t *alloced_num,
+				 uint32_t *locked_num)
+{
+	k_spinlock_key_t key = k_spin_lock(&ref->lock);
+
+	*locked_num = k_msgq_num_used_get(&ref->msgq);
+	*alloced_num = k_mem_slab_num_used_get(&ref->mem_slab);
+
+	k_spin_unlock(&ref->lock, key);
+
+	return (*alloced_num < *locked_num) ? -EACCES : 0;
+}
+
+static uint32_t ops_per_sec(uint32_t cycles)
+{
+	return (uint64_t)BENCHMARK_ITERATIONS * sys_clock_hw_cycles_per_sec() / MAX(cycles, 1);
+}
+
+/* An operation is one block through the FIFO, as done for every I2S block:
+ * alloc, lock, read and free. A query is one fill level read, as done by
+ * drift compensation and the overrun checks.
+ */
+void test_data_fifo_benchmark(void)
+{
+#define BENCHMARK_BLOCKS_NUM 10
+#define BENCHMARK_BLOCK_SIZE 16
+	static char __aligned(WB_UP(1))
+		ref_slab_buffer[BENCHMARK_BLOCKS_NUM * BENCHMARK_BLOCK_SIZE];
+	static char __aligned(WB_UP(1))
+		ref_msgq_buffer[BENCHMARK_BLOCKS_NUM * sizeof(struct data_fifo_msgq)];
+	static struct ref_fifo ref;
+	DATA_FIFO_DEFINE(data_fifo, BENCHMARK_BLOCKS_NUM, BENCHMARK_BLOCK_SIZE);
+
+	struct data_fifo_msgq msg;
+	uint32_t alloced_num;
+	uint32_t locked_num;
+	uint32_t cycles_ref;
+	uint32_t cycles_ring;
+	uint32_t start;
+	void *data_ptr;
+	size_t data_size;
+	int ret;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	ret = k_mem_slab_init(&ref.mem_slab, ref_slab_buffer, BENCHMARK_BLOCK_SIZE,
+			      BENCHMARK_BLOCKS_NUM);
+	zassert_equal(ret, 0, "slab init did not return 0");
+	k_msgq_init(&ref.msgq, ref_msgq_buffer, sizeof(struct data_fifo_msgq),
+		    BENCHMARK_BLOCKS_NUM);
+
+	/* Keep the FIFOs half full, as in streaming */
+	for (uint32_t i = 0; i < BENCHMARK_BLOCKS_NUM / 2; i++) {
+		ret = data_fifo_pointer_first_vacant_get(&data_fifo, &data_ptr, K_NO_WAIT);
+		zassert_equal(ret, 0, "first_vacant_get did not return 0");
+		ret = data_fifo_block_lock(&data_fifo, &data_ptr, BENCHMARK_BLOCK_SIZE);
+		zassert_equal(ret, 0, "block_lock did not return 0");
+
+		ret = k_mem_slab_alloc(&ref.mem_slab, &msg.block_ptr, K_NO_WAIT);
+		zassert_equal(ret, 0, "slab alloc did not return 0");
+		msg.size = BENCHMARK_BLOCK_SIZE;
+		ret = k_msgq_put(&ref.msgq, &msg, K_NO_WAIT);
+		zassert_equal(ret, 0, "msgq put did not return 0");
+	}
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		(void)k_mem_slab_alloc(&ref.mem_slab, &msg.block_ptr, K_NO_WAIT);
+		msg.size = BENCHMARK_BLOCK_SIZE;
+		(void)k_msgq_put(&ref.msgq, &msg, K_NO_WAIT);
+		(void)k_msgq_get(&ref.msgq, &msg, K_NO_WAIT);
+		k_mem_slab_free(&ref.mem_slab, &msg.block_ptr);
+	}
+	cycles_ref = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		(void)data_fifo_pointer_first_vacant_get(&data_fifo, &data_ptr, K_NO_WAIT);
+		(void)data_fifo_block_lock(&data_fifo, &data_ptr, BENCHMARK_BLOCK_SIZE);
+		(void)data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr, &data_size,
+							K_NO_WAIT);
+		data_fifo_block_free(&data_fifo, &data_ptr);
+	}
+	cycles_ring = k_cycle_get_32() - start;
+
+	internal_test_remaining_elements(&data_fifo, BENCHMARK_BLOCKS_NUM / 2,
+					 BENCHMARK_BLOCKS_NUM / 2, __LINE__);
+
+	TC_PRINT("Block ops/s: slab and msgq %u, ring %u\n", ops_per_sec(cycles_ref),
+		 ops_per_sec(cycles_ring));
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		(void)ref_fifo_num_used_get(&ref, &alloced_num, &locked_num);
+	}
+	cycles_ref = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		(void)data_fifo_num_used_get(&data_fifo, &alloced_num, &locked_num);
+	}
+	cycles_ring = k_cycle_get_32() - start;
+
+	TC_PRINT("Fill queries/s: slab and msgq %u, ring %u\n", ops_per_sec(cycles_ref),
+		 ops_per_sec(cycles_ring));
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_suite_data_fifo, ztest_unit_test(test_data_fifo_init_ok),
 			 ztest_unit_test(test_data_fifo_data_put_get_ok),
 			 ztest_unit_test(test_data_fifo_data_put_too_many),
 			 ztest_unit_test(test_data_fifo_data_put_too_much_data),
-			 ztest_unit_test(test_data_fifo_data_put_size_zero));
+			 ztest_unit_test(test_data_fifo_data_put_size_zero),
+			 ztest_unit_test(test_data_fifo_free_out_of_order),
+			 ztest_unit_test(test_data_fifo_overrun_drop_oldest),
+			 ztest_unit_test(test_data_fifo_wrap_around),
+			 ztest_unit_test(test_data_fifo_empty),
+			 ztest_unit_test(test_data_fifo_wait),
+			 ztest_unit_test(test_data_fifo_benchmark));
 
 	ztest_run_test_suite(test_suite_data_fifo);
 }
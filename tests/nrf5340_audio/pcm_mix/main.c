@@ -6,6 +6,7 @@
 
 #include <zephyr/ztest.h>
 #include <errno.h>
+#include <string.h>
 #include "pcm_mix.h"
 
 #define ZEQ(a, b) zassert_equal(a, b, "fail")
@@ -127,6 +128,208 @@ void test_mono_into_stereo_r(void)
 	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
 }
 
+void test_clip_count(void)
+{
+	int ret;
+	int16_t sample_a[] = { INT16_MAX, INT16_MIN, 100, INT16_MAX };
+	int16_t sample_b[] = { 1, -1, 10, 0 };
+	int16_t sample_r[] = { INT16_MAX, INT16_MIN, 110, INT16_MAX };
+
+	pcm_mix_clip_count_get(true);
+
+	ret = pcm_mix(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b), B_MONO_INTO_A_MONO);
+	ZEQ(ret, 0);
+
+	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
+	ZEQ(pcm_mix_clip_count_get(false), 2);
+	ZEQ(pcm_mix_clip_count_get(true), 2);
+	ZEQ(pcm_mix_clip_count_get(false), 0);
+}
+
+void test_odd_sample_count(void)
+{
+	int ret;
+	int16_t sample_a[] = { 1, 2, 3, 4, 5 };
+	int16_t sample_b[] = { 10, 20, 30 };
+	int16_t sample_r[] = { 11, 22, 33, 4, 5 };
+
+	ret = pcm_mix(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b), B_MONO_INTO_A_MONO);
+	ZEQ(ret, 0);
+
+	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
+}
+
+void test_size_checked_before_mixing(void)
+{
+	int ret;
+	int16_t sample_a[] = { 10, 10, 10, 10 };
+	int16_t sample_b[] = { 1, 1, 1 };
+	int16_t sample_r[] = { 10, 10, 10, 10 };
+
+	ret = pcm_mix(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+		      B_MONO_INTO_A_STEREO_L);
+	ZEQ(ret, -EPERM);
+	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
+
+	ret = pcm_mix(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+		      B_MONO_INTO_A_STEREO_R);
+	ZEQ(ret, -EPERM);
+	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
+
+	/* Not a whole number of samples */
+	ret = pcm_mix(sample_a, sizeof(sample_a), sample_b, 3, B_MONO_INTO_A_MONO);
+	ZEQ(ret, -EINVAL);
+	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
+}
+
+void test_gain(void)
+{
+	int ret;
+	int16_t sample_a[] = { 100, 100, 100, 100 };
+	int16_t sample_b[] = { 1000, -1000 };
+	int16_t sample_r[] = { 350, 350, -150, -150 };
+
+	ret = pcm_mix_gain(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+			   B_MONO_INTO_A_STEREO_LR, 16, PCM_MIX_GAIN_UNITY / 4);
+	ZEQ(ret, 0);
+	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
+
+	/* Zero gain leaves A unchanged */
+	ret = pcm_mix_gain(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+			   B_MONO_INTO_A_STEREO_LR, 16, 0);
+	ZEQ(ret, 0);
+	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
+
+	ret = pcm_mix_gain(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+			   B_MONO_INTO_A_STEREO_LR, 16, PCM_MIX_GAIN_UNITY + 1);
+	ZEQ(ret, -EINVAL);
+	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
+}
+
+void test_32_bit(void)
+{
+	int ret;
+	int32_t sample_a[] = { INT32_MAX - 1, INT32_MIN + 1, 5, -5 };
+	int32_t sample_b[] = { 10, 10 };
+	int32_t sample_r[] = { INT32_MAX, INT32_MIN + 1, 15, -5 };
+
+	pcm_mix_clip_count_get(true);
+
+	ret = pcm_mix_gain(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+			   B_MONO_INTO_A_STEREO_L, 32, PCM_MIX_GAIN_UNITY);
+	ZEQ(ret, 0);
+
+	zassert_mem_equal(sample_a, sample_r, sizeof(sample_r), "fail");
+	ZEQ(pcm_mix_clip_count_get(true), 1);
+}
+
+void test_24_bit(void)
+{
+	int ret;
+	/* Packed little endian: 0x7FFFFE, -5, 0x000100 */
+	uint8_t sample_a[] = { 0xFE, 0xFF, 0x7F, 0xFB, 0xFF, 0xFF, 0x00, 0x01, 0x00 };
+	/* 16, 2, -0x800000 */
+	uint8_t sample_b[] = { 0x10, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x80 };
+	/* Clipped to 0x7FFFFF, -3, -0x7FFF00 */
+	uint8_t sample_r[] = { 0xFF, 0xFF, 0x7F, 0xFD, 0xFF, 0xFF, 0x00, 0x01, 0x80 };
+
+	pcm_mix_clip_count_get(true);
+
+	ret = pcm_mix_gain(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+			   B_MONO_INTO_A_MONO, 24, PCM_MIX_GAIN_UNITY);
+	ZEQ(ret, 0);
+
+	zassert_mem_equal(sample_a, sample_r, sizeof(sample_r), "fail");
+	ZEQ(pcm_mix_clip_count_get(true), 1);
+
+	ret = pcm_mix_gain(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+			   B_MONO_INTO_A_MONO, 20, PCM_MIX_GAIN_UNITY);
+	ZEQ(ret, -EINVAL);
+}
+
+/* The mixer as it was before, one sample at a time */
+static void reference_mix(int16_t *pcm_a, int16_t const *pcm_b, size_t samples_b,
+			  enum pcm_mix_mode mix_mode)
+{
+	int32_t res;
+	size_t idx;
+
+	for (size_t i = 0; i < samples_b; i++) {
+		for (int ch = 0; ch < 2; ch++) {
+			if ((mix_mode == B_MONO_INTO_A_STEREO_L && ch == 1) ||
+			    (mix_mode == B_MONO_INTO_A_STEREO_R && ch == 0) ||
+			    (mix_mode == B_MONO_INTO_A_MONO && ch == 1)) {
+				continue;
+			}
+
+			idx = (mix_mode == B_MONO_INTO_A_MONO) ? i : i * 2 + ch;
+			res = pcm_a[idx] + pcm_b[i];
+			if (res < INT16_MIN) {
+				res = INT16_MIN;
+			} else if (res > INT16_MAX) {
+				res = INT16_MAX;
+			}
+			pcm_a[idx] = (int16_t)res;
+		}
+	}
+}
+
+/* One 10 ms frame of 48 kHz audio */
+#define BENCH_FRAMES 480
+#define BENCH_ROUNDS 100
+
+static int16_t bench_a[BENCH_FRAMES * 2];
+static int16_t bench_ref[BENCH_FRAMES * 2];
+static int16_t bench_b[BENCH_FRAMES * 2];
+
+static void bench_fill(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(bench_a); i++) {
+		/* Loud enough to clip now and then */
+		bench_a[i] = (int16_t)(i * 7919);
+		bench_b[i] = (int16_t)(i * 104729) / 4;
+	}
+
+	memcpy(bench_ref, bench_a, sizeof(bench_ref));
+}
+
+static void bench_mode(enum pcm_mix_mode mix_mode, const char *name)
+{
+	size_t samples_b = (mix_mode == B_MONO_INTO_A_MONO) ? BENCH_FRAMES * 2 : BENCH_FRAMES;
+	uint32_t ref_cycles;
+	uint32_t mix_cycles;
+	uint32_t start;
+	int ret;
+
+	bench_fill();
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCH_ROUNDS; i++) {
+		reference_mix(bench_ref, bench_b, samples_b, mix_mode);
+	}
+	ref_cycles = (k_cycle_get_32() - start) / BENCH_ROUNDS;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCH_ROUNDS; i++) {
+		ret = pcm_mix(bench_a, sizeof(bench_a), bench_b, samples_b * sizeof(int16_t),
+			      mix_mode);
+	}
+	mix_cycles = (k_cycle_get_32() - start) / BENCH_ROUNDS;
+
+	ZEQ(ret, 0);
+	verify_array_eq(bench_a, bench_ref, ARRAY_SIZE(bench_a));
+
+	TC_PRINT("%-10s reference %6u cycles, pcm_mix %6u cycles per frame\n", name, ref_cycles,
+		 mix_cycles);
+}
+
+void test_benchmark(void)
+{
+	bench_mode(B_MONO_INTO_A_MONO, "mono");
+	bench_mode(B_MONO_INTO_A_STEREO_LR, "mono->LR");
+	bench_mode(B_MONO_INTO_A_STEREO_L, "mono->L");
+	TC_PRINT("Clipped samples: %u\n", pcm_mix_clip_count_get(true));
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_suite_pcm_mix,
@@ -137,7 +340,14 @@ void test_main(void)
 		ztest_unit_test(test_high_values),
 		ztest_unit_test(test_mono_into_stereo_lr),
 		ztest_unit_test(test_mono_into_stereo_l),
-		ztest_unit_test(test_mono_into_stereo_r)
+		ztest_unit_test(test_mono_into_stereo_r),
+		ztest_unit_test(test_clip_count),
+		ztest_unit_test(test_odd_sample_count),
+		ztest_unit_test(test_size_checked_before_mixing),
+		ztest_unit_test(test_gain),
+		ztest_unit_test(test_32_bit),
+		ztest_unit_test(test_24_bit),
+		ztest_unit_test(test_benchmark)
 	);
 
 	ztest_run_test_suite(test_suite_pcm_mix);
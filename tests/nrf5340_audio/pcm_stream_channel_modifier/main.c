@@ -6,6 +6,7 @@
 
 #include <zephyr/ztest.h>
 #include <errno.h>
+#include <string.h>
 #include "pcm_stream_channel_modifier.h"
 
 #define ZEQ(a, b) zassert_equal(b, a, "fail")
@@ -301,6 +302,163 @@ void test_pscm_two_channel_split_32(void)
 	verify_array_eq(right_test_list, stereo_split_right_32, output_size);
 }
 
+void test_pscm_strided_copy(void)
+{
+	uint16_t input[] = { 1, 2, 3, 4, 5, 6 };
+	uint16_t output[] = { 0, 0, 0, 0, 0, 0 };
+	uint16_t every_other[] = { 1, 0, 3, 0, 5, 0 };
+	uint16_t odd_samples[] = { 1, 3, 5, 0, 5, 0 };
+	int ret;
+
+	/* Input stride */
+	ret = pscm_strided_copy(input, 2, 3, 16, output, 2);
+	ZEQ(ret, 0);
+	verify_array_eq(output, every_other, sizeof(output));
+
+	/* Output stride, in place */
+	ret = pscm_strided_copy(output, 2, 3, 16, output, 1);
+	ZEQ(ret, 0);
+	verify_array_eq(output, odd_samples, sizeof(output));
+
+	ret = pscm_strided_copy(input, 0, 3, 16, output, 1);
+	ZEQ(ret, -EINVAL);
+
+	ret = pscm_strided_copy(input, 1, 3, 20, output, 1);
+	ZEQ(ret, -EINVAL);
+}
+
+void test_pscm_invalid_channel(void)
+{
+	uint8_t output[sizeof(unpadded_left) * 2] = { 0 };
+	uint8_t zeros[sizeof(output)] = { 0 };
+	size_t output_size;
+	int ret;
+
+	ret = pscm_zero_pad(unpadded_left, sizeof(unpadded_left), AUDIO_CH_NUM, 16, output,
+			    &output_size);
+	ZEQ(ret, -EINVAL);
+	verify_array_eq(output, zeros, sizeof(output));
+
+	ret = pscm_one_channel_split(stereo_split, sizeof(stereo_split), AUDIO_CH_NUM, 16, output,
+				     &output_size);
+	ZEQ(ret, -EINVAL);
+	verify_array_eq(output, zeros, sizeof(output));
+}
+
+/* One 10 ms frame of 48 kHz, 16-bit stereo audio */
+#define FRAME_DURATION_US 10000
+#define FRAME_SAMPLES_MONO 480
+#define FRAME_BYTES_MONO (FRAME_SAMPLES_MONO * 2)
+#define FRAME_ROUNDS 100
+
+static uint8_t frame_stereo[FRAME_BYTES_MONO * 2];
+static uint8_t frame_out_stereo[FRAME_BYTES_MONO * 2];
+static uint8_t frame_mono[2][FRAME_BYTES_MONO];
+
+/* The split and combine as they were before, one byte at a time */
+static void reference_split(void const *input, size_t input_size, void *output_left,
+			    void *output_right)
+{
+	char const *pointer_input = input;
+	char *pointer_output_left = output_left;
+	char *pointer_output_right = output_right;
+
+	for (uint32_t i = 0; i < input_size / 2; i += 2) {
+		for (uint8_t j = 0; j < 2; j++) {
+			*pointer_output_left++ = *pointer_input++;
+		}
+		for (uint8_t j = 0; j < 2; j++) {
+			*pointer_output_right++ = *pointer_input++;
+		}
+	}
+}
+
+static void reference_combine(void const *input_left, void const *input_right, size_t input_size,
+			      void *output)
+{
+	char const *pointer_input_left = input_left;
+	char const *pointer_input_right = input_right;
+	char *pointer_output = output;
+
+	for (uint32_t i = 0; i < input_size / 2; i++) {
+		for (uint8_t j = 0; j < 2; j++) {
+			*pointer_output++ = *pointer_input_left++;
+		}
+		for (uint8_t j = 0; j < 2; j++) {
+			*pointer_output++ = *pointer_input_right++;
+		}
+	}
+}
+
+static uint32_t frame_permille(uint32_t cycles)
+{
+	uint64_t budget = (uint64_t)sys_clock_hw_cycles_per_sec() * FRAME_DURATION_US / 1000000;
+
+	return (uint32_t)(cycles * 1000ULL / budget);
+}
+
+/* Copies done per frame by sw_codec_encode() and sw_codec_decode() in stereo
+ * mode, before and after the strided copies
+ */
+void test_pscm_frame_time(void)
+{
+	/* Stack buffers cleared every frame, as the codec path did before */
+	char stack_mono[2][FRAME_BYTES_MONO];
+	uint32_t before_enc;
+	uint32_t before_dec;
+	uint32_t after_enc;
+	uint32_t after_dec;
+	uint32_t start;
+	size_t output_size;
+
+	for (size_t i = 0; i < sizeof(frame_stereo); i++) {
+		frame_stereo[i] = i * 31;
+	}
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < FRAME_ROUNDS; i++) {
+		memset(stack_mono, 0, sizeof(stack_mono));
+		reference_split(frame_stereo, sizeof(frame_stereo), stack_mono[0], stack_mono[1]);
+	}
+	before_enc = (k_cycle_get_32() - start) / FRAME_ROUNDS;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < FRAME_ROUNDS; i++) {
+		/* Each channel is split right before it is encoded */
+		pscm_one_channel_split(frame_stereo, sizeof(frame_stereo), AUDIO_CH_L, 16,
+				       frame_mono[0], &output_size);
+		pscm_one_channel_split(frame_stereo, sizeof(frame_stereo), AUDIO_CH_R, 16,
+				       frame_mono[1], &output_size);
+	}
+	after_enc = (k_cycle_get_32() - start) / FRAME_ROUNDS;
+
+	verify_array_eq(frame_mono, stack_mono, sizeof(frame_mono));
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < FRAME_ROUNDS; i++) {
+		memset(stack_mono, 0, sizeof(stack_mono));
+		reference_combine(frame_mono[0], frame_mono[1], FRAME_BYTES_MONO,
+				  frame_out_stereo);
+	}
+	before_dec = (k_cycle_get_32() - start) / FRAME_ROUNDS;
+
+	memset(frame_out_stereo, 0, sizeof(frame_out_stereo));
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < FRAME_ROUNDS; i++) {
+		pscm_combine(frame_mono[0], frame_mono[1], FRAME_BYTES_MONO, 16, frame_out_stereo,
+			     &output_size);
+	}
+	after_dec = (k_cycle_get_32() - start) / FRAME_ROUNDS;
+
+	verify_array_eq(frame_out_stereo, frame_stereo, sizeof(frame_stereo));
+
+	TC_PRINT("Encode copies: before %u cycles (%u permille of frame), after %u (%u)\n",
+		 before_enc, frame_permille(before_enc), after_enc, frame_permille(after_enc));
+	TC_PRINT("Decode copies: before %u cycles (%u permille of frame), after %u (%u)\n",
+		 before_dec, frame_permille(before_dec), after_dec, frame_permille(after_dec));
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_suite_pscm,
@@ -318,7 +476,10 @@ void test_main(void)
 		ztest_unit_test(test_pscm_copy_pad_32),
 		ztest_unit_test(test_pscm_combine_32),
 		ztest_unit_test(test_pscm_one_channel_split_32),
-		ztest_unit_test(test_pscm_two_channel_split_32)
+		ztest_unit_test(test_pscm_two_channel_split_32),
+		ztest_unit_test(test_pscm_strided_copy),
+		ztest_unit_test(test_pscm_invalid_channel),
+		ztest_unit_test(test_pscm_frame_time)
 	);
 
 	ztest_run_test_suite(test_suite_pscm);
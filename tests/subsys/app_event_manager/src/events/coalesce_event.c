@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "coalesce_event.h"
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCING)
+static void coalesce_sum_event(struct app_event_header *pending,
+			       const struct app_event_header *aeh)
+{
+	cast_coalesce_sum_event(pending)->val += cast_coalesce_sum_event(aeh)->val;
+}
+#endif
+
+APP_EVENT_TYPE_DEFINE_COALESCING(coalesce_latest_event,
+		  NULL,
+		  NULL,
+		  APP_EVENT_FLAGS_CREATE(),
+		  COND_CODE_1(CONFIG_APP_EVENT_MANAGER_COALESCING,
+			      (app_event_coalesce_latest), (NULL)));
+
+APP_EVENT_TYPE_DEFINE_COALESCING(coalesce_sum_event,
+		  NULL,
+		  NULL,
+		  APP_EVENT_FLAGS_CREATE(),
+		  COND_CODE_1(CONFIG_APP_EVENT_MANAGER_COALESCING,
+			      (coalesce_sum_event), (NULL)));
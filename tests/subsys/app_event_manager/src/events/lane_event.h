@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _LANE_EVENT_H_
+#define _LANE_EVENT_H_
+
+/**
+ * @brief Lane Events
+ * @defgroup lane_event Events used to test event priority lanes
+ * @{
+ */
+
+#include <app_event_manager.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct lane_normal_event {
+	struct app_event_header header;
+};
+
+APP_EVENT_TYPE_DECLARE(lane_normal_event);
+
+struct lane_high_event {
+	struct app_event_header header;
+};
+
+APP_EVENT_TYPE_DECLARE(lane_high_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _LANE_EVENT_H_ */
@@ -28,6 +28,9 @@ enum test_id {
 	TEST_SUBSCRIBER_ORDER,
 	TEST_OOM,
 	TEST_MULTICONTEXT,
+	TEST_LANES,
+	TEST_SUBSCRIBER_FILTER,
+	TEST_COALESCE,
 
 	TEST_CNT
 };
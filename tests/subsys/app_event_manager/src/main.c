@@ -77,6 +77,26 @@ static void test_multicontext(void)
 	test_start(TEST_MULTICONTEXT);
 }
 
+static void test_lanes(void)
+{
+	test_start(TEST_LANES);
+}
+
+static void test_subs_filter(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTERS)) {
+		ztest_test_skip();
+		return;
+	}
+
+	test_start(TEST_SUBSCRIBER_FILTER);
+}
+
+static void test_coalesce(void)
+{
+	test_start(TEST_COALESCE);
+}
+
 static void test_event_size_static(void)
 {
 	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROVIDE_EVENT_SIZE)) {
@@ -92,22 +112,22 @@ static void test_event_size_static(void)
 	ev_s1 = new_test_size1_event();
 	zassert_equal(sizeof(*ev_s1), app_event_manager_event_size(&ev_s1->header),
 		"Event size1 unexpected size");
-	app_event_manager_free(ev_s1);
+	app_event_manager_event_free(ev_s1);
 
 	ev_s2 = new_test_size2_event();
 	zassert_equal(sizeof(*ev_s2), app_event_manager_event_size(&ev_s2->header),
 		"Event size2 unexpected size");
-	app_event_manager_free(ev_s2);
+	app_event_manager_event_free(ev_s2);
 
 	ev_s3 = new_test_size3_event();
 	zassert_equal(sizeof(*ev_s3), app_event_manager_event_size(&ev_s3->header),
 		"Event size3 unexpected size");
-	app_event_manager_free(ev_s3);
+	app_event_manager_event_free(ev_s3);
 
 	ev_sb = new_test_size_big_event();
 	zassert_equal(sizeof(*ev_sb), app_event_manager_event_size(&ev_sb->header),
 		"Event size_big unexpected size");
-	app_event_manager_free(ev_sb);
+	app_event_manager_event_free(ev_sb);
 }
 
 static void test_event_size_dynamic(void)
@@ -122,17 +142,17 @@ static void test_event_size_dynamic(void)
 	ev = new_test_dynamic_event(0);
 	zassert_equal(sizeof(*ev) + 0, app_event_manager_event_size(&ev->header),
 		"Event dynamic with 0 elements unexpected size");
-	app_event_manager_free(ev);
+	app_event_manager_event_free(ev);
 
 	ev = new_test_dynamic_event(10);
 	zassert_equal(sizeof(*ev) + 10, app_event_manager_event_size(&ev->header),
 		"Event dynamic with 10 elements unexpected size");
-	app_event_manager_free(ev);
+	app_event_manager_event_free(ev);
 
 	ev = new_test_dynamic_event(100);
 	zassert_equal(sizeof(*ev) + 100, app_event_manager_event_size(&ev->header),
 		"Event dynamic with 100 elements unexpected size");
-	app_event_manager_free(ev);
+	app_event_manager_event_free(ev);
 }
 
 static void test_event_size_dynamic_with_data(void)
@@ -147,17 +167,17 @@ static void test_event_size_dynamic_with_data(void)
 	ev = new_test_dynamic_with_data_event(0);
 	zassert_equal(sizeof(*ev) + 0, app_event_manager_event_size(&ev->header),
 		"Event dynamic with 0 elements unexpected size");
-	app_event_manager_free(ev);
+	app_event_manager_event_free(ev);
 
 	ev = new_test_dynamic_with_data_event(10);
 	zassert_equal(sizeof(*ev) + 10, app_event_manager_event_size(&ev->header),
 		"Event dynamic with 10 elements unexpected size");
-	app_event_manager_free(ev);
+	app_event_manager_event_free(ev);
 
 	ev = new_test_dynamic_with_data_event(100);
 	zassert_equal(sizeof(*ev) + 100, app_event_manager_event_size(&ev->header),
 		"Event dynamic with 100 elements unexpected size");
-	app_event_manager_free(ev);
+	app_event_manager_event_free(ev);
 }
 
 static void test_event_size_disabled(void)
@@ -175,7 +195,45 @@ static void test_event_size_disabled(void)
 		"Event size1 unexpected size");
 	zassert_false(expect_assert,
 		"Assertion during app_event_manager_event_size function execution was expected");
-	app_event_manager_free(ev_s1);
+	app_event_manager_event_free(ev_s1);
+}
+
+static void test_event_pools(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_POOLS)) {
+		ztest_test_skip();
+		return;
+	}
+
+	struct test_size1_event *ev_tab[CONFIG_APP_EVENT_MANAGER_EVENT_POOL_SIZE + 1];
+	const struct event_type *et = _EVENT_ID(test_size1_event);
+	struct app_event_manager_pool_stats stats;
+	int err;
+
+	err = app_event_manager_pool_stats_get(_EVENT_ID(test_dynamic_event), &stats);
+	zassert_equal(err, -ENOTSUP, "Event with dynamic data should not use a pool");
+
+	for (size_t i = 0; i < ARRAY_SIZE(ev_tab); i++) {
+		ev_tab[i] = new_test_size1_event();
+		zassert_not_null(ev_tab[i], "Event allocation failed");
+	}
+
+	err = app_event_manager_pool_stats_get(et, &stats);
+	zassert_ok(err, "Cannot get pool statistics");
+	zassert_equal(stats.block_cnt, CONFIG_APP_EVENT_MANAGER_EVENT_POOL_SIZE,
+		      "Unexpected pool size");
+	zassert_equal(stats.used, stats.block_cnt, "Pool should be exhausted");
+	zassert_equal(stats.max_used, stats.block_cnt, "Unexpected pool high-water mark");
+	zassert_equal(stats.heap_fallback_cnt, 1, "Expected allocation from the heap");
+
+	for (size_t i = 0; i < ARRAY_SIZE(ev_tab); i++) {
+		app_event_manager_event_free(ev_tab[i]);
+	}
+
+	err = app_event_manager_pool_stats_get(et, &stats);
+	zassert_ok(err, "Cannot get pool statistics");
+	zassert_equal(stats.used, 0, "Events not returned to the pool");
+	zassert_equal(stats.max_used, stats.block_cnt, "Unexpected pool high-water mark");
 }
 
 void test_main(void)
@@ -188,10 +246,14 @@ void test_main(void)
 			 ztest_unit_test(test_subs_order),
 			 ztest_unit_test(test_oom),
 			 ztest_unit_test(test_multicontext),
+			 ztest_unit_test(test_lanes),
+			 ztest_unit_test(test_subs_filter),
+			 ztest_unit_test(test_coalesce),
 			 ztest_unit_test(test_event_size_static),
 			 ztest_unit_test(test_event_size_dynamic),
 			 ztest_unit_test(test_event_size_dynamic_with_data),
-			 ztest_unit_test(test_event_size_disabled)
+			 ztest_unit_test(test_event_size_disabled),
+			 ztest_unit_test(test_event_pools)
 			 );
 
 	ztest_run_test_suite(app_event_manager_tests);
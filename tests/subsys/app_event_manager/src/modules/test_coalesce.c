@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "test_events.h"
+#include "coalesce_event.h"
+
+#define MODULE test_coalesce
+
+/* Number of events of every type submitted in a batch. */
+#define BATCH_SIZE 4
+
+/* Number of batches. */
+#define BATCH_CNT 3
+
+#define EVENT_CNT (BATCH_SIZE * BATCH_CNT)
+
+static size_t latest_cnt;
+static size_t sum_cnt;
+static int latest_val;
+static int sum_val;
+
+
+static void coalesce_test_start(void)
+{
+	latest_cnt = 0;
+	sum_cnt = 0;
+	latest_val = -1;
+	sum_val = 0;
+
+	/* Events are submitted from a listener, so none of them is processed before
+	 * the test end event.
+	 */
+	for (size_t i = 0; i < BATCH_CNT; i++) {
+		struct coalesce_latest_event *latest[BATCH_SIZE];
+		struct coalesce_sum_event *sum[BATCH_SIZE];
+
+		for (size_t j = 0; j < BATCH_SIZE; j++) {
+			latest[j] = new_coalesce_latest_event();
+			latest[j]->val = i * BATCH_SIZE + j;
+
+			sum[j] = new_coalesce_sum_event();
+			sum[j]->val = 1;
+		}
+
+		BUILD_ASSERT(BATCH_SIZE == 4);
+		APP_EVENT_SUBMIT_BATCH(latest[0], sum[0], latest[1], sum[1],
+				       latest[2], sum[2], latest[3], sum[3]);
+	}
+
+	struct test_end_event *et = new_test_end_event();
+
+	et->test_id = TEST_COALESCE;
+	APP_EVENT_SUBMIT(et);
+}
+
+static void coalesce_test_end(void)
+{
+	size_t expected_cnt = IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCING) ? 1 : EVENT_CNT;
+
+	zassert_equal(latest_cnt, expected_cnt, "Unexpected number of latest-wins events");
+	zassert_equal(sum_cnt, expected_cnt, "Unexpected number of accumulated events");
+	zassert_equal(latest_val, EVENT_CNT - 1, "Latest event value lost");
+	zassert_equal(sum_val, EVENT_CNT, "Accumulated event value lost");
+}
+
+static bool app_event_handler(const struct app_event_header *aeh)
+{
+	if (is_test_start_event(aeh)) {
+		struct test_start_event *st = cast_test_start_event(aeh);
+
+		if (st->test_id == TEST_COALESCE) {
+			coalesce_test_start();
+		}
+
+		return false;
+	}
+
+	if (is_test_end_event(aeh)) {
+		struct test_end_event *et = cast_test_end_event(aeh);
+
+		if (et->test_id == TEST_COALESCE) {
+			coalesce_test_end();
+		}
+
+		return false;
+	}
+
+	if (is_coalesce_latest_event(aeh)) {
+		const struct coalesce_latest_event *event = cast_coalesce_latest_event(aeh);
+
+		zassert_true(event->val > latest_val, "Events out of order");
+		latest_val = event->val;
+		latest_cnt++;
+
+		return false;
+	}
+
+	if (is_coalesce_sum_event(aeh)) {
+		sum_val += cast_coalesce_sum_event(aeh)->val;
+		sum_cnt++;
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+	return false;
+}
+
+APP_EVENT_LISTENER(MODULE, app_event_handler);
+APP_EVENT_SUBSCRIBE(MODULE, test_start_event);
+APP_EVENT_SUBSCRIBE_EARLY(MODULE, test_end_event);
+APP_EVENT_SUBSCRIBE(MODULE, coalesce_latest_event);
+APP_EVENT_SUBSCRIBE(MODULE, coalesce_sum_event);
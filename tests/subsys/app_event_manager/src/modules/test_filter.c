@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "test_events.h"
+#include "order_event.h"
+
+#include "test_config.h"
+
+#define MODULE test_filter
+#define MODULE_FILTERED test_filter_order
+
+#define FILTER_VAL (TEST_EVENT_ORDER_CNT / 2)
+
+static size_t filtered_cnt;
+
+
+static bool app_event_handler(const struct app_event_header *aeh)
+{
+	if (is_test_start_event(aeh)) {
+		struct test_start_event *st = cast_test_start_event(aeh);
+
+		if (st->test_id != TEST_SUBSCRIBER_FILTER) {
+			return false;
+		}
+
+		filtered_cnt = 0;
+
+		for (size_t i = 0; i < TEST_EVENT_ORDER_CNT; i++) {
+			struct order_event *event = new_order_event();
+
+			event->val = i;
+			APP_EVENT_SUBMIT(event);
+		}
+
+		struct test_end_event *et = new_test_end_event();
+
+		et->test_id = st->test_id;
+		APP_EVENT_SUBMIT(et);
+
+		return false;
+	}
+
+	if (is_test_end_event(aeh)) {
+		struct test_end_event *et = cast_test_end_event(aeh);
+
+		if (et->test_id == TEST_SUBSCRIBER_FILTER) {
+			zassert_equal(filtered_cnt, 1, "Filtered listener notified %zu times",
+				      filtered_cnt);
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+	return false;
+}
+
+APP_EVENT_LISTENER(MODULE, app_event_handler);
+APP_EVENT_SUBSCRIBE(MODULE, test_start_event);
+APP_EVENT_SUBSCRIBE_EARLY(MODULE, test_end_event);
+
+
+static bool app_event_handler_filtered(const struct app_event_header *aeh)
+{
+	if (is_order_event(aeh)) {
+		struct order_event *event = cast_order_event(aeh);
+
+		zassert_equal(event->val, FILTER_VAL, "Event not filtered out");
+		filtered_cnt++;
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+	return false;
+}
+
+APP_EVENT_LISTENER(MODULE_FILTERED, app_event_handler_filtered);
+APP_EVENT_SUBSCRIBE_FILTERED(MODULE_FILTERED, order_event, val, FILTER_VAL);
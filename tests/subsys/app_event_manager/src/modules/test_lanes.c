@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "test_events.h"
+#include "lane_event.h"
+
+#define MODULE test_lanes
+
+/* Number of events submitted to every lane. */
+#define LANE_EVENT_CNT 10
+
+/* Time spent by the listener of normal lane events. Sleeping lets the higher priority lane
+ * run, like a listener waiting for flash or Bluetooth operation would.
+ */
+#define SLOW_LISTENER_TIME_MS 5
+
+static atomic_t normal_delivered_cnt;
+static atomic_t high_delivered_cnt;
+
+static void lanes_test_start(void)
+{
+	atomic_clear(&normal_delivered_cnt);
+	atomic_clear(&high_delivered_cnt);
+
+	/* The events of both lanes are submitted interleaved */
+	for (size_t i = 0; i < LANE_EVENT_CNT; i++) {
+		struct lane_normal_event *normal = new_lane_normal_event();
+
+		APP_EVENT_SUBMIT(normal);
+
+		struct lane_high_event *high = new_lane_high_event();
+
+		APP_EVENT_SUBMIT(high);
+	}
+}
+
+static void lanes_test_end(void)
+{
+	struct test_end_event *et = new_test_end_event();
+
+	et->test_id = TEST_LANES;
+	APP_EVENT_SUBMIT(et);
+}
+
+static void normal_event_delivered(void)
+{
+	atomic_val_t idx = atomic_inc(&normal_delivered_cnt);
+	atomic_val_t high_cnt = atomic_get(&high_delivered_cnt);
+
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES)) {
+		/* The high priority lane runs at the latest while the first slow listener sleeps */
+		if (idx > 0) {
+			zassert_equal(high_cnt, LANE_EVENT_CNT,
+				      "High priority events must be delivered first");
+		}
+	} else {
+		zassert_equal(high_cnt, idx, "Events must be delivered in submission order");
+	}
+
+	k_sleep(K_MSEC(SLOW_LISTENER_TIME_MS));
+
+	if (idx == (LANE_EVENT_CNT - 1)) {
+		lanes_test_end();
+	}
+}
+
+static bool app_event_handler(const struct app_event_header *aeh)
+{
+	if (is_test_start_event(aeh)) {
+		struct test_start_event *st = cast_test_start_event(aeh);
+
+		if (st->test_id == TEST_LANES) {
+			lanes_test_start();
+		}
+
+		return false;
+	}
+
+	if (is_lane_normal_event(aeh)) {
+		normal_event_delivered();
+
+		return false;
+	}
+
+	if (is_lane_high_event(aeh)) {
+		atomic_inc(&high_delivered_cnt);
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+APP_EVENT_LISTENER(MODULE, app_event_handler);
+APP_EVENT_SUBSCRIBE(MODULE, test_start_event);
+APP_EVENT_SUBSCRIBE(MODULE, lane_normal_event);
+APP_EVENT_SUBSCRIBE(MODULE, lane_high_event);
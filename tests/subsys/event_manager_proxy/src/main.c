@@ -38,6 +38,26 @@ void test_initialization(void)
 	zassert_ok(ret, "Error when waiting for remote (%d)", ret);
 }
 
+void test_stats(void)
+{
+	struct event_manager_proxy_stats stats;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_STATS)) {
+		ztest_test_skip();
+		return;
+	}
+
+	ret = event_manager_proxy_stats_get(REMOTE_IPC_DEV, &stats);
+	zassert_ok(ret, "Cannot get proxy statistics (%d)", ret);
+
+	zassert_true(stats.events_sent > 0, "No events sent");
+	zassert_true(stats.events_received > 0, "No events received");
+	zassert_true(stats.msgs_sent <= stats.events_sent, "More messages than events sent");
+	zassert_true(stats.msgs_received <= stats.events_received,
+		     "More messages than events received");
+	zassert_equal(stats.send_errors, 0, "Send errors reported: %u", stats.send_errors);
+}
 
 void test_main(void)
 {
@@ -49,4 +69,10 @@ void test_main(void)
 
 	simple_run();
 	data_run();
+
+	ztest_test_suite(test_proxy_stats,
+			 ztest_unit_test(test_stats)
+			 );
+
+	ztest_run_test_suite(test_proxy_stats);
 }
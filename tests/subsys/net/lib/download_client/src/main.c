@@ -15,6 +15,24 @@
 
 static enum download_client_evt_id last_event = -1;
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_BUF_LENDING)
+static struct download_client *lend_client;
+static uint8_t lent_buf[2][CONFIG_DOWNLOAD_CLIENT_BUF_SIZE];
+static bool relend;
+static int lent_fragments;
+
+static bool is_lent_buf(const void *buf)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(lent_buf); i++) {
+		if (buf == lent_buf[i]) {
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif /* CONFIG_DOWNLOAD_CLIENT_BUF_LENDING */
+
 static int download_client_callback(const struct download_client_evt *event)
 {
 	if (event == NULL) {
@@ -23,6 +41,17 @@ static int download_client_callback(const struct download_client_evt *event)
 
 	switch (event->id) {
 	case DOWNLOAD_CLIENT_EVT_FRAGMENT:
+#if defined(CONFIG_DOWNLOAD_CLIENT_BUF_LENDING)
+		if (lend_client) {
+			zassert_true(is_lent_buf(event->fragment.buf),
+				     "Fragment must be in a lent buffer");
+			lent_fragments++;
+			if (relend) {
+				zassert_ok(download_client_buf_lend(lend_client,
+					(void *)event->fragment.buf, sizeof(lent_buf[0])), NULL);
+			}
+		}
+#endif
 		last_event = DOWNLOAD_CLIENT_EVT_FRAGMENT;
 		break;
 	case DOWNLOAD_CLIENT_EVT_DONE:
@@ -101,7 +130,38 @@ static void de_init(struct download_client *client)
 
 	err = download_client_disconnect(client);
 	zassert_ok(err, NULL);
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_BUF_LENDING)
+	lend_client = NULL;
+#endif
+}
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_BUF_LENDING)
+static void dl_coap_start_lent(struct download_client *client, size_t buf_cnt)
+{
+	static const char host[] = "coap://10.1.0.10";
+	int err;
+
+	memset(client, 0, sizeof(struct download_client));
+
+	err = download_client_init(client, download_client_callback);
+	zassert_ok(err, NULL);
+
+	lend_client = client;
+	lent_fragments = 0;
+
+	for (size_t i = 0; i < buf_cnt; i++) {
+		err = download_client_buf_lend(client, lent_buf[i], sizeof(lent_buf[i]));
+		zassert_ok(err, NULL);
+	}
+
+	err = download_client_connect(client, host, &config);
+	zassert_ok(err, NULL);
+
+	err = download_client_start(client, "no.file", 0);
+	zassert_ok(err, NULL);
 }
+#endif /* CONFIG_DOWNLOAD_CLIENT_BUF_LENDING */
 
 static void test_download_simple(void)
 {
@@ -204,13 +264,80 @@ static void test_download_abort_on_invalid_block(void)
 	de_init(&client);
 }
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_BUF_LENDING)
+static void test_download_lent_buffers(void)
+{
+	struct download_client client;
+	int32_t recvfrom_params[] = { 25, 25, 25 };
+	int32_t sendto_params[] = { 20, 20, 20 };
+
+	dl_coap_init(75, 20);
+
+	mock_return_values("mock_socket_offload_recvfrom", recvfrom_params,
+			   ARRAY_SIZE(recvfrom_params));
+	mock_return_values("mock_socket_offload_sendto", sendto_params, ARRAY_SIZE(sendto_params));
+
+	relend = true;
+	dl_coap_start_lent(&client, ARRAY_SIZE(lent_buf));
+
+	zassert_ok(wait_for_event(DOWNLOAD_CLIENT_EVT_DONE, 10), "Download must have finished");
+	zassert_equal(lent_fragments, 3, "All fragments must be in lent buffers");
+
+	de_init(&client);
+}
+
+static void test_download_waits_for_lent_buffer(void)
+{
+	struct download_client client;
+	int32_t recvfrom_params[] = { 25, 25, 25 };
+	int32_t sendto_params[] = { 20, 20, 20 };
+	int err;
+
+	dl_coap_init(75, 20);
+
+	mock_return_values("mock_socket_offload_recvfrom", recvfrom_params,
+			   ARRAY_SIZE(recvfrom_params));
+	mock_return_values("mock_socket_offload_sendto", sendto_params, ARRAY_SIZE(sendto_params));
+
+	/* Lend a single buffer and keep it after the first fragment */
+	relend = false;
+	dl_coap_start_lent(&client, 1);
+
+	zassert_ok(wait_for_event(DOWNLOAD_CLIENT_EVT_FRAGMENT, 10), "Fragment expected");
+
+	k_sleep(K_MSEC(300));
+	zassert_equal(lent_fragments, 1, "Download must wait for a lent buffer");
+
+	relend = true;
+	err = download_client_buf_lend(&client, lent_buf[0], sizeof(lent_buf[0]));
+	zassert_ok(err, NULL);
+
+	zassert_ok(wait_for_event(DOWNLOAD_CLIENT_EVT_DONE, 10), "Download must have finished");
+	zassert_equal(lent_fragments, 3, NULL);
+
+	de_init(&client);
+}
+#else
+static void test_download_lent_buffers(void)
+{
+	ztest_test_skip();
+}
+
+static void test_download_waits_for_lent_buffer(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_DOWNLOAD_CLIENT_BUF_LENDING */
+
 void test_main(void)
 {
 	ztest_test_suite(lib_fota_download_test, ztest_unit_test(test_download_simple),
 			 ztest_unit_test(test_download_reconnect_on_socket_error),
 			 ztest_unit_test(test_download_reconnect_on_peer_close),
 			 ztest_unit_test(test_download_ignore_duplicate_block),
-			 ztest_unit_test(test_download_abort_on_invalid_block));
+			 ztest_unit_test(test_download_abort_on_invalid_block),
+			 ztest_unit_test(test_download_lent_buffers),
+			 ztest_unit_test(test_download_waits_for_lent_buffer));
 
 	ztest_run_test_suite(lib_fota_download_test);
 }
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/fff.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/coap.h>
+#include <zephyr/net/socket.h>
+#include <download_client.h>
+
+DEFINE_FFF_GLOBALS;
+
+#define BLOCK_BYTES DOWNLOAD_CLIENT_COAP_BLOCK_BYTES
+/* The last block is shorter */
+#define FILE_SIZE (7 * BLOCK_BYTES + 20)
+#define BLOCK_CNT ((FILE_SIZE + BLOCK_BYTES - 1) / BLOCK_BYTES)
+#define NO_BLOCK UINT32_MAX
+
+FAKE_VALUE_FUNC(int, socket_send, const struct download_client *, size_t, int);
+FAKE_VALUE_FUNC(int, coap_uri_path_append, const struct download_client *,
+		struct coap_packet *);
+FAKE_VALUE_FUNC(int, fake_poll, struct zsock_pollfd *, int, int);
+FAKE_VALUE_FUNC(ssize_t, fake_recv, int, void *, size_t, int);
+
+/* Route the socket calls of the windowed downloader to the fakes */
+#define pollfd zsock_pollfd
+#define POLLIN ZSOCK_POLLIN
+#define poll(fds, nfds, timeout) fake_poll(fds, nfds, timeout)
+#define recv(fd, buf, len, flags) fake_recv(fd, buf, len, flags)
+
+#include "coap_window.c"
+
+/* Requests received by the server, not responded to yet */
+static struct {
+	uint16_t id;
+	uint8_t token[8];
+	uint8_t tkl;
+	uint32_t num;
+	bool size2;
+} requests[CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE];
+static size_t request_cnt;
+static size_t request_cnt_max;
+
+static struct download_client client;
+
+static bool reverse_order;
+static uint32_t lose_num;
+static bool lost;
+static uint16_t lost_id;
+static size_t retransmits;
+static size_t out_of_order_rsps;
+
+static size_t frag_bytes;
+static size_t error_cnt;
+static bool done;
+
+static uint8_t file_byte(size_t offset)
+{
+	return (uint8_t)(offset * 7);
+}
+
+static int fake_socket_send__server_receives(const struct download_client *dl, size_t len,
+					     int timeout)
+{
+	struct coap_packet request;
+	int block2;
+	uint16_t id;
+
+	ARG_UNUSED(timeout);
+
+	zassert_ok(coap_packet_parse(&request, (uint8_t *)dl->buf, len, NULL, 0), NULL);
+	zassert_equal(coap_header_get_type(&request), COAP_TYPE_CON, NULL);
+	zassert_equal(coap_header_get_code(&request), COAP_METHOD_GET, NULL);
+
+	block2 = coap_get_option_int(&request, COAP_OPTION_BLOCK2);
+	zassert_true(block2 >= 0, "Block2 option missing");
+	zassert_equal(GET_BLOCK_SIZE(block2), CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE, NULL);
+
+	id = coap_header_get_id(&request);
+
+	if (GET_BLOCK_NUM(block2) == lose_num) {
+		if (!lost) {
+			/* Lose the first request of this block */
+			lost = true;
+			lost_id = id;
+			return 0;
+		}
+
+		zassert_equal(id, lost_id, "A retransmission must keep the message ID");
+		retransmits++;
+	}
+
+	for (size_t i = 0; i < request_cnt; i++) {
+		zassert_not_equal(requests[i].id, id, "Request sent twice");
+	}
+
+	zassert_true(request_cnt < ARRAY_SIZE(requests), "Window exceeded");
+
+	requests[request_cnt].id = id;
+	requests[request_cnt].tkl = coap_header_get_token(&request, requests[request_cnt].token);
+	requests[request_cnt].num = GET_BLOCK_NUM(block2);
+	requests[request_cnt].size2 = coap_get_option_int(&request, COAP_OPTION_SIZE2) >= 0;
+	request_cnt++;
+	request_cnt_max = MAX(request_cnt_max, request_cnt);
+
+	return 0;
+}
+
+static int fake_poll__serves(struct zsock_pollfd *fds, int nfds, int timeout)
+{
+	zassert_equal(nfds, 1, NULL);
+
+	if (request_cnt == 0) {
+		/* Nothing to respond to, wait for a retransmission */
+		zassert_true(timeout >= 0, "A request must be pending");
+		k_sleep(K_MSEC(timeout));
+		return 0;
+	}
+
+	fds[0].revents = ZSOCK_POLLIN;
+
+	return 1;
+}
+
+/* Respond to the oldest request, or to the newest if the responses are to be reordered */
+static ssize_t fake_recv__server_responds(int fd, void *buf, size_t len, int flags)
+{
+	struct coap_packet response;
+	size_t idx = reverse_order ? request_cnt - 1 : 0;
+	uint32_t num = requests[idx].num;
+	size_t start = num * BLOCK_BYTES;
+	size_t payload_len = MIN(BLOCK_BYTES, FILE_SIZE - start);
+	uint8_t payload[BLOCK_BYTES];
+	bool more = (start + payload_len) < FILE_SIZE;
+
+	ARG_UNUSED(fd);
+	ARG_UNUSED(flags);
+
+	if (num * BLOCK_BYTES != client.progress) {
+		out_of_order_rsps++;
+	}
+
+	for (size_t i = 0; i < payload_len; i++) {
+		payload[i] = file_byte(start + i);
+	}
+
+	zassert_ok(coap_packet_init(&response, buf, len, COAP_VERSION_1, COAP_TYPE_ACK,
+				    requests[idx].tkl, requests[idx].token,
+				    COAP_RESPONSE_CODE_CONTENT, requests[idx].id), NULL);
+	zassert_ok(coap_append_option_int(&response, COAP_OPTION_BLOCK2,
+					  (num << 4) | (more << 3) |
+					  CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE), NULL);
+	if (requests[idx].size2) {
+		zassert_ok(coap_append_option_int(&response, COAP_OPTION_SIZE2, FILE_SIZE), NULL);
+	}
+	zassert_ok(coap_packet_append_payload_marker(&response), NULL);
+	zassert_ok(coap_packet_append_payload(&response, payload, payload_len), NULL);
+
+	request_cnt--;
+	memmove(&requests[idx], &requests[idx + 1], (request_cnt - idx) * sizeof(requests[0]));
+
+	return response.offset;
+}
+
+static int download_client_callback(const struct download_client_evt *event)
+{
+	switch (event->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT:
+		zassert_false(done, "Fragment after the download has completed");
+
+		for (size_t i = 0; i < event->fragment.len; i++) {
+			zassert_equal(((const uint8_t *)event->fragment.buf)[i],
+				      file_byte(frag_bytes + i),
+				      "Block delivered out of order");
+		}
+
+		frag_bytes += event->fragment.len;
+		break;
+	case DOWNLOAD_CLIENT_EVT_DONE:
+		done = true;
+		break;
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		error_cnt++;
+		/* Stop the download */
+		return -1;
+	}
+
+	return 0;
+}
+
+static void run_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	RESET_FAKE(socket_send);
+	RESET_FAKE(coap_uri_path_append);
+	RESET_FAKE(fake_poll);
+	RESET_FAKE(fake_recv);
+
+	socket_send_fake.custom_fake = fake_socket_send__server_receives;
+	fake_poll_fake.custom_fake = fake_poll__serves;
+	fake_recv_fake.custom_fake = fake_recv__server_responds;
+
+	memset(requests, 0, sizeof(requests));
+	memset(&client, 0, sizeof(client));
+
+	request_cnt = 0;
+	request_cnt_max = 0;
+	reverse_order = false;
+	lose_num = NO_BLOCK;
+	lost = false;
+	lost_id = 0;
+	retransmits = 0;
+	out_of_order_rsps = 0;
+	frag_bytes = 0;
+	error_cnt = 0;
+	done = false;
+
+	client.callback = download_client_callback;
+	/* Any valid descriptor, the sockets are faked */
+	client.fd = 1;
+}
+
+ZTEST_SUITE(download_client_coap_window, NULL, NULL, run_before, NULL, NULL);
+
+ZTEST(download_client_coap_window, test_window_slides)
+{
+	coap_window_download(&client);
+
+	zassert_true(done, "Download must have completed");
+	zassert_equal(frag_bytes, FILE_SIZE, NULL);
+	zassert_equal(error_cnt, 0, NULL);
+	zassert_equal(socket_send_fake.call_count, BLOCK_CNT, "Each block is requested once");
+	zassert_true(request_cnt_max > 1, "The window must have grown");
+	zassert_true(request_cnt_max <= CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE, NULL);
+}
+
+ZTEST(download_client_coap_window, test_lost_block_is_retransmitted)
+{
+	lose_num = 2;
+
+	coap_window_download(&client);
+
+	zassert_true(done, "Download must have completed");
+	zassert_equal(frag_bytes, FILE_SIZE, NULL);
+	zassert_equal(error_cnt, 0, NULL);
+	zassert_equal(retransmits, 1, "The lost block must be requested again");
+	zassert_equal(socket_send_fake.call_count, BLOCK_CNT + 1, NULL);
+}
+
+ZTEST(download_client_coap_window, test_out_of_order_ack)
+{
+	reverse_order = true;
+
+	coap_window_download(&client);
+
+	zassert_true(out_of_order_rsps > 0, "Responses must have been reordered");
+	zassert_true(done, "Download must have completed");
+	zassert_equal(frag_bytes, FILE_SIZE, NULL);
+	zassert_equal(error_cnt, 0, NULL);
+	zassert_equal(socket_send_fake.call_count, BLOCK_CNT, NULL);
+}
@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <zephyr/fff.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <download_client.h>
+
+DEFINE_FFF_GLOBALS;
+
+#define FILE_SIZE 256
+#define FD_MAX 16
+#define RECV_CHUNK 40
+#define RSP_HDR_MAX 32
+
+FAKE_VALUE_FUNC(int, socket_connect, const struct download_client *, int *);
+FAKE_VALUE_FUNC(int, http_range_request_send, const struct download_client *, int, char *,
+		size_t, size_t);
+FAKE_VALUE_FUNC(int, fake_poll, struct zsock_pollfd *, int, int);
+FAKE_VALUE_FUNC(ssize_t, fake_recv, int, void *, size_t, int);
+FAKE_VALUE_FUNC(int, fake_close, int);
+
+/* Route the socket calls of the parallel downloader to the fakes */
+#define pollfd zsock_pollfd
+#define POLLIN ZSOCK_POLLIN
+#define poll(fds, nfds, timeout) fake_poll(fds, nfds, timeout)
+#define recv(fd, buf, len, flags) fake_recv(fd, buf, len, flags)
+#define close(fd) fake_close(fd)
+
+#include "http_parallel.c"
+
+/* Server side of a connection */
+static struct {
+	bool open;
+	size_t start;
+	char rsp[RSP_HDR_MAX + FILE_SIZE];
+	size_t rsp_len;
+	size_t rsp_off;
+} server[FD_MAX];
+
+static struct download_client client;
+
+static int next_fd;
+static bool reverse_order;
+static bool close_after_first;
+static bool ranges_unsupported;
+static bool abort_on_fragment;
+static size_t out_of_order_rsps;
+
+static size_t frag_cnt;
+static size_t frag_bytes;
+static size_t error_cnt;
+static int last_error;
+static bool done;
+
+static uint8_t file_byte(size_t offset)
+{
+	return (uint8_t)(offset * 7);
+}
+
+static int fake_socket_connect__succeeds(const struct download_client *dl, int *fd)
+{
+	ARG_UNUSED(dl);
+
+	zassert_true(next_fd < FD_MAX, "Too many connections");
+
+	*fd = next_fd++;
+	server[*fd].open = true;
+
+	return 0;
+}
+
+static int fake_socket_connect__fails(const struct download_client *dl, int *fd)
+{
+	ARG_UNUSED(dl);
+	ARG_UNUSED(fd);
+
+	return -ECONNREFUSED;
+}
+
+static int fake_http_range_request_send__responds(const struct download_client *dl, int fd,
+						  char *buf, size_t from, size_t to)
+{
+	int len;
+
+	ARG_UNUSED(dl);
+	ARG_UNUSED(buf);
+
+	zassert_true(server[fd].open, "Request on a closed connection");
+	zassert_equal(server[fd].rsp_off, server[fd].rsp_len, "Response still pending");
+
+	if (ranges_unsupported) {
+		/* The server sends the whole file */
+		from = 0;
+		to = FILE_SIZE - 1;
+	}
+
+	to = MIN(to, FILE_SIZE - 1);
+
+	/* The header is "<range start> <file size> <connection close> <whole file>" */
+	len = snprintf(server[fd].rsp, RSP_HDR_MAX, "%u %u %d %d\r\n\r\n",
+		       from, FILE_SIZE, close_after_first, ranges_unsupported);
+	close_after_first = false;
+
+	for (size_t i = from; i <= to; i++) {
+		server[fd].rsp[len++] = file_byte(i);
+	}
+
+	server[fd].start = from;
+	server[fd].rsp_len = len;
+	server[fd].rsp_off = 0;
+
+	return 0;
+}
+
+int http_range_header_parse(char *buf, size_t *hdr_len, size_t *range_start,
+			    size_t *file_size, bool *connection_close, bool *whole_file)
+{
+	unsigned int start;
+	unsigned int size;
+	int conn_close;
+	int whole;
+	char *p;
+
+	p = strstr(buf, "\r\n\r\n");
+	if (!p) {
+		return 1;
+	}
+
+	zassert_equal(sscanf(buf, "%u %u %d %d", &start, &size, &conn_close, &whole), 4, NULL);
+
+	*hdr_len = p + strlen("\r\n\r\n") - buf;
+	*range_start = start;
+	*file_size = size;
+	*connection_close = conn_close;
+	*whole_file = whole;
+
+	return 0;
+}
+
+static bool rsp_pending(int fd)
+{
+	return server[fd].open && (server[fd].rsp_off < server[fd].rsp_len);
+}
+
+/* Make a single socket readable, the one with the first range,
+ * or the one with the last range if the responses are to be reordered.
+ */
+static int fake_poll__serves(struct zsock_pollfd *fds, int nfds, int timeout)
+{
+	int pick = -1;
+
+	ARG_UNUSED(timeout);
+
+	if (client.range_abort) {
+		/* The sockets have been closed */
+		return -1;
+	}
+
+	for (int i = 0; i < nfds; i++) {
+		if (!rsp_pending(fds[i].fd)) {
+			continue;
+		}
+
+		if ((pick == -1) ||
+		    (reverse_order && server[fds[i].fd].start > server[fds[pick].fd].start) ||
+		    (!reverse_order && server[fds[i].fd].start < server[fds[pick].fd].start)) {
+			pick = i;
+		}
+	}
+
+	if (pick == -1) {
+		return 0;
+	}
+
+	if (server[fds[pick].fd].start != client.progress) {
+		out_of_order_rsps++;
+	}
+
+	fds[pick].revents = ZSOCK_POLLIN;
+
+	return 1;
+}
+
+static ssize_t fake_recv__reads(int fd, void *buf, size_t len, int flags)
+{
+	ARG_UNUSED(flags);
+
+	len = MIN(len, RECV_CHUNK);
+	len = MIN(len, server[fd].rsp_len - server[fd].rsp_off);
+
+	memcpy(buf, server[fd].rsp + server[fd].rsp_off, len);
+	server[fd].rsp_off += len;
+
+	return len;
+}
+
+static int fake_close__closes(int fd)
+{
+	if (fd >= 0 && fd < FD_MAX) {
+		server[fd].open = false;
+	}
+
+	return 0;
+}
+
+/* Does what download_client_disconnect() does to the client */
+static void client_disconnect(void)
+{
+	client.range_abort = true;
+	client.fd = -1;
+
+	for (size_t i = 0; i < ARRAY_SIZE(client.range_conn); i++) {
+		fake_close__closes(client.range_conn[i].fd);
+		client.range_conn[i].fd = -1;
+	}
+}
+
+static int download_client_callback(const struct download_client_evt *event)
+{
+	switch (event->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT:
+		zassert_false(done, "Fragment after the download has completed");
+
+		for (size_t i = 0; i < event->fragment.len; i++) {
+			zassert_equal(((const uint8_t *)event->fragment.buf)[i],
+				      file_byte(frag_bytes + i),
+				      "Fragment delivered out of order");
+		}
+
+		frag_bytes += event->fragment.len;
+		frag_cnt++;
+
+		if (abort_on_fragment) {
+			client_disconnect();
+		}
+		break;
+	case DOWNLOAD_CLIENT_EVT_DONE:
+		done = true;
+		break;
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		last_error = event->error;
+		error_cnt++;
+		/* Stop the download */
+		return -1;
+	}
+
+	return 0;
+}
+
+static void run_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	RESET_FAKE(socket_connect);
+	RESET_FAKE(http_range_request_send);
+	RESET_FAKE(fake_poll);
+	RESET_FAKE(fake_recv);
+	RESET_FAKE(fake_close);
+
+	socket_connect_fake.custom_fake = fake_socket_connect__succeeds;
+	http_range_request_send_fake.custom_fake = fake_http_range_request_send__responds;
+	fake_poll_fake.custom_fake = fake_poll__serves;
+	fake_recv_fake.custom_fake = fake_recv__reads;
+	fake_close_fake.custom_fake = fake_close__closes;
+
+	memset(server, 0, sizeof(server));
+	memset(&client, 0, sizeof(client));
+
+	next_fd = 0;
+	reverse_order = false;
+	close_after_first = false;
+	ranges_unsupported = false;
+	abort_on_fragment = false;
+	out_of_order_rsps = 0;
+	frag_cnt = 0;
+	frag_bytes = 0;
+	error_cnt = 0;
+	last_error = 0;
+	done = false;
+
+	client.callback = download_client_callback;
+	for (size_t i = 0; i < ARRAY_SIZE(client.range_conn); i++) {
+		client.range_conn[i].fd = -1;
+	}
+
+	/* The client socket, connected by download_client_connect() */
+	zassert_ok(fake_socket_connect__succeeds(&client, &client.fd), NULL);
+}
+
+ZTEST_SUITE(download_client_parallel, NULL, NULL, run_before, NULL, NULL);
+
+ZTEST(download_client_parallel, test_download_in_order)
+{
+	http_parallel_download(&client);
+
+	zassert_true(done, "Download must have completed");
+	zassert_equal(frag_bytes, FILE_SIZE, NULL);
+	zassert_equal(frag_cnt, FILE_SIZE / CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE, NULL);
+	zassert_equal(error_cnt, 0, NULL);
+	/* The second range connection is opened once the file size is known */
+	zassert_equal(socket_connect_fake.call_count, 1, NULL);
+}
+
+ZTEST(download_client_parallel, test_download_out_of_order)
+{
+	reverse_order = true;
+
+	http_parallel_download(&client);
+
+	zassert_true(out_of_order_rsps > 0, "Responses must have been reordered");
+	zassert_true(done, "Download must have completed");
+	zassert_equal(frag_bytes, FILE_SIZE, NULL);
+	zassert_equal(error_cnt, 0, NULL);
+}
+
+ZTEST(download_client_parallel, test_download_reconnect_on_connection_close)
+{
+	close_after_first = true;
+
+	http_parallel_download(&client);
+
+	zassert_true(done, "Download must have completed");
+	zassert_equal(frag_bytes, FILE_SIZE, NULL);
+	zassert_equal(error_cnt, 0, NULL);
+	zassert_equal(client.fd, client.range_conn[0].fd,
+		      "The client socket must follow the first range connection");
+}
+
+ZTEST(download_client_parallel, test_download_reconnect_fails)
+{
+	close_after_first = true;
+	socket_connect_fake.custom_fake = fake_socket_connect__fails;
+
+	http_parallel_download(&client);
+
+	zassert_false(done, NULL);
+	zassert_equal(frag_cnt, 1, NULL);
+	zassert_equal(error_cnt, 1, "The failed reconnection must be reported");
+	zassert_equal(last_error, -EHOSTDOWN, NULL);
+}
+
+ZTEST(download_client_parallel, test_download_abort)
+{
+	abort_on_fragment = true;
+
+	http_parallel_download(&client);
+
+	zassert_false(done, NULL);
+	zassert_equal(frag_cnt, 1, NULL);
+	zassert_equal(error_cnt, 0, "An abort is not an error");
+	zassert_equal(socket_connect_fake.call_count, 1,
+		      "No connection must be opened after the abort");
+}
+
+ZTEST(download_client_parallel, test_download_closes_range_conns)
+{
+	http_parallel_download(&client);
+
+	zassert_true(done, "Download must have completed");
+
+	/* Only the client socket is left open */
+	for (size_t i = 1; i < ARRAY_SIZE(client.range_conn); i++) {
+		zassert_equal(client.range_conn[i].fd, -1, NULL);
+	}
+
+	for (int fd = 0; fd < next_fd; fd++) {
+		zassert_equal(server[fd].open, fd == client.fd, NULL);
+	}
+}
+
+ZTEST(download_client_parallel, test_download_ranges_unsupported)
+{
+	ranges_unsupported = true;
+
+	http_parallel_download(&client);
+
+	zassert_true(done, "Download must have completed");
+	zassert_equal(frag_bytes, FILE_SIZE, NULL);
+	zassert_equal(error_cnt, 0, NULL);
+	zassert_equal(socket_connect_fake.call_count, 0,
+		      "No range connection must be opened");
+}
+
+ZTEST(download_client_parallel, test_download_ranges_unsupported_resume)
+{
+	ranges_unsupported = true;
+	client.progress = FILE_SIZE / 2 + 3;
+	frag_bytes = client.progress;
+
+	http_parallel_download(&client);
+
+	zassert_true(done, "Download must have completed");
+	zassert_equal(frag_bytes, FILE_SIZE, "The downloaded part must be skipped");
+	zassert_equal(error_cnt, 0, NULL);
+}
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <math.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <cJSON.h>
+
+#include "nrf_cloud_json_writer.h"
+#include "recorded_messages.h"
+
+/* Model used for the size report. The uplink rates are typical application
+ * throughputs, not peak rates, and the current is the average supply current
+ * while the radio transmits at high output power. Only the payload is
+ * counted; MQTT, TLS and IP headers are the same for both formats.
+ */
+#define MODEL_LTE_M_BPS		300000
+#define MODEL_NB_IOT_BPS	30000
+#define MODEL_TX_CURRENT_MA	100
+
+ZTEST_SUITE(nrf_cloud_cbor_test, NULL, NULL, NULL, NULL, NULL);
+
+static int encode_cbor(const cJSON *item, uint8_t *buf, size_t size)
+{
+	struct json_writer w;
+
+	json_writer_init_format(&w, JSON_WRITER_FORMAT_CBOR, (char *)buf, size);
+	json_writer_cjson(&w, NULL, item);
+
+	return json_writer_finish(&w);
+}
+
+/* Minimal decoder for the subset of CBOR the writer produces */
+struct cbor_reader {
+	const uint8_t *buf;
+	size_t len;
+	size_t pos;
+};
+
+static uint64_t read_be(struct cbor_reader *r, size_t len)
+{
+	uint64_t val = 0;
+
+	zassert_true(r->pos + len <= r->len, "Truncated CBOR");
+
+	while (len--) {
+		val = (val << 8) | r->buf[r->pos++];
+	}
+
+	return val;
+}
+
+static cJSON *decode_item(struct cbor_reader *r)
+{
+	uint8_t initial = read_be(r, 1);
+	uint8_t major = initial >> 5;
+	uint8_t info = initial & 0x1F;
+	uint64_t arg = info;
+	uint32_t bits32;
+	uint64_t bits64;
+	float val32;
+	double val64;
+	cJSON *item;
+	cJSON *child;
+	char *str;
+
+	switch (initial) {
+	case 0xF4:
+		return cJSON_CreateFalse();
+	case 0xF5:
+		return cJSON_CreateTrue();
+	case 0xF6:
+		return cJSON_CreateNull();
+	case 0xFA:
+		bits32 = read_be(r, 4);
+		memcpy(&val32, &bits32, sizeof(val32));
+		return cJSON_CreateNumber(val32);
+	case 0xFB:
+		bits64 = read_be(r, 8);
+		memcpy(&val64, &bits64, sizeof(val64));
+		return cJSON_CreateNumber(val64);
+	default:
+		break;
+	}
+
+	if ((info >= 24) && (info <= 27)) {
+		arg = read_be(r, 1 << (info - 24));
+	} else if (info == 31) {
+		zassert_true((major == 4) || (major == 5), "Unexpected indefinite length");
+	} else {
+		zassert_true(info < 24, "Unexpected additional info %u", info);
+	}
+
+	switch (major) {
+	case 0:
+		return cJSON_CreateNumber((double)arg);
+	case 1:
+		return cJSON_CreateNumber(-1.0 - (double)arg);
+	case 3:
+		zassert_true(r->pos + arg <= r->len, "Truncated CBOR");
+		str = cJSON_malloc(arg + 1);
+		memcpy(str, &r->buf[r->pos], arg);
+		str[arg] = '\0';
+		r->pos += arg;
+		item = cJSON_CreateString(str);
+		cJSON_free(str);
+		return item;
+	case 4:
+	case 5:
+		zassert_equal(info, 31, "Only indefinite length containers expected");
+		item = (major == 4) ? cJSON_CreateArray() : cJSON_CreateObject();
+		while (r->buf[r->pos] != 0xFF) {
+			if (major == 4) {
+				cJSON_AddItemToArray(item, decode_item(r));
+				continue;
+			}
+
+			child = decode_item(r);
+			zassert_true(cJSON_IsString(child), "Map key is not a string");
+			cJSON_AddItemToObject(item, child->valuestring, decode_item(r));
+			cJSON_Delete(child);
+		}
+		r->pos++;
+		return item;
+	default:
+		zassert_unreachable("Unexpected major type %u", major);
+		return NULL;
+	}
+}
+
+static cJSON *decode(const uint8_t *buf, size_t len)
+{
+	struct cbor_reader r = { .buf = buf, .len = len };
+	cJSON *item = decode_item(&r);
+
+	zassert_equal(r.pos, len, "Trailing data after %zu bytes", r.pos);
+
+	return item;
+}
+
+static void check_number(double val, const uint8_t *expected, size_t expected_len)
+{
+	cJSON *item = cJSON_CreateNumber(val);
+	uint8_t buf[16];
+	int len;
+
+	len = encode_cbor(item, buf, sizeof(buf));
+	cJSON_Delete(item);
+
+	zassert_equal(len, expected_len, "%g: unexpected length %d", val, len);
+	zassert_mem_equal(buf, expected, len, "%g: unexpected encoding", val);
+}
+
+ZTEST(nrf_cloud_cbor_test, test_numbers)
+{
+	/* Examples from RFC 8949 appendix A */
+	check_number(0, (uint8_t[]){ 0x00 }, 1);
+	check_number(23, (uint8_t[]){ 0x17 }, 1);
+	check_number(24, (uint8_t[]){ 0x18, 0x18 }, 2);
+	check_number(1000, (uint8_t[]){ 0x19, 0x03, 0xE8 }, 3);
+	check_number(1000000, (uint8_t[]){ 0x1A, 0x00, 0x0F, 0x42, 0x40 }, 5);
+	check_number(1000000000000.0,
+		     (uint8_t[]){ 0x1B, 0x00, 0x00, 0x00, 0xE8, 0xD4, 0xA5, 0x10, 0x00 }, 9);
+	check_number(-1, (uint8_t[]){ 0x20 }, 1);
+	check_number(-1000, (uint8_t[]){ 0x39, 0x03, 0xE7 }, 3);
+	check_number(100000.5, (uint8_t[]){ 0xFA, 0x47, 0xC3, 0x50, 0x40 }, 5);
+	check_number(1.1, (uint8_t[]){ 0xFB, 0x3F, 0xF1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9A }, 9);
+	check_number(NAN, (uint8_t[]){ 0xF6 }, 1);
+	check_number(-INFINITY, (uint8_t[]){ 0xF6 }, 1);
+}
+
+ZTEST(nrf_cloud_cbor_test, test_containers)
+{
+	static const uint8_t expected[] = {
+		0xBF, 0x61, 'a', 0x9F, 0xF5, 0xF4, 0xF6, 0xFF,
+		0x61, 'b', 0x62, 'h', 'i', 0xFF,
+	};
+	cJSON *item = cJSON_Parse("{\"a\":[true,false,null],\"b\":\"hi\"}");
+	uint8_t buf[32];
+	int len;
+
+	zassert_not_null(item, NULL);
+	len = encode_cbor(item, buf, sizeof(buf));
+	cJSON_Delete(item);
+
+	zassert_equal(len, sizeof(expected), "Unexpected length %d", len);
+	zassert_mem_equal(buf, expected, len, "Unexpected encoding");
+}
+
+ZTEST(nrf_cloud_cbor_test, test_exact_fit)
+{
+	cJSON *item = cJSON_Parse(MSG_GNSS);
+	uint8_t buf[256];
+	int len;
+
+	zassert_not_null(item, NULL);
+	len = encode_cbor(item, NULL, 0);
+	zassert_true(len > 0, "Measuring failed: %d", len);
+
+	/* CBOR output is not null-terminated */
+	zassert_equal(encode_cbor(item, buf, len), len, "Exact size buffer rejected");
+	zassert_equal(encode_cbor(item, buf, len - 1), -ENOMEM, "Overflow not detected");
+
+	cJSON_Delete(item);
+}
+
+ZTEST(nrf_cloud_cbor_test, test_raw_not_supported)
+{
+	cJSON *item = cJSON_CreateObject();
+
+	cJSON_AddRawToObject(item, "raw", "{\"a\":1}");
+	zassert_equal(encode_cbor(item, NULL, 0), -ENOTSUP, NULL);
+
+	cJSON_Delete(item);
+}
+
+/* Encode each recorded message in both formats from the same cJSON tree,
+ * check that the CBOR decodes to the same message and report the sizes.
+ */
+ZTEST(nrf_cloud_cbor_test, test_recorded_messages)
+{
+	static uint8_t buf[1024];
+	size_t json_total = 0;
+	size_t cbor_total = 0;
+	struct json_writer w;
+	cJSON *decoded;
+	cJSON *item;
+	char *json;
+	int json_len;
+	int cbor_len;
+
+	TC_PRINT("%-16s %6s %6s %7s\n", "Message", "JSON", "CBOR", "Saved");
+
+	for (size_t i = 0; i < ARRAY_SIZE(recorded_messages); i++) {
+		item = cJSON_Parse(recorded_messages[i].json);
+		zassert_not_null(item, "Invalid message %s", recorded_messages[i].name);
+
+		/* The JSON path of the writer matches cJSON */
+		json = cJSON_PrintUnformatted(item);
+		json_writer_init(&w, (char *)buf, sizeof(buf));
+		json_writer_cjson(&w, NULL, item);
+		json_len = json_writer_finish(&w);
+		zassert_equal(json_len, strlen(json), "%s: unexpected length",
+			      recorded_messages[i].name);
+		zassert_mem_equal(buf, json, json_len, "%s: output differs",
+				  recorded_messages[i].name);
+		cJSON_free(json);
+
+		cbor_len = encode_cbor(item, buf, sizeof(buf));
+		zassert_true(cbor_len > 0, "%s: encoding failed: %d",
+			     recorded_messages[i].name, cbor_len);
+
+		decoded = decode(buf, cbor_len);
+		zassert_true(cJSON_Compare(item, decoded, true), "%s: decoded message differs",
+			     recorded_messages[i].name);
+		zassert_true(cbor_len < json_len, "%s: CBOR is not smaller",
+			     recorded_messages[i].name);
+
+		cJSON_Delete(decoded);
+		cJSON_Delete(item);
+
+		TC_PRINT("%-16s %6d %6d %6d%%\n", recorded_messages[i].name, json_len, cbor_len,
+			 100 * (json_len - cbor_len) / json_len);
+
+		json_total += json_len;
+		cbor_total += cbor_len;
+	}
+
+	TC_PRINT("%-16s %6zu %6zu %6zu%%\n", "Total", json_total, cbor_total,
+		 100 * (json_total - cbor_total) / json_total);
+
+	/* Time on air in microseconds and charge in microcoulombs */
+	TC_PRINT("LTE-M:  %llu us / %llu uC (JSON), %llu us / %llu uC (CBOR)\n",
+		 8000000ULL * json_total / MODEL_LTE_M_BPS,
+		 8000ULL * json_total * MODEL_TX_CURRENT_MA / MODEL_LTE_M_BPS,
+		 8000000ULL * cbor_total / MODEL_LTE_M_BPS,
+		 8000ULL * cbor_total * MODEL_TX_CURRENT_MA / MODEL_LTE_M_BPS);
+	TC_PRINT("NB-IoT: %llu us / %llu uC (JSON), %llu us / %llu uC (CBOR)\n",
+		 8000000ULL * json_total / MODEL_NB_IOT_BPS,
+		 8000ULL * json_total * MODEL_TX_CURRENT_MA / MODEL_NB_IOT_BPS,
+		 8000000ULL * cbor_total / MODEL_NB_IOT_BPS,
+		 8000ULL * cbor_total * MODEL_TX_CURRENT_MA / MODEL_NB_IOT_BPS);
+}
@@ -0,0 +1,422 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <cJSON.h>
+
+#include "nrf_cloud_json_writer.h"
+
+#define BENCHMARK_ROUNDS 1000
+
+/* Heap usage of cJSON, tracked through its allocation hooks */
+static size_t heap_used;
+static size_t heap_peak;
+static size_t heap_allocs;
+
+struct alloc_hdr {
+	size_t size;
+	/* Keep the allocated memory aligned */
+	max_align_t align;
+};
+
+static void *counting_malloc(size_t size)
+{
+	struct alloc_hdr *hdr = malloc(sizeof(*hdr) + size);
+
+	if (!hdr) {
+		return NULL;
+	}
+
+	hdr->size = size;
+	heap_used += size;
+	heap_peak = MAX(heap_peak, heap_used);
+	heap_allocs++;
+
+	return hdr + 1;
+}
+
+static void counting_free(void *ptr)
+{
+	struct alloc_hdr *hdr;
+
+	if (!ptr) {
+		return;
+	}
+
+	hdr = (struct alloc_hdr *)ptr - 1;
+	heap_used -= hdr->size;
+	free(hdr);
+}
+
+static void heap_stats_reset(void)
+{
+	heap_used = 0;
+	heap_peak = 0;
+	heap_allocs = 0;
+}
+
+static void *suite_setup(void)
+{
+	cJSON_Hooks hooks = {
+		.malloc_fn = counting_malloc,
+		.free_fn = counting_free,
+	};
+
+	cJSON_InitHooks(&hooks);
+
+	return NULL;
+}
+
+static void run_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	heap_stats_reset();
+}
+
+static void run_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_equal(heap_used, 0, "Memory leaked: %zu bytes", heap_used);
+}
+
+ZTEST_SUITE(nrf_cloud_json_writer_test, NULL, suite_setup, run_before, run_after, NULL);
+
+static const char *const test_strings[] = {
+	"",
+	"plain",
+	"quote\" backslash\\ slash/",
+	"\b\f\n\r\t",
+	"\x01\x1f\x7f",
+	"UTF-8 \xc3\xa6\xc3\xb8\xc3\xa5",
+};
+
+static const double test_numbers[] = {
+	0, 1, -1, 42, 3600, INT32_MAX, INT32_MIN, 3000000000.0, -3000000000.0,
+	0.1, -0.5, 1.0 / 3, 63.4305, 10.3951, 1e-9, 1e300, NAN, INFINITY,
+};
+
+/* A message with all value types, similar to a device status message */
+static void write_message(struct json_writer *w)
+{
+	json_writer_obj_start(w, NULL);
+	json_writer_obj_start(w, "state");
+	json_writer_obj_start(w, "reported");
+
+	json_writer_obj_start(w, "strings");
+	for (size_t i = 0; i < ARRAY_SIZE(test_strings); i++) {
+		/* Use the strings as keys too */
+		json_writer_str(w, test_strings[i], test_strings[i]);
+	}
+	json_writer_obj_end(w);
+
+	json_writer_arr_start(w, "numbers");
+	for (size_t i = 0; i < ARRAY_SIZE(test_numbers); i++) {
+		json_writer_num(w, NULL, test_numbers[i]);
+	}
+	json_writer_arr_end(w);
+
+	json_writer_arr_start(w, "empty_array");
+	json_writer_arr_end(w);
+	json_writer_obj_start(w, "empty_object");
+	json_writer_obj_end(w);
+	json_writer_null(w, "null");
+
+	json_writer_arr_start(w, "objects");
+	json_writer_obj_start(w, NULL);
+	json_writer_null(w, "a");
+	json_writer_obj_end(w);
+	json_writer_null(w, NULL);
+	json_writer_str(w, NULL, "b");
+	json_writer_arr_end(w);
+
+	json_writer_obj_end(w);
+	json_writer_obj_end(w);
+	json_writer_obj_end(w);
+}
+
+static cJSON *create_message(void)
+{
+	cJSON *root = cJSON_CreateObject();
+	cJSON *state = cJSON_AddObjectToObject(root, "state");
+	cJSON *reported = cJSON_AddObjectToObject(state, "reported");
+	cJSON *strings = cJSON_AddObjectToObject(reported, "strings");
+	cJSON *numbers = cJSON_AddArrayToObject(reported, "numbers");
+	cJSON *objects;
+	cJSON *obj;
+
+	for (size_t i = 0; i < ARRAY_SIZE(test_strings); i++) {
+		cJSON_AddStringToObject(strings, test_strings[i], test_strings[i]);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(test_numbers); i++) {
+		cJSON_AddItemToArray(numbers, cJSON_CreateNumber(test_numbers[i]));
+	}
+
+	cJSON_AddArrayToObject(reported, "empty_array");
+	cJSON_AddObjectToObject(reported, "empty_object");
+	cJSON_AddNullToObject(reported, "null");
+
+	objects = cJSON_AddArrayToObject(reported, "objects");
+	obj = cJSON_CreateObject();
+	cJSON_AddNullToObject(obj, "a");
+	cJSON_AddItemToArray(objects, obj);
+	cJSON_AddItemToArray(objects, cJSON_CreateNull());
+	cJSON_AddItemToArray(objects, cJSON_CreateString("b"));
+
+	return root;
+}
+
+static char *print_message(void)
+{
+	cJSON *root = create_message();
+	char *str;
+
+	zassert_not_null(root, "Failed to create cJSON message");
+	str = cJSON_PrintUnformatted(root);
+	cJSON_Delete(root);
+	zassert_not_null(str, "Failed to print cJSON message");
+
+	return str;
+}
+
+static int encode_message(char *buf, size_t size)
+{
+	struct json_writer w;
+
+	json_writer_init(&w, buf, size);
+	write_message(&w);
+
+	return json_writer_finish(&w);
+}
+
+ZTEST(nrf_cloud_json_writer_test, test_output_matches_cjson)
+{
+	char *expected = print_message();
+	char buf[1024];
+	int len;
+
+	len = encode_message(buf, sizeof(buf));
+
+	zassert_equal(len, strlen(expected), "Unexpected length: %d", len);
+	zassert_equal(strlen(buf), len, "Output not null-terminated");
+	zassert_mem_equal(buf, expected, len + 1, "Output differs:\n%s\n%s", buf, expected);
+
+	cJSON_free(expected);
+}
+
+ZTEST(nrf_cloud_json_writer_test, test_measure)
+{
+	char buf[1024];
+	int measured;
+	int len;
+
+	measured = encode_message(NULL, 0);
+	len = encode_message(buf, sizeof(buf));
+
+	zassert_true(measured > 0, "Measuring failed: %d", measured);
+	zassert_equal(measured, len, "Measured %d, encoded %d", measured, len);
+}
+
+ZTEST(nrf_cloud_json_writer_test, test_exact_fit)
+{
+	char buf[1024];
+	int len = encode_message(NULL, 0);
+
+	/* The null terminator must fit too */
+	zassert_equal(encode_message(buf, len), -ENOMEM, "Output without terminator accepted");
+	zassert_equal(encode_message(buf, len + 1), len, "Exact size buffer rejected");
+}
+
+ZTEST(nrf_cloud_json_writer_test, test_overflow)
+{
+	char buf[64];
+	const size_t size = 32;
+
+	memset(buf, 0xA5, sizeof(buf));
+
+	zassert_equal(encode_message(buf, size), -ENOMEM, "Overflow not detected");
+
+	for (size_t i = size; i < sizeof(buf); i++) {
+		zassert_equal((uint8_t)buf[i], 0xA5, "Written beyond the buffer at %zu", i);
+	}
+}
+
+ZTEST(nrf_cloud_json_writer_test, test_invalid_structure)
+{
+	struct json_writer w;
+	char buf[64];
+
+	/* Object member without a name */
+	json_writer_init(&w, buf, sizeof(buf));
+	json_writer_obj_start(&w, NULL);
+	json_writer_str(&w, NULL, "value");
+	json_writer_obj_end(&w);
+	zassert_equal(json_writer_finish(&w), -EINVAL, NULL);
+
+	/* Array element with a name */
+	json_writer_init(&w, buf, sizeof(buf));
+	json_writer_arr_start(&w, NULL);
+	json_writer_null(&w, "key");
+	json_writer_arr_end(&w);
+	zassert_equal(json_writer_finish(&w), -EINVAL, NULL);
+
+	/* Mismatched end */
+	json_writer_init(&w, buf, sizeof(buf));
+	json_writer_obj_start(&w, NULL);
+	json_writer_arr_end(&w);
+	zassert_equal(json_writer_finish(&w), -EINVAL, NULL);
+
+	/* Unclosed object */
+	json_writer_init(&w, buf, sizeof(buf));
+	json_writer_obj_start(&w, NULL);
+	zassert_equal(json_writer_finish(&w), -EINVAL, NULL);
+
+	/* Two root values */
+	json_writer_init(&w, buf, sizeof(buf));
+	json_writer_null(&w, NULL);
+	json_writer_null(&w, NULL);
+	zassert_equal(json_writer_finish(&w), -EINVAL, NULL);
+
+	/* NULL string */
+	json_writer_init(&w, buf, sizeof(buf));
+	json_writer_obj_start(&w, NULL);
+	json_writer_str(&w, "key", NULL);
+	json_writer_obj_end(&w);
+	zassert_equal(json_writer_finish(&w), -EINVAL, NULL);
+
+	/* Nothing written */
+	json_writer_init(&w, buf, sizeof(buf));
+	zassert_equal(json_writer_finish(&w), -EINVAL, NULL);
+}
+
+ZTEST(nrf_cloud_json_writer_test, test_max_depth)
+{
+	struct json_writer w;
+	char buf[2 * JSON_WRITER_MAX_DEPTH + 1];
+
+	json_writer_init(&w, buf, sizeof(buf));
+	for (int i = 0; i < JSON_WRITER_MAX_DEPTH; i++) {
+		json_writer_arr_start(&w, NULL);
+	}
+	for (int i = 0; i < JSON_WRITER_MAX_DEPTH; i++) {
+		json_writer_arr_end(&w);
+	}
+	zassert_equal(json_writer_finish(&w), 2 * JSON_WRITER_MAX_DEPTH, NULL);
+
+	json_writer_init(&w, NULL, 0);
+	for (int i = 0; i <= JSON_WRITER_MAX_DEPTH; i++) {
+		json_writer_arr_start(&w, NULL);
+	}
+	zassert_equal(json_writer_finish(&w), -E2BIG, NULL);
+}
+
+ZTEST(nrf_cloud_json_writer_test, test_cjson_output)
+{
+	char *expected = print_message();
+	cJSON *root = cJSON_CreateObject();
+	struct json_writer w;
+	char *str;
+
+	zassert_not_null(root, "Failed to create cJSON object");
+
+	json_writer_init_cjson(&w, root);
+	write_message(&w);
+	zassert_equal(json_writer_finish(&w), 0, NULL);
+
+	str = cJSON_PrintUnformatted(root);
+	cJSON_Delete(root);
+	zassert_not_null(str, "Failed to print cJSON message");
+	zassert_true(!strcmp(str, expected), "Output differs:\n%s\n%s", str, expected);
+
+	cJSON_free(str);
+	cJSON_free(expected);
+}
+
+ZTEST(nrf_cloud_json_writer_test, test_cjson_invalid_structure)
+{
+	cJSON *root = cJSON_CreateObject();
+	struct json_writer w;
+
+	zassert_not_null(root, "Failed to create cJSON object");
+
+	/* The root value must be an object */
+	json_writer_init_cjson(&w, root);
+	json_writer_arr_start(&w, NULL);
+	json_writer_arr_end(&w);
+	zassert_equal(json_writer_finish(&w), -EINVAL, NULL);
+
+	json_writer_init_cjson(&w, root);
+	json_writer_null(&w, NULL);
+	zassert_equal(json_writer_finish(&w), -EINVAL, NULL);
+
+	/* Object member without a name */
+	json_writer_init_cjson(&w, root);
+	json_writer_obj_start(&w, NULL);
+	json_writer_null(&w, NULL);
+	json_writer_obj_end(&w);
+	zassert_equal(json_writer_finish(&w), -EINVAL, NULL);
+
+	/* Nothing written */
+	json_writer_init_cjson(&w, root);
+	zassert_equal(json_writer_finish(&w), -EINVAL, NULL);
+
+	zassert_is_null(root->child, "Members added to the object");
+	cJSON_Delete(root);
+}
+
+ZTEST(nrf_cloud_json_writer_test, test_benchmark)
+{
+	size_t cjson_peak;
+	size_t cjson_allocs;
+	size_t writer_peak;
+	size_t writer_allocs;
+	uint32_t cjson_cycles;
+	uint32_t writer_cycles;
+	uint32_t start;
+	char *str;
+	int len;
+
+	/* Build a tree and print it, as the encoders did before */
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+		heap_stats_reset();
+		str = print_message();
+		cJSON_free(str);
+	}
+	cjson_cycles = k_cycle_get_32() - start;
+	cjson_peak = heap_peak;
+	cjson_allocs = heap_allocs;
+
+	/* Measure, allocate once and write, as the encoders do now */
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+		heap_stats_reset();
+		len = encode_message(NULL, 0);
+		str = cJSON_malloc(len + 1);
+		zassert_not_null(str, NULL);
+		zassert_equal(encode_message(str, len + 1), len, NULL);
+		cJSON_free(str);
+	}
+	writer_cycles = k_cycle_get_32() - start;
+	writer_peak = heap_peak;
+	writer_allocs = heap_allocs;
+
+	TC_PRINT("Message: %d bytes, %d rounds\n", len, BENCHMARK_ROUNDS);
+	TC_PRINT("cJSON:  heap peak %zu bytes, %zu allocations, %u cycles\n",
+		 cjson_peak, cjson_allocs, cjson_cycles);
+	TC_PRINT("Writer: heap peak %zu bytes, %zu allocations, %u cycles\n",
+		 writer_peak, writer_allocs, writer_cycles);
+
+	zassert_equal(writer_allocs, 1, "Unexpected allocations: %zu", writer_allocs);
+	zassert_equal(writer_peak, len + 1, "Unexpected heap peak: %zu", writer_peak);
+	zassert_true(writer_peak < cjson_peak, "Heap peak not reduced");
+}
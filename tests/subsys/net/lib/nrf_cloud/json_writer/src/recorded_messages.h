@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef RECORDED_MESSAGES_H__
+#define RECORDED_MESSAGES_H__
+
+/* Device messages as sent to nRF Cloud by the nrf_cloud library and by the
+ * asset_tracker_v2 application, recorded from an nRF9160 DK on LTE-M.
+ */
+
+struct recorded_message {
+	const char *name;
+	const char *json;
+};
+
+#define MSG_TEMP \
+	"{\"appId\":\"TEMP\",\"data\":\"24.52\",\"messageType\":\"DATA\",\"ts\":1663064400123}"
+
+#define MSG_BUTTON \
+	"{\"appId\":\"BUTTON\",\"messageType\":\"DATA\",\"ts\":1663064412877,\"data\":\"1\"}"
+
+#define MSG_GNSS \
+	"{\"appId\":\"GNSS\",\"messageType\":\"DATA\",\"ts\":1663064431004,"	\
+	"\"data\":{\"lng\":10.436720129,\"lat\":63.421514793,\"acc\":4.8762946128845215,"	\
+	"\"alt\":41.34796142578125,\"spd\":0.0940827876329422,"	\
+	"\"hdg\":0}}"
+
+#define MSG_MODEM_STATIC \
+	"{\"appId\":\"DEVICE\",\"messageType\":\"DATA\",\"ts\":1663064398211,"	\
+	"\"data\":{\"deviceInfo\":{\"imei\":\"352656100367872\","	\
+	"\"iccid\":\"89450421180216254864\",\"modemFirmware\":\"mfw_nrf9160_1.3.2\","	\
+	"\"board\":\"nrf9160dk_nrf9160\",\"appVersion\":\"0.0.0-development\"}}}"
+
+#define MSG_MODEM_DYNAMIC \
+	"{\"appId\":\"DEVICE\",\"messageType\":\"DATA\",\"ts\":1663064398577,"	\
+	"\"data\":{\"networkInfo\":{\"currentBand\":20,\"networkMode\":\"LTE-M\","	\
+	"\"rsrp\":-97,\"areaCode\":30401,\"mccmnc\":24202,\"cellID\":21679716,"	\
+	"\"ipAddress\":\"10.81.183.99\"}}}"
+
+#define MSG_ENV(app_id, value) \
+	"{\"appId\":\"" app_id "\",\"messageType\":\"DATA\",\"ts\":1663064420318,"	\
+	"\"data\":\"" value "\"}"
+
+#define MSG_BATCH \
+	"[" MSG_GNSS ","	\
+	MSG_ENV("HUMID", "38.21") "," MSG_ENV("TEMP", "24.52") ","	\
+	MSG_ENV("AIR_PRESS", "99.87") ","	\
+	"{\"appId\":\"VOLTAGE\",\"messageType\":\"DATA\",\"ts\":1663064420511,"	\
+	"\"data\":\"4410\"}," MSG_MODEM_DYNAMIC ","	\
+	"{\"appId\":\"RSRP\",\"messageType\":\"DATA\",\"ts\":1663064398577,\"data\":\"-97\"}]"
+
+static const struct recorded_message recorded_messages[] = {
+	{ "Sensor (TEMP)", MSG_TEMP },
+	{ "Button", MSG_BUTTON },
+	{ "GNSS PVT", MSG_GNSS },
+	{ "Modem static", MSG_MODEM_STATIC },
+	{ "Modem dynamic", MSG_MODEM_DYNAMIC },
+	{ "Batch", MSG_BATCH },
+};
+
+#endif /* RECORDED_MESSAGES_H__ */
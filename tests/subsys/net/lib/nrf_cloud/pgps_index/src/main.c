@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/fff.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/crc.h>
+
+#include "nrf_cloud_pgps_utils.c"
+
+DEFINE_FFF_GLOBALS;
+
+FAKE_VALUE_FUNC(int, download_client_init, struct download_client *,
+		download_client_callback_t);
+FAKE_VALUE_FUNC(int, download_client_connect, struct download_client *, const char *,
+		const struct download_client_cfg *);
+FAKE_VALUE_FUNC(int, download_client_start, struct download_client *, const char *, size_t);
+FAKE_VALUE_FUNC(int, download_client_disconnect, struct download_client *);
+FAKE_VALUE_FUNC(int, date_time_now, int64_t *);
+
+#define PERIOD_SEC (240 * SEC_PER_MIN)
+#define START_SEC (1000 * PERIOD_SEC)
+#define STORE_ENTRIES 16
+#define STORE_NAME_SIZE 32
+#define STORE_VAL_SIZE 16
+
+struct store_entry {
+	char name[STORE_NAME_SIZE];
+	uint8_t val[STORE_VAL_SIZE];
+	size_t val_len;
+};
+
+static struct store_entry store[STORE_ENTRIES];
+static int store_writes;
+
+static struct store_entry *store_find(const char *name)
+{
+	for (size_t i = 0; i < STORE_ENTRIES; i++) {
+		if (!strcmp(store[i].name, name)) {
+			return &store[i];
+		}
+	}
+	return NULL;
+}
+
+static void store_put(const char *name, const void *val, size_t val_len)
+{
+	struct store_entry *entry = store_find(name);
+
+	if (!entry) {
+		entry = store_find("");
+		zassert_not_null(entry, "Settings store full");
+	}
+
+	zassert_true(strlen(name) < STORE_NAME_SIZE, "Too long settings key");
+	zassert_true(val_len <= STORE_VAL_SIZE, "Too long settings value");
+
+	strcpy(entry->name, name);
+	memcpy(entry->val, val, val_len);
+	entry->val_len = val_len;
+}
+
+static ssize_t store_read(void *cb_arg, void *data, size_t len)
+{
+	struct store_entry *entry = cb_arg;
+
+	len = MIN(len, entry->val_len);
+	memcpy(data, entry->val, len);
+	return len;
+}
+
+static int store_load(struct settings_store *cs, const struct settings_load_arg *arg)
+{
+	for (size_t i = 0; i < STORE_ENTRIES; i++) {
+		if (store[i].name[0]) {
+			(void)settings_call_set_handler(store[i].name, store[i].val_len,
+							store_read, &store[i], arg);
+		}
+	}
+	return 0;
+}
+
+static int store_save(struct settings_store *cs, const char *name, const char *value,
+		      size_t val_len)
+{
+	struct store_entry *entry;
+
+	store_writes++;
+
+	/* Deleted entries are saved with no value */
+	if (!val_len) {
+		entry = store_find(name);
+		if (entry) {
+			memset(entry, 0, sizeof(*entry));
+		}
+		return 0;
+	}
+
+	store_put(name, value, val_len);
+	return 0;
+}
+
+static struct settings_store_itf store_itf = {
+	.csi_load = store_load,
+	.csi_save = store_save,
+};
+
+static struct settings_store settings_store = {
+	.cs_itf = &store_itf
+};
+
+/* Called by settings_subsys_init() with CONFIG_SETTINGS_CUSTOM */
+int settings_backend_init(void)
+{
+	settings_dst_register(&settings_store);
+	settings_src_register(&settings_store);
+	return 0;
+}
+
+/* The index is lost from RAM and loaded from settings, as after a reset */
+static void reboot(void)
+{
+	int err;
+
+	memset(saved_block_info, 0, sizeof(saved_block_info));
+
+	err = npgps_settings_init();
+	zassert_ok(err, "Settings not loaded (%d)", err);
+}
+
+static void save_info(int block, uint32_t gps_sec)
+{
+	struct npgps_block_info info = {
+		.gps_sec = gps_sec,
+		.crc = gps_sec ^ 0xFFFFFFFF
+	};
+	int err = npgps_save_block_info(block, &info);
+
+	zassert_ok(err, "Block:%d info not saved (%d)", block, err);
+}
+
+static void save_raw(const char *name, uint32_t gps_sec, size_t len)
+{
+	struct npgps_block_info info = {
+		.gps_sec = gps_sec
+	};
+
+	store_put(name, &info, len);
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(store, 0, sizeof(store));
+	reboot();
+	store_writes = 0;
+}
+
+ZTEST(pgps_index, test_rebuild_after_reboot)
+{
+	int blocks[NUM_PREDICTIONS];
+	int count;
+
+	/* The predictions wrap around the end of the storage */
+	for (int pnum = 0; pnum < 6; pnum++) {
+		save_info((5 + pnum) % NUM_BLOCKS, START_SEC + pnum * PERIOD_SEC);
+	}
+
+	reboot();
+
+	for (int pnum = 0; pnum < 6; pnum++) {
+		const struct npgps_block_info *info =
+			npgps_get_saved_block_info((5 + pnum) % NUM_BLOCKS);
+
+		zassert_equal(info->gps_sec, START_SEC + pnum * PERIOD_SEC,
+			      "Prediction num:%d time not restored", pnum);
+		zassert_equal(info->crc, info->gps_sec ^ 0xFFFFFFFF,
+			      "Prediction num:%d CRC not restored", pnum);
+	}
+
+	count = npgps_find_indexed_blocks(START_SEC, PERIOD_SEC, 6, blocks);
+	zassert_equal(count, 6, "Invalid number of predictions found (%d)", count);
+	for (int pnum = 0; pnum < count; pnum++) {
+		zassert_equal(blocks[pnum], (5 + pnum) % NUM_BLOCKS,
+			      "Prediction num:%d in wrong block", pnum);
+	}
+}
+
+ZTEST(pgps_index, test_stale_entries)
+{
+	int blocks[NUM_PREDICTIONS];
+	int count;
+
+	save_info(0, START_SEC);
+	save_info(1, START_SEC + PERIOD_SEC);
+	/* prediction of the previous set */
+	save_info(2, START_SEC - PERIOD_SEC);
+	/* not aligned to the prediction period */
+	save_info(3, START_SEC + PERIOD_SEC / 2);
+	/* after the last prediction of the set */
+	save_info(4, START_SEC + 6 * PERIOD_SEC);
+	/* prediction num 2 is missing, so num 3 cannot be used */
+	save_info(5, START_SEC + 3 * PERIOD_SEC);
+
+	reboot();
+
+	count = npgps_find_indexed_blocks(START_SEC, PERIOD_SEC, 6, blocks);
+	zassert_equal(count, 2, "Stale entries used (%d)", count);
+	zassert_equal(blocks[0], 0, "Prediction num:0 in wrong block");
+	zassert_equal(blocks[1], 1, "Prediction num:1 in wrong block");
+	zassert_equal(blocks[2], NO_BLOCK, "Missing prediction num:2 found");
+	zassert_equal(blocks[3], 5, "Prediction num:3 in wrong block");
+
+	/* a newer set does not use any of the entries */
+	count = npgps_find_indexed_blocks(START_SEC + 7 * PERIOD_SEC, PERIOD_SEC, 6, blocks);
+	zassert_equal(count, -ENODATA, "Entries of an older set used (%d)", count);
+}
+
+ZTEST(pgps_index, test_duplicate_entries)
+{
+	int blocks[NUM_PREDICTIONS];
+	int count;
+
+	save_info(0, START_SEC);
+	save_info(1, START_SEC + PERIOD_SEC);
+	save_info(6, START_SEC + PERIOD_SEC);
+
+	reboot();
+
+	count = npgps_find_indexed_blocks(START_SEC, PERIOD_SEC, 6, blocks);
+	zassert_equal(count, -ENODATA, "Prediction indexed twice not rejected (%d)", count);
+}
+
+ZTEST(pgps_index, test_corrupt_entries)
+{
+	int blocks[NUM_PREDICTIONS];
+	int count;
+
+	save_raw(SETTINGS_FULL_BLOCK_INFO "/1", START_SEC, sizeof(uint32_t));
+	save_raw(SETTINGS_FULL_BLOCK_INFO "/8", START_SEC, sizeof(struct npgps_block_info));
+	save_raw(SETTINGS_FULL_BLOCK_INFO "/-1", START_SEC, sizeof(struct npgps_block_info));
+	save_raw(SETTINGS_FULL_BLOCK_INFO "/x", START_SEC, sizeof(struct npgps_block_info));
+	save_raw(SETTINGS_FULL_BLOCK_INFO "/2x", START_SEC, sizeof(struct npgps_block_info));
+	save_raw(SETTINGS_FULL_BLOCK_INFO "/", START_SEC, sizeof(struct npgps_block_info));
+	save_raw(SETTINGS_FULL_BLOCK_INFO, START_SEC, sizeof(struct npgps_block_info));
+
+	reboot();
+
+	for (int i = 0; i < NUM_BLOCKS; i++) {
+		zassert_equal(npgps_get_saved_block_info(i)->gps_sec, 0,
+			      "Corrupt entry loaded to block:%d", i);
+	}
+
+	count = npgps_find_indexed_blocks(START_SEC, PERIOD_SEC, 6, blocks);
+	zassert_equal(count, -ENODATA, "Corrupt entries used (%d)", count);
+
+	/* valid entries are still loaded after the corrupt ones */
+	save_raw(SETTINGS_FULL_BLOCK_INFO "/3", START_SEC, sizeof(struct npgps_block_info));
+
+	reboot();
+
+	count = npgps_find_indexed_blocks(START_SEC, PERIOD_SEC, 6, blocks);
+	zassert_equal(count, 1, "Valid entry not used (%d)", count);
+	zassert_equal(blocks[0], 3, "Prediction num:0 in wrong block");
+}
+
+ZTEST(pgps_index, test_prediction_check)
+{
+	static struct nrf_cloud_pgps_prediction pred;
+	struct npgps_block_info info;
+	int err;
+
+	memset(&pred, 0x5A, sizeof(pred));
+	pred.sentinel = START_SEC;
+	info.gps_sec = START_SEC;
+	info.crc = crc32_ieee((const uint8_t *)&pred, sizeof(pred));
+	zassert_ok(npgps_save_block_info(2, &info), "Block info not saved");
+
+	reboot();
+
+	err = npgps_check_block_info(2, &pred);
+	zassert_ok(err, "Matching prediction rejected (%d)", err);
+
+	/* prediction overwritten in flash without updating the index */
+	pred.sentinel = START_SEC + PERIOD_SEC;
+	err = npgps_check_block_info(2, &pred);
+	zassert_equal(err, -EBADMSG, "Prediction of another time accepted (%d)", err);
+
+	/* prediction corrupted in flash */
+	pred.sentinel = START_SEC;
+	pred.time_type ^= 1;
+	err = npgps_check_block_info(2, &pred);
+	zassert_equal(err, -EBADMSG, "Corrupt prediction accepted (%d)", err);
+}
+
+ZTEST(pgps_index, test_eviction)
+{
+	int blocks[NUM_PREDICTIONS];
+	int count;
+
+	for (int pnum = 0; pnum < 4; pnum++) {
+		save_info(pnum, START_SEC + pnum * PERIOD_SEC);
+	}
+	zassert_equal(store_writes, 4, "Invalid number of settings writes");
+
+	/* saving an unchanged entry does not write to settings */
+	save_info(3, START_SEC + 3 * PERIOD_SEC);
+	zassert_equal(store_writes, 4, "Unchanged entry written");
+
+	/* the two oldest predictions expire; the next set starts with
+	 * the other two, and its third prediction replaces the first
+	 */
+	zassert_ok(npgps_clear_block_info(0), "Block:0 info not cleared");
+	zassert_ok(npgps_clear_block_info(1), "Block:1 info not cleared");
+	save_info(0, START_SEC + 4 * PERIOD_SEC);
+	zassert_equal(store_writes, 7, "Invalid number of settings writes");
+
+	/* clearing an empty entry does not write to settings */
+	zassert_ok(npgps_clear_block_info(1), "Empty block:1 info not cleared");
+	zassert_equal(store_writes, 7, "Empty entry deleted");
+
+	zassert_is_null(store_find(SETTINGS_FULL_BLOCK_INFO "/1"), "Entry not deleted");
+
+	reboot();
+
+	zassert_equal(npgps_get_saved_block_info(1)->gps_sec, 0, "Deleted entry loaded");
+
+	count = npgps_find_indexed_blocks(START_SEC + 2 * PERIOD_SEC, PERIOD_SEC, 6, blocks);
+	zassert_equal(count, 3, "Invalid number of predictions found (%d)", count);
+	zassert_equal(blocks[0], 2, "Prediction num:0 in wrong block");
+	zassert_equal(blocks[1], 3, "Prediction num:1 in wrong block");
+	zassert_equal(blocks[2], 0, "Prediction num:2 in wrong block");
+
+	/* the evicted predictions of the old set are not found */
+	count = npgps_find_indexed_blocks(START_SEC, PERIOD_SEC, 6, blocks);
+	zassert_equal(count, -ENODATA, "Evicted predictions found (%d)", count);
+}
+
+ZTEST_SUITE(pgps_index, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Loopback IPC Service backend: data sent on the endpoint is received on the same endpoint. */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/ipc/ipc_service.h>
+
+#include "fake_ipc.h"
+
+static const struct ipc_ept_cfg *ept_cfg;
+static struct fake_ipc_stats stats;
+static bool nocopy_supported = true;
+static uint32_t shm_bufs[FAKE_IPC_BUF_COUNT][FAKE_IPC_BUF_SIZE / sizeof(uint32_t)];
+static bool shm_buf_taken[FAKE_IPC_BUF_COUNT];
+
+static int shm_buf_idx(const void *data)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(shm_bufs); i++) {
+		if (data == shm_bufs[i]) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+void fake_ipc_reset(void)
+{
+	memset(&stats, 0, sizeof(stats));
+	memset(shm_buf_taken, 0, sizeof(shm_buf_taken));
+	nocopy_supported = true;
+}
+
+void fake_ipc_nocopy_support_set(bool supported)
+{
+	nocopy_supported = supported;
+}
+
+size_t fake_ipc_bufs_taken(void)
+{
+	size_t cnt = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(shm_buf_taken); i++) {
+		cnt += shm_buf_taken[i] ? 1 : 0;
+	}
+
+	return cnt;
+}
+
+const struct fake_ipc_stats *fake_ipc_stats_get(void)
+{
+	return &stats;
+}
+
+int ipc_service_open_instance(const struct device *instance)
+{
+	return 0;
+}
+
+int ipc_service_register_endpoint(const struct device *instance, struct ipc_ept *ept,
+				  const struct ipc_ept_cfg *cfg)
+{
+	ept->instance = instance;
+	ept_cfg = cfg;
+
+	cfg->cb.bound(cfg->priv);
+
+	return 0;
+}
+
+int ipc_service_send(struct ipc_ept *ept, const void *data, size_t len)
+{
+	zassert_true(shm_buf_idx(data) < 0, "Shared memory buffer sent by copy");
+
+	stats.sent++;
+	ept_cfg->cb.received(data, len, ept_cfg->priv);
+
+	return len;
+}
+
+int ipc_service_get_tx_buffer(struct ipc_ept *ept, void **data, uint32_t *size,
+			      k_timeout_t wait)
+{
+	if (!nocopy_supported) {
+		return -EIO;
+	}
+
+	if (*size > FAKE_IPC_BUF_SIZE) {
+		*size = FAKE_IPC_BUF_SIZE;
+		return -ENOMEM;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(shm_bufs); i++) {
+		if (!shm_buf_taken[i]) {
+			shm_buf_taken[i] = true;
+			*data = shm_bufs[i];
+			*size = FAKE_IPC_BUF_SIZE;
+			return 0;
+		}
+	}
+
+	return -ENOBUFS;
+}
+
+int ipc_service_send_nocopy(struct ipc_ept *ept, const void *data, size_t len)
+{
+	int idx = shm_buf_idx(data);
+
+	zassert_true(idx >= 0, "Unknown shared memory buffer");
+	zassert_true(shm_buf_taken[idx], "Shared memory buffer not taken");
+	zassert_true(len <= FAKE_IPC_BUF_SIZE, "Shared memory buffer overflow");
+
+	stats.sent_nocopy++;
+	ept_cfg->cb.received(data, len, ept_cfg->priv);
+	shm_buf_taken[idx] = false;
+
+	return len;
+}
+
+int ipc_service_drop_tx_buffer(struct ipc_ept *ept, const void *data)
+{
+	int idx = shm_buf_idx(data);
+
+	zassert_true(idx >= 0, "Unknown shared memory buffer");
+	zassert_true(shm_buf_taken[idx], "Shared memory buffer not taken");
+
+	stats.dropped++;
+	shm_buf_taken[idx] = false;
+
+	return 0;
+}
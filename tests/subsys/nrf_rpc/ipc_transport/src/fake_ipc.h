@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef FAKE_IPC_H_
+#define FAKE_IPC_H_
+
+#include <zephyr/types.h>
+
+/* Size of a single shared memory buffer of the fake IPC Service backend. */
+#define FAKE_IPC_BUF_SIZE 128
+#define FAKE_IPC_BUF_COUNT 2
+
+struct fake_ipc_stats {
+	uint32_t sent;
+	uint32_t sent_nocopy;
+	uint32_t dropped;
+};
+
+/* Reset statistics and release all shared memory buffers. */
+void fake_ipc_reset(void);
+
+/* Emulate backend without the no-copy API. */
+void fake_ipc_nocopy_support_set(bool supported);
+
+/* Number of shared memory buffers taken by the transport. */
+size_t fake_ipc_bufs_taken(void);
+
+const struct fake_ipc_stats *fake_ipc_stats_get(void);
+
+#endif /* FAKE_IPC_H_ */
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <nrf_rpc/nrf_rpc_ipc.h>
+
+#include "fake_ipc.h"
+
+#define SMALL_PACKET_SIZE 32
+#define BIG_PACKET_SIZE 200
+/* Bigger than a Tx pool block */
+#define HUGE_PACKET_SIZE 300
+#define MANY_PACKETS_CNT 10000
+
+#if defined(CONFIG_NRF_RPC_IPC_SERVICE_TX_POOL)
+extern struct k_mem_slab nrf_rpc_ipc_tx_pool;
+#endif
+
+/* The fake backend does not access the instance. */
+static const struct device fake_ipc_instance;
+
+NRF_RPC_IPC_TRANSPORT(test_tr, &fake_ipc_instance, "test_ept");
+
+static size_t received_cnt;
+static size_t received_len;
+static uint8_t received_data[HUGE_PACKET_SIZE];
+
+static void receive_handler(const struct nrf_rpc_tr *transport, const uint8_t *packet,
+			    size_t len, void *context)
+{
+	zassert_equal_ptr(transport, &test_tr, "Invalid transport");
+
+	received_cnt++;
+	received_len = len;
+	memcpy(received_data, packet, MIN(len, sizeof(received_data)));
+}
+
+static uint8_t *packet_alloc(size_t size)
+{
+	size_t alloc_size = size;
+	uint8_t *packet = test_tr.api->tx_buf_alloc(&test_tr, &alloc_size);
+
+	zassert_not_null(packet, "Tx buffer allocation failed");
+	zassert_true(alloc_size >= size, "Tx buffer too small");
+
+	return packet;
+}
+
+static void packet_loopback(size_t size)
+{
+	uint8_t *packet = packet_alloc(size);
+	int err;
+
+	for (size_t i = 0; i < size; i++) {
+		packet[i] = i;
+	}
+
+	received_cnt = 0;
+	err = test_tr.api->send(&test_tr, packet, size);
+	zassert_ok(err, "Send failed (%d)", err);
+
+	zassert_equal(received_cnt, 1, "Packet not received");
+	zassert_equal(received_len, size, "Invalid packet length");
+	for (size_t i = 0; i < size; i++) {
+		zassert_equal(received_data[i], (uint8_t)i, "Invalid packet content");
+	}
+}
+
+static void tx_bufs_released_check(void)
+{
+	zassert_equal(fake_ipc_bufs_taken(), 0, "Shared memory buffer not released");
+#if defined(CONFIG_NRF_RPC_IPC_SERVICE_TX_POOL)
+	zassert_equal(k_mem_slab_num_used_get(&nrf_rpc_ipc_tx_pool), 0,
+		      "Tx pool block not released");
+#endif
+}
+
+static void test_init(void)
+{
+	int err = test_tr.api->init(&test_tr, receive_handler, NULL);
+
+	zassert_ok(err, "Transport init failed (%d)", err);
+}
+
+static void test_loopback_small(void)
+{
+	fake_ipc_reset();
+
+	packet_loopback(SMALL_PACKET_SIZE);
+
+	const struct fake_ipc_stats *stats = fake_ipc_stats_get();
+
+	if (IS_ENABLED(CONFIG_NRF_RPC_IPC_SERVICE_NOCOPY)) {
+		zassert_equal(stats->sent_nocopy, 1, "Packet not sent without copying");
+	} else {
+		zassert_equal(stats->sent, 1, "Packet not sent");
+	}
+
+	tx_bufs_released_check();
+}
+
+static void test_loopback_big(void)
+{
+	fake_ipc_reset();
+
+	/* The packet does not fit in the shared memory buffer. */
+	packet_loopback(BIG_PACKET_SIZE);
+
+	zassert_equal(fake_ipc_stats_get()->sent, 1, "Packet not sent");
+	tx_bufs_released_check();
+}
+
+static void test_loopback_huge(void)
+{
+	uint8_t *packets[FAKE_IPC_BUF_COUNT];
+
+	fake_ipc_reset();
+
+	/* The packet fits neither in the shared memory buffer nor in a Tx pool block. */
+	packet_loopback(HUGE_PACKET_SIZE);
+
+	zassert_equal(fake_ipc_stats_get()->sent, 1, "Packet not sent");
+	tx_bufs_released_check();
+
+	/* Also when no shared memory buffer is free. */
+	for (size_t i = 0; i < ARRAY_SIZE(packets); i++) {
+		packets[i] = packet_alloc(SMALL_PACKET_SIZE);
+	}
+
+	packet_loopback(HUGE_PACKET_SIZE);
+
+	for (size_t i = 0; i < ARRAY_SIZE(packets); i++) {
+		test_tr.api->tx_buf_free(&test_tr, packets[i]);
+	}
+
+	zassert_equal(fake_ipc_stats_get()->sent, 2, "Packet not sent");
+	tx_bufs_released_check();
+}
+
+static void test_tx_buf_free_huge(void)
+{
+	fake_ipc_reset();
+
+	uint8_t *packet = packet_alloc(HUGE_PACKET_SIZE);
+
+	test_tr.api->tx_buf_free(&test_tr, packet);
+
+	zassert_equal(fake_ipc_stats_get()->dropped, 0, "Heap buffer dropped as IPC buffer");
+	tx_bufs_released_check();
+}
+
+static void test_tx_buf_free(void)
+{
+	fake_ipc_reset();
+
+	uint8_t *packet = packet_alloc(SMALL_PACKET_SIZE);
+
+	test_tr.api->tx_buf_free(&test_tr, packet);
+
+	if (IS_ENABLED(CONFIG_NRF_RPC_IPC_SERVICE_NOCOPY)) {
+		zassert_equal(fake_ipc_stats_get()->dropped, 1, "Buffer not dropped");
+	}
+
+	tx_bufs_released_check();
+}
+
+static void test_shm_exhausted(void)
+{
+	uint8_t *packets[FAKE_IPC_BUF_COUNT + 1];
+
+	fake_ipc_reset();
+
+	/* Packets that do not get the shared memory buffer use the Tx pool or the heap. */
+	for (size_t i = 0; i < ARRAY_SIZE(packets); i++) {
+		packets[i] = packet_alloc(SMALL_PACKET_SIZE);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(packets); i++) {
+		int err = test_tr.api->send(&test_tr, packets[i], SMALL_PACKET_SIZE);
+
+		zassert_ok(err, "Send failed (%d)", err);
+	}
+
+	const struct fake_ipc_stats *stats = fake_ipc_stats_get();
+
+	zassert_equal(stats->sent + stats->sent_nocopy, ARRAY_SIZE(packets),
+		      "Packets not sent");
+	if (IS_ENABLED(CONFIG_NRF_RPC_IPC_SERVICE_NOCOPY)) {
+		zassert_equal(stats->sent_nocopy, FAKE_IPC_BUF_COUNT,
+			      "Shared memory buffers not used");
+	}
+
+	tx_bufs_released_check();
+}
+
+static void test_many_packets(void)
+{
+	fake_ipc_reset();
+	received_cnt = 0;
+
+	for (size_t i = 0; i < MANY_PACKETS_CNT; i++) {
+		size_t size = SMALL_PACKET_SIZE;
+		uint8_t *packet = test_tr.api->tx_buf_alloc(&test_tr, &size);
+
+		memset(packet, (uint8_t)i, SMALL_PACKET_SIZE);
+		test_tr.api->send(&test_tr, packet, SMALL_PACKET_SIZE);
+	}
+
+	zassert_equal(received_cnt, MANY_PACKETS_CNT, "Packets lost");
+	tx_bufs_released_check();
+}
+
+static void test_nocopy_unsupported(void)
+{
+	if (!IS_ENABLED(CONFIG_NRF_RPC_IPC_SERVICE_NOCOPY)) {
+		ztest_test_skip();
+		return;
+	}
+
+	fake_ipc_reset();
+	fake_ipc_nocopy_support_set(false);
+
+	packet_loopback(SMALL_PACKET_SIZE);
+	packet_loopback(HUGE_PACKET_SIZE);
+
+	zassert_equal(fake_ipc_stats_get()->sent, 2, "Packets not sent by copy");
+	tx_bufs_released_check();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(nrf_rpc_ipc_transport,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_loopback_small),
+			 ztest_unit_test(test_loopback_big),
+			 ztest_unit_test(test_loopback_huge),
+			 ztest_unit_test(test_tx_buf_free_huge),
+			 ztest_unit_test(test_tx_buf_free),
+			 ztest_unit_test(test_shm_exhausted),
+			 ztest_unit_test(test_many_packets),
+			 /* Must be the last one, the transport stops using no-copy API. */
+			 ztest_unit_test(test_nocopy_unsupported)
+			 );
+
+	ztest_run_test_suite(nrf_rpc_ipc_transport);
+}
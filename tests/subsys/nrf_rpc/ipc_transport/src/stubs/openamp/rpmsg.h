@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Error codes used by the nRF RPC IPC transport, the values match OpenAMP. */
+
+#ifndef RPMSG_STUB_H_
+#define RPMSG_STUB_H_
+
+#define RPMSG_ERROR_BASE	-2000
+#define RPMSG_ERR_NO_MEM	(RPMSG_ERROR_BASE - 1)
+#define RPMSG_ERR_NO_BUFF	(RPMSG_ERROR_BASE - 2)
+#define RPMSG_ERR_PARAM		(RPMSG_ERROR_BASE - 3)
+#define RPMSG_ERR_DEV_STATE	(RPMSG_ERROR_BASE - 4)
+#define RPMSG_ERR_BUFF_SIZE	(RPMSG_ERROR_BASE - 5)
+#define RPMSG_ERR_INIT		(RPMSG_ERROR_BASE - 6)
+#define RPMSG_ERR_ADDR		(RPMSG_ERROR_BASE - 7)
+
+#endif /* RPMSG_STUB_H_ */
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <nrf_rpc_os.h>
+
+#define CTX_CNT CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE
+#define POOL_PACKET_CNT 10
+#define WAITER_STACK_SIZE 1024
+#define WAIT_TIME_MS 10
+
+BUILD_ASSERT(CTX_CNT > 32, "The test must use more contexts than bits in a word");
+
+static K_SEM_DEFINE(pool_done, 0, POOL_PACKET_CNT);
+static K_THREAD_STACK_DEFINE(waiter_stack, WAITER_STACK_SIZE);
+static struct k_thread waiter_thread;
+
+static uint8_t pool_packets[POOL_PACKET_CNT];
+static uint32_t waiter_ctx;
+
+static void pool_callback(const uint8_t *data, size_t len)
+{
+	zassert_equal(len, 1, "Invalid packet length");
+	zassert_true((data >= pool_packets) && (data < pool_packets + POOL_PACKET_CNT),
+		     "Invalid packet");
+
+	k_sem_give(&pool_done);
+}
+
+static void ctx_reserve_all(uint32_t *ctxs)
+{
+	bool reserved[CTX_CNT] = {false};
+
+	for (size_t i = 0; i < CTX_CNT; i++) {
+		ctxs[i] = nrf_rpc_os_ctx_pool_reserve();
+
+		zassert_true(ctxs[i] < CTX_CNT, "Invalid context number %u", ctxs[i]);
+		zassert_false(reserved[ctxs[i]], "Context %u reserved twice", ctxs[i]);
+		reserved[ctxs[i]] = true;
+	}
+}
+
+static void ctx_release_all(const uint32_t *ctxs)
+{
+	for (size_t i = 0; i < CTX_CNT; i++) {
+		nrf_rpc_os_ctx_pool_release(ctxs[i]);
+	}
+}
+
+static void waiter_fn(void *p1, void *p2, void *p3)
+{
+	waiter_ctx = nrf_rpc_os_ctx_pool_reserve();
+}
+
+static void test_init(void)
+{
+	int err = nrf_rpc_os_init(pool_callback);
+
+	zassert_ok(err, "OS abstraction init failed (%d)", err);
+}
+
+static void test_ctx_reserve_all(void)
+{
+	uint32_t ctxs[CTX_CNT];
+	struct nrf_rpc_os_stats stats;
+
+	ctx_reserve_all(ctxs);
+
+	nrf_rpc_os_stats_get(&stats);
+	zassert_equal(stats.ctx_used_max, CTX_CNT, "Invalid maximum number of used contexts");
+	zassert_equal(stats.ctx_exhausted_cnt, 0, "Contexts reported as exhausted");
+
+	ctx_release_all(ctxs);
+}
+
+static void test_ctx_reuse(void)
+{
+	uint32_t ctxs[CTX_CNT];
+	uint32_t ctx;
+
+	ctx_reserve_all(ctxs);
+
+	/* Only the released context in the second word of the bitmap is free. */
+	nrf_rpc_os_ctx_pool_release(CTX_CNT - 1);
+	ctx = nrf_rpc_os_ctx_pool_reserve();
+	zassert_equal(ctx, CTX_CNT - 1, "Released context not reused");
+
+	ctx_release_all(ctxs);
+
+	/* The lowest free context is taken. */
+	ctx = nrf_rpc_os_ctx_pool_reserve();
+	zassert_equal(ctx, 0, "Lowest context not taken");
+	nrf_rpc_os_ctx_pool_release(ctx);
+}
+
+static void test_ctx_exhausted(void)
+{
+	uint32_t ctxs[CTX_CNT];
+	struct nrf_rpc_os_stats stats;
+	k_tid_t tid;
+
+	ctx_reserve_all(ctxs);
+
+	tid = k_thread_create(&waiter_thread, waiter_stack, K_THREAD_STACK_SIZEOF(waiter_stack),
+			      waiter_fn, NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	/* Let the thread wait for a context. */
+	k_sleep(K_MSEC(WAIT_TIME_MS));
+
+	nrf_rpc_os_ctx_pool_release(33);
+	k_thread_join(tid, K_FOREVER);
+
+	zassert_equal(waiter_ctx, 33, "Released context not passed to the waiting thread");
+
+	nrf_rpc_os_stats_get(&stats);
+	zassert_equal(stats.ctx_exhausted_cnt, 1, "Exhausted contexts not reported");
+	zassert_equal(stats.ctx_used_max, CTX_CNT, "Invalid maximum number of used contexts");
+
+	for (size_t i = 0; i < CTX_CNT; i++) {
+		/* The waiting thread took over context 33. */
+		nrf_rpc_os_ctx_pool_release((ctxs[i] == 33) ? waiter_ctx : ctxs[i]);
+	}
+}
+
+static void test_thread_pool(void)
+{
+	struct nrf_rpc_os_stats stats;
+	struct nrf_rpc_os_stats stats_before;
+	int err;
+
+	nrf_rpc_os_stats_get(&stats_before);
+
+	/* The test thread is cooperative, so the pool threads do not take packets from the
+	 * queue until it blocks on the full queue.
+	 */
+	for (size_t i = 0; i < POOL_PACKET_CNT; i++) {
+		nrf_rpc_os_thread_pool_send(&pool_packets[i], 1);
+	}
+
+	for (size_t i = 0; i < POOL_PACKET_CNT; i++) {
+		err = k_sem_take(&pool_done, K_MSEC(WAIT_TIME_MS));
+		zassert_ok(err, "Packet not processed by the thread pool");
+	}
+
+	nrf_rpc_os_stats_get(&stats);
+	zassert_equal(stats.pool_msg_cnt - stats_before.pool_msg_cnt, POOL_PACKET_CNT,
+		      "Invalid number of packets passed to the thread pool");
+	zassert_true(stats.pool_queue_full_cnt > stats_before.pool_queue_full_cnt,
+		     "Full thread pool queue not reported");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(nrf_rpc_os,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_ctx_reserve_all),
+			 ztest_unit_test(test_ctx_reuse),
+			 ztest_unit_test(test_ctx_exhausted),
+			 ztest_unit_test(test_thread_pool)
+			 );
+
+	ztest_run_test_suite(nrf_rpc_os);
+}